@@ -1061,16 +1061,19 @@ run_save_brm() {
         smcat /data1/systemFiles/dbrm/BRM_saves_em   2>/dev/null > $tmp_dir/BRM_saves_em 
         smcat /data1/systemFiles/dbrm/BRM_saves_vbbm 2>/dev/null > $tmp_dir/BRM_saves_vbbm 
         smcat /data1/systemFiles/dbrm/BRM_saves_vss  2>/dev/null > $tmp_dir/BRM_saves_vss 
+        smcat_if_exists /data1/systemFiles/dbrm/BRM_saves_em_delta $tmp_dir/BRM_saves_em_delta
 
         # A Set
         smcat /data1/systemFiles/dbrm/BRM_savesA_em   2>/dev/null > $tmp_dir/BRM_savesA_em 
         smcat /data1/systemFiles/dbrm/BRM_savesA_vbbm 2>/dev/null > $tmp_dir/BRM_savesA_vbbm 
         smcat /data1/systemFiles/dbrm/BRM_savesA_vss  2>/dev/null > $tmp_dir/BRM_savesA_vss 
+        smcat_if_exists /data1/systemFiles/dbrm/BRM_savesA_em_delta $tmp_dir/BRM_savesA_em_delta
         
         # B Set
         smcat /data1/systemFiles/dbrm/BRM_savesB_em   2>/dev/null > $tmp_dir/BRM_savesB_em 
         smcat /data1/systemFiles/dbrm/BRM_savesB_vbbm 2>/dev/null > $tmp_dir/BRM_savesB_vbbm 
         smcat /data1/systemFiles/dbrm/BRM_savesB_vss  2>/dev/null > $tmp_dir/BRM_savesB_vss 
+        smcat_if_exists /data1/systemFiles/dbrm/BRM_savesB_em_delta $tmp_dir/BRM_savesB_em_delta
         printf " Done \n" 
     fi
     
@@ -3156,6 +3159,10 @@ process_dbrm_backup() {
             smcat /data1/systemFiles/dbrm/BRM_savesB_em 2>/dev/null > $backup_folder/dbrms/BRM_savesB_em
             smcat /data1/systemFiles/dbrm/BRM_savesB_vbbm 2>/dev/null > $backup_folder/dbrms/BRM_savesB_vbbm
             smcat /data1/systemFiles/dbrm/BRM_savesB_vss 2>/dev/null > $backup_folder/dbrms/BRM_savesB_vss
+            # EM delta files of incremental snapshots, applied on top of their EM image by load_brm
+            for delta in BRM_saves_em_delta BRM_savesA_em_delta BRM_savesB_em_delta; do
+                smcat_if_exists /data1/systemFiles/dbrm/$delta $backup_folder/dbrms/$delta
+            done
             smcat /data1/systemFiles/dbrm/oidbitmap 2>/dev/null > $backup_folder/dbrms/oidbitmap
             smcat /data1/systemFiles/dbrm/SMTxnID 2>/dev/null > $backup_folder/dbrms/SMTxnID
             smcat /data1/systemFiles/dbrm/tablelocks 2>/dev/null > $backup_folder/dbrms/tablelocks
@@ -3405,6 +3412,14 @@ process_dbrm_restore() {
     fi;
 }
 
+# $1 - File in storagemanager to cat, if it is there
+# $2 - Local file to write it to
+smcat_if_exists() {
+    if ! smcat "$1" 2>/dev/null > "$2"; then
+        rm -f "$2"
+    fi
+}
+
 # $1 - File to cat/ upload into S3
 # $2 - Location in storagemanager to overwrite
 # example:  smput_or_error "${backup_location}/${backup_folder_to_restore_dbrms}/${prefix}_em" "/data1/systemFiles/dbrm/BRM_saves_em"
@@ -3471,6 +3486,12 @@ process_s3_dbrm_restore() {
     smput_or_error "${backup_location}/${backup_folder_to_restore_dbrms}/${prefix}_em" "/data1/systemFiles/dbrm/BRM_saves_em"
     smput_or_error "${backup_location}/${backup_folder_to_restore_dbrms}/${prefix}_vbbm" "/data1/systemFiles/dbrm/BRM_saves_vbbm"
     smput_or_error "${backup_location}/${backup_folder_to_restore_dbrms}/${prefix}_vss" "/data1/systemFiles/dbrm/BRM_saves_vss"
+    # The EM image only is complete with the delta of the incremental snapshots taken after it
+    if [ -f "${backup_location}/${backup_folder_to_restore_dbrms}/${prefix}_em_delta" ]; then
+        smput_or_error "${backup_location}/${backup_folder_to_restore_dbrms}/${prefix}_em_delta" "/data1/systemFiles/dbrm/BRM_saves_em_delta"
+    else
+        smrm /data1/systemFiles/dbrm/BRM_saves_em_delta 2>/dev/null
+    fi
     if ! echo "BRM_saves" | smput /data1/systemFiles/dbrm/BRM_saves_current 2>/dev/null; then
         printf "[!] Failed to smput: BRM_saves_current\n"
     else
@@ -3576,6 +3597,12 @@ process_localstorage_dbrm_restore() {
         cp -arpf "${dbrm_dir}/$em_file_name" "${dbrm_dir}/BRM_saves_em"
         cp -arpf "${dbrm_dir}/$vbbm_name"    "${dbrm_dir}/BRM_saves_vbbm"
         cp -arpf "${dbrm_dir}/$vss_name"     "${dbrm_dir}/BRM_saves_vss"
+        # The EM image only is complete with the delta of the incremental snapshots taken after it
+        if [ -f "${dbrm_dir}/${prefix}_em_delta" ]; then
+            cp -arpf "${dbrm_dir}/${prefix}_em_delta" "${dbrm_dir}/BRM_saves_em_delta"
+        else
+            rm -f "${dbrm_dir}/BRM_saves_em_delta"
+        fi
     fi
     echo "BRM_saves" > "${dbrm_dir}/BRM_saves_current"
     chown -R mysql:mysql "${dbrm_dir}"
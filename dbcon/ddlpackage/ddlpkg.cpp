@@ -67,13 +67,15 @@ ColumnType::ColumnType(int prec, int scale)
  , fCollate(NULL)
  , fCharsetNum(0)
  , fExplicitLength(false)
+ , fSortKey(0)
+ , fIndexType(0)
 {
   fLength = utils::widthByPrecision(fPrecision);
 }
 
 ColumnType::ColumnType(int type)
  : fType(type), fLength(0), fScale(0), fWithTimezone(false),
-   fCharset(NULL), fCollate(NULL), fCharsetNum(0), fExplicitLength(false)
+   fCharset(NULL), fCollate(NULL), fCharsetNum(0), fExplicitLength(false), fSortKey(0), fIndexType(0)
 {
   switch (type)
   {
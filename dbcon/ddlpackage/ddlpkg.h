@@ -935,7 +935,8 @@ struct ColumnType
   EXPORT int serialize(messageqcpp::ByteStream& bs);
 
   /** @brief For deserialization. */
-  ColumnType() : fCharset(NULL), fCollate(NULL), fCharsetNum(0), fExplicitLength(false)
+  ColumnType()
+   : fCharset(NULL), fCollate(NULL), fCharsetNum(0), fExplicitLength(false), fSortKey(0), fIndexType(0)
   {
   }
 
@@ -986,6 +987,12 @@ struct ColumnType
 
   /** @brief Is the TEXT column has explicit defined length, ie TEXT(1717) */
   bool fExplicitLength;
+
+  /** @brief 1-based position of the column in the sort key of the table, 0 if not in it */
+  uint32_t fSortKey;
+
+  /** @brief Secondary indexes of the column, CalpontSystemCatalog::ColumnIndexType bits */
+  uint32_t fIndexType;
 };
 
 /** @brief A column constraint definition.
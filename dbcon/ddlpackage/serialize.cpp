@@ -1125,6 +1125,8 @@ int ColumnType::unserialize(ByteStream& bytestream)
   std::string autoincrement;
   messageqcpp::ByteStream::octbyte nextVal;
   messageqcpp::ByteStream::quadbyte charsetNum;
+  messageqcpp::ByteStream::quadbyte sortKey;
+  messageqcpp::ByteStream::quadbyte indexType;
 
   // read column types
   bytestream >> ftype;
@@ -1136,6 +1138,8 @@ int ColumnType::unserialize(ByteStream& bytestream)
   bytestream >> autoincrement;
   bytestream >> nextVal;
   bytestream >> charsetNum;
+  bytestream >> sortKey;
+  bytestream >> indexType;
 
   fType = ftype;
   fLength = length;
@@ -1146,6 +1150,8 @@ int ColumnType::unserialize(ByteStream& bytestream)
   fAutoincrement = autoincrement;
   fNextvalue = nextVal;
   fCharsetNum = charsetNum;
+  fSortKey = sortKey;
+  fIndexType = indexType;
 
   //	cout << "BS length = " << bytestream.length() << endl;
 
@@ -1166,6 +1172,8 @@ int ColumnType::serialize(ByteStream& bytestream)
   std::string autoincrement = fAutoincrement;
   messageqcpp::ByteStream::octbyte nextVal = fNextvalue;
   messageqcpp::ByteStream::quadbyte charsetNum = fCharsetNum;
+  messageqcpp::ByteStream::quadbyte sortKey = fSortKey;
+  messageqcpp::ByteStream::quadbyte indexType = fIndexType;
 
   // write column types
   bytestream << ftype;
@@ -1177,6 +1185,8 @@ int ColumnType::serialize(ByteStream& bytestream)
   bytestream << autoincrement;
   bytestream << nextVal;
   bytestream << charsetNum;
+  bytestream << sortKey;
+  bytestream << indexType;
 
   //	cout << "BS length = " << bytestream.length() << endl;
 
@@ -39,6 +39,7 @@ using namespace oam;
 using namespace messageqcpp;
 
 #include "calpontsystemcatalog.h"
+#include "aggregateprojection.h"
 using namespace execplan;
 
 #include "sqllogger.h"
@@ -756,6 +757,7 @@ CreateTableProcessor::DDLResult CreateTableProcessor::processPackageInternal(
       fSessionManager.committed(txnID);
       fWEClient->removeQueue(uniqueId);
       deleteLogFile(DROPTABLE_LOG, fStartingColOID, uniqueId);
+      AggregateProjection::created(systemCatalogPtr.get(), tableName, fStartingColOID);
     }
 
     // Log the DDL statement.
@@ -28,6 +28,7 @@
 #include "cacheutils.h"
 #include "oamcache.h"
 #include "logicalpartition.h"
+#include "aggregateprojection.h"
 
 using namespace std;
 using namespace execplan;
@@ -142,6 +143,9 @@ DropPartitionProcessor::DDLResult DropPartitionProcessor::processPackageInternal
       throw std::runtime_error("Drop partition cannot be operated on Calpont system catalog.");
     }
 
+    // it changes the rows of the table without its aggregate projections
+    AggregateProjection::markStale(tableName, roPair.objnum);
+
     int i = 0;
     processID = ::getpid();
     oam::OamCache* oamcache = OamCache::makeOamCache();
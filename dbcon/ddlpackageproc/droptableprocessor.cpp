@@ -43,6 +43,7 @@ using namespace messageqcpp;
 using namespace logging;
 
 #include "calpontsystemcatalog.h"
+#include "aggregateprojection.h"
 using namespace execplan;
 
 #include "oamcache.h"
@@ -758,6 +759,16 @@ DropTableProcessor::DDLResult DropTableProcessor::processPackageInternal(ddlpack
   // Remove the log file
   fWEClient->removeQueue(uniqueId);
   deleteLogFile(DROPTABLE_LOG, roPair.objnum, uniqueId);
+
+  // the OID can be given to a new table
+  try
+  {
+    AggregateProjection::clearStale(roPair.objnum);
+  }
+  catch (std::exception&)
+  {
+  }
+
   // release the transaction
   // fSessionManager.committed(txnID);
   returnOIDs(tableColRidList, dictOIDList);
@@ -972,6 +983,9 @@ TruncTableProcessor::DDLResult TruncTableProcessor::processPackageInternal(ddlpa
 
     // Check whether the table has autoincrement column
     tableInfo = systemCatalogPtr->tableInfo(userTableName);
+
+    // it empties the table, not its aggregate projections
+    AggregateProjection::markStale(userTableName, roPair.objnum);
   }
   catch (std::exception& ex)
   {
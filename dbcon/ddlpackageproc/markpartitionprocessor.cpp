@@ -25,6 +25,7 @@
 #include "messagelog.h"
 #include "sqllogger.h"
 #include "oamcache.h"
+#include "aggregateprojection.h"
 
 using namespace std;
 using namespace execplan;
@@ -108,6 +109,9 @@ MarkPartitionProcessor::DDLResult MarkPartitionProcessor::processPackageInternal
       throw std::runtime_error("Mark partition cannot be operated on Calpont system catalog.");
     }
 
+    // it changes the rows of the table without its aggregate projections
+    AggregateProjection::markStale(tableName, roPair.objnum);
+
     int i = 0;
     processID = ::getpid();
     oam::OamCache* oamcache = OamCache::makeOamCache();
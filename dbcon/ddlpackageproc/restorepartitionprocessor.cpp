@@ -26,6 +26,7 @@
 #include "messagelog.h"
 #include "sqllogger.h"
 #include "oamcache.h"
+#include "aggregateprojection.h"
 
 using namespace std;
 using namespace execplan;
@@ -109,6 +110,9 @@ RestorePartitionProcessor::DDLResult RestorePartitionProcessor::processPackageIn
       throw std::runtime_error("Drop partition cannot be operated on Calpont system catalog.");
     }
 
+    // it changes the rows of the table without its aggregate projections
+    AggregateProjection::markStale(tableName, roPair.objnum);
+
     int i = 0;
     processID = ::getpid();
     oam::OamCache* oamcache = oam::OamCache::makeOamCache();
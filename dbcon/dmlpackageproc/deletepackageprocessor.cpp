@@ -43,6 +43,7 @@ using namespace std;
 #include "we_messages.h"
 #include "oamcache.h"
 #include "tablelockdata.h"
+#include "aggregateprojection.h"
 #include "bytestream.h"
 
 using namespace WriteEngine;
@@ -209,6 +210,10 @@ DMLPackageProcessor::DMLResult DeletePackageProcessor::processPackageInternal(
 
       // cout << " tablelock is obtained with id " << tableLockId << endl;
       tablelockData->setTablelock(roPair.objnum, tableLockId);
+
+      // the write doesn't maintain the aggregate projections of the table
+      AggregateProjection::markStale(aTableName, roPair.objnum);
+
       //@Bug 4491 start AI sequence for autoincrement column
       const CalpontSystemCatalog::RIDList ridList = csc->columnRIDs(aTableName);
       CalpontSystemCatalog::RIDList::const_iterator rid_iterator = ridList.begin();
@@ -37,6 +37,7 @@
 #include <boost/thread.hpp>
 #include "we_messages.h"
 #include "tablelockdata.h"
+#include "aggregateprojection.h"
 
 using namespace boost::algorithm;
 using namespace std;
@@ -220,6 +221,9 @@ DMLPackageProcessor::DMLResult InsertPackageProcessor::processPackageInternal(
       // cout << " tablelock is obtained with id " << tableLockId << endl;
       tablelockData->setTablelock(roPair.objnum, tableLockId);
 
+      // the write doesn't maintain the aggregate projections of the table
+      AggregateProjection::markStale(tableName, roPair.objnum);
+
       int pmNum = 0;
 
       // Select PM to receive the row.
@@ -45,6 +45,7 @@ using namespace std;
 #include "we_messages.h"
 #include "tablelockdata.h"
 #include "oamcache.h"
+#include "aggregateprojection.h"
 
 using namespace WriteEngine;
 using namespace dmlpackage;
@@ -236,6 +237,10 @@ DMLPackageProcessor::DMLResult UpdatePackageProcessor::processPackageInternal(
 
       // cout << " tablelock is obtained with id " << tableLockId << endl;
       tablelockData->setTablelock(roPair.objnum, tableLockId);
+
+      // the write doesn't maintain the aggregate projections of the table
+      AggregateProjection::markStale(tableName, roPair.objnum);
+
       //@Bug 4491 start AI sequence for autoincrement column
       const CalpontSystemCatalog::RIDList ridList = systemCatalogPtr->columnRIDs(tableName);
       CalpontSystemCatalog::RIDList::const_iterator rid_iterator = ridList.begin();
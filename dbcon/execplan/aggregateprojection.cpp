@@ -0,0 +1,691 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "aggregateprojection.h"
+#include "calpontselectexecutionplan.h"
+#include "aggregatecolumn.h"
+#include "arithmeticcolumn.h"
+#include "constantcolumn.h"
+#include "constantfilter.h"
+#include "functioncolumn.h"
+#include "operator.h"
+#include "pseudocolumn.h"
+#include "simplecolumn.h"
+#include "simplefilter.h"
+#include "mcs_datatype.h"
+#include "configcpp.h"
+#include "dbrm.h"
+#include "IDBDataFile.h"
+#include "IDBPolicy.h"
+
+using namespace std;
+using namespace boost::algorithm;
+using namespace idbdatafile;
+
+namespace
+{
+using namespace execplan;
+
+bool sameType(const CalpontSystemCatalog::ColType& a, const CalpontSystemCatalog::ColType& b)
+{
+  return a.colDataType == b.colDataType && a.colWidth == b.colWidth && a.scale == b.scale &&
+         a.precision == b.precision;
+}
+
+bool isFloat(CalpontSystemCatalog::ColDataType type)
+{
+  return type == CalpontSystemCatalog::FLOAT || type == CalpontSystemCatalog::UFLOAT ||
+         type == CalpontSystemCatalog::DOUBLE || type == CalpontSystemCatalog::UDOUBLE;
+}
+
+// the type a sum_<column> column can have for a base column of type base
+bool isSumType(const CalpontSystemCatalog::ColType& sum, const CalpontSystemCatalog::ColType& base)
+{
+  if (isFloat(base.colDataType))
+    return sum.colDataType == CalpontSystemCatalog::DOUBLE;
+
+  return (datatypes::isInteger(sum.colDataType) || datatypes::isDecimal(sum.colDataType)) &&
+         sum.scale == base.scale;
+}
+
+// the tables named like projections of base
+vector<pair<CalpontSystemCatalog::OID, CalpontSystemCatalog::TableName>> projectionTables(
+    CalpontSystemCatalog* csc, const CalpontSystemCatalog::TableName& base)
+{
+  vector<pair<CalpontSystemCatalog::OID, CalpontSystemCatalog::TableName>> tables;
+  string prefix = to_lower_copy(base.table) + AggregateProjection::NAME_INFIX;
+
+  for (const auto& table : csc->getTables(base.schema))
+  {
+    if (table.second.table.size() > prefix.size() && istarts_with(table.second.table, prefix))
+      tables.push_back(table);
+  }
+
+  return tables;
+}
+
+// the file that marks the projections of tableOid stale, next to the DBRM files
+string staleFileName(CalpontSystemCatalog::OID tableOid)
+{
+  string prefix = config::Config::makeConfig()->getConfig("SystemConfig", "DBRMRoot");
+  string::size_type pos = prefix.find_last_of('/');
+
+  if (pos == string::npos)
+    throw runtime_error("Need a valid DBRMRoot entry in Columnstore configuration file");
+
+  ostringstream oss;
+  oss << prefix.substr(0, pos + 1) << "AGGREGATE_PROJECTION_Stale_" << tableOid;
+  return oss.str();
+}
+
+// the state of checking, then rewriting, a query against one projection
+struct Rewrite
+{
+  Rewrite(const AggregateProjection& p, const string& a, const string& na, const string& v)
+   : proj(p)
+   , alias(a)
+   , newAlias(na)
+   , view(v)
+   , apply(false)
+   , ok(true)
+   , hasAggregate(false)
+   , hasCount(false)
+  {
+  }
+
+  const AggregateProjection& proj;
+  string alias;     // of the base table in the query
+  string newAlias;  // of the projection
+  string view;
+  bool apply;  // false to only check
+  bool ok;
+  bool hasAggregate;
+  bool hasCount;
+  set<TreeNode*> done;
+  vector<SimpleColumn*> columns;  // after the rewrite, for the column map
+};
+
+void rewriteTree(ParseTree* tree, Rewrite& rw);
+
+// points sc at column of the projection
+void retarget(SimpleColumn* sc, const AggregateProjection::Column& column, Rewrite& rw)
+{
+  if (sc->tableAlias() == rw.alias)
+    sc->tableAlias(rw.newAlias);
+
+  sc->tableName(rw.proj.table.table);
+  sc->columnName(column.name);
+  sc->oid(column.oid);
+  sc->resultType(column.colType);
+  rw.columns.push_back(sc);
+}
+
+// the base column the single parameter of an aggregate is, or nullptr
+SimpleColumn* aggregateParm(AggregateColumn* ac)
+{
+  if (ac->aggParms().size() != 1)
+    return nullptr;
+
+  SimpleColumn* sc = dynamic_cast<SimpleColumn*>(ac->aggParms()[0].get());
+
+  if (sc == nullptr || dynamic_cast<PseudoColumn*>(sc) != nullptr)
+    return nullptr;
+
+  return sc;
+}
+
+void rewriteAggregate(AggregateColumn* ac, Rewrite& rw)
+{
+  const AggregateProjection::Column* column = nullptr;
+  SimpleColumn* sc = nullptr;
+  uint8_t newOp = ac->aggOp();
+
+  switch (ac->aggOp())
+  {
+    case AggregateColumn::COUNT_ASTERISK:
+      column = rw.proj.findColumn(AggregateProjection::COUNT_STAR, 0);
+      newOp = AggregateColumn::SUM;
+      rw.hasCount = true;
+      break;
+
+    case AggregateColumn::COUNT:
+      if ((sc = aggregateParm(ac)) != nullptr)
+        column = rw.proj.findColumn(AggregateProjection::COUNT, sc->oid());
+
+      newOp = AggregateColumn::SUM;
+      rw.hasCount = true;
+      break;
+
+    case AggregateColumn::SUM:
+      if ((sc = aggregateParm(ac)) != nullptr)
+        column = rw.proj.findColumn(AggregateProjection::SUM, sc->oid());
+
+      break;
+
+    case AggregateColumn::MIN:
+    case AggregateColumn::MAX:
+      if ((sc = aggregateParm(ac)) != nullptr)
+      {
+        column = rw.proj.findColumn(
+            ac->aggOp() == AggregateColumn::MIN ? AggregateProjection::MIN : AggregateProjection::MAX,
+            sc->oid());
+
+        // the minimum of a key is the minimum of the key in the projection
+        if (column == nullptr)
+          column = rw.proj.findColumn(AggregateProjection::GROUP_KEY, sc->oid());
+      }
+
+      break;
+
+    default: break;
+  }
+
+  if (column == nullptr)
+  {
+    rw.ok = false;
+    return;
+  }
+
+  rw.hasAggregate = true;
+
+  if (!rw.apply)
+    return;
+
+  ac->aggOp(newOp);
+
+  if (newOp == AggregateColumn::SUM)
+    ac->functionName("sum");
+
+  if (sc != nullptr)
+  {
+    retarget(sc, *column, rw);
+    sc->data(column->name);
+    return;
+  }
+
+  // count(*) counts a constant
+  SimpleColumn* countStar = new SimpleColumn();
+  countStar->schemaName(rw.proj.table.schema);
+  countStar->viewName(rw.view);
+  countStar->tableAlias(rw.alias);
+  countStar->sessionID(ac->sessionID());
+  countStar->data(column->name);
+  countStar->alias(column->name);
+  retarget(countStar, *column, rw);
+  ac->aggParms().assign(1, SRCP(countStar));
+}
+
+void rewriteColumn(ReturnedColumn* rc, Rewrite& rw)
+{
+  if (rc == nullptr || !rw.ok)
+    return;
+
+  if (rw.apply && !rw.done.insert(rc).second)
+    return;
+
+  AggregateColumn* ac;
+  ArithmeticColumn* arc;
+  FunctionColumn* fc;
+  SimpleColumn* sc;
+
+  if ((ac = dynamic_cast<AggregateColumn*>(rc)) != nullptr)
+  {
+    rewriteAggregate(ac, rw);
+  }
+  else if ((arc = dynamic_cast<ArithmeticColumn*>(rc)) != nullptr)
+  {
+    rewriteTree(arc->expression(), rw);
+  }
+  else if ((fc = dynamic_cast<FunctionColumn*>(rc)) != nullptr)
+  {
+    for (const auto& parm : fc->functionParms())
+      rewriteTree(parm.get(), rw);
+  }
+  else if ((sc = dynamic_cast<SimpleColumn*>(rc)) != nullptr && dynamic_cast<PseudoColumn*>(sc) == nullptr)
+  {
+    // outside of the aggregates only the keys are left
+    const AggregateProjection::Column* column =
+        rw.proj.findColumn(AggregateProjection::GROUP_KEY, sc->oid());
+
+    if (column == nullptr)
+      rw.ok = false;
+    else if (rw.apply)
+      retarget(sc, *column, rw);
+  }
+  else if (dynamic_cast<ConstantColumn*>(rc) == nullptr)
+  {
+    rw.ok = false;
+  }
+}
+
+void rewriteNode(ParseTree* n, void* obj)
+{
+  Rewrite* rw = reinterpret_cast<Rewrite*>(obj);
+  TreeNode* tn = n->data();
+  ReturnedColumn* rc;
+  SimpleFilter* sf;
+  ConstantFilter* cf;
+
+  if (!rw->ok || tn == nullptr)
+    return;
+
+  if ((rc = dynamic_cast<ReturnedColumn*>(tn)) != nullptr)
+  {
+    rewriteColumn(rc, *rw);
+  }
+  else if ((sf = dynamic_cast<SimpleFilter*>(tn)) != nullptr)
+  {
+    rewriteColumn(sf->lhs(), *rw);
+    rewriteColumn(sf->rhs(), *rw);
+  }
+  else if ((cf = dynamic_cast<ConstantFilter*>(tn)) != nullptr)
+  {
+    rewriteColumn(cf->col().get(), *rw);
+
+    for (const auto& filter : cf->filterList())
+    {
+      rewriteColumn(filter->lhs(), *rw);
+      rewriteColumn(filter->rhs(), *rw);
+    }
+  }
+  // subqueries and the rest
+  else if (dynamic_cast<Operator*>(tn) == nullptr)
+  {
+    rw->ok = false;
+  }
+}
+
+void rewriteTree(ParseTree* tree, Rewrite& rw)
+{
+  if (tree != nullptr)
+    tree->walk(rewriteNode, &rw);
+}
+
+void rewriteColumns(vector<SRCP>& columns, Rewrite& rw)
+{
+  for (auto& column : columns)
+    rewriteColumn(column.get(), rw);
+}
+
+bool rewrite(CalpontSelectExecutionPlan* csep, Rewrite& rw)
+{
+  rewriteColumns(csep->returnedCols(), rw);
+  rewriteColumns(csep->groupByCols(), rw);
+  rewriteColumns(csep->orderByCols(), rw);
+  rewriteTree(csep->filters(), rw);
+  rewriteTree(csep->having(), rw);
+
+  // without rows count(*) is 0 and the sum of count_star NULL, with a GROUP BY there are no groups
+  return rw.ok && rw.hasAggregate && (!rw.hasCount || !csep->groupByCols().empty());
+}
+
+bool rewritePlans(const CalpontSelectExecutionPlan::SelectList& plans, CalpontSystemCatalog* csc)
+{
+  bool changed = false;
+
+  for (const auto& plan : plans)
+  {
+    CalpontSelectExecutionPlan* csep = dynamic_cast<CalpontSelectExecutionPlan*>(plan.get());
+
+    if (csep != nullptr && useAggregateProjection(csep, csc))
+      changed = true;
+  }
+
+  return changed;
+}
+
+}  // namespace
+
+namespace execplan
+{
+const string AggregateProjection::NAME_INFIX = "__agg_";
+
+vector<AggregateProjection> AggregateProjection::find(CalpontSystemCatalog* csc,
+                                                      const CalpontSystemCatalog::TableName& base,
+                                                      vector<string>* errors)
+{
+  vector<AggregateProjection> projections;
+
+  for (const auto& table : projectionTables(csc, base))
+  {
+    const CalpontSystemCatalog::TableName& name = table.second;
+    AggregateProjection projection;
+    string error;
+
+    if (projection.init(csc, name, base, error))
+      projections.push_back(projection);
+    else if (errors != nullptr)
+      errors->push_back(name.toString() + ": " + error);
+  }
+
+  return projections;
+}
+
+bool AggregateProjection::init(CalpontSystemCatalog* csc, const CalpontSystemCatalog::TableName& t,
+                               const CalpontSystemCatalog::TableName& b, string& error)
+{
+  static const pair<string, Function> measures[] = {
+      {"count_", COUNT}, {"sum_", SUM}, {"min_", MIN}, {"max_", MAX}};
+  map<string, pair<CalpontSystemCatalog::OID, CalpontSystemCatalog::ColType>> baseColumns;
+  bool hasCountStar = false;
+
+  table = t;
+  base = b;
+  tableOid = csc->tableRID(table).objnum;
+  baseTableOid = csc->tableRID(base).objnum;
+  columns.clear();
+  keyCount = 0;
+
+  for (const auto& rid : csc->columnRIDs(base, true))
+  {
+    string name = to_lower_copy(csc->colName(rid.objnum).column);
+    baseColumns[name] = make_pair(rid.objnum, csc->colType(rid.objnum));
+  }
+
+  for (const auto& rid : csc->columnRIDs(table, true))
+  {
+    Column column;
+    column.oid = rid.objnum;
+    column.name = csc->colName(rid.objnum).column;
+    column.colType = csc->colType(rid.objnum);
+    column.baseOid = 0;
+
+    string name = to_lower_copy(column.name);
+    auto it = baseColumns.end();
+
+    if (name == "count_star")
+    {
+      column.function = COUNT_STAR;
+    }
+    else if ((it = baseColumns.find(name)) != baseColumns.end())
+    {
+      column.function = GROUP_KEY;
+    }
+    else
+    {
+      for (const auto& measure : measures)
+      {
+        if (starts_with(name, measure.first) &&
+            (it = baseColumns.find(name.substr(measure.first.size()))) != baseColumns.end())
+        {
+          column.function = measure.second;
+          break;
+        }
+      }
+
+      if (it == baseColumns.end())
+      {
+        error = "column " + column.name + " is neither a column of " + base.table +
+                " nor count_star, count_, sum_, min_, or max_ of one";
+        return false;
+      }
+    }
+
+    if (it != baseColumns.end())
+    {
+      column.baseOid = it->second.first;
+      column.baseName = it->first;
+    }
+
+    const CalpontSystemCatalog::ColType* baseType = column.baseOid ? &it->second.second : nullptr;
+    bool typeOk = true;
+
+    switch (column.function)
+    {
+      case GROUP_KEY: typeOk = sameType(column.colType, *baseType); break;
+
+      case COUNT_STAR:
+      case COUNT: typeOk = datatypes::isInteger(column.colType.colDataType); break;
+
+      case SUM:
+        typeOk = datatypes::isNumeric(baseType->colDataType) && isSumType(column.colType, *baseType);
+        break;
+
+      case MIN:
+      case MAX:
+        typeOk = datatypes::isNumeric(baseType->colDataType) && sameType(column.colType, *baseType);
+        break;
+    }
+
+    if (!typeOk)
+    {
+      error = "column " + column.name + " has the wrong type";
+      return false;
+    }
+
+    if (column.function == GROUP_KEY)
+      keyCount++;
+    else if (column.function == COUNT_STAR)
+      hasCountStar = true;
+
+    columns.push_back(column);
+  }
+
+  if (!hasCountStar)
+  {
+    error = "there's no count_star column";
+    return false;
+  }
+
+  return true;
+}
+
+const AggregateProjection::Column* AggregateProjection::findColumn(Function function,
+                                                                   CalpontSystemCatalog::OID baseOid) const
+{
+  for (const auto& column : columns)
+  {
+    if (column.function == function && column.baseOid == baseOid)
+      return &column;
+  }
+
+  return nullptr;
+}
+
+void AggregateProjection::markStale(const CalpontSystemCatalog::TableName& table,
+                                    CalpontSystemCatalog::OID tableOid)
+{
+  // a table named like a projection is taken for one, loading it is how it's built
+  if (to_lower_copy(table.table).find(NAME_INFIX) == string::npos)
+    markStale(tableOid);
+}
+
+void AggregateProjection::markStale(CalpontSystemCatalog::OID tableOid)
+{
+  string fileName = staleFileName(tableOid);
+
+  if (IDBPolicy::exists(fileName.c_str()))
+    return;
+
+  boost::scoped_ptr<IDBDataFile> file(IDBDataFile::open(
+      IDBPolicy::getType(fileName.c_str(), IDBPolicy::WRITEENG), fileName.c_str(), "w", 0));
+
+  if (!file)
+    throw runtime_error("Aggregate projection stale marker " + fileName + " can't be created");
+}
+
+bool AggregateProjection::isStale(CalpontSystemCatalog::OID tableOid)
+{
+  return IDBPolicy::exists(staleFileName(tableOid).c_str());
+}
+
+void AggregateProjection::clearStale(CalpontSystemCatalog::OID tableOid)
+{
+  string fileName = staleFileName(tableOid);
+
+  if (IDBPolicy::exists(fileName.c_str()) && IDBPolicy::remove(fileName.c_str()) != 0)
+    throw runtime_error("Aggregate projection stale marker " + fileName + " can't be removed");
+}
+
+void AggregateProjection::created(CalpontSystemCatalog* csc, const CalpontSystemCatalog::TableName& table,
+                                  CalpontSystemCatalog::OID tableOid)
+{
+  string::size_type pos = to_lower_copy(table.table).find(NAME_INFIX);
+
+  if (pos == 0 || pos == string::npos)
+    return;
+
+  // if anything fails the base table stays marked, which leaves the new projection unused
+  try
+  {
+    CalpontSystemCatalog::TableName b(table.schema, table.table.substr(0, pos));
+    CalpontSystemCatalog::OID baseOid = csc->tableRID(b).objnum;
+
+    // it's used once a load of it populates it
+    if (!isEmpty(csc, b))
+      markStale(tableOid);
+
+    if (!isStale(baseOid))
+      return;
+
+    for (const auto& projection : projectionTables(csc, b))
+    {
+      if (projection.first != tableOid)
+        markStale(projection.first);
+    }
+
+    clearStale(baseOid);
+  }
+  catch (exception&)
+  {
+  }
+}
+
+void AggregateProjection::loaded(const CalpontSystemCatalog::TableName& table,
+                                 CalpontSystemCatalog::OID tableOid)
+{
+  string::size_type pos = to_lower_copy(table.table).find(NAME_INFIX);
+
+  if (pos != 0 && pos != string::npos)
+    clearStale(tableOid);
+}
+
+// A table none of whose extents has been written to, judging by a column of it.  Extents are
+// created unavailable and become available with the HWM of the first write that commits.  If it
+// can't be told, the table isn't empty.
+bool AggregateProjection::isEmpty(CalpontSystemCatalog* csc, const CalpontSystemCatalog::TableName& table)
+{
+  vector<BRM::EMEntry> extents;
+
+  try
+  {
+    CalpontSystemCatalog::RIDList rids = csc->columnRIDs(table, true);
+    BRM::DBRM dbrm;
+
+    if (rids.empty() || dbrm.getExtents(rids[0].objnum, extents, false, false, true) != 0)
+      return false;
+  }
+  catch (exception&)
+  {
+    return false;
+  }
+
+  for (const auto& extent : extents)
+  {
+    if (extent.status != BRM::EXTENTUNAVAILABLE)
+      return false;
+  }
+
+  return true;
+}
+
+bool useAggregateProjection(CalpontSelectExecutionPlan* csep, CalpontSystemCatalog* csc)
+{
+  bool changed = rewritePlans(csep->derivedTableList(), csc);
+  changed = rewritePlans(csep->unionVec(), csc) || changed;
+
+  if (csep->tableList().size() != 1 || !csep->subSelects().empty() || !csep->selectSubList().empty() ||
+      csep->withRollup())
+    return changed;
+
+  CalpontSystemCatalog::TableAliasName tan = csep->tableList()[0];
+
+  if (tan.schema.empty() || !tan.fisColumnStore || tan.schema == CALPONT_SCHEMA)
+    return changed;
+
+  // only look the projections up for a query that aggregates
+  bool hasAggregate = false;
+
+  for (const auto& column : csep->returnedCols())
+    hasAggregate = hasAggregate || column->hasAggregate();
+
+  if (!hasAggregate)
+    return changed;
+
+  vector<AggregateProjection> projections;
+
+  try
+  {
+    projections = AggregateProjection::find(csc, CalpontSystemCatalog::TableName(tan));
+
+    if (!projections.empty() && AggregateProjection::isStale(projections[0].baseTableOid))
+      return changed;
+
+    for (auto it = projections.begin(); it != projections.end();)
+      it = AggregateProjection::isStale(it->tableOid) ? projections.erase(it) : it + 1;
+  }
+  catch (exception&)
+  {
+    // the catalog or the markers couldn't be read, the query reads the table
+    return changed;
+  }
+
+  string newAlias = tan.alias;
+  const AggregateProjection* best = nullptr;
+
+  for (const auto& projection : projections)
+  {
+    Rewrite check(projection, tan.alias, newAlias, tan.view);
+
+    if (rewrite(csep, check) && (best == nullptr || projection.keyCount < best->keyCount))
+      best = &projection;
+  }
+
+  if (best == nullptr)
+    return changed;
+
+  // an alias that's just the table name goes with the table
+  if (tan.alias.empty() || iequals(tan.alias, tan.table))
+    newAlias = best->table.table;
+
+  Rewrite rw(*best, tan.alias, newAlias, tan.view);
+  rw.apply = true;
+  rewrite(csep, rw);
+
+  CalpontSelectExecutionPlan::TableList tableList(1, tan);
+  tableList[0].table = best->table.table;
+  tableList[0].alias = newAlias;
+  csep->tableList(tableList);
+
+  CalpontSelectExecutionPlan::ColumnMap columnMap;
+
+  for (SimpleColumn* sc : rw.columns)
+    columnMap.insert(CalpontSelectExecutionPlan::ColumnMap::value_type(sc->columnName(), SRCP(sc->clone())));
+
+  csep->columnMapNonStatic(columnMap);
+  return true;
+}
+
+}  // namespace execplan
@@ -0,0 +1,148 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "calpontsystemcatalog.h"
+
+namespace execplan
+{
+class CalpontSelectExecutionPlan;
+
+/** @brief An aggregate projection is a table of partial aggregates of another table
+ *
+ * It's an ordinary ColumnStore table, in the schema of the table it aggregates (the base table),
+ * named <base table>__agg_<anything>.  Its columns say what it holds:
+ *   <column>          a GROUP BY key, a column of the base table with the same type
+ *   count_star        the number of rows in the group; every projection has it
+ *   count_<column>    the number of non-NULL values of a base column in the group
+ *   sum_<column>      the sum of a numeric base column
+ *   min_<column>      the minimum of a numeric base column, with its type
+ *   max_<column>      the maximum of a numeric base column, with its type
+ *
+ * cpimport appends the aggregates of every load of the base table, so a group can have more
+ * than one row.  Queries have to aggregate the projection again, see useAggregateProjection().
+ *
+ * Nothing else maintains it.  A write of the base table that doesn't, like DML, a binary import, or
+ * a load of the projection that failed, marks it stale first, and queries don't use a stale
+ * projection.  The marker of a base table stands for all of its projections, for the writers that
+ * don't look them up.  Creating a projection turns it into the markers of the other projections
+ * there are.
+ *
+ * A new projection is stale too, unless its base table is empty.  It's populated from the base
+ * table with a cpimport load of it, which LOAD DATA and INSERT ... SELECT use by default, and the
+ * commit of that load clears its marker.  cpimport doesn't append to a stale projection, so a
+ * stale one is rebuilt by truncating it, or creating it again, and loading it.
+ * The markers are files in the DBRM directory, so every node sees the same ones.
+ */
+class AggregateProjection
+{
+ public:
+  enum Function
+  {
+    GROUP_KEY,
+    COUNT_STAR,
+    COUNT,
+    SUM,
+    MIN,
+    MAX
+  };
+
+  struct Column
+  {
+    CalpontSystemCatalog::OID oid;
+    std::string name;
+    CalpontSystemCatalog::ColType colType;
+    Function function;
+    CalpontSystemCatalog::OID baseOid;  // 0 for COUNT_STAR
+    std::string baseName;
+  };
+
+  static const std::string NAME_INFIX;  // "__agg_"
+
+  /** @brief Returns the projections of base.
+   *
+   * Tables named like projections of base whose columns break the rules above are left out, and
+   * why is added to errors if it's given.
+   */
+  static std::vector<AggregateProjection> find(CalpontSystemCatalog* csc,
+                                               const CalpontSystemCatalog::TableName& base,
+                                               std::vector<std::string>* errors = nullptr);
+
+  /** @brief Reads the definition of the projection table from the catalog.  Returns false and
+   * why if it's not a valid projection of base.
+   */
+  bool init(CalpontSystemCatalog* csc, const CalpontSystemCatalog::TableName& table,
+            const CalpontSystemCatalog::TableName& base, std::string& error);
+
+  // returns nullptr if the projection has no such column
+  const Column* findColumn(Function function, CalpontSystemCatalog::OID baseOid) const;
+
+  // if it or its base table is marked stale
+  bool isStale() const
+  {
+    return isStale(tableOid) || isStale(baseTableOid);
+  }
+
+  /** @brief Marks the projections of a table stale before a write that doesn't maintain them.
+   *
+   * A write of a projection itself marks nothing.  Throws if the marker can't be written.
+   */
+  static void markStale(const CalpontSystemCatalog::TableName& table, CalpontSystemCatalog::OID tableOid);
+
+  // the marker of a projection, or of all the projections of a base table
+  static void markStale(CalpontSystemCatalog::OID tableOid);
+  static bool isStale(CalpontSystemCatalog::OID tableOid);
+  static void clearStale(CalpontSystemCatalog::OID tableOid);
+
+  /** @brief Called once table is created.  If it's a projection, it's marked stale unless its base
+   * table is empty.  If the base table is marked stale, the other projections of the base table
+   * are marked instead, so the new one can be used once it's loaded.
+   */
+  static void created(CalpontSystemCatalog* csc, const CalpontSystemCatalog::TableName& table,
+                      CalpontSystemCatalog::OID tableOid);
+
+  /** @brief Called once a cpimport load of table is committed.  If it's a projection, it's been
+   * populated from its base table and its marker is cleared.  Throws if the marker can't be removed.
+   */
+  static void loaded(const CalpontSystemCatalog::TableName& table, CalpontSystemCatalog::OID tableOid);
+
+  CalpontSystemCatalog::TableName table;
+  CalpontSystemCatalog::TableName base;
+  CalpontSystemCatalog::OID tableOid = 0;
+  CalpontSystemCatalog::OID baseTableOid = 0;
+  std::vector<Column> columns;  // in the order of the table
+  uint32_t keyCount = 0;
+
+ private:
+  static bool isEmpty(CalpontSystemCatalog* csc, const CalpontSystemCatalog::TableName& table);
+};
+
+/** @brief Makes csep read an aggregate projection of its table instead of the table.
+ *
+ * Applies to a query of a single ColumnStore table that aggregates it with COUNT, SUM, MIN, and
+ * MAX, and otherwise only refers to columns that a projection has as keys.  COUNT becomes a SUM
+ * of the counts, SUM a SUM of the sums, MIN and MAX stay as they are.  Of the projections that
+ * can answer the query, the one with the fewest keys is used; stale ones aren't.  FROM subqueries
+ * and UNION members are handled the same way.  Returns true if anything was changed.
+ */
+bool useAggregateProjection(CalpontSelectExecutionPlan* csep, CalpontSystemCatalog* csc);
+
+}  // namespace execplan
@@ -510,6 +510,16 @@ class CalpontSelectExecutionPlan : public CalpontExecutionPlan
     return fOverrideLargeSideEstimate;
   }
 
+  // The server found nothing in the query that makes its result vary between runs over the same data
+  void resultCacheable(const bool cacheable)
+  {
+    fResultCacheable = cacheable;
+  }
+  bool resultCacheable() const
+  {
+    return fResultCacheable;
+  }
+
   void unionVec(const SelectList& unionVec)
   {
     fUnionVec = unionVec;
@@ -973,6 +983,10 @@ class CalpontSelectExecutionPlan : public CalpontExecutionPlan
    * A flag to compute subtotals, related to GROUP BY operation.
    */
   bool fWithRollup;
+  /**
+   * A flag to allow ExeMgr to keep the result for the next run of the query.
+   */
+  bool fResultCacheable = false;
 };
 
 /**
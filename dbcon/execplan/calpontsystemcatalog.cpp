@@ -554,8 +554,10 @@ CalpontSystemCatalog::OID CalpontSystemCatalog::lookupOID(const TableColName& ta
   string nextVal = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + NEXTVALUE_COL;
   string nullable = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + NULLABLE_COL;
   string charsetnum = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + CHARSETNUM_COL;
+  string sortkey = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + SORTKEY_COL;
+  string indextype = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + INDEXTYPE_COL;
 
-  SimpleColumn* col[18];
+  SimpleColumn* col[20];
   col[0] = new SimpleColumn(columnlength, fSessionID);
   col[1] = new SimpleColumn(objectid, fSessionID);
   col[2] = new SimpleColumn(datatype, fSessionID);
@@ -574,6 +576,8 @@ CalpontSystemCatalog::OID CalpontSystemCatalog::lookupOID(const TableColName& ta
   col[15] = new SimpleColumn(nextVal, fSessionID);
   col[16] = new SimpleColumn(nullable, fSessionID);
   col[17] = new SimpleColumn(charsetnum, fSessionID);
+  col[18] = new SimpleColumn(sortkey, fSessionID);
+  col[19] = new SimpleColumn(indextype, fSessionID);
 
   SRCP srcp;
   srcp.reset(col[0]);
@@ -613,13 +617,17 @@ CalpontSystemCatalog::OID CalpontSystemCatalog::lookupOID(const TableColName& ta
   colMap.insert(CMVT_(nullable, srcp));
   srcp.reset(col[17]);
   colMap.insert(CMVT_(charsetnum, srcp));
+  srcp.reset(col[18]);
+  colMap.insert(CMVT_(sortkey, srcp));
+  srcp.reset(col[19]);
+  colMap.insert(CMVT_(indextype, srcp));
   csep.columnMapNonStatic(colMap);
 
   // ignore returnedcolumn, because it's not read by Joblist for now
   csep.returnedCols(returnedColumnList);
-  OID oid[18];
+  OID oid[20];
 
-  for (int i = 0; i < 18; i++)
+  for (int i = 0; i < 20; i++)
     oid[i] = col[i]->oid();
 
   // Filters
@@ -715,6 +723,10 @@ CalpontSystemCatalog::OID CalpontSystemCatalog::lookupOID(const TableColName& ta
     }
     else if ((*it)->ColumnOID() == oid[17])
       ct.charsetNumber = ((*it)->GetData(0));
+    else if ((*it)->ColumnOID() == oid[18])
+      ct.sortKeyPosition = ((*it)->GetData(0));
+    else if ((*it)->ColumnOID() == oid[19])
+      ct.indexType = ((*it)->GetData(0));
     else if ((*it)->ColumnOID() == DICTOID_SYSCOLUMN_DEFAULTVAL)
     {
       ct.defaultValue = ((*it)->GetStringData(0));
@@ -1084,8 +1096,10 @@ const CalpontSystemCatalog::ColType CalpontSystemCatalog::colType(const OID& Oid
   string autoincrement = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + AUTOINC_COL;
   string nextvalue = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + NEXTVALUE_COL;
   string charsetnum = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + CHARSETNUM_COL;
+  string sortkey = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + SORTKEY_COL;
+  string indextype = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + INDEXTYPE_COL;
 
-  SimpleColumn* col[18];
+  SimpleColumn* col[20];
   col[0] = new SimpleColumn(columnlength, fSessionID);
   col[1] = new SimpleColumn(objectid, fSessionID);
   col[2] = new SimpleColumn(datatype, fSessionID);
@@ -1104,6 +1118,8 @@ const CalpontSystemCatalog::ColType CalpontSystemCatalog::colType(const OID& Oid
   col[15] = new SimpleColumn(autoincrement, fSessionID);
   col[16] = new SimpleColumn(nextvalue, fSessionID);
   col[17] = new SimpleColumn(charsetnum, fSessionID);
+  col[18] = new SimpleColumn(sortkey, fSessionID);
+  col[19] = new SimpleColumn(indextype, fSessionID);
 
   SRCP srcp;
   srcp.reset(col[0]);
@@ -1144,14 +1160,18 @@ const CalpontSystemCatalog::ColType CalpontSystemCatalog::colType(const OID& Oid
   colMap.insert(CMVT_(nextvalue, srcp));
   srcp.reset(col[17]);
   colMap.insert(CMVT_(charsetnum, srcp));
+  srcp.reset(col[18]);
+  colMap.insert(CMVT_(sortkey, srcp));
+  srcp.reset(col[19]);
+  colMap.insert(CMVT_(indextype, srcp));
 
   csep.columnMapNonStatic(colMap);
 
   // ignore returnedcolumn, because it's not read by Joblist for now
   csep.returnedCols(returnedColumnList);
-  OID oid[18];
+  OID oid[20];
 
-  for (int i = 0; i < 18; i++)
+  for (int i = 0; i < 20; i++)
     oid[i] = col[i]->oid();
 
   // Filters
@@ -1243,6 +1263,10 @@ const CalpontSystemCatalog::ColType CalpontSystemCatalog::colType(const OID& Oid
       ct.nextvalue = ((*it)->GetData(0));
     else if ((*it)->ColumnOID() == oid[17])
       ct.charsetNumber = ((*it)->GetData(0));
+    else if ((*it)->ColumnOID() == oid[18])
+      ct.sortKeyPosition = ((*it)->GetData(0));
+    else if ((*it)->ColumnOID() == oid[19])
+      ct.indexType = ((*it)->GetData(0));
 
     ct.columnOID = Oid;
   }
@@ -3068,8 +3092,10 @@ const CalpontSystemCatalog::RIDList CalpontSystemCatalog::columnRIDs(const Table
   string autoIncrement = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + AUTOINC_COL;
   string nextVal = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + NEXTVALUE_COL;
   string charsetnum = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + CHARSETNUM_COL;
+  string sortkey = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + SORTKEY_COL;
+  string indextype = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + INDEXTYPE_COL;
 
-  SimpleColumn* col[18];
+  SimpleColumn* col[20];
   col[0] = new SimpleColumn(columnlength, fSessionID);
   col[1] = new SimpleColumn(objectid, fSessionID);
   col[2] = new SimpleColumn(datatype, fSessionID);
@@ -3088,6 +3114,8 @@ const CalpontSystemCatalog::RIDList CalpontSystemCatalog::columnRIDs(const Table
   col[15] = new SimpleColumn(autoIncrement, fSessionID);
   col[16] = new SimpleColumn(nextVal, fSessionID);
   col[17] = new SimpleColumn(charsetnum, fSessionID);
+  col[18] = new SimpleColumn(sortkey, fSessionID);
+  col[19] = new SimpleColumn(indextype, fSessionID);
 
   SRCP srcp;
   srcp.reset(col[0]);
@@ -3127,15 +3155,19 @@ const CalpontSystemCatalog::RIDList CalpontSystemCatalog::columnRIDs(const Table
   colMap.insert(CMVT_(nextVal, srcp));
   srcp.reset(col[17]);
   colMap.insert(CMVT_(charsetnum, srcp));
+  srcp.reset(col[18]);
+  colMap.insert(CMVT_(sortkey, srcp));
+  srcp.reset(col[19]);
+  colMap.insert(CMVT_(indextype, srcp));
   csep.columnMapNonStatic(colMap);
 
   srcp.reset(col[1]->clone());
   returnedColumnList.push_back(srcp);
   csep.returnedCols(returnedColumnList);
 
-  OID oid[18];
+  OID oid[20];
 
-  for (int i = 0; i < 18; i++)
+  for (int i = 0; i < 20; i++)
     oid[i] = col[i]->oid();
 
   oid[12] = DICTOID_SYSCOLUMN_COLNAME;
@@ -3324,6 +3356,16 @@ const CalpontSystemCatalog::RIDList CalpontSystemCatalog::columnRIDs(const Table
       for (int i = 0; i < (*it)->dataCount(); i++)
         ctList[i].charsetNumber = ((*it)->GetData(i));
     }
+    else if ((*it)->ColumnOID() == oid[18])
+    {
+      for (int i = 0; i < (*it)->dataCount(); i++)
+        ctList[i].sortKeyPosition = ((*it)->GetData(i));
+    }
+    else if ((*it)->ColumnOID() == oid[19])
+    {
+      for (int i = 0; i < (*it)->dataCount(); i++)
+        ctList[i].indexType = ((*it)->GetData(i));
+    }
   }
 
   // MCOL-895 sort ctList, we can't specify an ORDER BY to do this yet
@@ -5568,8 +5610,10 @@ void CalpontSystemCatalog::getSchemaInfo(const string& in_schema, int lower_case
   string autoinc = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + AUTOINC_COL;
   string nextval = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + NEXTVALUE_COL;
   string charsetnum = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + CHARSETNUM_COL;
+  string sortkey = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + SORTKEY_COL;
+  string indextype = CALPONT_SCHEMA + "." + SYSCOLUMN_TABLE + "." + INDEXTYPE_COL;
 
-  SimpleColumn* col[18];
+  SimpleColumn* col[20];
   col[0] = new SimpleColumn(columnlength, fSessionID);
   col[1] = new SimpleColumn(objectid, fSessionID);
   col[2] = new SimpleColumn(datatype, fSessionID);
@@ -5588,6 +5632,8 @@ void CalpontSystemCatalog::getSchemaInfo(const string& in_schema, int lower_case
   col[15] = new SimpleColumn(autoinc, fSessionID);
   col[16] = new SimpleColumn(nextval, fSessionID);
   col[17] = new SimpleColumn(charsetnum, fSessionID);
+  col[18] = new SimpleColumn(sortkey, fSessionID);
+  col[19] = new SimpleColumn(indextype, fSessionID);
 
   SRCP srcp;
   srcp.reset(col[0]);
@@ -5628,15 +5674,19 @@ void CalpontSystemCatalog::getSchemaInfo(const string& in_schema, int lower_case
   colMap.insert(CMVT_(nextval, srcp));
   srcp.reset(col[17]);
   colMap.insert(CMVT_(charsetnum, srcp));
+  srcp.reset(col[18]);
+  colMap.insert(CMVT_(sortkey, srcp));
+  srcp.reset(col[19]);
+  colMap.insert(CMVT_(indextype, srcp));
   csep.columnMapNonStatic(colMap);
 
   srcp.reset(col[1]->clone());
   returnedColumnList.push_back(srcp);
   csep.returnedCols(returnedColumnList);
 
-  OID oid[18];
+  OID oid[20];
 
-  for (int i = 0; i < 18; i++)
+  for (int i = 0; i < 20; i++)
     oid[i] = col[i]->oid();
 
   oid[12] = DICTOID_SYSCOLUMN_COLNAME;
@@ -5835,6 +5885,16 @@ void CalpontSystemCatalog::getSchemaInfo(const string& in_schema, int lower_case
       for (int i = 0; i < (*it)->dataCount(); i++)
         ctList[i].charsetNumber = ((*it)->GetData(i));
     }
+    else if ((*it)->ColumnOID() == oid[18])
+    {
+      for (int i = 0; i < (*it)->dataCount(); i++)
+        ctList[i].sortKeyPosition = ((*it)->GetData(i));
+    }
+    else if ((*it)->ColumnOID() == oid[19])
+    {
+      for (int i = 0; i < (*it)->dataCount(); i++)
+        ctList[i].indexType = ((*it)->GetData(i));
+    }
   }
 
   // populate colinfo cache
@@ -6068,6 +6128,12 @@ void CalpontSystemCatalog::buildSysColinfomap()
 
   fColinfomap[OID_SYSCOLUMN_CHARSETNUM] = ColType(4, scale, precision, NOTNULL_CONSTRAINT,
     notDict, colPosition++, compressionType, OID_SYSCOLUMN_CHARSETNUM, INT);
+
+  fColinfomap[OID_SYSCOLUMN_SORTKEY] = ColType(4, scale, precision, NOTNULL_CONSTRAINT,
+    notDict, colPosition++, compressionType, OID_SYSCOLUMN_SORTKEY, INT);
+
+  fColinfomap[OID_SYSCOLUMN_INDEXTYPE] = ColType(4, scale, precision, NOTNULL_CONSTRAINT,
+    notDict, colPosition++, compressionType, OID_SYSCOLUMN_INDEXTYPE, INT);
 }
 
 void CalpontSystemCatalog::buildSysOIDmap()
@@ -6107,6 +6173,8 @@ void CalpontSystemCatalog::buildSysOIDmap()
   fOIDmap[make_tcn(CALPONT_SCHEMA, SYSCOLUMN_TABLE, COMPRESSIONTYPE_COL)] = OID_SYSCOLUMN_COMPRESSIONTYPE;
   fOIDmap[make_tcn(CALPONT_SCHEMA, SYSCOLUMN_TABLE, NEXTVALUE_COL)] = OID_SYSCOLUMN_NEXTVALUE;
   fOIDmap[make_tcn(CALPONT_SCHEMA, SYSCOLUMN_TABLE, CHARSETNUM_COL)] = OID_SYSCOLUMN_CHARSETNUM;
+  fOIDmap[make_tcn(CALPONT_SCHEMA, SYSCOLUMN_TABLE, SORTKEY_COL)] = OID_SYSCOLUMN_SORTKEY;
+  fOIDmap[make_tcn(CALPONT_SCHEMA, SYSCOLUMN_TABLE, INDEXTYPE_COL)] = OID_SYSCOLUMN_INDEXTYPE;
 }
 
 void CalpontSystemCatalog::buildSysTablemap()
@@ -6157,6 +6225,8 @@ CalpontSystemCatalog::ColType::ColType(const ColType& rhs) : TypeHolderStd(rhs)
   autoincrement = rhs.autoincrement;
   nextvalue = rhs.nextvalue;
   charsetNumber = rhs.charsetNumber;
+  sortKeyPosition = rhs.sortKeyPosition;
+  indexType = rhs.indexType;
   cs = rhs.cs;
 }
 
@@ -6187,6 +6257,8 @@ CalpontSystemCatalog::ColType& CalpontSystemCatalog::ColType::operator=(const Co
   autoincrement = rhs.autoincrement;
   nextvalue = rhs.nextvalue;
   charsetNumber = rhs.charsetNumber;
+  sortKeyPosition = rhs.sortKeyPosition;
+  indexType = rhs.indexType;
   cs = rhs.cs;
 
   return *this;
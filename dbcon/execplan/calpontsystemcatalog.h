@@ -114,6 +114,14 @@ class CalpontSystemCatalog : public datatypes::SystemCatalog
     COMPRESSION2
   };
 
+  /** the secondary indexes kept for a column, bits of SYSCOLUMN indextype */
+  enum ColumnIndexType
+  {
+    NO_COLUMN_INDEX = 0,
+    INVERTED_INDEX = 0x1,
+    BLOOM_FILTER = 0x2
+  };
+
   enum AutoincrColumn
   {
     NO_AUTOINCRCOL,
@@ -223,6 +231,8 @@ class CalpontSystemCatalog : public datatypes::SystemCatalog
     bool autoincrement = 0;  // set to true if  SYSCOLUMN autoincrement is �y�
     uint64_t nextvalue = 0;  // next autoincrement value
     uint32_t charsetNumber = default_charset_info->number;
+    int32_t sortKeyPosition = 0;  // 1-based position in the sort key of the table, 0 if not in it
+    int32_t indexType = NO_COLUMN_INDEX;  // ColumnIndexType bits
     const mutable CHARSET_INFO* cs = nullptr;
 
    private:
@@ -1218,6 +1228,8 @@ const std::string COMPRESSIONTYPE_COL = "compressiontype";
 const std::string NEXTVALUE_COL = "nextvalue";
 const std::string AUXCOLUMNOID_COL = "auxcolumnoid";
 const std::string CHARSETNUM_COL = "charsetnum";
+const std::string SORTKEY_COL = "sortkey";
+const std::string INDEXTYPE_COL = "indextype";
 
 /*****************************************************
  * System tables OID definition
@@ -1270,7 +1282,9 @@ const int OID_SYSCOLUMN_MAXVALUE = SYSCOLUMN_BASE + 20;        /** @brief max va
 const int OID_SYSCOLUMN_COMPRESSIONTYPE = SYSCOLUMN_BASE + 21; /** @brief compression type */
 const int OID_SYSCOLUMN_NEXTVALUE = SYSCOLUMN_BASE + 22;       /** @brief next value */
 const int OID_SYSCOLUMN_CHARSETNUM = SYSCOLUMN_BASE + 23; /** @brief character set number for the column */
-const int SYSCOLUMN_MAX = SYSCOLUMN_BASE + 24;            // be sure this is one more than the highest #
+const int OID_SYSCOLUMN_SORTKEY = SYSCOLUMN_BASE + 24;    /** @brief position in the table sort key */
+const int OID_SYSCOLUMN_INDEXTYPE = SYSCOLUMN_BASE + 25;  /** @brief secondary indexes of the column */
+const int SYSCOLUMN_MAX = SYSCOLUMN_BASE + 26;            // be sure this is one more than the highest #
 
 /*****************************************************
  * SYSTABLE columns dictionary OID definition
@@ -46,6 +46,8 @@ using namespace execplan;
 
 #include "bpp-jl.h"
 #include "jlf_common.h"
+#include "joinercacheregistry.h"
+#include "hasher.h"
 using namespace messageqcpp;
 using namespace rowgroup;
 using namespace joiner;
@@ -59,6 +61,7 @@ BatchPrimitiveProcessorJL::BatchPrimitiveProcessorJL(const ResourceManager* rm)
  , needToSetLBID(true)
  , count(1)
  , baseRid(0)
+ , scannedLBID(BPP_NO_SCANNED_LBID)
  , ridCount(0)
  , needStrValues(false)
  , wideColumnsWidths(0)
@@ -88,6 +91,9 @@ BatchPrimitiveProcessorJL::BatchPrimitiveProcessorJL(const ResourceManager* rm)
 
 BatchPrimitiveProcessorJL::~BatchPrimitiveProcessorJL()
 {
+  for (uint32_t i = 0; i < joinerCacheModes.size(); i++)
+    if (joinerCacheModes[i] != JOINER_CACHE_NONE)
+      JoinerCacheRegistry::instance()->release(joinerDigests[i], joinerCacheModes[i], joinerGenerations[i]);
 }
 
 void BatchPrimitiveProcessorJL::addFilterStep(const pColScanStep& scan,
@@ -947,6 +953,7 @@ void BatchPrimitiveProcessorJL::setLBID(uint64_t l, const BRM::EMEntry& scannedE
   uint32_t i;
 
   dbRoot = scannedExtent.dbRoot;
+  scannedLBID = l;
   baseRid = rowgroup::convertToRid(
       scannedExtent.partitionNum, scannedExtent.segmentNum,
       scannedExtent.blockOffset / (scannedExtent.range.size * 1024),  // the extent #
@@ -1140,6 +1147,16 @@ void BatchPrimitiveProcessorJL::createBPP(ByteStream& bs) const
           bs << (uint64_t)tJoiners[i]->smallNullValue();
           bs << (messageqcpp::ByteStream::quadbyte)tJoiners[i]->getLargeKeyColumn();
           // cout << "large key column is " << (uint32_t) tJoiners[i]->getLargeKeyColumn() << endl;
+
+          JoinerCacheMode cacheMode = (i < joinerCacheModes.size() ? joinerCacheModes[i] : JOINER_CACHE_NONE);
+          bs << (uint8_t)cacheMode;
+
+          if (cacheMode != JOINER_CACHE_NONE)
+          {
+            bs << JoinerCacheRegistry::instance()->getOwner();
+            bs << joinerDigests[i];
+            bs << joinerGenerations[i];
+          }
         }
         else
         {
@@ -1282,6 +1299,7 @@ void BatchPrimitiveProcessorJL::runBPP(ByteStream& bs, uint32_t pmNum, bool isEx
   // The weight is used by PrimProc thread pool algo
   uint32_t weight = calculateBPPWeight();
   bs << weight;
+  bs << scannedLBID;
 
   bs << dbRoot;
   bs << count;
@@ -1569,58 +1587,7 @@ bool BatchPrimitiveProcessorJL::nextTupleJoinerMsg(ByteStream& bs)
     for (i = pos, j = 0; i < pos + toSend; ++i, ++j)
     {
       r.setPointer((*tSmallSide)[i]);
-
-      if (r.getColType(smallKeyCol) == CalpontSystemCatalog::LONGDOUBLE)
-      {
-        // Small side is a long double. Since CS can't store larger than DOUBLE,
-        // we need to convert to whatever type large side is -- double or int64
-        long double smallkeyld = r.getLongDoubleField(smallKeyCol);
-        switch (largeSideRG.getColType(tJoiners[joinerNum]->getLargeKeyColumns()[0]))
-        {
-          case CalpontSystemCatalog::DOUBLE:
-          case CalpontSystemCatalog::UDOUBLE:
-          case CalpontSystemCatalog::FLOAT:
-          case CalpontSystemCatalog::UFLOAT:
-          {
-            if (smallkeyld > MAX_DOUBLE || smallkeyld < MIN_DOUBLE)
-            {
-              smallkey = joblist::UBIGINTEMPTYROW;
-            }
-            else
-            {
-              double d = (double)smallkeyld;
-              smallkey = *(int64_t*)&d;
-            }
-            break;
-          }
-          default:
-          {
-            if (r.isUnsigned(smallKeyCol) && smallkeyld > MAX_UBIGINT)
-            {
-              smallkey = joblist::UBIGINTEMPTYROW;
-            }
-            else if (smallkeyld > MAX_BIGINT || smallkeyld < MIN_BIGINT)
-            {
-              smallkey = joblist::UBIGINTEMPTYROW;
-            }
-            else
-            {
-              smallkey = (int64_t)smallkeyld;
-            }
-            break;
-          }
-        }
-      }
-      else if (r.isUnsigned(smallKeyCol))
-        smallkey = r.getUintField(smallKeyCol);
-      else
-        smallkey = r.getIntField(smallKeyCol);
-
-      // If this is a compare signed vs unsigned and the sign bit is on for this value, then all compares
-      // against the large side should fall. UBIGINTEMPTYROW is not a valid value, so nothing will match.
-      if (bSignedUnsigned && (smallkey & 0x8000000000000000ULL))
-        smallkey = joblist::UBIGINTEMPTYROW;
-
+      smallkey = getSmallSideKey(r, joinerNum, bSignedUnsigned);
       arr[j].key = (int64_t)smallkey;
       arr[j].value = i;
       // 			cout << "sending " << arr[j].key << ", " << arr[j].value << endl;
@@ -1654,6 +1621,159 @@ bool BatchPrimitiveProcessorJL::nextTupleJoinerMsg(ByteStream& bs)
   return true;
 }
 
+uint64_t BatchPrimitiveProcessorJL::getSmallSideKey(Row& r, uint32_t joinerNum, bool bSignedUnsigned) const
+{
+  uint32_t smallKeyCol = smallSideKeys[joinerNum][0];
+  uint64_t smallkey;
+
+  if (r.getColType(smallKeyCol) == CalpontSystemCatalog::LONGDOUBLE)
+  {
+    // Small side is a long double. Since CS can't store larger than DOUBLE,
+    // we need to convert to whatever type large side is -- double or int64
+    long double smallkeyld = r.getLongDoubleField(smallKeyCol);
+    switch (largeSideRG.getColType(tJoiners[joinerNum]->getLargeKeyColumns()[0]))
+    {
+      case CalpontSystemCatalog::DOUBLE:
+      case CalpontSystemCatalog::UDOUBLE:
+      case CalpontSystemCatalog::FLOAT:
+      case CalpontSystemCatalog::UFLOAT:
+      {
+        if (smallkeyld > MAX_DOUBLE || smallkeyld < MIN_DOUBLE)
+        {
+          smallkey = joblist::UBIGINTEMPTYROW;
+        }
+        else
+        {
+          double d = (double)smallkeyld;
+          smallkey = *(int64_t*)&d;
+        }
+        break;
+      }
+      default:
+      {
+        if (r.isUnsigned(smallKeyCol) && smallkeyld > MAX_UBIGINT)
+        {
+          smallkey = joblist::UBIGINTEMPTYROW;
+        }
+        else if (smallkeyld > MAX_BIGINT || smallkeyld < MIN_BIGINT)
+        {
+          smallkey = joblist::UBIGINTEMPTYROW;
+        }
+        else
+        {
+          smallkey = (int64_t)smallkeyld;
+        }
+        break;
+      }
+    }
+  }
+  else if (r.isUnsigned(smallKeyCol))
+    smallkey = r.getUintField(smallKeyCol);
+  else
+    smallkey = r.getIntField(smallKeyCol);
+
+  // If this is a compare signed vs unsigned and the sign bit is on for this value, then all compares
+  // against the large side should fall. UBIGINTEMPTYROW is not a valid value, so nothing will match.
+  if (bSignedUnsigned && (smallkey & 0x8000000000000000ULL))
+    smallkey = joblist::UBIGINTEMPTYROW;
+
+  return smallkey;
+}
+
+/* The digest covers everything PrimProc's table for the joiner is built from:  the join type,
+   the NULL value, and the keys in the order they're sent. */
+uint64_t BatchPrimitiveProcessorJL::getJoinerDigest(uint32_t joinerNum) const
+{
+  vector<Row::Pointer>* tSmallSide = tJoiners[joinerNum]->getSmallSide();
+  utils::Hasher64_r hasher;
+  Row r;
+  uint64_t header[3], digest, smallkey;
+  bool bSignedUnsigned;
+
+  header[0] = tJoiners[joinerNum]->getJoinType();
+  header[1] = tJoiners[joinerNum]->smallNullValue();
+  header[2] = tSmallSide->size();
+  digest = hasher(header, sizeof(header));
+
+  smallSideRGs[joinerNum].initRow(&r);
+  bSignedUnsigned = r.isUnsigned(smallSideKeys[joinerNum][0]) !=
+                    largeSideRG.isUnsigned(tJoiners[joinerNum]->getLargeKeyColumns()[0]);
+
+  for (uint32_t i = 0; i < tSmallSide->size(); i++)
+  {
+    r.setPointer((*tSmallSide)[i]);
+    smallkey = getSmallSideKey(r, joinerNum, bSignedUnsigned);
+    digest = hasher(&smallkey, sizeof(smallkey), digest);
+  }
+
+  return hasher.finalize(digest, header[2]);
+}
+
+void BatchPrimitiveProcessorJL::useJoinerCache()
+{
+  JoinerCacheRegistry* registry = JoinerCacheRegistry::instance();
+
+  // PrimProc only keeps the tables of integer joins that don't need the small side rows
+  if (PMJoinerCount == 0 || sendTupleJoinRowGroupData || !registry->enabled())
+    return;
+
+  joinerCacheModes.assign(PMJoinerCount, JOINER_CACHE_NONE);
+  joinerDigests.assign(PMJoinerCount, 0);
+  joinerGenerations.assign(PMJoinerCount, 0);
+
+  for (uint32_t i = 0; i < PMJoinerCount; i++)
+  {
+    if (tJoiners[i]->isTypelessJoin())
+      continue;
+
+    joinerDigests[i] = getJoinerDigest(i);
+    joinerCacheModes[i] = registry->acquire(joinerDigests[i], tJoiners[i]->size(), joinerGenerations[i]);
+
+    // nextTupleJoinerMsg() skips it
+    if (joinerCacheModes[i] == JOINER_CACHE_USE)
+      posByJoinerNum[i] = tJoiners[i]->getSmallSide()->size();
+  }
+}
+
+bool BatchPrimitiveProcessorJL::joinersSent(ByteStream& dropMsg, uint32_t pmCount)
+{
+  JoinerCacheRegistry* registry = JoinerCacheRegistry::instance();
+
+  // the destructor's release() drops what the PrimProcs didn't all confirm by then
+  for (uint32_t i = 0; i < joinerCacheModes.size(); i++)
+  {
+    if (joinerCacheModes[i] == JOINER_CACHE_STORE)
+      registry->sent(joinerDigests[i], joinerGenerations[i], pmCount);
+  }
+
+  return registry->getDropMsg(dropMsg, sessionID, stepID, uniqueID);
+}
+
+void BatchPrimitiveProcessorJL::disableJoinerCache()
+{
+  for (uint32_t i = 0; i < joinerCacheModes.size(); i++)
+  {
+    if (joinerCacheModes[i] == JOINER_CACHE_NONE)
+      continue;
+
+    if (joinerCacheModes[i] == JOINER_CACHE_USE)
+      posByJoinerNum[i] = 0;
+
+    JoinerCacheRegistry::instance()->release(joinerDigests[i], joinerCacheModes[i], joinerGenerations[i]);
+    joinerCacheModes[i] = JOINER_CACHE_NONE;
+  }
+}
+
+void BatchPrimitiveProcessorJL::joinerCacheMiss(uint32_t joinerNum)
+{
+  if (joinerNum >= joinerDigests.size())
+    return;
+
+  // the mode stays as it is for the PrimProcs that had it; another one that misses it gets it too
+  JoinerCacheRegistry::instance()->missed(joinerDigests[joinerNum], joinerGenerations[joinerNum]);
+  posByJoinerNum[joinerNum] = 0;
+}
+
 void BatchPrimitiveProcessorJL::setProjectionRowGroup(const rowgroup::RowGroup& rg)
 {
   ot = ROW_GROUP;
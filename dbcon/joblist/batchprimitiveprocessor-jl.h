@@ -210,6 +210,17 @@ class BatchPrimitiveProcessorJL
   /* Tuple hashjoin */
   void useJoiners(const std::vector<std::shared_ptr<joiner::TupleJoiner> >&);
   bool nextTupleJoinerMsg(messageqcpp::ByteStream&);
+
+  /* PrimProc's joiner cache, see JoinerCacheRegistry.  useJoinerCache() decides which of the PM
+     joiners PrimProc already has or should keep, before createBPP().  joinersSent() is called once
+     the joiner msgs are out to pmCount PrimProcs; it returns true and fills in dropMsg if there are
+     tables PrimProc should drop.  disableJoinerCache() goes back to sending every joiner, ex for a
+     PrimProc that just came online.  joinerCacheMiss() is for a PrimProc that didn't have the
+     table of joinerNum, after it nextTupleJoinerMsg() sends that joiner again. */
+  void useJoinerCache();
+  bool joinersSent(messageqcpp::ByteStream& dropMsg, uint32_t pmCount);
+  void disableJoinerCache();
+  void joinerCacheMiss(uint32_t joinerNum);
   // 	void setSmallSideKeyColumn(uint32_t col);
 
   /* OR hacks */
@@ -299,6 +310,7 @@ class BatchPrimitiveProcessorJL
       on the PM */
 
   uint64_t baseRid;  // first abs RID of the logical block
+  uint64_t scannedLBID;  // the LBID setLBID() was called with
 
   uint16_t relRids[LOGICAL_BLOCK_RIDS];
   boost::scoped_array<uint64_t> absRids;
@@ -337,6 +349,8 @@ class BatchPrimitiveProcessorJL
 
   /* for Joiner serialization */
   bool pickNextJoinerNum();
+  uint64_t getSmallSideKey(rowgroup::Row& r, uint32_t joinerNum, bool bSignedUnsigned) const;
+  uint64_t getJoinerDigest(uint32_t joinerNum) const;
   uint32_t pos, joinerNum;
   boost::shared_ptr<std::vector<ElementType> > smallSide;
   boost::scoped_array<uint32_t> posByJoinerNum;
@@ -359,6 +373,8 @@ class BatchPrimitiveProcessorJL
   boost::scoped_array<uint32_t> tlKeyLens;
   bool sendTupleJoinRowGroupData;
   uint32_t PMJoinerCount;
+  std::vector<JoinerCacheMode> joinerCacheModes;
+  std::vector<uint64_t> joinerDigests, joinerGenerations;
 
   /* OR hack */
   uint8_t bop;  // BOP_AND or BOP_OR
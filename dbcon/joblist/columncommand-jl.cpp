@@ -221,6 +221,8 @@ void ColumnCommandJL::createCommand(ByteStream& bs) const
     bs << (uint8_t)1;
   else
     bs << (uint8_t)0;
+  // PP only looks for the inverted index and bloom filters of a column that has them
+  bs << (uint32_t)colType.indexType;
   serializeInlineVector(bs, fLastLbid);
 
   CommandJL::createCommand(bs);
@@ -369,6 +371,14 @@ uint16_t ColumnCommandJL::getWidth()
   return colType.colWidth;
 }
 
+const ExtentCPSummary& ColumnCommandJL::getCPSummary()
+{
+  if (!fCPSummary)
+    fCPSummary.reset(new ExtentCPSummary(extents, colType, getIsDict()));
+
+  return *fCPSummary;
+}
+
 void ColumnCommandJL::reloadExtents()
 {
   int err;
@@ -384,6 +394,7 @@ void ColumnCommandJL::reloadExtents()
   }
 
   sort(extents.begin(), extents.end(), BRM::ExtentSorter());
+  fCPSummary.reset();
 
   if (hasAuxCol)
   {
@@ -78,6 +78,8 @@ class ColumnCommandJL : public CommandJL
   {
     return extentsAux;
   }
+  // The dbroot and partition CP summaries of the extents, built on the first call.
+  const ExtentCPSummary& getCPSummary();
   const execplan::CalpontSystemCatalog::ColType& getColType() const
   {
     return colType;
@@ -139,6 +141,7 @@ class ColumnCommandJL : public CommandJL
   uint32_t dbroot;
 
   std::vector<struct BRM::EMEntry> extentsAux;
+  std::unique_ptr<ExtentCPSummary> fCPSummary;
   bool hasAuxCol;
   uint64_t lbidAux;
   execplan::CalpontSystemCatalog::OID fOidAux;
@@ -65,6 +65,7 @@ using namespace logging;
 using namespace oam;
 
 #include "jobstep.h"
+#include "joinercacheregistry.h"
 using namespace joblist;
 
 #include "atomicops.h"
@@ -880,6 +881,7 @@ int32_t DistributedEngineComm::write(uint32_t senderID, const SBS& msg)
       case BATCH_PRIMITIVE_ADD_JOINER:
       case BATCH_PRIMITIVE_END_JOINER:
       case BATCH_PRIMITIVE_ABORT:
+      case BATCH_PRIMITIVE_DROP_JOINER_CACHE:
       case DICT_CREATE_EQUALITY_FILTER:
       case DICT_DESTROY_EQUALITY_FILTER:
         /* XXXPAT: This relies on the assumption that the first pmCount "PMS*"
@@ -968,6 +970,43 @@ void DistributedEngineComm::addDataToOutput(SBS sbs, uint32_t connIndex, Stats*
   ISMPacketHeader* hdr = (ISMPacketHeader*)(sbs->buf());
   PrimitiveHeader* p = (PrimitiveHeader*)(hdr + 1);
   uint32_t uniqueId = p->UniqueID;
+
+  // Not for the step, PrimProc kept the joiners the step asked it to
+  if (hdr->Command == BATCH_PRIMITIVE_JOINER_CACHED)
+  {
+    JoinerCacheRegistry::instance()->storedMsg(*sbs);
+    return;
+  }
+
+  // Not for the step's queue either, PrimProc needs joiners it was told it has
+  if (hdr->Command == BATCH_PRIMITIVE_JOINER_MISS)
+  {
+    SBSVector resend;
+    boost::mutex::scoped_lock lk(eventListenerLock);
+
+    for (uint32_t i = 0; i < eventListeners.size(); i++)
+    {
+      sbs->rewind();
+      eventListeners[i]->joinerCacheMiss(*sbs, resend);
+    }
+
+    // writeToClient() can reconnect, which needs eventListenerLock
+    lk.unlock();
+
+    try
+    {
+      for (auto& msg : resend)
+        writeToClient(connIndex, msg, uniqueId);
+    }
+    catch (std::exception& e)
+    {
+      writeToLog(__FILE__, __LINE__, string("Could not resend a cached joiner: ") + e.what(),
+                 LOG_TYPE_ERROR);
+    }
+
+    return;
+  }
+
   std::unique_lock lk(fMlock);
   MessageQueueMap::iterator map_tok = fSessionMessages.find(uniqueId);
 
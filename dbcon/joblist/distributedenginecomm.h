@@ -76,6 +76,12 @@ class DECEventListener
 
   /* Do whatever needs to be done to init the new PM */
   virtual void newPMOnline(uint32_t newConnectionNumber) = 0;
+
+  /* A BATCH_PRIMITIVE_JOINER_MISS, a PrimProc doesn't have the joiner tables a step told it to use.
+     The step it's for adds the joiner msgs to send that PrimProc.  See JoinerCacheRegistry. */
+  virtual void joinerCacheMiss(messageqcpp::ByteStream& /*msg*/, std::vector<messageqcpp::SBS>& /*resend*/)
+  {
+  }
 };
 
 /**
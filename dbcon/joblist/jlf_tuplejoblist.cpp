@@ -1638,6 +1638,8 @@ class CircularJoinGraphTransformer
   virtual void initializeJoinGraph();
   // Check if the given join edge has FK - FK relations.
   bool isForeignKeyForeignKeyLink(const JoinEdge& edge, statistics::StatisticsManager* statisticsManager);
+  // Returns the largest number of distinct values among the join keys of the given edge, 0 if unknown.
+  uint64_t getJoinKeyDistinctCount(const JoinEdge& edge, statistics::StatisticsManager* statisticsManager);
   // Based on column statistics tries to search `join edge` with maximum join cardinality.
   virtual void chooseEdgeToTransform(Cycle& cycle, std::pair<JoinEdge, int64_t>& resultEdge);
   // Removes given `tableId` from adjacent list.
@@ -1824,11 +1826,42 @@ bool CircularJoinGraphTransformer::isForeignKeyForeignKeyLink(
   return false;
 }
 
+uint64_t CircularJoinGraphTransformer::getJoinKeyDistinctCount(
+    const JoinEdge& edge, statistics::StatisticsManager* statisticsManager)
+{
+  auto it = jobInfo.tableJoinMap.find(edge);
+  if (it == jobInfo.tableJoinMap.end())
+  {
+    it = jobInfo.tableJoinMap.find(make_pair(edge.second, edge.first));
+    if (it == jobInfo.tableJoinMap.end())
+      return 0;
+  }
+
+  uint64_t distinctCount = 0;
+  for (const auto* keys : {&it->second.fLeftKeys, &it->second.fRightKeys})
+  {
+    for (auto key : *keys)
+    {
+      const auto keyDistinctCount = statisticsManager->getDistinctCount(jobInfo.keyInfo->tupleKeyVec[key].fId);
+      if (!keyDistinctCount)
+        return 0;
+
+      distinctCount = std::max(distinctCount, keyDistinctCount);
+    }
+  }
+
+  return distinctCount;
+}
+
 void CircularJoinGraphTransformer::chooseEdgeToTransform(Cycle& cycle,
                                                          std::pair<JoinEdge, int64_t>& resultEdge)
 {
   // Use statistics if possible.
   auto* statisticsManager = statistics::StatisticsManager::instance();
+  // An equi-join produces about |L| * |R| / max(NDV(L), NDV(R)) rows, so among FK - FK edges the one
+  // with the fewest distinct key values has the highest join cardinality.
+  const JoinEdge* bestEdge = nullptr;
+  uint64_t bestDistinctCount = 0;
   for (auto& edgeForward : cycle)
   {
     // Check that `join edge` is aligned with our needs.
@@ -1837,12 +1870,26 @@ void CircularJoinGraphTransformer::chooseEdgeToTransform(Cycle& cycle,
       const auto edgeBackward = std::make_pair(edgeForward.second, edgeForward.first);
       if (!jobInfo.joinEdgesToRestore.count(edgeForward) && !jobInfo.joinEdgesToRestore.count(edgeBackward))
       {
-        resultEdge = std::make_pair(edgeForward, 0 /*Dummy weight*/);
-        return;
+        const auto distinctCount = getJoinKeyDistinctCount(edgeForward, statisticsManager);
+        if (!bestEdge || (distinctCount && (!bestDistinctCount || distinctCount < bestDistinctCount)))
+        {
+          bestEdge = &edgeForward;
+          bestDistinctCount = distinctCount;
+        }
       }
     }
   }
 
+  if (bestEdge)
+  {
+    if (jobInfo.trace)
+      std::cout << "Join edge " << bestEdge->first << " <-> " << bestEdge->second
+                << " has the fewest distinct key values: " << bestDistinctCount << std::endl;
+
+    resultEdge = std::make_pair(*bestEdge, 0 /*Dummy weight*/);
+    return;
+  }
+
   if (jobInfo.trace)
     std::cout << "FK FK key not found, removing the last one inner join edge" << std::endl;
 
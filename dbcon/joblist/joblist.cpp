@@ -42,6 +42,7 @@ using namespace execplan;
 #include "tupleunion.h"
 #include "tupleaggregatestep.h"
 #include "windowfunctionstep.h"
+#include "resultcache.h"
 #include "configcpp.h"
 #include "oamcache.h"
 
@@ -380,6 +381,23 @@ uint32_t TupleJobList::projectTable(CalpontSystemCatalog::OID, messageqcpp::Byte
 {
   uint32_t ret = ds->nextBand(bs);
   moreData = (ret != 0);
+
+  if (fCachedResult && fCachingAborted)
+    fCachedResult.reset();
+
+  if (fCachedResult)
+  {
+    if (!fCachedResult->addBand(bs, ret))
+      fCachedResult.reset();
+    else if (ret == 0)
+    {
+      if (status() == 0)
+        ResultCache::instance()->insert(fCachedResult);
+
+      fCachedResult.reset();
+    }
+  }
+
   return ret;
 }
 
@@ -1182,7 +1200,7 @@ string JobList::toString() const
   return ret;
 }
 
-TupleJobList::TupleJobList(bool isEM) : JobList(isEM), ds(NULL), moreData(true)
+TupleJobList::TupleJobList(bool isEM) : JobList(isEM), ds(NULL), moreData(true), fCachingAborted(false)
 {
 }
 
@@ -1193,6 +1211,9 @@ TupleJobList::~TupleJobList()
 
 void TupleJobList::abort()
 {
+  // the rest of the result is drained without being delivered
+  fCachingAborted = true;
+
   if (fAborted == 0 && fIsRunning)
   {
     JobList::abort();
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <map>
@@ -214,6 +215,8 @@ class JobList
   uint32_t fPriority;  // higher #s = higher priority
 };
 
+struct CachedResult;
+
 class TupleJobList : public JobList
 {
  public:
@@ -241,6 +244,13 @@ class TupleJobList : public JobList
    */
   EXPORT void validate() const;
 
+  /** Stores the result in the ResultCache as it's delivered, unless the query fails or is aborted
+   */
+  void cacheResult(const boost::shared_ptr<CachedResult>& result)
+  {
+    fCachedResult = result;
+  }
+
  private:
   // defaults okay
   // TupleJobList(const TupleJobList& rhs);
@@ -248,6 +258,10 @@ class TupleJobList : public JobList
 
   TupleDeliveryStep* ds;
   bool moreData;  // used to prevent calling nextBand beyond the last RowGroup
+  // what's been delivered so far.  Only the thread delivering the result touches it; abort() can come
+  // from another one, so it only sets fCachingAborted for projectTable() to drop it.
+  boost::shared_ptr<CachedResult> fCachedResult;
+  std::atomic<bool> fCachingAborted;
 };
 
 typedef boost::shared_ptr<TupleJobList> STJLP;
@@ -81,6 +81,8 @@ using namespace logging;
 #include "tuplehavingstep.h"
 #include "windowfunctionstep.h"
 #include "tupleannexstep.h"
+#include "resultcache.h"
+#include "aggregateprojection.h"
 
 #include "jlf_common.h"
 #include "jlf_graphics.h"
@@ -2140,8 +2142,26 @@ SJLP makeJobList_(CalpontExecutionPlan* cplan, ResourceManager* rm,
       JobStepVector querySteps;
       JobStepVector projectSteps;
       DeliveredTableMap deliverySteps;
+      // before the result cache sees the plan, so the rewritten plan is what it keys on
+      if (rm->getJlAggregateProjections() && csep->queryType() == "SELECT" && !csep->isInternal() &&
+          !(csep->sessionID() & 0x80000000) && useAggregateProjection(csep, csc.get()) && csep->traceOn())
+        cout << "aggregate projection used:" << endl << (*csep) << endl;
 
-      if (csep->unionVec().size() == 0)
+      ResultCache* resultCache = ResultCache::instance();
+      ResultCacheKey resultKey;
+      bool cacheResult = resultCache->makeKey(csep, csc.get(), resultKey);
+      boost::shared_ptr<const CachedResult> cachedResult;
+
+      if (cacheResult)
+        cachedResult = resultCache->find(resultKey);
+
+      if (cachedResult)
+      {
+        SJSTEP step(new CachedResultStep(jobInfo, cachedResult));
+        querySteps.push_back(step);
+        deliverySteps[CNX_VTABLE_ID] = step;
+      }
+      else if (csep->unionVec().size() == 0)
         makeJobSteps(csep, jobInfo, querySteps, projectSteps, deliverySteps);
       else
         makeUnionJobSteps(csep, jobInfo, querySteps, projectSteps, deliverySteps);
@@ -2209,6 +2229,12 @@ SJLP makeJobList_(CalpontExecutionPlan* cplan, ResourceManager* rm,
       csep->setDynamicParseTreeVec(jobInfo.dynamicParseTreeVec);
 
       dynamic_cast<TupleJobList*>(jl)->setDeliveryFlag(true);
+
+      if (cacheResult && !cachedResult)
+      {
+        TupleJobList* tjl = dynamic_cast<TupleJobList*>(jl);
+        tjl->cacheResult(resultCache->newResult(resultKey, tjl->getOutputRowGroup()));
+      }
     }
     catch (IDBExcept& iex)
     {
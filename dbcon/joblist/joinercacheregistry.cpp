@@ -0,0 +1,265 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <unistd.h>
+#include <cstring>
+#include <string>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "joinercacheregistry.h"
+#include "resourcemanager.h"
+#include "hasher.h"
+
+using namespace std;
+using namespace messageqcpp;
+
+namespace
+{
+// roughly what one key costs in a PrimProc hash table, a node and its share of the buckets
+const uint64_t bytesPerKey = 48;
+}  // namespace
+
+namespace joblist
+{
+JoinerCacheRegistry* JoinerCacheRegistry::instance()
+{
+  static JoinerCacheRegistry registry;
+  return &registry;
+}
+
+namespace
+{
+uint32_t getHostOwner()
+{
+  char hostname[256];
+  memset(hostname, 0, sizeof(hostname));
+  gethostname(hostname, sizeof(hostname) - 1);
+  utils::Hasher_r hasher;
+  return hasher(hostname, strlen(hostname), 0);
+}
+}  // namespace
+
+JoinerCacheRegistry::JoinerCacheRegistry()
+ : JoinerCacheRegistry(getHostOwner(), ResourceManager::instance()->getHjPmJoinerCache()
+                                           ? ResourceManager::instance()->getHjPmJoinerCacheSize()
+                                           : 0)
+{
+}
+
+JoinerCacheRegistry::JoinerCacheRegistry(uint32_t owner_, uint64_t maxSize_)
+ : owner(owner_), maxSize(maxSize_), currentSize(0), dropAll(true)
+{
+  /* Generations start at the time ExeMgr started, so they're newer than anything a previous run
+     left in PrimProc.  The first drop msg sent clears those. */
+  boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+  nextGeneration = (boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds();
+  dropAllGeneration = nextGeneration++;
+}
+
+JoinerCacheMode JoinerCacheRegistry::acquire(uint64_t digest, uint64_t rowCount, uint64_t& generation)
+{
+  uint64_t size = rowCount * bytesPerKey;
+
+  if (!enabled() || size > maxSize)
+    return JOINER_CACHE_NONE;
+
+  boost::mutex::scoped_lock lk(mutex);
+  auto it = entries.find(digest);
+
+  if (it == entries.end())
+  {
+    Entry& e = entries[digest];
+    e.generation = generation = nextGeneration++;
+    e.size = size;
+    e.pins = 0;
+    e.unconfirmed = 0;
+    e.sent = false;
+    e.stored = false;
+    return JOINER_CACHE_STORE;
+  }
+
+  // another query is sending it, or PrimProc hasn't confirmed it has it
+  if (!it->second.stored)
+    return JOINER_CACHE_NONE;
+
+  it->second.pins++;
+  lru.splice(lru.begin(), lru, it->second.lruPos);
+  generation = it->second.generation;
+  return JOINER_CACHE_USE;
+}
+
+void JoinerCacheRegistry::sent(uint64_t digest, uint64_t generation, uint32_t pmCount)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  auto it = entries.find(digest);
+
+  if (it == entries.end() || it->second.generation != generation || it->second.sent)
+    return;
+
+  // the confirmations can come before this
+  it->second.sent = true;
+  it->second.unconfirmed += pmCount;
+  confirm(it);
+}
+
+void JoinerCacheRegistry::stored(uint64_t digest, uint64_t generation)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  auto it = entries.find(digest);
+
+  // release() or reset() forgot it before PrimProc got all of it
+  if (it == entries.end() || it->second.generation != generation)
+  {
+    drops.push_back(make_pair(digest, generation));
+    return;
+  }
+
+  if (it->second.stored)
+    return;
+
+  it->second.unconfirmed--;
+  confirm(it);
+}
+
+/* The msg is the ISMPacketHeader and PrimitiveHeader of the step PrimProc stored the tables for, a
+   count, and count pairs of digest & generation. */
+void JoinerCacheRegistry::storedMsg(ByteStream& bs)
+{
+  uint32_t count;
+  uint64_t digest, generation;
+
+  bs.advance(sizeof(ISMPacketHeader) + sizeof(PrimitiveHeader));
+  bs >> count;
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    bs >> digest;
+    bs >> generation;
+    stored(digest, generation);
+  }
+}
+
+void JoinerCacheRegistry::confirm(std::map<uint64_t, Entry>::iterator it)
+{
+  if (!it->second.sent || it->second.unconfirmed > 0)
+    return;
+
+  it->second.stored = true;
+  lru.push_front(it->first);
+  it->second.lruPos = lru.begin();
+  currentSize += it->second.size;
+  evict();
+}
+
+void JoinerCacheRegistry::release(uint64_t digest, JoinerCacheMode mode, uint64_t generation)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  auto it = entries.find(digest);
+
+  if (it == entries.end() || it->second.generation != generation)
+    return;
+
+  if (mode == JOINER_CACHE_USE && it->second.pins > 0)
+  {
+    it->second.pins--;
+    evict();
+  }
+  else if (mode == JOINER_CACHE_STORE && !it->second.stored)
+  {
+    // the query didn't send all of it, or not every PrimProc kept it; some may have, or may still
+    drops.push_back(make_pair(digest, generation));
+    entries.erase(it);
+  }
+}
+
+void JoinerCacheRegistry::missed(uint64_t digest, uint64_t generation)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  auto it = entries.find(digest);
+
+  if (it == entries.end() || it->second.generation != generation || !it->second.stored)
+    return;
+
+  // the queries that have it pinned find nothing to release(); the other PrimProcs drop their copy
+  drops.push_back(make_pair(digest, generation));
+  currentSize -= it->second.size;
+  lru.erase(it->second.lruPos);
+  entries.erase(it);
+}
+
+void JoinerCacheRegistry::reset()
+{
+  boost::mutex::scoped_lock lk(mutex);
+
+  entries.clear();
+  lru.clear();
+  currentSize = 0;
+  drops.clear();
+  dropAll = true;
+  dropAllGeneration = nextGeneration++;
+}
+
+bool JoinerCacheRegistry::getDropMsg(ByteStream& bs, uint32_t sessionID, uint32_t stepID, uint32_t uniqueID)
+{
+  ISMPacketHeader ism;
+  boost::mutex::scoped_lock lk(mutex);
+
+  if (!dropAll && drops.empty())
+    return false;
+
+  memset((void*)&ism, 0, sizeof(ism));
+  ism.Command = BATCH_PRIMITIVE_DROP_JOINER_CACHE;
+  bs.load((uint8_t*)&ism, sizeof(ism));
+  bs << (ByteStream::quadbyte)sessionID;
+  bs << (ByteStream::quadbyte)stepID;
+  bs << uniqueID;
+  bs << owner;
+  bs << (uint8_t)dropAll;
+  bs << dropAllGeneration;
+  bs << (uint32_t)drops.size();
+
+  for (auto& drop : drops)
+  {
+    bs << drop.first;
+    bs << drop.second;
+  }
+
+  dropAll = false;
+  drops.clear();
+  return true;
+}
+
+void JoinerCacheRegistry::evict()
+{
+  auto lruIt = lru.end();
+
+  while (currentSize > maxSize && lruIt != lru.begin())
+  {
+    --lruIt;
+    auto it = entries.find(*lruIt);
+
+    if (it->second.pins > 0)
+      continue;
+
+    drops.push_back(make_pair(it->first, it->second.generation));
+    currentSize -= it->second.size;
+    lruIt = lru.erase(lruIt);
+    entries.erase(it);
+  }
+}
+
+}  // namespace joblist
@@ -0,0 +1,125 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+#include "bytestream.h"
+#include "primitivemsg.h"
+
+namespace joblist
+{
+/* JoinerCacheRegistry is ExeMgr's side of PrimProc's JoinerCache, which keeps the hash tables of
+   integer PM joins for reuse by later queries.
+
+   A table is identified by a digest of the keys ExeMgr sends for it, in the order it sends them.
+   PrimProc's table maps those keys to positions in the small side, so it can serve any query whose
+   small side has the same keys in the same order, whatever the data version it was read from.  A
+   DML or cpimport commit that changes the small side changes the digest; the old table is no
+   longer used and ages out.
+
+   ExeMgr owns its entries in PrimProc.  It decides what's stored, keeps the total under
+   HashJoin/PmJoinerCacheSize, and tells PrimProc what to drop.  An entry is only used once every
+   PrimProc the table was sent to said it keeps it (BATCH_PRIMITIVE_JOINER_CACHED), a query that
+   stops before then leaves nothing a later query would wait for.  An entry a running query uses is
+   pinned until the query is done with it.
+
+   PrimProc can still lose an entry, it drops what doesn't fit in its own limit and a restart loses
+   all of them.  A PrimProc told to use one it doesn't have says so (BATCH_PRIMITIVE_JOINER_MISS),
+   the entry is forgotten and the query sends that PrimProc the table.
+*/
+class JoinerCacheRegistry
+{
+ public:
+  static JoinerCacheRegistry* instance();
+
+  // a registry of its own, instance() is the one ExeMgr uses
+  JoinerCacheRegistry(uint32_t owner, uint64_t maxSize);
+
+  // identifies this ExeMgr's entries in PrimProc
+  uint32_t getOwner() const
+  {
+    return owner;
+  }
+  bool enabled() const
+  {
+    return maxSize > 0;
+  }
+
+  /* For a small side whose keys hash to digest, returns
+       JOINER_CACHE_USE if PrimProc has it.  It's pinned until release().
+       JOINER_CACHE_STORE if the caller should send it for PrimProc to keep.  The caller calls
+         sent() once it's sent all of it to pmCount PrimProcs, and release() when it's done.
+       JOINER_CACHE_NONE if it should be sent and not kept.
+     generation identifies the PrimProc copy. */
+  JoinerCacheMode acquire(uint64_t digest, uint64_t rowCount, uint64_t& generation);
+  void sent(uint64_t digest, uint64_t generation, uint32_t pmCount);
+  void release(uint64_t digest, JoinerCacheMode mode, uint64_t generation);
+
+  // A PrimProc keeps the table, from its BATCH_PRIMITIVE_JOINER_CACHED msg
+  void stored(uint64_t digest, uint64_t generation);
+  void storedMsg(messageqcpp::ByteStream& bs);
+
+  // A PrimProc didn't have the table, from its BATCH_PRIMITIVE_JOINER_MISS msg.  Forgets it.
+  void missed(uint64_t digest, uint64_t generation);
+
+  // A PrimProc came online without its cache.  Forgets everything.
+  void reset();
+
+  /* If PrimProc has entries to drop, builds the BATCH_PRIMITIVE_DROP_JOINER_CACHE msg on behalf of
+     the given step and returns true. */
+  bool getDropMsg(messageqcpp::ByteStream& bs, uint32_t sessionID, uint32_t stepID, uint32_t uniqueID);
+
+ private:
+  JoinerCacheRegistry();
+
+  struct Entry
+  {
+    uint64_t generation;
+    uint64_t size;
+    uint32_t pins;
+    int32_t unconfirmed;  // the PrimProcs it's sent to that haven't said they keep it
+    bool sent;
+    bool stored;
+    std::list<uint64_t>::iterator lruPos;
+  };
+
+  // these are called holding mutex
+  // makes an entry usable once it's sent and every PrimProc confirmed it
+  void confirm(std::map<uint64_t, Entry>::iterator it);
+  // drops unpinned entries until the rest fit in maxSize
+  void evict();
+
+  uint32_t owner;
+  uint64_t maxSize;
+  uint64_t currentSize;
+  uint64_t nextGeneration;
+  std::map<uint64_t, Entry> entries;
+  std::list<uint64_t> lru;  // of stored entries, front = most recently used
+
+  // what to tell PrimProc to drop
+  bool dropAll;
+  uint64_t dropAllGeneration;
+  std::vector<std::pair<uint64_t, uint64_t> > drops;  // digest, generation
+  boost::mutex mutex;
+};
+
+}  // namespace joblist
@@ -864,6 +864,110 @@ bool LBIDList::CasualPartitionPredicate(const BRM::EMCasualPartition_t& cpRange,
   return scan;
 }  // CasualPartitioningPredicate
 
+void LBIDList::CasualPartitionPredicate(const ExtentCPSummary& summary, const messageqcpp::ByteStream* bs,
+                                        const uint16_t NOPS, const execplan::CalpontSystemCatalog::ColType& ct,
+                                        const uint8_t BOP, bool isDict, vector<bool>& eliminated)
+{
+  const auto& partitions = summary.partitions();
+
+  for (const auto& dbRoot : summary.dbRoots())
+  {
+    if (dbRoot.isValid && !CasualPartitionPredicate(dbRoot.cpRange, bs, NOPS, ct, BOP, isDict))
+    {
+      std::fill(eliminated.begin() + dbRoot.first, eliminated.begin() + dbRoot.last, true);
+      continue;
+    }
+
+    for (uint32_t i = dbRoot.firstChild; i < dbRoot.lastChild; i++)
+    {
+      const auto& partition = partitions[i];
+
+      if (partition.isValid && !CasualPartitionPredicate(partition.cpRange, bs, NOPS, ct, BOP, isDict))
+        std::fill(eliminated.begin() + partition.first, eliminated.begin() + partition.last, true);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// ExtentCPSummary
+//------------------------------------------------------------------------------
+
+ExtentCPSummary::ExtentCPSummary(const vector<EMEntry>& extents, const CalpontSystemCatalog::ColType& ct,
+                                 bool isDict)
+ : fColType(ct), fIsDict(isDict)
+{
+  for (uint32_t i = 0; i < extents.size(); i++)
+  {
+    const EMEntry& extent = extents[i];
+
+    if (fDBRoots.empty() || extents[fDBRoots.back().first].dbRoot != extent.dbRoot)
+    {
+      fDBRoots.push_back({i, i, (uint32_t)fPartitions.size(), (uint32_t)fPartitions.size(), true, {}});
+      fDBRoots.back().cpRange = extent.partition.cprange;
+    }
+
+    auto& dbRoot = fDBRoots.back();
+
+    if (dbRoot.firstChild == dbRoot.lastChild ||
+        extents[fPartitions.back().first].partitionNum != extent.partitionNum)
+    {
+      fPartitions.push_back({i, i, 0, 0, true, {}});
+      fPartitions.back().cpRange = extent.partition.cprange;
+      dbRoot.lastChild++;
+    }
+
+    merge(fPartitions.back(), extent);
+    merge(dbRoot, extent);
+  }
+}
+
+void ExtentCPSummary::merge(CPSummaryNode& node, const EMEntry& extent) const
+{
+  node.last++;
+  node.isValid = node.isValid && extent.partition.cprange.isValid == BRM::CP_VALID &&
+                 extent.colWid == fColType.colWidth;
+
+  if (!node.isValid)
+    return;
+
+  const auto& cpRange = extent.partition.cprange;
+
+  if (!fIsDict && datatypes::isCharType(fColType.colDataType))
+  {
+    datatypes::Charset cs(const_cast<CalpontSystemCatalog::ColType&>(fColType).getCharset());
+
+    if (datatypes::TCharShort::strnncollsp(cs, cpRange.loVal, node.cpRange.loVal, fColType.colWidth) < 0)
+      node.cpRange.loVal = cpRange.loVal;
+
+    if (datatypes::TCharShort::strnncollsp(cs, cpRange.hiVal, node.cpRange.hiVal, fColType.colWidth) > 0)
+      node.cpRange.hiVal = cpRange.hiVal;
+  }
+  else if (fIsDict || datatypes::isUnsigned(fColType.colDataType))
+  {
+    if (static_cast<uint64_t>(cpRange.loVal) < static_cast<uint64_t>(node.cpRange.loVal))
+      node.cpRange.loVal = cpRange.loVal;
+
+    if (static_cast<uint64_t>(cpRange.hiVal) > static_cast<uint64_t>(node.cpRange.hiVal))
+      node.cpRange.hiVal = cpRange.hiVal;
+  }
+  else if (fColType.colWidth == datatypes::MAXDECIMALWIDTH)
+  {
+    if (cpRange.bigLoVal < node.cpRange.bigLoVal)
+      node.cpRange.bigLoVal = cpRange.bigLoVal;
+
+    if (cpRange.bigHiVal > node.cpRange.bigHiVal)
+      node.cpRange.bigHiVal = cpRange.bigHiVal;
+  }
+  else
+  {
+    if (cpRange.loVal < node.cpRange.loVal)
+      node.cpRange.loVal = cpRange.loVal;
+
+    if (cpRange.hiVal > node.cpRange.hiVal)
+      node.cpRange.hiVal = cpRange.hiVal;
+  }
+}
+
 void LBIDList::copyLbidList(const LBIDList& rhs)
 {
   em = rhs.em;
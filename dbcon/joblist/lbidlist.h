@@ -59,6 +59,52 @@ struct MinMaxPartition
   };
 };
 
+/** @brief struct CPSummaryNode
+ *
+ * The union of the CP ranges of the extents [first, last) of a column extent list.
+ * The children of a dbroot node are the partition nodes [firstChild, lastChild).
+ */
+struct CPSummaryNode
+{
+  uint32_t first;
+  uint32_t last;
+  uint32_t firstChild;
+  uint32_t lastChild;
+  // false if any of the extents doesn't have a valid CP range of the column width.
+  bool isValid;
+  BRM::EMCasualPartition_t cpRange;
+};
+
+/** @brief class ExtentCPSummary
+ *
+ * The per dbroot and per logical partition CP summaries of an extent list sorted
+ * with ExtentSorter.  A predicate that eliminates the summary eliminates every
+ * extent of it, so whole partitions are dropped before the extents are checked.
+ */
+class ExtentCPSummary
+{
+ public:
+  ExtentCPSummary(const std::vector<BRM::EMEntry>& extents, const execplan::CalpontSystemCatalog::ColType& ct,
+                  bool isDict);
+
+  const std::vector<CPSummaryNode>& dbRoots() const
+  {
+    return fDBRoots;
+  }
+  const std::vector<CPSummaryNode>& partitions() const
+  {
+    return fPartitions;
+  }
+
+ private:
+  void merge(CPSummaryNode& node, const BRM::EMEntry& extent) const;
+
+  execplan::CalpontSystemCatalog::ColType fColType;
+  bool fIsDict;
+  std::vector<CPSummaryNode> fDBRoots;
+  std::vector<CPSummaryNode> fPartitions;
+};
+
 /** @brief class LBIDList
  *
  */
@@ -106,6 +152,12 @@ class LBIDList
                                 const execplan::CalpontSystemCatalog::ColType& ct, const uint8_t BOP,
                                 bool isDict);
 
+  // Sets eliminated[i] for the extents of the dbroots and partitions whose summaries
+  // fail the predicate.  The other extents are left for CasualPartitionPredicate().
+  void CasualPartitionPredicate(const ExtentCPSummary& summary, const messageqcpp::ByteStream* MsgDataPtr,
+                                const uint16_t NOPS, const execplan::CalpontSystemCatalog::ColType& ct,
+                                const uint8_t BOP, bool isDict, std::vector<bool>& eliminated);
+
   template <typename T>
   bool checkSingleValue(T min, T max, T value, const execplan::CalpontSystemCatalog::ColType& type);
 
@@ -167,6 +167,9 @@ enum ISMPACKETCOMMAND
   BATCH_PRIMITIVE_END_JOINER = PRIM_LOCALBASE + 11,
   BATCH_PRIMITIVE_ACK = PRIM_LOCALBASE + 12,
   BATCH_PRIMITIVE_ABORT = PRIM_LOCALBASE + 13,
+  BATCH_PRIMITIVE_DROP_JOINER_CACHE = PRIM_LOCALBASE + 14,
+  BATCH_PRIMITIVE_JOINER_CACHED = PRIM_LOCALBASE + 15,  // PrimProc -> ExeMgr
+  BATCH_PRIMITIVE_JOINER_MISS = PRIM_LOCALBASE + 16,    // PrimProc -> ExeMgr
 
   // max of 100-50=50 commands
   COL_RESULTS = PRIM_COLBASE + 0,
@@ -239,6 +242,10 @@ const uint16_t HAS_ROWGROUP = 0x40;           // 64;
 const uint16_t JOIN_ROWGROUP_DATA = 0x80;     // 128
 const uint16_t HAS_WIDE_COLUMNS = 0x100;      // 256;
 
+/* BPP run messages carry the LBID of the scanned block so that PrimProc can queue the job
+   near the cache that holds it. This value means the BPP doesn't scan. */
+const uint64_t BPP_NO_SCANNED_LBID = 0xFFFFFFFFFFFFFFFFULL;
+
 // TODO: put this in a namespace to stop global ns pollution
 enum PrimFlags
 {
@@ -246,6 +253,17 @@ enum PrimFlags
   PF_PM_PROF = 0x02,    /*!< Enable LBID tracing in PrimProc */
 };
 
+/* What a BPP does with the hash table of an integer PM join, see joblist::JoinerCacheRegistry.
+   STORE: build it from the joiner msgs and keep it in PrimProc's JoinerCache afterward.
+   USE: no joiner msgs follow, take it from the JoinerCache.  If it isn't there, PrimProc sends a
+     BATCH_PRIMITIVE_JOINER_MISS and the joiner msgs for it follow. */
+enum JoinerCacheMode
+{
+  JOINER_CACHE_NONE = 0,
+  JOINER_CACHE_STORE = 1,
+  JOINER_CACHE_USE = 2
+};
+
 enum BPSOutputType
 {
   BPS_ELEMENT_TYPE,
@@ -1101,6 +1101,7 @@ class TupleBPS : public BatchPrimitive, public TupleDeliveryStep
 
   // DEC event listener interface
   void newPMOnline(uint32_t connectionNumber);
+  void joinerCacheMiss(messageqcpp::ByteStream& msg, std::vector<messageqcpp::SBS>& resend);
 
   void setInputRowGroup(const rowgroup::RowGroup& rg);
   void setOutputRowGroup(const rowgroup::RowGroup& rg);
@@ -50,8 +50,10 @@ const uint64_t defaultHJMaxElems = 512 * 1024;  // hashjoin uses 8192
 const int defaultHJMaxBuckets = 32;             // hashjoin uses 4
 const uint64_t defaultHJPmMaxMemorySmallSide = 1 * 1024 * 1024 * 1024ULL;
 const uint64_t defaultHJUmMaxMemorySmallSide = 4 * 1024 * 1024 * 1024ULL;
+const uint64_t defaultHJPmJoinerCacheSize = 256 * 1024 * 1024ULL;
 const uint64_t defaultTotalUmMemory = 8 * 1024 * 1024 * 1024ULL;
 const uint32_t defaultJLThreadPoolSize = 100;
+const uint64_t defaultJLResultCacheSize = 256 * 1024 * 1024ULL;
 
 // pcolscan.cpp
 const uint32_t defaultScanLbidReqThreshold = 5000;
@@ -195,6 +197,20 @@ class ResourceManager
   {
     return getUintVal(fJobListStr, "FifoSize", defaultFifoSize);
   }
+  // ExeMgr keeps the results of queries for their next run, see ResultCache
+  bool getJlResultCache() const
+  {
+    return getBoolVal(fJobListStr, "ResultCache", false);
+  }
+  uint64_t getJlResultCacheSize() const
+  {
+    return getUintVal(fJobListStr, "ResultCacheSize", defaultJLResultCacheSize);
+  }
+  // queries are answered from aggregate projections where they can be, see AggregateProjection
+  bool getJlAggregateProjections() const
+  {
+    return getBoolVal(fJobListStr, "AggregateProjections", false);
+  }
   uint32_t getJlScanLbidReqThreshold() const
   {
     return getUintVal(fJobListStr, "ScanLbidReqThreshold", defaultScanLbidReqThreshold);
@@ -342,6 +358,16 @@ class ResourceManager
   {
     return fHJPmMaxMemorySmallSideSessionMap.getSessionResource(sessionID);
   }
+  // PrimProc keeps the tables of PM joins for reuse by later queries, see JoinerCacheRegistry
+  bool getHjPmJoinerCache() const
+  {
+    return getBoolVal(fHashJoinStr, "PmJoinerCache", true);
+  }
+  // the memory PrimProc may spend on each ExeMgr's cached tables
+  uint64_t getHjPmJoinerCacheSize() const
+  {
+    return getUintVal(fHashJoinStr, "PmJoinerCacheSize", defaultHJPmJoinerCacheSize);
+  }
   uint64_t getHjUmMaxMemorySmallSide(uint32_t sessionID)
   {
     return fHJUmMaxMemorySmallSideDistributor.getSessionResource(sessionID);
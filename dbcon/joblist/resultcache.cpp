@@ -0,0 +1,342 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <boost/uuid/nil_generator.hpp>
+
+#include "resultcache.h"
+#include "jlf_common.h"
+#include "resourcemanager.h"
+#include "existsfilter.h"
+#include "selectfilter.h"
+#include "simplescalarfilter.h"
+#include "dbrm.h"
+#include "hasher.h"
+
+using namespace std;
+using namespace execplan;
+using namespace messageqcpp;
+
+namespace
+{
+// the plans of a query and the tables they read
+struct PlanWalk
+{
+  PlanWalk() : cacheable(true)
+  {
+  }
+  vector<CalpontSelectExecutionPlan*> plans;
+  set<CalpontSystemCatalog::TableName> tables;
+  bool cacheable;
+};
+
+// what the plugin sets anew for every run of a query
+struct RunFields
+{
+  uint32_t sessionID;
+  int txnID;
+  BRM::QueryContext verID;
+  uint32_t statementID;
+  boost::uuids::uuid uuid;
+};
+
+void walkPlan(CalpontExecutionPlan* cep, PlanWalk& walk);
+
+void walkFilter(const ParseTree* n, void* obj)
+{
+  PlanWalk* walk = reinterpret_cast<PlanWalk*>(obj);
+  TreeNode* tn = n->data();
+  SelectFilter* sf;
+  ExistsFilter* ef;
+  SimpleScalarFilter* ssf;
+
+  if ((sf = dynamic_cast<SelectFilter*>(tn)) != NULL)
+    walkPlan(sf->sub().get(), *walk);
+  else if ((ef = dynamic_cast<ExistsFilter*>(tn)) != NULL)
+    walkPlan(ef->sub().get(), *walk);
+  else if ((ssf = dynamic_cast<SimpleScalarFilter*>(tn)) != NULL)
+    walkPlan(ssf->sub().get(), *walk);
+}
+
+void walkPlans(const CalpontSelectExecutionPlan::SelectList& plans, PlanWalk& walk)
+{
+  for (uint32_t i = 0; i < plans.size() && walk.cacheable; i++)
+    walkPlan(plans[i].get(), walk);
+}
+
+void walkPlan(CalpontExecutionPlan* cep, PlanWalk& walk)
+{
+  CalpontSelectExecutionPlan* csep = dynamic_cast<CalpontSelectExecutionPlan*>(cep);
+
+  if (csep == NULL)
+  {
+    walk.cacheable = false;
+    return;
+  }
+
+  walk.plans.push_back(csep);
+
+  for (const auto& table : csep->tableList())
+  {
+    // a FROM subquery, it's in derivedTableList()
+    if (table.schema.empty())
+      continue;
+
+    // there's no version to check the data of other engines against
+    if (!table.fisColumnStore)
+    {
+      walk.cacheable = false;
+      return;
+    }
+
+    walk.tables.insert(CalpontSystemCatalog::TableName(table));
+  }
+
+  walkPlans(csep->derivedTableList(), walk);
+  walkPlans(csep->unionVec(), walk);
+  walkPlans(csep->selectSubList(), walk);
+  walkPlans(csep->subSelects(), walk);
+
+  if (csep->filters() != NULL)
+    csep->filters()->walk(walkFilter, &walk);
+
+  if (csep->having() != NULL)
+    csep->having()->walk(walkFilter, &walk);
+}
+
+}  // namespace
+
+namespace joblist
+{
+bool CachedResult::addBand(const ByteStream& bs, uint32_t rowCount)
+{
+  size += bs.length() + sizeof(bands[0]);
+
+  if (size > maxSize)
+    return false;
+
+  bands.push_back(make_pair(SBS(new ByteStream(bs)), rowCount));
+  return true;
+}
+
+ResultCache* ResultCache::instance()
+{
+  static ResultCache cache;
+  return &cache;
+}
+
+ResultCache::ResultCache()
+ : ResultCache(ResourceManager::instance()->getJlResultCache()
+                   ? ResourceManager::instance()->getJlResultCacheSize()
+                   : 0)
+{
+}
+
+ResultCache::ResultCache(uint64_t maxSize)
+ : maxSize(maxSize), currentSize(0), hits(0), misses(0), inserts(0), evictions(0), invalidations(0)
+{
+}
+
+bool ResultCache::makeKey(CalpontSelectExecutionPlan* csep, CalpontSystemCatalog* csc, ResultCacheKey& key)
+{
+  PlanWalk walk;
+  vector<RunFields> runFields;
+  ByteStream bs;
+  utils::Hasher64_r hasher;
+  uint32_t i;
+
+  // the session's own transaction sees its uncommitted changes
+  if (!enabled() || !csep->resultCacheable() || csep->isInternal() || csep->traceOn() ||
+      csep->queryType() != "SELECT" || csep->txnID() != 0)
+    return false;
+
+  walkPlan(csep, walk);
+
+  if (!walk.cacheable)
+    return false;
+
+  // the plan with the fields of this run zeroed, in the subqueries as well
+  runFields.resize(walk.plans.size());
+
+  for (i = 0; i < walk.plans.size(); i++)
+  {
+    CalpontSelectExecutionPlan* plan = walk.plans[i];
+    runFields[i] = {plan->sessionID(), plan->txnID(), plan->verID(), plan->statementID(), plan->uuid()};
+    plan->sessionID(0);
+    plan->txnID(0);
+    plan->verID(BRM::QueryContext());
+    plan->statementID(0);
+    plan->uuid(boost::uuids::nil_uuid());
+  }
+
+  csep->serialize(bs);
+
+  for (i = 0; i < walk.plans.size(); i++)
+  {
+    CalpontSelectExecutionPlan* plan = walk.plans[i];
+    plan->sessionID(runFields[i].sessionID);
+    plan->txnID(runFields[i].txnID);
+    plan->verID(runFields[i].verID);
+    plan->statementID(runFields[i].statementID);
+    plan->uuid(runFields[i].uuid);
+  }
+
+  key.plan = hasher.finalize(hasher(bs.buf(), bs.length()), bs.length());
+
+  // What the query sees of DML:  the transactions started before it and not among the open ones
+  BRM::QueryContext verID = csep->verID();
+  vector<CalpontSystemCatalog::SCN> txns(*verID.currentTxns);
+  sort(txns.begin(), txns.end());
+  uint64_t version = hasher(&verID.currentScn, sizeof(verID.currentScn));
+
+  if (!txns.empty())
+    version = hasher(&txns[0], txns.size() * sizeof(txns[0]), version);
+
+  /* What it sees of everything else:  the extents of a column of each table.  A cpimport, DDL, or
+     partition operation changes the HWMs, the extent list, or the state of the extents of every
+     column it touches. */
+  BRM::DBRM dbrm;
+
+  for (const auto& table : walk.tables)
+  {
+    CalpontSystemCatalog::RIDList rids = csc->columnRIDs(table, true);
+    vector<BRM::EMEntry> extents;
+
+    if (rids.empty())
+      return false;
+
+    dbrm.getExtents(rids[0].objnum, extents, false, false, true);
+    uint64_t oid = rids[0].objnum;
+    version = hasher(&oid, sizeof(oid), version);
+
+    for (const auto& extent : extents)
+    {
+      uint64_t state[4];
+      state[0] = extent.range.start;
+      state[1] = extent.HWM;
+      state[2] = extent.status;
+      state[3] = ((uint64_t)(uint32_t)extent.partition.cprange.sequenceNum << 8) |
+                 (uint8_t)extent.partition.cprange.isValid;
+      version = hasher(state, sizeof(state), version);
+    }
+  }
+
+  key.dataVersion = hasher.finalize(version, walk.tables.size());
+  return true;
+}
+
+boost::shared_ptr<const CachedResult> ResultCache::find(const ResultCacheKey& key)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  auto it = entries.find(key.plan);
+
+  if (it == entries.end())
+  {
+    misses++;
+    return boost::shared_ptr<const CachedResult>();
+  }
+
+  // the data changed since it was stored
+  if (it->second.result->key.dataVersion != key.dataVersion)
+  {
+    erase(it);
+    invalidations++;
+    misses++;
+    return boost::shared_ptr<const CachedResult>();
+  }
+
+  lru.splice(lru.begin(), lru, it->second.lruPos);
+  hits++;
+  return it->second.result;
+}
+
+boost::shared_ptr<CachedResult> ResultCache::newResult(const ResultCacheKey& key,
+                                                       const rowgroup::RowGroup& rg)
+{
+  // one result can take a quarter of the cache
+  return boost::shared_ptr<CachedResult>(new CachedResult(key, rg, maxSize / 4));
+}
+
+void ResultCache::insert(const boost::shared_ptr<CachedResult>& result)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  auto it = entries.find(result->key.plan);
+
+  // a stale version, or another run of the query stored it first
+  if (it != entries.end())
+    erase(it);
+
+  Entry& entry = entries[result->key.plan];
+  entry.result = result;
+  lru.push_front(result->key.plan);
+  entry.lruPos = lru.begin();
+  currentSize += result->size;
+  inserts++;
+
+  while (currentSize > maxSize)
+  {
+    erase(entries.find(lru.back()));
+    evictions++;
+  }
+}
+
+void ResultCache::erase(map<uint64_t, Entry>::iterator it)
+{
+  currentSize -= it->second.result->size;
+  lru.erase(it->second.lruPos);
+  entries.erase(it);
+}
+
+void ResultCache::serializeStats(ByteStream& bs)
+{
+  boost::mutex::scoped_lock lk(mutex);
+
+  bs << (uint64_t)entries.size();
+  bs << currentSize;
+  bs << maxSize;
+  bs << hits;
+  bs << misses;
+  bs << inserts;
+  bs << evictions;
+  bs << invalidations;
+}
+
+CachedResultStep::CachedResultStep(const JobInfo& jobInfo,
+                                   const boost::shared_ptr<const CachedResult>& result)
+ : JobStep(jobInfo), fResult(result), fNextBand(0)
+{
+}
+
+uint32_t CachedResultStep::nextBand(ByteStream& bs)
+{
+  // the last band is the empty one that ends the result
+  uint32_t i = min<uint32_t>(fNextBand++, fResult->bands.size() - 1);
+  bs = *fResult->bands[i].first;
+  return fResult->bands[i].second;
+}
+
+const string CachedResultStep::toString() const
+{
+  ostringstream oss;
+  oss << "CachedResultStep ses:" << fSessionId << " txn:" << fTxnId << " st:" << fStepId
+      << " bands:" << fResult->bands.size() << endl;
+  return oss.str();
+}
+
+}  // namespace joblist
@@ -0,0 +1,166 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "bytestream.h"
+#include "calpontselectexecutionplan.h"
+#include "calpontsystemcatalog.h"
+#include "jobstep.h"
+#include "rowgroup.h"
+
+// The ExeMgr command for the counters, numbered after statistics.h's ANALYZE_TABLE_* commands
+#define RESULT_CACHE_GET_STATS 10
+
+namespace joblist
+{
+struct JobInfo;
+
+struct ResultCacheKey
+{
+  uint64_t plan;         // the plan, less what differs between runs of the same query
+  uint64_t dataVersion;  // the BRM version and the extents of the tables the plan reads
+};
+
+/* The bands of a query result as TupleJobList::projectTable() delivered them */
+struct CachedResult
+{
+  CachedResult(const ResultCacheKey& k, const rowgroup::RowGroup& rg, uint64_t max)
+   : key(k), rowGroup(rg), size(0), maxSize(max)
+  {
+  }
+
+  // returns false once the result is larger than maxSize
+  bool addBand(const messageqcpp::ByteStream& bs, uint32_t rowCount);
+
+  ResultCacheKey key;
+  rowgroup::RowGroup rowGroup;
+  std::vector<std::pair<messageqcpp::SBS, uint32_t> > bands;  // band, row count; ends with an empty band
+  uint64_t size;
+  uint64_t maxSize;
+};
+
+/* ResultCache keeps the results of SELECTs in ExeMgr so the next run of the same query over the same
+   data is answered without running it.
+
+   A result is found by a hash of the plan, then checked against the data version it was computed
+   from.  The version covers the BRM transaction state, which every DML commit and rollback changes,
+   and the extents of one column of every table the plan reads, which cpimport, DDL, and partition
+   operations change.  A result whose version is stale is dropped when it's found.  The results
+   are kept under JobList/ResultCacheSize and evicted LRU.
+
+   A query is cached only if the server marked its plan cacheable, it reads nothing but ColumnStore
+   tables, and it's not part of an open transaction.
+*/
+class ResultCache
+{
+ public:
+  static ResultCache* instance();
+
+  // a cache of its own, instance() is the one ExeMgr uses
+  explicit ResultCache(uint64_t maxSize);
+
+  bool enabled() const
+  {
+    return maxSize > 0;
+  }
+
+  /* Returns false if the result of csep can't be cached.  Call before the plan is made into
+     a joblist, which modifies it. */
+  bool makeKey(execplan::CalpontSelectExecutionPlan* csep, execplan::CalpontSystemCatalog* csc,
+               ResultCacheKey& key);
+
+  boost::shared_ptr<const CachedResult> find(const ResultCacheKey& key);
+
+  // the result to fill in for insert() on a miss
+  boost::shared_ptr<CachedResult> newResult(const ResultCacheKey& key, const rowgroup::RowGroup& rg);
+  void insert(const boost::shared_ptr<CachedResult>& result);
+
+  // answers RESULT_CACHE_GET_STATS, see is_columnstore_result_cache.cpp for the layout
+  void serializeStats(messageqcpp::ByteStream& bs);
+
+ private:
+  ResultCache();
+
+  struct Entry
+  {
+    boost::shared_ptr<const CachedResult> result;
+    std::list<uint64_t>::iterator lruPos;
+  };
+
+  // call holding mutex
+  void erase(std::map<uint64_t, Entry>::iterator it);
+
+  uint64_t maxSize;
+  uint64_t currentSize;
+  std::map<uint64_t, Entry> entries;
+  std::list<uint64_t> lru;  // front = most recently used
+
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t inserts;
+  uint64_t evictions;
+  uint64_t invalidations;
+  boost::mutex mutex;
+};
+
+/* The delivery step of a joblist made for a cache hit, it replays the result */
+class CachedResultStep : public JobStep, public TupleDeliveryStep
+{
+ public:
+  CachedResultStep(const JobInfo& jobInfo, const boost::shared_ptr<const CachedResult>& result);
+
+  void run()
+  {
+  }
+  void join()
+  {
+  }
+  const std::string toString() const;
+
+  void setOutputRowGroup(const rowgroup::RowGroup&)
+  {
+  }
+  const rowgroup::RowGroup& getOutputRowGroup() const
+  {
+    return fResult->rowGroup;
+  }
+  const rowgroup::RowGroup& getDeliveredRowGroup() const
+  {
+    return fResult->rowGroup;
+  }
+  void deliverStringTableRowGroup(bool)
+  {
+  }
+  bool deliverStringTableRowGroup() const
+  {
+    return fResult->rowGroup.usesStringTable();
+  }
+  uint32_t nextBand(messageqcpp::ByteStream& bs);
+
+ private:
+  boost::shared_ptr<const CachedResult> fResult;
+  uint32_t fNextBand;
+};
+
+}  // namespace joblist
@@ -20,6 +20,7 @@
  *
  ******************************************************************************/
 #include <iostream>
+#include <limits>
 #include "primitivemsg.h"
 #include "blocksize.h"
 #include "rowestimator.h"
@@ -28,6 +29,7 @@
 #include "brmtypes.h"
 #include "dataconvert.h"
 #include "configcpp.h"
+#include "statistics.h"
 
 #define ROW_EST_DEBUG 0
 #if ROW_EST_DEBUG
@@ -257,12 +259,97 @@ float RowEstimator::estimateOpFactor(const T& min, const T& max, const T& value,
   return factor;
 }
 
+// ANALYZE TABLE samples the values with Row::getIntField(), so the histogram bounds are signed 64 bit
+// integers.  Only the types whose raw values keep the same order can use it.
+bool RowEstimator::statisticsApplicable(const execplan::CalpontSystemCatalog::ColType& ct) const
+{
+  switch (ct.colDataType)
+  {
+    case CalpontSystemCatalog::TINYINT:
+    case CalpontSystemCatalog::SMALLINT:
+    case CalpontSystemCatalog::MEDINT:
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::BIGINT:
+    case CalpontSystemCatalog::DATE:
+    case CalpontSystemCatalog::DATETIME:
+    case CalpontSystemCatalog::TIMESTAMP: return true;
+
+    case CalpontSystemCatalog::DECIMAL: return !ct.isWideDecimalType();
+
+    default: return false;
+  }
+}
+
+// Returns the factor for a single operation against the extent with the range [min, max] using the
+// histogram and the MCV list.  The histogram describes the whole column, so the fraction of the rows that
+// qualify is taken relative to the fraction of the rows that fall into the extent range.
+float RowEstimator::estimateOpFactorFromStats(const statistics::ColumnStatistics& stats, int64_t min,
+                                              int64_t max, int64_t value, char op, uint32_t distinctValues)
+{
+  const statistics::ColumnHistogram& histogram = stats.histogram;
+  auto lessOrEqual = [&histogram](int64_t v) { return histogram.lessOrEqualFraction(v); };
+  auto less = [&lessOrEqual](int64_t v)
+  { return v == numeric_limits<int64_t>::min() ? 0.0 : lessOrEqual(v - 1); };
+
+  const double belowExtent = less(min);
+  const double inExtent = lessOrEqual(max) - belowExtent;
+  // The sample has no rows in this range, fall back to the extent based estimate.
+  if (inExtent <= 0.0)
+    return -1.0;
+
+  double factor = -1.0;
+  switch (op)
+  {
+    case COMPARE_LT:
+    case COMPARE_NGE: factor = (less(std::min(value, max)) - belowExtent) / inExtent; break;
+
+    case COMPARE_LE:
+    case COMPARE_NGT: factor = (lessOrEqual(std::min(value, max)) - belowExtent) / inExtent; break;
+
+    case COMPARE_GT:
+    case COMPARE_NLE: factor = (lessOrEqual(max) - lessOrEqual(std::max(value, min))) / inExtent; break;
+
+    case COMPARE_GE:
+    case COMPARE_NLT: factor = (lessOrEqual(max) - less(std::max(value, min))) / inExtent; break;
+
+    case COMPARE_EQ:
+    case COMPARE_NE:
+    {
+      if (value < min || value > max)
+      {
+        factor = 0.0;
+      }
+      else
+      {
+        auto mcvIt = stats.mcv.find(static_cast<uint64_t>(value));
+        if (mcvIt != stats.mcv.end())
+          factor = (1.0 * mcvIt->second / stats.histogram.sampleSize) / inExtent;
+        else
+          factor = 1.0 / distinctValues;
+      }
+
+      if (op == COMPARE_NE)
+        factor = 1.0 - std::min(factor, 1.0);
+
+      break;
+    }
+
+    default: break;
+  }
+
+  if (factor < 0.0)
+    return -1.0;
+
+  return std::min(factor, 1.0);
+}
+
 // Estimate the percentage of rows that will be returned for a particular extent.
 // This function provides the estimate for entire filter such as "col 1 < 100 or col1 > 10000".
 float RowEstimator::estimateRowReturnFactor(const BRM::EMEntry& emEntry, const messageqcpp::ByteStream* bs,
                                             const uint16_t NOPS,
                                             const execplan::CalpontSystemCatalog::ColType& ct,
-                                            const uint8_t BOP, const uint32_t& rowsInExtent)
+                                            const uint8_t BOP, const uint32_t& rowsInExtent,
+                                            const statistics::ColumnStatistics* stats)
 {
   bool bIsUnsigned = datatypes::isUnsigned(ct.colDataType);
   float factor = 1.0;
@@ -288,6 +375,13 @@ float RowEstimator::estimateRowReturnFactor(const BRM::EMEntry& emEntry, const m
         estimateDistinctValues(ct, adjustedBigMin, adjustedBigMax, emEntry.partition.cprange.isValid);
   }
 
+  // An extent can't have more distinct values than the whole column.
+  if (stats && stats->distinctCount && stats->distinctCount < distinctValuesEstimate)
+    distinctValuesEstimate = stats->distinctCount;
+
+  // The histogram needs a valid extent range to be related to.
+  const bool useStats = stats && emEntry.partition.cprange.isValid == BRM::CP_VALID;
+
   // Loop through the operations and estimate the percentage of rows that will qualify.
   // For example, there are two operations for "col1 > 5 and col1 < 10":
   // 1) col1 > 5
@@ -420,34 +514,46 @@ float RowEstimator::estimateRowReturnFactor(const BRM::EMEntry& emEntry, const m
          << ", Val-" << value;
 #endif
 
-    // Get the factor for the individual operation.
-    if (bIsUnsigned)
-    {
-      if (!ct.isWideDecimalType())
-      {
-        tempFactor =
-            estimateOpFactor<uint64_t>(adjustedMin, adjustedMax, adjustValue(ct, value), op, lcf,
-                                       distinctValuesEstimate, emEntry.partition.cprange.isValid, ct);
-      }
-      else
-      {
-        tempFactor =
-            estimateOpFactor<uint128_t>(adjustedBigMin, adjustedBigMax, bigValue, op, lcf,
-                                        distinctValuesEstimate, emEntry.partition.cprange.isValid, ct);
-      }
-    }
+    // Get the factor for the individual operation.  The column statistics are preferred, the extent
+    // range is used if there are none or they don't cover the extent.
+    if (useStats)
+      tempFactor = estimateOpFactorFromStats(*stats, emEntry.partition.cprange.loVal,
+                                             emEntry.partition.cprange.hiVal, value, op,
+                                             distinctValuesEstimate);
     else
+      tempFactor = -1.0;
+
+    if (tempFactor < 0.0)
     {
-      if (!ct.isWideDecimalType())
+      if (bIsUnsigned)
       {
-        tempFactor = estimateOpFactor<int64_t>(adjustedMin, adjustedMax, adjustValue(ct, value), op, lcf,
-                                               distinctValuesEstimate, emEntry.partition.cprange.isValid, ct);
+        if (!ct.isWideDecimalType())
+        {
+          tempFactor =
+              estimateOpFactor<uint64_t>(adjustedMin, adjustedMax, adjustValue(ct, value), op, lcf,
+                                         distinctValuesEstimate, emEntry.partition.cprange.isValid, ct);
+        }
+        else
+        {
+          tempFactor =
+              estimateOpFactor<uint128_t>(adjustedBigMin, adjustedBigMax, bigValue, op, lcf,
+                                          distinctValuesEstimate, emEntry.partition.cprange.isValid, ct);
+        }
       }
       else
       {
-        tempFactor =
-            estimateOpFactor<int128_t>(adjustedBigMin, adjustedBigMax, bigValue, op, lcf,
-                                       distinctValuesEstimate, emEntry.partition.cprange.isValid, ct);
+        if (!ct.isWideDecimalType())
+        {
+          tempFactor =
+              estimateOpFactor<int64_t>(adjustedMin, adjustedMax, adjustValue(ct, value), op, lcf,
+                                        distinctValuesEstimate, emEntry.partition.cprange.isValid, ct);
+        }
+        else
+        {
+          tempFactor =
+              estimateOpFactor<int128_t>(adjustedBigMin, adjustedBigMax, bigValue, op, lcf,
+                                         distinctValuesEstimate, emEntry.partition.cprange.isValid, ct);
+        }
       }
     }
 
@@ -533,6 +639,18 @@ uint64_t RowEstimator::estimateRows(const vector<ColumnCommandJL*>& cpColVec,
   hwm = extents.back().HWM;  // extents is sorted by "global" fbo
   rowsInLastExtent = ((hwm + 1) * fBlockSize / colCmd->getColType().colWidth) % fRowsPerExtent;
 
+  // Fetch the ANALYZE TABLE statistics once per column.
+  auto* statisticsManager = statistics::StatisticsManager::instance();
+  vector<statistics::ColumnStatistics> colStats(cpColVec.size());
+  vector<const statistics::ColumnStatistics*> colStatsPtrs(cpColVec.size(), NULL);
+
+  for (uint32_t j = 0; j < cpColVec.size(); j++)
+  {
+    if (statisticsApplicable(cpColVec[j]->getColType()) &&
+        statisticsManager->getColumnStatistics(cpColVec[j]->getOID(), colStats[j]))
+      colStatsPtrs[j] = &colStats[j];
+  }
+
   // Sum up the total number of scanned rows.
   int32_t idx = scanFlags.size() - 1;
 
@@ -559,7 +677,7 @@ uint64_t RowEstimator::estimateRows(const vector<ColumnCommandJL*>& cpColVec,
         // tempFactor =  rowEstimator.estimateRowReturnFactor(
         tempFactor = estimateRowReturnFactor(colCmd->getExtents()[idx], &(colCmd->getFilterString()),
                                              colCmd->getFilterCount(), colCmd->getColType(), colCmd->getBOP(),
-                                             extentRows);
+                                             extentRows, colStatsPtrs[j]);
 #if ROW_EST_DEBUG
         stopwatch.stop("estimateRowReturnFactor");
 #endif
@@ -34,13 +34,19 @@
 #include <vector>
 #include "brm.h"
 
+namespace statistics
+{
+struct ColumnStatistics;
+}
+
 namespace joblist
 {
 /** @brief estimates row counts for a TupleBPS.
  *
  * Class RowEstimator uses Casual Partitioning information and the filter string pertaining to a particular
  * TupleBPS object to estimate cardinality.  It is used to determine which table to use as the large side
- * table in a multijoin operation.
+ * table in a multijoin operation.  When ANALYZE TABLE statistics exist for a column, its histogram, most
+ * common values and distinct count refine the estimate made from the extent ranges.
  */
 class RowEstimator
 {
@@ -113,6 +119,18 @@ class RowEstimator
                          uint32_t distinctValues, char cpStatus,
                          const execplan::CalpontSystemCatalog::ColType& ct);
 
+  /** @brief returns a factor between 0 and 1 for the estimate of rows in the extent with the range
+   *          [min, max] that will qualify the given individual operation, based on the column statistics.
+   *
+   * Returns a negative number if the statistics don't cover the range.
+   *
+   * @param stats	 The column statistics collected by ANALYZE TABLE.
+   * @param distinctValues The distinct values estimate for the extent.
+   *
+   */
+  float estimateOpFactorFromStats(const statistics::ColumnStatistics& stats, int64_t min, int64_t max,
+                                  int64_t value, char op, uint32_t distinctValues);
+
   /** @brief returns a factor between 0 and 1 for the estimate of rows that will qualify
    *          the given operation(s).
    *
@@ -124,11 +142,18 @@ class RowEstimator
    * @param ct	      The column type.
    * @param BOP	      The binary operator for the filter predicates (eg. OR for col1 = 5 or col1 = 10)
    * @param rowsInExtent The number of rows in the extent being evaluated.
+   * @param stats        The column statistics, NULL if there are none.
    *
    */
   float estimateRowReturnFactor(const BRM::EMEntry& emEntry, const messageqcpp::ByteStream* msgDataPtr,
                                 const uint16_t NOPS, const execplan::CalpontSystemCatalog::ColType& ct,
-                                const uint8_t BOP, const uint32_t& rowsInExtent);
+                                const uint8_t BOP, const uint32_t& rowsInExtent,
+                                const statistics::ColumnStatistics* stats = NULL);
+
+  /** @brief returns true if the raw column values order the same way as the values collected by
+   *          ANALYZE TABLE, so the histogram can be applied to the filter values.
+   */
+  bool statisticsApplicable(const execplan::CalpontSystemCatalog::ColType& ct) const;
 
   // Configurables read from Columnstore.xml - future.
   uint32_t fExtentsToSample;
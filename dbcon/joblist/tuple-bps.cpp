@@ -41,6 +41,7 @@ using namespace boost;
 #include "primitivestep.h"
 #include "unique32generator.h"
 #include "rowestimator.h"
+#include "joinercacheregistry.h"
 using namespace joblist;
 
 #include "messagequeue.h"
@@ -1095,6 +1096,23 @@ void TupleBPS::storeCasualPartitionInfo(const bool estimateRowCounts)
 
   const bool ignoreCP = ((fTraceFlags & CalpontSelectExecutionPlan::IGNORE_CP) != 0);
 
+  // Check the dbroot and partition summaries first so the extents of the eliminated
+  // partitions aren't checked one by one.
+  vector<vector<bool>> eliminated(cpColVec.size());
+
+  for (uint32_t i = 0; !ignoreCP && defaultScanFlag && i < cpColVec.size(); i++)
+  {
+    colCmd = cpColVec[i];
+
+    if (colCmd->getExtents().size() != numExtents)
+      continue;
+
+    eliminated[i].assign(numExtents, false);
+    lbidListVec[i]->CasualPartitionPredicate(colCmd->getCPSummary(), &(colCmd->getFilterString()),
+                                             colCmd->getFilterCount(), colCmd->getColType(), colCmd->getBOP(),
+                                             colCmd->getIsDict(), eliminated[i]);
+  }
+
   for (uint32_t idx = 0; idx < numExtents; idx++)
   {
     scanFlags[idx] = defaultScanFlag;
@@ -1102,6 +1120,13 @@ void TupleBPS::storeCasualPartitionInfo(const bool estimateRowCounts)
     for (uint32_t i = 0; scanFlags[idx] && i < cpColVec.size(); i++)
     {
       colCmd = cpColVec[i];
+
+      if (!eliminated[i].empty() && eliminated[i][idx])
+      {
+        scanFlags[idx] = false;
+        break;
+      }
+
       const EMEntry& extent = colCmd->getExtents()[idx];
 
       /* If any column filter eliminates an extent, it doesn't get scanned */
@@ -1481,13 +1506,22 @@ void TupleBPS::run()
   {
     fDec->addDECEventListener(this);
     fBPP->priority(priority());
+    fBPP->useJoinerCache();
     fBPP->createBPP(*sbs);
     fDec->write(uniqueID, sbs);
     BPPIsAllocated = true;
 
     if (doJoin && tjoiners[0]->inPM())
+    {
       serializeJoiner();
 
+      // Piggyback what PrimProc should drop from its joiner cache
+      sbs.reset(new ByteStream());
+
+      if (fBPP->joinersSent(*sbs, fDec->getPmCount()))
+        fDec->write(uniqueID, sbs);
+    }
+
     prepCasualPartitioning();
     startPrimitiveThread();
     fProducerThreads.clear();
@@ -2955,6 +2989,9 @@ void TupleBPS::newPMOnline(uint32_t connectionNumber)
 {
   ByteStream bs;
 
+  // The new PrimProc has none of the cached joiners
+  JoinerCacheRegistry::instance()->reset();
+  fBPP->disableJoinerCache();
   fBPP->createBPP(bs);
 
   try
@@ -2971,6 +3008,36 @@ void TupleBPS::newPMOnline(uint32_t connectionNumber)
   }
 }
 
+void TupleBPS::joinerCacheMiss(ByteStream& msg, vector<SBS>& resend)
+{
+  const PrimitiveHeader* ph = (const PrimitiveHeader*)(msg.buf() + sizeof(ISMPacketHeader));
+  uint32_t count, joinerNum, i;
+
+  if (ph->UniqueID != uniqueID || !hasPMJoin)
+    return;
+
+  msg.advance(sizeof(ISMPacketHeader) + sizeof(PrimitiveHeader));
+  msg >> count;
+
+  // PrimProc has all of the joiner msgs by now, serializeJoiner() is done
+  boost::mutex::scoped_lock lk(serializeJoinerMutex);
+
+  for (i = 0; i < count; i++)
+  {
+    msg >> joinerNum;
+    fBPP->joinerCacheMiss(joinerNum);
+  }
+
+  // the last msg is the BATCH_PRIMITIVE_END_JOINER it already has
+  SBS sbs(new ByteStream());
+
+  while (fBPP->nextTupleJoinerMsg(*sbs))
+  {
+    resend.push_back(sbs);
+    sbs.reset(new ByteStream());
+  }
+}
+
 void TupleBPS::setInputRowGroup(const rowgroup::RowGroup& rg)
 {
   inputRowGroup = rg;
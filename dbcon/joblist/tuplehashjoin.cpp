@@ -288,6 +288,8 @@ void TupleHashJoinStep::startSmallRunners(uint index)
 
   joiner->setUniqueLimit(uniqueLimit);
   joiner->setTableName(smallTableNames[index]);
+  // before the inserts, a semi or anti join keeps every row of a key only when it has an FE
+  joiner->setFcnExpFilter(getJoinFilter(index));
   joiners[index] = joiner;
 
   /* check for join types unsupported on the PM. */
@@ -727,9 +729,6 @@ void TupleHashJoinStep::hjRunner()
   jobstepThreadPool.join(smallRunners);
   smallRunners.clear();
 
-  for (i = 0; i < feIndexes.size() && joiners.size() > 0; i++)
-    joiners[feIndexes[i]]->setFcnExpFilter(fe[i]);
-
   /* segregate the Joiners into ones for TBPS and ones for DJS */
   segregateJoiners();
 
@@ -1759,12 +1758,43 @@ void TupleHashJoinStep::joinOneRG(
   joinOutput.setDBRoot(inputRG.getDBRoot());
   inputRG.getRow(0, &largeSideRow);
 
+  /* The UM tables of big small sides don't fit in cache.  Hint the slots of the row
+     prefetchDistance rows ahead so they've arrived by the time it gets matched. */
+  const uint32_t prefetchDistance = 8;
+  const uint32_t rowCount = inputRG.getRowCount();
+  vector<uint32_t> prefetchJoiners;
+  Row aheadRow;
+
+  for (j = 0; j < smallSideCount; j++)
+    if ((*tjoiners)[j]->canPrefetch())
+      prefetchJoiners.push_back(j);
+
+  if (!prefetchJoiners.empty() && rowCount > prefetchDistance)
+  {
+    inputRG.initRow(&aheadRow);
+    inputRG.getRow(0, &aheadRow);
+
+    for (k = 0; k < prefetchDistance; k++, aheadRow.nextRow())
+      for (auto pj : prefetchJoiners)
+        (*tjoiners)[pj]->prefetch(aheadRow);
+  }
+  else
+    prefetchJoiners.clear();
+
   // cout << "jointype = " << (*tjoiners)[0]->getJoinType() << endl;
-  for (k = 0; k < inputRG.getRowCount() && !cancelled(); k++, largeSideRow.nextRow())
+  for (k = 0; k < rowCount && !cancelled(); k++, largeSideRow.nextRow())
   {
     // cout << "THJS: Large side row: " << largeSideRow.toString() << endl;
     matchCount = 0;
 
+    if (!prefetchJoiners.empty() && k + prefetchDistance < rowCount)
+    {
+      for (auto pj : prefetchJoiners)
+        (*tjoiners)[pj]->prefetch(aheadRow);
+
+      aheadRow.nextRow();
+    }
+
     for (j = 0; j < smallSideCount; j++)
     {
       (*tjoiners)[j]->match(largeSideRow, k, threadID, &joinMatches[j]);
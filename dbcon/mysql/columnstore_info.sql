@@ -120,6 +120,96 @@ create or replace procedure columnstore_upgrade() SQL SECURITY INVOKER
     END LOOP;
 END //
 
+CREATE TABLE IF NOT EXISTS columnstore_info.reorganized_extents (object_id INT, logical_block_start BIGINT, PRIMARY KEY (object_id, logical_block_start)) ENGINE=Aria //
+
+-- Re-sorts the rows of the partitions of a table whose ranges on the first
+-- column of its sort key (a table COMMENT 'sortkey=(...)') overlap those of
+-- other partitions, or are unknown, so the extents get narrow ranges again.
+-- Up to max_partitions partitions are copied to columnstore_info.reorg_<oid>,
+-- dropped and inserted back in sort key order.  Run it (or schedule it with
+-- CREATE EVENT) while nothing else writes to the table; if it fails after the
+-- partitions are dropped, their rows are still in the copy.  The extents the
+-- rows are inserted back into are recorded in columnstore_info.reorganized_extents
+-- and left out of later runs while their ranges are valid, so rows that still
+-- overlap other partitions aren't rewritten over and over.
+CREATE OR REPLACE PROCEDURE reorganize_sort_key (IN t_schema char(64), IN t_name char(64), IN max_partitions int) SQL SECURITY INVOKER
+`reorganize_sort_key`: BEGIN
+    DECLARE key_oid INT DEFAULT NULL;
+    DECLARE key_columns TEXT DEFAULT NULL;
+    DECLARE partitions TEXT DEFAULT NULL;
+    DECLARE copy_table VARCHAR(200);
+    DECLARE drop_result TEXT;
+    DECLARE saved_max_len BIGINT UNSIGNED DEFAULT @@SESSION.group_concat_max_len;
+    DECLARE EXIT HANDLER FOR SQLEXCEPTION
+    BEGIN
+        SET SESSION group_concat_max_len = saved_max_len;
+        RESIGNAL;
+    END;
+
+    -- the list of partitions would be cut at the default 1024 bytes
+    SET SESSION group_concat_max_len = 4294967295;
+    SELECT objectid INTO key_oid FROM calpontsys.syscolumn WHERE `schema` = t_schema AND tablename = t_name AND sortkey = 1;
+    SELECT GROUP_CONCAT(concat('`', columnname, '`') ORDER BY sortkey) INTO key_columns FROM calpontsys.syscolumn WHERE `schema` = t_schema AND tablename = t_name AND sortkey > 0;
+    IF key_oid IS NULL THEN
+        SIGNAL SQLSTATE '45000' SET MESSAGE_TEXT = 'The table has no sort key';
+        LEAVE `reorganize_sort_key`;
+    END IF;
+
+    DELETE FROM columnstore_info.reorganized_extents WHERE object_id = key_oid AND logical_block_start NOT IN
+        (SELECT logical_block_start FROM information_schema.columnstore_extents WHERE object_id = key_oid);
+    SELECT GROUP_CONCAT(p ORDER BY p) INTO partitions FROM
+        (SELECT DISTINCT concat(e1.partition_id, '.', e1.segment_id, '.', e1.dbroot) p FROM information_schema.columnstore_extents e1
+         WHERE e1.object_id = key_oid AND e1.high_water_mark > 0
+         AND NOT (e1.state = 'Valid' AND e1.logical_block_start IN
+            (SELECT logical_block_start FROM columnstore_info.reorganized_extents WHERE object_id = key_oid))
+         AND (e1.state <> 'Valid' OR EXISTS
+            (SELECT 1 FROM information_schema.columnstore_extents e2
+             WHERE e2.object_id = key_oid AND e2.logical_block_start <> e1.logical_block_start AND e2.state = 'Valid'
+             AND e2.min_value <= e1.max_value AND e1.min_value <= e2.max_value))
+         ORDER BY e1.partition_id, e1.segment_id, e1.dbroot LIMIT max_partitions) overlapping;
+    IF partitions IS NULL THEN
+        SET SESSION group_concat_max_len = saved_max_len;
+        SELECT 'No partitions to reorganize' AS result;
+        LEAVE `reorganize_sort_key`;
+    END IF;
+
+    SET copy_table = concat('columnstore_info.reorg_', key_oid);
+    SET @sql_query = concat('CREATE TABLE ', copy_table, ' ENGINE=Aria AS SELECT * FROM `', t_schema, '`.`', t_name, '` WHERE find_in_set(idbPartition(', substring_index(key_columns, ',', 1), '), \'', partitions, '\')');
+    PREPARE stmt FROM @sql_query;
+    EXECUTE stmt;
+    DEALLOCATE PREPARE stmt;
+
+    SELECT calDropPartitions(t_schema, t_name, partitions) INTO drop_result;
+    IF drop_result NOT LIKE 'Partitions are dropped successfully%' THEN
+        SET @sql_query = concat('DROP TABLE ', copy_table);
+        PREPARE stmt FROM @sql_query;
+        EXECUTE stmt;
+        DEALLOCATE PREPARE stmt;
+        SIGNAL SQLSTATE '45000' SET MESSAGE_TEXT = 'Error dropping the partitions to reorganize';
+        LEAVE `reorganize_sort_key`;
+    END IF;
+
+    DROP TEMPORARY TABLE IF EXISTS columnstore_info.reorg_extents;
+    CREATE TEMPORARY TABLE columnstore_info.reorg_extents ENGINE=Aria AS
+        SELECT logical_block_start FROM information_schema.columnstore_extents WHERE object_id = key_oid;
+    SET @sql_query = concat('INSERT INTO `', t_schema, '`.`', t_name, '` SELECT * FROM ', copy_table, ' ORDER BY ', key_columns);
+    PREPARE stmt FROM @sql_query;
+    EXECUTE stmt;
+    DEALLOCATE PREPARE stmt;
+    INSERT IGNORE INTO columnstore_info.reorganized_extents SELECT key_oid, logical_block_start
+        FROM information_schema.columnstore_extents WHERE object_id = key_oid AND logical_block_start NOT IN
+        (SELECT logical_block_start FROM columnstore_info.reorg_extents);
+    DROP TEMPORARY TABLE columnstore_info.reorg_extents;
+
+    SET @sql_query = concat('DROP TABLE ', copy_table);
+    PREPARE stmt FROM @sql_query;
+    EXECUTE stmt;
+    DEALLOCATE PREPARE stmt;
+
+    SET SESSION group_concat_max_len = saved_max_len;
+    SELECT concat('Reorganized partitions ', partitions) AS result;
+END //
+
 CREATE OR REPLACE PROCEDURE load_from_s3 (in bucket varchar(256) CHARACTER SET utf8,
                                           in filename varchar(256) CHARACTER SET utf8,
                                           in dbname varchar(256) CHARACTER SET utf8,
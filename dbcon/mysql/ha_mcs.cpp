@@ -1905,8 +1905,11 @@ maria_declare_plugin(columnstore){
      "MariaDB Corporation", "An information schema plugin to list ColumnStore extents", PLUGIN_LICENSE_GPL,
      is_columnstore_extents_plugin_init,
      // is_columnstore_extents_plugin_deinit,
-     NULL, MCSVERSIONHEX, NULL, NULL, PLUGIN_COLUMNSTORE_VERSION,
-     COLUMNSTORE_MATURITY} maria_declare_plugin_end;
+     NULL, MCSVERSIONHEX, NULL, NULL, PLUGIN_COLUMNSTORE_VERSION, COLUMNSTORE_MATURITY},
+    {MYSQL_INFORMATION_SCHEMA_PLUGIN, &is_columnstore_plugin_version, "COLUMNSTORE_RESULT_CACHE",
+     "MariaDB Corporation", "An information schema plugin to show the ExeMgr result cache stats",
+     PLUGIN_LICENSE_GPL, is_columnstore_result_cache_plugin_init, NULL, MCSVERSIONHEX, NULL, NULL,
+     PLUGIN_COLUMNSTORE_VERSION, COLUMNSTORE_MATURITY} maria_declare_plugin_end;
 
 /******************************************************************************
 Implementation of write cache
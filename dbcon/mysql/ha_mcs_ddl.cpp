@@ -184,6 +184,106 @@ int parseCompressionComment(std::string comment)
   return compressiontype;
 }
 
+// Returns the columns of a SORTKEY=(col[,col...]) table comment in the order of the key
+std::vector<std::string> parseSortKeyComment(const std::string& comment)
+{
+  std::regex pat("[[:space:]]*SORTKEY[[:space:]]*=[[:space:]]*",
+                 std::regex_constants::extended | std::regex_constants::icase);
+  std::smatch what;
+  std::vector<std::string> columns;
+
+  if (!std::regex_search(comment, what, pat))
+    return columns;
+
+  //; is the separator between the options of a comment.
+  std::string keys = what.suffix().str();
+  keys = keys.substr(0, keys.find_first_of(";"));
+  boost::algorithm::erase_all(keys, "(");
+  boost::algorithm::erase_all(keys, ")");
+  boost::algorithm::split(columns, keys, boost::algorithm::is_any_of(","));
+
+  for (auto& column : columns)
+    boost::algorithm::trim(column);
+
+  return columns;
+}
+
+// Returns the CalpontSystemCatalog::ColumnIndexType bits of an INDEX=type[,type...] column
+// comment, or -1 if it names an unknown index type
+int parseIndexComment(const std::string& comment)
+{
+  std::regex pat("[[:space:]]*INDEX[[:space:]]*=[[:space:]]*",
+                 std::regex_constants::extended | std::regex_constants::icase);
+  std::smatch what;
+  std::vector<std::string> types;
+  int indexType = CalpontSystemCatalog::NO_COLUMN_INDEX;
+
+  if (!std::regex_search(comment, what, pat))
+    return indexType;
+
+  //; is the separator between the options of a comment.
+  std::string value = what.suffix().str();
+  value = value.substr(0, value.find_first_of(";"));
+  boost::algorithm::erase_all(value, "(");
+  boost::algorithm::erase_all(value, ")");
+  boost::algorithm::split(types, value, boost::algorithm::is_any_of(","));
+
+  for (auto& type : types)
+  {
+    boost::algorithm::trim(type);
+
+    if (algorithm::iequals(type, "inverted"))
+      indexType |= CalpontSystemCatalog::INVERTED_INDEX;
+    else if (algorithm::iequals(type, "bloom"))
+      indexType |= CalpontSystemCatalog::BLOOM_FILTER;
+    else
+      return -1;
+  }
+
+  return indexType;
+}
+
+// The columns an inverted index or bloom filters can be kept on: the values are at most 8 bytes
+// and compared as they're stored
+bool validateColumnIndexDatatype(const ddlpackage::ColumnType& type)
+{
+  switch (type.fType)
+  {
+    case ddlpackage::DDL_TINYINT:
+    case ddlpackage::DDL_SMALLINT:
+    case ddlpackage::DDL_MEDINT:
+    case ddlpackage::DDL_INT:
+    case ddlpackage::DDL_INTEGER:
+    case ddlpackage::DDL_BIGINT:
+    case ddlpackage::DDL_UNSIGNED_TINYINT:
+    case ddlpackage::DDL_UNSIGNED_SMALLINT:
+    case ddlpackage::DDL_UNSIGNED_MEDINT:
+    case ddlpackage::DDL_UNSIGNED_INT:
+    case ddlpackage::DDL_UNSIGNED_BIGINT:
+    case ddlpackage::DDL_DATE:
+    case ddlpackage::DDL_DATETIME:
+    case ddlpackage::DDL_TIME:
+    case ddlpackage::DDL_TIMESTAMP: return true;
+
+    case ddlpackage::DDL_DECIMAL:
+    case ddlpackage::DDL_NUMERIC:
+    case ddlpackage::DDL_UNSIGNED_DECIMAL:
+    case ddlpackage::DDL_UNSIGNED_NUMERIC: return type.fPrecision <= 18;
+
+    // Strings stored in the column, if they compare by their bytes, see ColumnIndex::isIndexable()
+    case ddlpackage::DDL_CHAR:
+    case ddlpackage::DDL_VARCHAR:
+    case ddlpackage::DDL_VARBINARY:
+    {
+      const CHARSET_INFO* cs = get_charset(type.fCharsetNum, MYF(0));
+      return type.fLength <= (type.fType == ddlpackage::DDL_CHAR ? 8 : 7) && cs &&
+             (cs->state & (MY_CS_BINSORT | MY_CS_NOPAD)) == (MY_CS_BINSORT | MY_CS_NOPAD);
+    }
+
+    default: return false;
+  }
+}
+
 bool validateAutoincrementDatatype(int type)
 {
   bool validAutoType = false;
@@ -1145,6 +1245,88 @@ int ProcessDDLStatement(string& ddlStatement, string& schema, const string& tabl
         ci->isAlter = false;
         return rc;
       }
+
+      // The sort key cpimport and batch inserts order the rows of the table by
+      TableOptionMap::const_iterator commentIt = createTable->fTableDef->fOptions.find("comment");
+      vector<string> sortKey;
+
+      if (commentIt != createTable->fTableDef->fOptions.end())
+        sortKey = parseSortKeyComment(commentIt->second);
+
+      for (unsigned k = 0; k < sortKey.size(); k++)
+      {
+        ColumnDef* keyColumn = NULL;
+
+        for (unsigned i = 0; i < createTable->fTableDef->fColumns.size(); i++)
+        {
+          if (algorithm::iequals(createTable->fTableDef->fColumns[i]->fName, sortKey[k]))
+            keyColumn = createTable->fTableDef->fColumns[i];
+        }
+
+        string errmsg;
+
+        if (keyColumn == NULL)
+        {
+          Message::Args args;
+          args.add(sortKey[k]);
+          errmsg = IDBErrorInfo::instance()->errorMsg(ERR_UNKNOWN_COL, args);
+        }
+        else if (keyColumn->fType->fSortKey != 0)
+        {
+          errmsg = "Column '" + sortKey[k] + "' is in the sort key more than once.";
+        }
+        else if (keyColumn->fType->fType == ddlpackage::DDL_BLOB ||
+                 keyColumn->fType->fType == ddlpackage::DDL_CLOB ||
+                 keyColumn->fType->fType == ddlpackage::DDL_TEXT ||
+                 keyColumn->fType->fType == ddlpackage::DDL_VARBINARY)
+        {
+          errmsg = "Column '" + sortKey[k] + "' can't be in the sort key, it's a BLOB, TEXT or VARBINARY.";
+        }
+
+        if (!errmsg.empty())
+        {
+          rc = 1;
+          thd->get_stmt_da()->set_overwrite_status(true);
+          thd->raise_error_printf(ER_INTERNAL_ERROR, errmsg.c_str());
+          ci->alterTableState = cal_connection_info::NOT_ALTER;
+          ci->isAlter = false;
+          return rc;
+        }
+
+        keyColumn->fType->fSortKey = k + 1;
+      }
+
+      // The secondary indexes WriteEngine keeps on the columns
+      for (unsigned i = 0; i < createTable->fTableDef->fColumns.size(); i++)
+      {
+        ColumnDef* column = createTable->fTableDef->fColumns[i];
+        int indexType = parseIndexComment(column->fComment);
+        string errmsg;
+
+        if (indexType < 0)
+        {
+          errmsg = "Column '" + column->fName + "' has an unknown index type.";
+        }
+        else if (indexType != CalpontSystemCatalog::NO_COLUMN_INDEX &&
+                 !validateColumnIndexDatatype(*column->fType))
+        {
+          errmsg = "Column '" + column->fName +
+                   "' can't have an index, it's not an integer, temporal, DECIMAL(18) or short binary "
+                   "string column.";
+        }
+
+        if (!errmsg.empty())
+        {
+          rc = 1;
+          thd->get_stmt_da()->set_overwrite_status(true);
+          thd->raise_error_printf(ER_INTERNAL_ERROR, errmsg.c_str());
+          ci->alterTableState = cal_connection_info::NOT_ALTER;
+          ci->isAlter = false;
+          return rc;
+        }
+
+        column->fType->fIndexType = indexType;
+      }
     }
     else if (typeid(stmt) == typeid(AlterTableStatement))
     {
@@ -278,11 +278,75 @@ bool onlyOneTableinTM(cal_impl_if::cal_connection_info* ci)
   return true;
 }
 
+// Works out, once per scan, which rowgroup column and type handler fill each field of the table.
+// fetchNextRow() then converts rows without redoing that for every field of every row.
+void makeFetchPlan(cal_table_info& ti, RowGroup* rowGroup)
+{
+  int num_attr = ti.msTablePtr->s->fields;
+  std::vector<CalpontSystemCatalog::ColType>& colTypes = ti.tpl_scan_ctx->ctp;
+  bool tableMode = ti.tpl_scan_ctx->traceFlags & execplan::CalpontSelectExecutionPlan::TRACE_TUPLE_OFF;
+
+  // table mode mysql expects all columns of the table. mapping between columnoid and position in rowgroup
+  // set coltype.position to be the position in rowgroup. only set once.
+  if (ti.tpl_scan_ctx->rowsreturned == 0 && tableMode)
+  {
+    for (uint32_t i = 0; i < rowGroup->getColumnCount(); i++)
+    {
+      int oid = rowGroup->getOIDs()[i];
+      int j = 0;
+
+      for (; j < num_attr; j++)
+      {
+        // mysql should haved eliminated duplicate projection columns
+        if (oid == colTypes[j].columnOID || oid == colTypes[j].ddn.dictOID)
+        {
+          colTypes[j].colPosition = i;
+          break;
+        }
+      }
+    }
+  }
+
+  // get coltype if not there yet
+  if (num_attr > 0 && colTypes[0].colWidth == 0)
+  {
+    for (short c = 0; c < num_attr; c++)
+    {
+      colTypes[c].colPosition = c;
+      colTypes[c].colWidth = rowGroup->getColumnWidth(c);
+      colTypes[c].colDataType = rowGroup->getColTypes()[c];
+      colTypes[c].columnOID = rowGroup->getOIDs()[c];
+      colTypes[c].scale = rowGroup->getScale()[c];
+      colTypes[c].precision = rowGroup->getPrecision()[c];
+    }
+  }
+
+  ti.fetchColumns.resize(num_attr);
+  Field** f = ti.msTablePtr->field;
+
+  for (int p = 0; p < num_attr; p++, f++)
+  {
+    cal_fetch_column& col = ti.fetchColumns[p];
+    col.field = *f;
+    col.colType = colTypes[p];
+    // table mode handling
+    col.position = (tableMode ? col.colType.colPosition : p);
+    col.handler = col.colType.typeHandler();
+    col.skipNullCheck = (col.colType.precision == -16);
+    col.setNullOnNull = (col.colType.colDataType == CalpontSystemCatalog::CHAR ||
+                         col.colType.colDataType == CalpontSystemCatalog::VARCHAR ||
+                         col.colType.colDataType == CalpontSystemCatalog::TEXT ||
+                         col.colType.colDataType == CalpontSystemCatalog::VARBINARY);
+  }
+
+  rowGroup->initRow(&ti.fetchRow);
+  ti.fetchScanCtx = ti.tpl_scan_ctx.get();
+}
+
 int fetchNextRow(uchar* buf, cal_table_info& ti, cal_connection_info* ci, long timeZone,
                  bool handler_flag = false)
 {
   int rc = HA_ERR_END_OF_FILE;
-  int num_attr = ti.msTablePtr->s->fields;
   sm::status_t sm_stat;
 
   try
@@ -319,9 +383,6 @@ int fetchNextRow(uchar* buf, cal_table_info& ti, cal_connection_info* ci, long t
 
   if (sm_stat == sm::STATUS_OK)
   {
-    Field** f;
-    f = ti.msTablePtr->field;
-
     // set all fields to null in null col bitmap
     if (!handler_flag)
       memset(buf, -1, ti.msTablePtr->s->null_bytes);
@@ -330,99 +391,46 @@ int fetchNextRow(uchar* buf, cal_table_info& ti, cal_connection_info* ci, long t
       memset(ti.msTablePtr->null_flags, -1, ti.msTablePtr->s->null_bytes);
     }
 
-    std::vector<CalpontSystemCatalog::ColType>& colTypes = ti.tpl_scan_ctx->ctp;
-
     RowGroup* rowGroup = ti.tpl_scan_ctx->rowGroup;
 
-    // table mode mysql expects all columns of the table. mapping between columnoid and position in rowgroup
-    // set coltype.position to be the position in rowgroup. only set once.
-    if (ti.tpl_scan_ctx->rowsreturned == 0 &&
-        (ti.tpl_scan_ctx->traceFlags & execplan::CalpontSelectExecutionPlan::TRACE_TUPLE_OFF))
-    {
-      for (uint32_t i = 0; i < rowGroup->getColumnCount(); i++)
-      {
-        int oid = rowGroup->getOIDs()[i];
-        int j = 0;
+    if (ti.tpl_scan_ctx->rowsreturned == 0 || ti.fetchScanCtx != ti.tpl_scan_ctx.get())
+      makeFetchPlan(ti, rowGroup);
 
-        for (; j < num_attr; j++)
-        {
-          // mysql should haved eliminated duplicate projection columns
-          if (oid == colTypes[j].columnOID || oid == colTypes[j].ddn.dictOID)
-          {
-            colTypes[j].colPosition = i;
-            break;
-          }
-        }
-      }
-    }
-
-    rowgroup::Row row;
-    rowGroup->initRow(&row);
+    rowgroup::Row& row = ti.fetchRow;
     rowGroup->getRow(ti.tpl_scan_ctx->rowsreturned, &row);
-    int s;
 
-    for (int p = 0; p < num_attr; p++, f++)
+    for (cal_fetch_column& col : ti.fetchColumns)
     {
-      // This col is going to be written
-      bitmap_set_bit(ti.msTablePtr->write_set, (*f)->field_index);
-
-      // get coltype if not there yet
-      if (colTypes[0].colWidth == 0)
-      {
-        for (short c = 0; c < num_attr; c++)
-        {
-          colTypes[c].colPosition = c;
-          colTypes[c].colWidth = rowGroup->getColumnWidth(c);
-          colTypes[c].colDataType = rowGroup->getColTypes()[c];
-          colTypes[c].columnOID = rowGroup->getOIDs()[c];
-          colTypes[c].scale = rowGroup->getScale()[c];
-          colTypes[c].precision = rowGroup->getPrecision()[c];
-        }
-      }
+      Field* f = col.field;
 
-      CalpontSystemCatalog::ColType colType(colTypes[p]);
+      // This col is going to be written
+      bitmap_set_bit(ti.msTablePtr->write_set, f->field_index);
 
-      // table mode handling
-      if (ti.tpl_scan_ctx->traceFlags & execplan::CalpontSelectExecutionPlan::TRACE_TUPLE_OFF)
-      {
-        if (colType.colPosition == -1)  // not projected by tuplejoblist
-          continue;
-        else
-          s = colType.colPosition;
-      }
-      else
-      {
-        s = p;
-      }
+      if (col.position == -1)  // not projected by tuplejoblist
+        continue;
 
-      // precision == -16 is borrowed as skip null check indicator for bit ops.
-      if (row.isNullValue(s) && colType.precision != -16)
+      if (!col.skipNullCheck && row.isNullValue(col.position))
       {
-        // @2835. Handle empty string and null confusion. store empty string for string column
-        if (colType.colDataType == CalpontSystemCatalog::CHAR ||
-            colType.colDataType == CalpontSystemCatalog::VARCHAR ||
-            colType.colDataType == CalpontSystemCatalog::TEXT ||
-            colType.colDataType == CalpontSystemCatalog::VARBINARY)
+        if (col.setNullOnNull)
         {
-          (*f)->reset();
-          (*f)->set_null();
+          f->reset();
+          f->set_null();
         }
 
         continue;
       }
 
-      const datatypes::TypeHandler* h = colType.typeHandler();
-      if (!h)
+      if (!col.handler)
       {
         idbassert(0);
-        (*f)->reset();
-        (*f)->set_null();
+        f->reset();
+        f->set_null();
       }
       else
       {
-        (*f)->set_notnull();
-        datatypes::StoreFieldMariaDB mf(*f, colType, timeZone);
-        h->storeValueToField(row, s, &mf);
+        f->set_notnull();
+        datatypes::StoreFieldMariaDB mf(f, col.colType, timeZone);
+        col.handler->storeValueToField(row, col.position, &mf);
       }
     }
 
@@ -4864,6 +4872,9 @@ int ha_mcs_impl_pushdown_init(mcs_handler_info* handler_info, TABLE* table, bool
 
       csep->traceFlags(ci->traceFlags);
 
+      // RAND(), UUID(), SYSDATE() and the like clear it
+      csep->resultCacheable(thd->lex->safe_to_cache_query);
+
       // cast the handler and get a plan.
       int status = 42;
       if (handler_info->hndl_type == mcs_handler_types_t::SELECT)
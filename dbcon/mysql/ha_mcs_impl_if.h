@@ -212,6 +212,18 @@ struct gp_walk_info
   }
 };
 
+// How fetchNextRow() fills one field of the MariaDB record.  These are worked out once per scan
+// instead of for every field of every row.
+struct cal_fetch_column
+{
+  Field* field;
+  int position;  // the field's column in the rowgroup, -1 if it isn't projected
+  execplan::CalpontSystemCatalog::ColType colType;
+  const datatypes::TypeHandler* handler;
+  bool skipNullCheck;  // precision == -16 is borrowed as skip null check indicator for bit ops
+  bool setNullOnNull;  // @2835. string columns have to be reset to tell null from an empty string
+};
+
 struct cal_table_info
 {
   enum RowSources
@@ -220,7 +232,8 @@ struct cal_table_info
     FROM_FILE
   };
 
-  cal_table_info() : tpl_ctx(0), c(0), msTablePtr(0), conn_hndl(0), condInfo(0), moreRows(false)
+  cal_table_info()
+   : tpl_ctx(0), c(0), msTablePtr(0), conn_hndl(0), condInfo(0), moreRows(false), fetchScanCtx(0)
   {
   }
   ~cal_table_info()
@@ -236,6 +249,10 @@ struct cal_table_info
   gp_walk_info* condInfo;
   execplan::SCSEP csep;
   bool moreRows;  // are there more rows to consume (b/c of limit)
+  // the fetch plan for tpl_scan_ctx, see fetchNextRow()
+  sm::cpsm_tplsch_t* fetchScanCtx;
+  std::vector<cal_fetch_column> fetchColumns;
+  rowgroup::Row fetchRow;
 };
 
 struct cal_group_info
@@ -21,6 +21,7 @@ int is_columnstore_extents_plugin_init(void* p);
 int is_columnstore_files_plugin_init(void* p);
 int is_columnstore_tables_plugin_init(void* p);
 int is_columnstore_columns_plugin_init(void* p);
+int is_columnstore_result_cache_plugin_init(void* p);
 
 class InformationSchemaCond
 {
@@ -0,0 +1,85 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#define PREFER_MY_CONFIG_H
+#include "idb_mysql.h"
+#include <iostream>
+
+#include "bytestream.h"
+#include "messagequeue.h"
+#include "resultcache.h"
+#include "is_columnstore.h"
+
+// Required declaration as it isn't in a MairaDB include
+bool schema_table_store_record(THD* thd, TABLE* table);
+
+ST_FIELD_INFO is_columnstore_result_cache_fields[] = {
+    Show::Column("ENTRIES", Show::ULonglong(0), NOT_NULL),        // 0
+    Show::Column("MEMORY_USED", Show::ULonglong(0), NOT_NULL),    // 1
+    Show::Column("MEMORY_LIMIT", Show::ULonglong(0), NOT_NULL),   // 2
+    Show::Column("HITS", Show::ULonglong(0), NOT_NULL),           // 3
+    Show::Column("MISSES", Show::ULonglong(0), NOT_NULL),         // 4
+    Show::Column("INSERTS", Show::ULonglong(0), NOT_NULL),        // 5
+    Show::Column("EVICTIONS", Show::ULonglong(0), NOT_NULL),      // 6
+    Show::Column("INVALIDATIONS", Show::ULonglong(0), NOT_NULL),  // 7
+    Show::CEnd()};
+
+/* One row with the counters of ExeMgr's ResultCache, in the order ResultCache::serializeStats()
+   sends them. */
+static int is_columnstore_result_cache_fill(THD* thd, TABLE_LIST* tables, COND* cond)
+{
+  TABLE* table = tables->table;
+  messageqcpp::ByteStream msg;
+  messageqcpp::ByteStream::quadbyte qb = RESULT_CACHE_GET_STATS;
+  uint64_t value;
+
+  try
+  {
+    messageqcpp::MessageQueueClient mqc("ExeMgr1");
+    msg << qb;
+    mqc.write(msg);
+    msg = mqc.read();
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 0;
+  }
+
+  // lost the connection to ExeMgr
+  if (msg.length() == 0)
+    return 0;
+
+  for (uint32_t i = 0; i < 8; i++)
+  {
+    msg >> value;
+    table->field[i]->store(value, true);
+  }
+
+  if (schema_table_store_record(thd, table))
+    return 1;
+
+  return 0;
+}
+
+int is_columnstore_result_cache_plugin_init(void* p)
+{
+  ST_SCHEMA_TABLE* schema = (ST_SCHEMA_TABLE*)p;
+  schema->fields_info = is_columnstore_result_cache_fields;
+  schema->fill_table = is_columnstore_result_cache_fill;
+  return 0;
+}
@@ -135,6 +135,8 @@ status_t tpl_scan_fetch_getband(cpsm_conhdl_t* hndl, sp_cpsm_tplsch_t& ntplsch,
       // most normal path. also the path for vtable
       else
       {
+        // the rows of the last band are in bs, see deserializeTable()
+        ntplsch->rgData.clear();
         ntplsch->bs.restart();
         // @bug 2244. Bypass ClientRotator::read() because if I/O error occurs, it tries
         //			to reestablish a connection with ExeMgr which ends up causing mysql
@@ -151,7 +153,7 @@ status_t tpl_scan_fetch_getband(cpsm_conhdl_t* hndl, sp_cpsm_tplsch_t& ntplsch,
 
         if (ntplsch->bs.length() != 0)
         {
-          ntplsch->deserializeTable(ntplsch->bs);
+          ntplsch->deserializeTable(ntplsch->bs, true);
 
           if (ntplsch->rowGroup && ntplsch->rowGroup->getRGData() == NULL)
           {
@@ -176,7 +178,7 @@ status_t tpl_scan_fetch_getband(cpsm_conhdl_t* hndl, sp_cpsm_tplsch_t& ntplsch,
               return logging::ERR_LOST_CONN_EXEMGR;
             }
 
-            ntplsch->deserializeTable(ntplsch->bs);
+            ntplsch->deserializeTable(ntplsch->bs, true);
           }
 
           uint16_t error = ntplsch->getStatus();
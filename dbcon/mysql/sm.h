@@ -154,7 +154,9 @@ struct cpsm_tplsch_t
   std::vector<execplan::CalpontSystemCatalog::ColType> ctp;
   std::string errMsg;
   rowgroup::RGData rgData;
-  void deserializeTable(messageqcpp::ByteStream& bs)
+  // inPlace leaves the row data in bs instead of copying it.  Pass it only for the scan's own bs,
+  // which lives until the next band replaces it.
+  void deserializeTable(messageqcpp::ByteStream& bs, bool inPlace = false)
   {
     if (!rowGroup)
     {
@@ -163,11 +165,13 @@ struct cpsm_tplsch_t
     }
     else
     {
-      // XXXST: the 'true' is to ease the transition to RGDatas.  Take it out when the
-      // transition is done.
-      rgData.deserialize(bs, true);
+      if (inPlace)
+        rgData.deserializeInPlace(bs);
+      else
+        // XXXST: the 'true' is to ease the transition to RGDatas.  Take it out when the
+        // transition is done.
+        rgData.deserialize(bs, true);
       rowGroup->setData(&rgData);
-      // rowGroup->setData(const_cast<uint8_t*>(bs.buf()));
     }
   }
 
@@ -179,7 +183,7 @@ struct cpsm_tplsch_t
 
   uint64_t getRowCount()
   {
-    if (rowGroup)
+    if (rowGroup && rgData.hasRowData())
       return rowGroup->getRowCount();
     else
       return 0;
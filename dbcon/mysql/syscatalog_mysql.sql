@@ -42,6 +42,8 @@ create table if not exists syscolumn (`schema` varchar(128),
                         `maxvalue` varchar(64),
                         compressiontype integer,
                         nextvalue bigint,
-                        charsetnum int not null default 0) engine=columnstore comment='SCHEMA SYNC ONLY';
+                        charsetnum int not null default 0,
+                        sortkey int not null default 0,
+                        indextype int not null default 0) engine=columnstore comment='SCHEMA SYNC ONLY';
 
 DELIMITER ;
@@ -45,6 +45,7 @@ using namespace boost;
 #include "sqllogger.h"
 #include "we_messages.h"
 #include "dmlprocessor.h"
+#include "aggregateprojection.h"
 using namespace BRM;
 using namespace config;
 using namespace execplan;
@@ -665,6 +666,31 @@ void PackageHandler::run()
             // << endl;
             if (tableLockId == 0)
             {
+              // the batch doesn't maintain the aggregate projections of the table
+              try
+              {
+                CalpontSystemCatalog::TableName tableName(insertPkg.get_Table()->get_SchemaName(),
+                                                          insertPkg.get_Table()->get_TableName());
+                AggregateProjection::markStale(tableName, insertPkg.getTableOid());
+              }
+              catch (std::exception& ex)
+              {
+                BRM::TxnID brmTxnID;
+                brmTxnID.id = fTxnid;
+                brmTxnID.valid = true;
+                sessionManager.rolledback(brmTxnID);
+                result.result = DMLPackageProcessor::INSERT_ERROR;
+                logging::Message::Args args;
+                logging::Message message(1);
+                args.add("Insert Failed: ");
+                args.add(ex.what());
+                args.add("");
+                args.add("");
+                message.format(args);
+                result.message = message;
+                break;
+              }
+
               // cout << "Grabing tablelock for batchProcessor " << batchProcessor << endl;
               tableLockId = batchProcessor->grabTableLock(insertPkg.get_SessionID());
 
@@ -145,6 +145,7 @@ class FdEntry
   FdEntry() : oid(0), dbroot(0), partNum(0), segNum(0), fp(0), c(0), inUse(0), compType(0)
   {
     cmpMTime = 0;
+    lastReadEnd = readAheadEnd = 0;
   }
 
   FdEntry(const BRM::OID_t o, const uint16_t d, const uint32_t p, const uint16_t s, const int ct,
@@ -152,6 +153,7 @@ class FdEntry
    : oid(o), dbroot(d), partNum(p), segNum(s), fp(f), c(0), inUse(0), compType(0)
   {
     cmpMTime = 0;
+    lastReadEnd = readAheadEnd = 0;
 
     if (oid >= 1000)
       compType = ct;
@@ -179,6 +181,9 @@ class FdEntry
     return (oid >= 1000 && compType != 0);
   }
   time_t cmpMTime;
+  // file offsets, protected by fdMapMutex.  See issueReadAhead().
+  uint64_t lastReadEnd;
+  uint64_t readAheadEnd;
   friend ostream& operator<<(ostream& out, const FdEntry& o)
   {
     out << " o: " << o.oid << " f: " << o.fp << " d: " << o.dbroot << " p: " << o.partNum
@@ -258,6 +263,71 @@ FdCacheType_t fdcache;
 boost::mutex fdMapMutex;
 rwlock::RWLock_local localLock;
 
+// If the read of [readStart, readEnd) continues a sequential pass over the file, tell the file
+// which bytes will be wanted next so it can start fetching them.  Only StorageManager files act
+// on the hint; there it turns a cold scan of object storage into concurrent downloads instead of one
+// synchronous miss per object.  For compressed files the offsets are those of chunk 'chunk'.
+// The caller must hold a reference (inUse) on fe.
+void issueReadAhead(const SPFdEntry_t& fe, uint64_t readStart, uint64_t readEnd, uint32_t chunk,
+                    uint64_t window)
+{
+  uint64_t hintStart = 0, hintEnd = 0;
+
+  fdMapMutex.lock();
+
+  if (fe->isCompressed())
+  {
+    const CompChunkPtrList& ptrs = fe->ptrList;
+
+    if (chunk >= ptrs.size())
+    {
+      fdMapMutex.unlock();
+      return;
+    }
+
+    readStart = ptrs[chunk].first;
+    readEnd = ptrs[chunk].first + ptrs[chunk].second;
+  }
+
+  bool sequential = (readStart <= fe->lastReadEnd + window && readStart + window >= fe->lastReadEnd);
+
+  if (!sequential)
+  {
+    fe->lastReadEnd = fe->readAheadEnd = readEnd;
+    fdMapMutex.unlock();
+    return;
+  }
+
+  fe->lastReadEnd = std::max(fe->lastReadEnd, readEnd);
+
+  // only send another hint once the scan is halfway through the last one
+  if (fe->readAheadEnd < readEnd + window / 2)
+  {
+    hintStart = std::max(readEnd, fe->readAheadEnd);
+    hintEnd = readEnd + window;
+
+    if (fe->isCompressed())
+    {
+      // round out to whole chunks; stop at the last one
+      const CompChunkPtrList& ptrs = fe->ptrList;
+      uint64_t end = hintStart;
+
+      for (uint32_t k = chunk + 1; k < ptrs.size() && ptrs[k].first < hintEnd; k++)
+        end = ptrs[k].first + ptrs[k].second;
+
+      hintEnd = end;
+    }
+
+    if (hintEnd > hintStart)
+      fe->readAheadEnd = hintEnd;
+  }
+
+  fdMapMutex.unlock();
+
+  if (hintEnd > hintStart)
+    fe->fp->prefetch(hintStart, hintEnd - hintStart);
+}
+
 char* alignTo(const char* in, int av)
 {
   ptrdiff_t inx = reinterpret_cast<ptrdiff_t>(in);
@@ -755,6 +825,8 @@ void* thr_popper(ioManager* arg)
     if (blocksRequested % iom->blocksPerRead)
       jend++;
 
+    const uint64_t readStartOffset = longSeekOffset;
+
     for (j = 0; j < jend; j++)
     {
       int decompRetryCount = 0;
@@ -1131,6 +1203,9 @@ void* thr_popper(ioManager* arg)
 
     }  // for (j...
 
+    if (!errorOccurred && iom->readAheadBytes() > 0 && fdit->second.get())
+      issueReadAhead(fdit->second, readStartOffset, longSeekOffset, cmpOffFact.quot, iom->readAheadBytes());
+
     fdMapMutex.lock();
 
     if (fdit->second.get())
@@ -1291,6 +1366,17 @@ ioManager::ioManager(FileBufferMgr& fbm, fileBlockRequestQueue& fbrq, int thrCou
     FDTraceFile().open(string(MCSLOGDIR) + "/trace/fdcache", ios_base::ate | ios_base::app);
   }
 
+  // how far ahead of a sequential scan to ask the storage layer to fetch.  0 disables it.
+  val = fConfig->getConfig("DBBC", "StorageReadAhead");
+  fReadAheadBytes = 32 * 1024 * 1024;
+
+  if (val.length() > 0)
+    fReadAheadBytes = Config::uFromText(val);
+
+  // only StorageManager files act on the hint; elsewhere it'd be fdMapMutex traffic for nothing
+  if (!IDBPolicy::useCloud())
+    fReadAheadBytes = 0;
+
   fThreadCount = thrCount;
   go();
 }
@@ -101,6 +101,11 @@ class ioManager
     return fFDCacheTrace;
   }
 
+  uint64_t readAheadBytes() const
+  {
+    return fReadAheadBytes;
+  }
+
   void handleBlockReadError(fileRequest* fr, const std::string& errMsg, bool* copyLocked,
                             int errorCode = fileRequest::FAILED);
 
@@ -137,6 +142,7 @@ class ioManager
   uint32_t fDecreaseOpenFilesCount;
   bool fFDCacheTrace;
   std::ofstream fFDTraceFile;
+  uint64_t fReadAheadBytes;
 };
 
 // @bug2631, for remount filesystem by loadBlock() in primitiveserver
@@ -58,6 +58,7 @@ using namespace boost;
 #include "threadnaming.h"
 #include "vlarray.h"
 #include "widedecimalutils.h"
+#include "joinercache.h"
 
 #define MAX64 0x7fffffffffffffffLL
 #define MIN64 0x8000000000000000LL
@@ -338,6 +339,7 @@ void BatchPrimitiveProcessor::initBPP(ByteStream& bs)
 
       joinNullValues.reset(new uint64_t[joinerCount]);
       doMatchNulls.reset(new bool[joinerCount]);
+      cachedJoinerRefs.reset(new CachedJoinerRef[joinerCount]);
       joinFEFilters.reset(new scoped_ptr<FuncExpWrapper>[joinerCount]);
       hasJoinFEFilters = false;
       hasSmallOuterJoin = false;
@@ -346,6 +348,7 @@ void BatchPrimitiveProcessor::initBPP(ByteStream& bs)
       for (i = 0; i < joinerCount; i++)
       {
         doMatchNulls[i] = false;
+        cachedJoinerRefs[i].mode = JOINER_CACHE_NONE;
         uint32_t tmp32;
         bs >> tmp32;
         tJoinerSizes[i] = tmp32;
@@ -367,6 +370,15 @@ void BatchPrimitiveProcessor::initBPP(ByteStream& bs)
         {
           bs >> joinNullValues[i];
           bs >> largeSideKeyColumns[i];
+          bs >> cachedJoinerRefs[i].mode;
+
+          if (cachedJoinerRefs[i].mode != JOINER_CACHE_NONE)
+          {
+            bs >> cachedJoinerRefs[i].owner;
+            bs >> cachedJoinerRefs[i].digest;
+            bs >> cachedJoinerRefs[i].generation;
+          }
+
           for (uint j = 0; j < processorThreads; ++j)
             tJoiners[i][j].reset(new TJoiner(10, TupleJoiner::hasher()));
         }
@@ -536,6 +548,8 @@ void BatchPrimitiveProcessor::resetBPP(ByteStream& bs, const SP_UM_MUTEX& w, con
   // skip the header, sessionID, stepID, uniqueID, and priority
   bs.advance(sizeof(ISMPacketHeader) + 16);
   bs >> weight_;
+  // the scanned LBID is only for PrimitiveServer's job routing
+  bs.advance(sizeof(uint64_t));
   bs >> dbRoot;
   bs >> count;
   uint8_t u8 = 0;
@@ -628,6 +642,10 @@ void BatchPrimitiveProcessor::addToJoiner(ByteStream& bs)
     arr = (JoinerElements*)bs.buf();
 
     std::atomic<uint32_t>& tJoinerSize = tJoinerSizes[joinerNum];
+    // Semi & anti joins w/o a function expression only probe for existence; one row per key is enough
+    bool distinctKeys =
+        (joinTypes[joinerNum] & (SEMI | ANTI)) && !(joinTypes[joinerNum] & (SCALAR | WITHFCNEXP));
+    uint32_t skipped = 0;
 
     // XXXPAT: enormous if stmts are evil.  TODO: move each block into
     // properly-named functions for clarity.
@@ -681,7 +699,13 @@ void BatchPrimitiveProcessor::addToJoiner(ByteStream& bs)
               continue;
             }
             for (auto& element : tmpBuckets[i])
-              tlJoiners[joinerNum][i]->insert(element);
+            {
+              TLJoiner& table = *tlJoiners[joinerNum][i];
+              if (distinctKeys && table.find(element.first) != table.end())
+                ++skipped;
+              else
+                table.insert(element);
+            }
             addToJoinerLocks[joinerNum][i].unlock();
             tmpBuckets[i].clear();
             didSomeWork = true;
@@ -737,7 +761,13 @@ void BatchPrimitiveProcessor::addToJoiner(ByteStream& bs)
                 continue;
               }
               for (auto& element : tmpBuckets[i])
-                tJoiners[joinerNum][i]->insert(element);
+              {
+                TJoiner& table = *tJoiners[joinerNum][i];
+                if (distinctKeys && table.find(element.first) != table.end())
+                  ++skipped;
+                else
+                  table.insert(element);
+              }
               addToJoinerLocks[joinerNum][i].unlock();
               tmpBuckets[i].clear();
               didSomeWork = true;
@@ -783,7 +813,13 @@ void BatchPrimitiveProcessor::addToJoiner(ByteStream& bs)
                 continue;
               }
               for (auto& element : tmpBuckets[i])
-                tJoiners[joinerNum][i]->insert(element);
+              {
+                TJoiner& table = *tJoiners[joinerNum][i];
+                if (distinctKeys && table.find(element.first) != table.end())
+                  ++skipped;
+                else
+                  table.insert(element);
+              }
               addToJoinerLocks[joinerNum][i].unlock();
               tmpBuckets[i].clear();
               didSomeWork = true;
@@ -802,6 +838,9 @@ void BatchPrimitiveProcessor::addToJoiner(ByteStream& bs)
       }
     }
 
+    // endOfJoiner() compares the table sizes to tJoinerSize
+    tJoinerSize -= skipped;
+
     if (!typelessJoin[joinerNum])
       bs.advance(count * sizeof(JoinerElements));
 
@@ -852,6 +891,9 @@ int BatchPrimitiveProcessor::endOfJoiner()
   {
     if (!typelessJoin[i])
     {
+      if (cachedJoinerRefs[i].mode == JOINER_CACHE_USE)
+        useCachedJoiner(i);
+
       currentSize = 0;
       for (uint j = 0; j < processorThreads; ++j)
         if (!tJoiners[i] || !tJoiners[i][j])
@@ -884,12 +926,71 @@ int BatchPrimitiveProcessor::endOfJoiner()
     }
   }
 
+  storeCachedJoiners();
   endOfJoinerRan = true;
 
   pthread_mutex_unlock(&objLock);
   return 0;
 }
 
+void BatchPrimitiveProcessor::useCachedJoiner(uint32_t joinerNum)
+{
+  CachedJoinerRef& ref = cachedJoinerRefs[joinerNum];
+  JoinerCache::Entry entry;
+
+  ref.mode = JOINER_CACHE_NONE;
+
+  /* The table was dropped to make room, or PrimProc restarted since it was stored.  ExeMgr is told,
+     and sends it the way it does when nothing is cached. */
+  if (!JoinerCache::instance()->find(ref.owner, ref.digest, entry) ||
+      entry.partitionCount != processorThreads)
+  {
+    missedJoiners.push_back(joinerNum);
+    return;
+  }
+
+  tJoiners[joinerNum] = entry.tables;
+  tJoinerSizes[joinerNum] = entry.size;
+  doMatchNulls[joinerNum] = entry.matchNulls;
+}
+
+void BatchPrimitiveProcessor::storeCachedJoiners()
+{
+  for (uint32_t i = 0; i < joinerCount; i++)
+  {
+    CachedJoinerRef& ref = cachedJoinerRefs[i];
+
+    if (typelessJoin[i] || ref.mode != JOINER_CACHE_STORE)
+      continue;
+
+    // the tables aren't modified after this point, the queries that use them only read them
+    JoinerCache::Entry entry;
+    entry.tables = tJoiners[i];
+    entry.partitionCount = processorThreads;
+    entry.size = tJoinerSizes[i];
+    entry.matchNulls = doMatchNulls[i];
+    entry.generation = ref.generation;
+
+    // ExeMgr doesn't have later queries use a table that didn't fit
+    if (JoinerCache::instance()->insert(ref.owner, ref.digest, entry))
+      storedJoiners.push_back(std::make_pair(ref.digest, ref.generation));
+
+    ref.mode = JOINER_CACHE_NONE;
+  }
+}
+
+void BatchPrimitiveProcessor::getStoredJoiners(vector<pair<uint64_t, uint64_t> >& stored)
+{
+  stored.insert(stored.end(), storedJoiners.begin(), storedJoiners.end());
+  storedJoiners.clear();
+}
+
+void BatchPrimitiveProcessor::getMissedJoiners(vector<uint32_t>& missed)
+{
+  missed.insert(missed.end(), missedJoiners.begin(), missedJoiners.end());
+  missedJoiners.clear();
+}
+
 void BatchPrimitiveProcessor::initProcessor()
 {
   uint32_t i, j;
@@ -934,6 +1035,14 @@ void BatchPrimitiveProcessor::initProcessor()
       tSmallSideMatches.reset(new MatchedData[joinerCount]);
       keyColumnProj.reset(new bool[projectCount]);
 
+      joinerProbeOrder.resize(joinerCount);
+      for (i = 0; i < joinerCount; i++)
+        joinerProbeOrder[i] = i;
+      joinerRejectCounts.assign(joinerCount, 0);
+      tProbeRanges.reset(new pair<TJoiner::iterator, TJoiner::iterator>[joinerCount]);
+      tlProbeRanges.reset(new pair<TLJoiner::iterator, TLJoiner::iterator>[joinerCount]);
+      probeRangeValid.reset(new bool[joinerCount]);
+
       for (i = 0; i < projectCount; i++)
       {
         keyColumnProj[i] = false;
@@ -1131,13 +1240,21 @@ void BatchPrimitiveProcessor::initProcessor()
   asyncLoaded.reset(new bool[projectCount + 2]);
 }
 
+// Star joins: a large-side row is rejected as soon as one joiner has no match for it, so the joiners
+// that reject the most rows are probed first.
+void BatchPrimitiveProcessor::orderJoinerProbes()
+{
+  std::stable_sort(joinerProbeOrder.begin(), joinerProbeOrder.end(),
+                   [this](uint32_t a, uint32_t b) { return joinerRejectCounts[a] > joinerRejectCounts[b]; });
+}
+
 // This version does a join on projected rows
 // In order to prevent super size result sets in the case of near cartesian joins on three or more joins,
 // the startRid start at 0) is used to begin the rid loop and if we cut off processing early because of
 // the size of the result set, we return the next rid to start with. If we finish ridCount rids, return 0-
 uint32_t BatchPrimitiveProcessor::executeTupleJoin(uint32_t startRid, RowGroup& largeSideRowGroup)
 {
-  uint32_t newRowCount = 0, i, j;
+  uint32_t newRowCount = 0, i, j, p;
   vector<uint32_t> matches;
   uint64_t largeKey;
   uint64_t resultCount = 0;
@@ -1145,6 +1262,9 @@ uint32_t BatchPrimitiveProcessor::executeTupleJoin(uint32_t startRid, RowGroup&
   largeSideRowGroup.getRow(startRid, &oldRow);
   outputRG.getRow(0, &newRow);
 
+  if (joinerCount > 1)
+    orderJoinerProbes();
+
   // ridCount gets modified based on the number of Rids actually processed during this call.
   // origRidCount is the number of rids for this thread after filter, which are the total
   // number of rids to be processed from all calls to this function during this thread.
@@ -1161,9 +1281,11 @@ uint32_t BatchPrimitiveProcessor::executeTupleJoin(uint32_t startRid, RowGroup&
      * 		  are NULL values to match against, but there is no filter, all rows can be eliminated.
      */
 
-    for (j = 0; j < joinerCount; j++)
+    for (p = 0; p < joinerCount; p++)
     {
       bool found;
+      j = joinerProbeOrder[p];
+      probeRangeValid[j] = false;
 
       if (UNLIKELY(joinTypes[j] & ANTI))
       {
@@ -1186,8 +1308,11 @@ uint32_t BatchPrimitiveProcessor::executeTupleJoin(uint32_t startRid, RowGroup&
 
         bool joinerIsEmpty = tJoiners[j][bucket]->empty() ? true : false;
 
-        found = (tJoiners[j][bucket]->find(largeKey) != tJoiners[j][bucket]->end());
+        tProbeRanges[j] = tJoiners[j][bucket]->equal_range(largeKey);
+        found = (tProbeRanges[j].first != tProbeRanges[j].second);
         isNull = oldRow.isNullValue(colIndex);
+        // getJoinResults() doesn't look a NULL key up
+        probeRangeValid[j] = !isNull;
         /* These conditions define when the row is NOT in the result set:
          *    - if the key is not in the small side, and the join isn't a large-outer or anti join
          *    - if the key is NULL, and the join isn't anti- or large-outer
@@ -1208,7 +1333,9 @@ uint32_t BatchPrimitiveProcessor::executeTupleJoin(uint32_t startRid, RowGroup&
         uint bucket = oldRow.hashTypeless(tlLargeSideKeyColumns[j], mSmallSideKeyColumnsPtr,
                                           mSmallSideRGPtr ? &mSmallSideRGPtr->getColWidths() : nullptr) &
                       ptMask;
-        found = tlJoiners[j][bucket]->find(tlLargeKey) != tlJoiners[j][bucket]->end();
+        tlProbeRanges[j] = tlJoiners[j][bucket]->equal_range(tlLargeKey);
+        found = (tlProbeRanges[j].first != tlProbeRanges[j].second);
+        probeRangeValid[j] = true;
 
         if ((!found && !(joinTypes[j] & (LARGEOUTER | ANTI))) || (joinTypes[j] & ANTI))
         {
@@ -1244,7 +1371,11 @@ uint32_t BatchPrimitiveProcessor::executeTupleJoin(uint32_t startRid, RowGroup&
       }
     }
 
-    if (j == joinerCount)
+    if (p < joinerCount)
+    {
+      joinerRejectCounts[j]++;
+    }
+    else
     {
       uint32_t matchCount;
       for (j = 0; j < joinerCount; j++)
@@ -1322,9 +1453,15 @@ uint32_t BatchPrimitiveProcessor::executeTupleJoin(uint32_t startRid, RowGroup&
           }
         }
 
-        /* For all join types, no matches here means it's not in the result */
+        /* For all join types, no matches here means it's not in the result.  Drop the matches
+           collected for the previous joiners, the next row reuses this slot. */
         if (matchCount == 0)
+        {
+          for (uint32_t z = 0; z < j; z++)
+            tSmallSideMatches[z][newRowCount].clear();
+
           break;
+        }
 
         /* Pair non-scalar semi-joins with a NULL row */
         if ((joinTypes[j] & SEMI) && !(joinTypes[j] & SCALAR))
@@ -2674,20 +2811,29 @@ inline void BatchPrimitiveProcessor::getJoinResults(const Row& r, uint32_t jInde
         return;
     }
 
-    uint64_t largeKey;
-    uint32_t colIndex = largeSideKeyColumns[jIndex];
+    pair<TJoiner::iterator, TJoiner::iterator> range;
 
-    if (r.isUnsigned(colIndex))
-    {
-      largeKey = r.getUintField(colIndex);
-    }
+    // executeTupleJoin() has already probed this joiner
+    if (probeRangeValid[jIndex])
+      range = tProbeRanges[jIndex];
     else
     {
-      largeKey = r.getIntField(colIndex);
+      uint64_t largeKey;
+      uint32_t colIndex = largeSideKeyColumns[jIndex];
+
+      if (r.isUnsigned(colIndex))
+      {
+        largeKey = r.getUintField(colIndex);
+      }
+      else
+      {
+        largeKey = r.getIntField(colIndex);
+      }
+
+      bucket = bucketPicker((char*)&largeKey, 8, bpSeed) & ptMask;
+      range = tJoiners[jIndex][bucket]->equal_range(largeKey);
     }
 
-    bucket = bucketPicker((char*)&largeKey, 8, bpSeed) & ptMask;
-    pair<TJoiner::iterator, TJoiner::iterator> range = tJoiners[jIndex][bucket]->equal_range(largeKey);
     for (; range.first != range.second; ++range.first)
       v.push_back(range.first->second);
 
@@ -2724,11 +2870,19 @@ inline void BatchPrimitiveProcessor::getJoinResults(const Row& r, uint32_t jInde
       }
     }
 
-    TypelessData largeKey(&r);
-    bucket = r.hashTypeless(tlLargeSideKeyColumns[jIndex], mSmallSideKeyColumnsPtr,
-                            mSmallSideRGPtr ? &mSmallSideRGPtr->getColWidths() : nullptr) &
-             ptMask;
-    pair<TLJoiner::iterator, TLJoiner::iterator> range = tlJoiners[jIndex][bucket]->equal_range(largeKey);
+    pair<TLJoiner::iterator, TLJoiner::iterator> range;
+
+    if (probeRangeValid[jIndex])
+      range = tlProbeRanges[jIndex];
+    else
+    {
+      TypelessData largeKey(&r);
+      bucket = r.hashTypeless(tlLargeSideKeyColumns[jIndex], mSmallSideKeyColumnsPtr,
+                              mSmallSideRGPtr ? &mSmallSideRGPtr->getColWidths() : nullptr) &
+               ptMask;
+      range = tlJoiners[jIndex][bucket]->equal_range(largeKey);
+    }
+
     for (; range.first != range.second; ++range.first)
       v.push_back(range.first->second);
   }
@@ -86,6 +86,12 @@ class NeedToRestartJob : public std::runtime_error
 class BatchPrimitiveProcessor
 {
  public:
+  // the hash tables of integer PM joins, also held by JoinerCache
+  typedef std::tr1::unordered_multimap<uint64_t, uint32_t, joiner::TupleJoiner::hasher,
+                                       std::equal_to<uint64_t>,
+                                       utils::STLPoolAllocator<std::pair<const uint64_t, uint32_t>>>
+      TJoiner;
+
   BatchPrimitiveProcessor(messageqcpp::ByteStream&, double prefetchThresh, boost::shared_ptr<BPPSendThread>,
                           uint processorThreads);
 
@@ -96,6 +102,10 @@ class BatchPrimitiveProcessor
   void resetBPP(messageqcpp::ByteStream&, const SP_UM_MUTEX& wLock, const SP_UM_IOSOCK& outputSock);
   void addToJoiner(messageqcpp::ByteStream&);
   int endOfJoiner();
+  // the digest & generation of the tables endOfJoiner() put in the JoinerCache since the last call
+  void getStoredJoiners(std::vector<std::pair<uint64_t, uint64_t> >& stored);
+  // the joiners endOfJoiner() didn't find in the JoinerCache since the last call
+  void getMissedJoiners(std::vector<uint32_t>& missed);
   int operator()();
   void setLBIDForScan(uint64_t rid);
 
@@ -308,11 +318,6 @@ class BatchPrimitiveProcessor
   bool hasRowGroup;
 
   /* Rowgroups + join */
-  typedef std::tr1::unordered_multimap<uint64_t, uint32_t, joiner::TupleJoiner::hasher,
-                                       std::equal_to<uint64_t>,
-                                       utils::STLPoolAllocator<std::pair<const uint64_t, uint32_t>>>
-      TJoiner;
-
   typedef std::tr1::unordered_multimap<
       joiner::TypelessData, uint32_t, joiner::TupleJoiner::TypelessDataHasher,
       joiner::TupleJoiner::TypelessDataComparator,
@@ -370,9 +375,33 @@ class BatchPrimitiveProcessor
   const std::vector<uint32_t>* mSmallSideKeyColumnsPtr;
 
   inline void getJoinResults(const rowgroup::Row& r, uint32_t jIndex, std::vector<uint32_t>& v);
+
+  /* star join probing.  The first pass of executeTupleJoin() probes the joiners starting with the
+     ones that reject the most large-side rows, and keeps the matched ranges so getJoinResults()
+     doesn't have to probe again. */
+  void orderJoinerProbes();
+  std::vector<uint32_t> joinerProbeOrder;
+  std::vector<uint64_t> joinerRejectCounts;
+  boost::scoped_array<std::pair<TJoiner::iterator, TJoiner::iterator>> tProbeRanges;
+  boost::scoped_array<std::pair<TLJoiner::iterator, TLJoiner::iterator>> tlProbeRanges;
+  boost::scoped_array<bool> probeRangeValid;
   // these allocators hold the memory for the keys stored in tlJoiners
   std::shared_ptr<utils::PoolAllocator[]> storedKeyAllocators;
 
+  /* PrimProc's joiner cache.  The tables of integer joins can come from or go to the JoinerCache. */
+  struct CachedJoinerRef
+  {
+    uint8_t mode;  // a JoinerCacheMode
+    uint32_t owner;
+    uint64_t digest;
+    uint64_t generation;
+  };
+  boost::scoped_array<CachedJoinerRef> cachedJoinerRefs;
+  std::vector<std::pair<uint64_t, uint64_t> > storedJoiners;
+  std::vector<uint32_t> missedJoiners;
+  void useCachedJoiner(uint32_t joinerNum);
+  void storeCachedJoiners();
+
   /* PM Aggregation */
   rowgroup::RowGroup joinedRG;  // if there's a join, the rows are formatted with this
   rowgroup::SP_ROWAGG_PM_t fAggregator;
@@ -53,7 +53,17 @@ namespace primitiveprocessor
 {
 extern int noVB;
 
-ColumnCommand::ColumnCommand() : Command(COLUMN_COMMAND), blockCount(0), loadCount(0), suppressFilter(false)
+ColumnCommand::ColumnCommand()
+ : Command(COLUMN_COMMAND)
+ , blockCount(0)
+ , loadCount(0)
+ , suppressFilter(false)
+ , columnIndexFile(0)
+ , columnIndexDbRoot(0)
+ , columnIndexLooked(false)
+ , bloomFiltersExtent(0)
+ , bloomFiltersDbRoot(0)
+ , bloomFiltersLooked(false)
 {
 }
 
@@ -68,6 +78,44 @@ ColumnCommand::~ColumnCommand()
 
 void ColumnCommand::_execute()
 {
+  if (_isScan && !indexKeys.empty() && !suppressFilter && fFilterFeeder == NOT_FEEDER)
+  {
+    // no row of the block can match the filter values, don't read it
+    if ((colType.indexType & execplan::CalpontSystemCatalog::BLOOM_FILTER) && bloomFiltersRuleOut())
+    {
+      bpp->ridCount = 0;
+      blockCount += colType.colWidth;
+      return;
+    }
+
+    // read just the rows the index has for the filter values, like a step does
+    if ((colType.indexType & execplan::CalpontSystemCatalog::INVERTED_INDEX) && lookupIndex())
+    {
+      if (bpp->ridCount == 0)
+      {
+        blockCount += colType.colWidth;
+        return;
+      }
+
+      makeStepMsg();
+      _isScan = false;
+
+      try
+      {
+        issuePrimitive();
+      }
+      catch (...)
+      {
+        _isScan = true;
+        throw;
+      }
+
+      _isScan = true;
+      processResult();
+      return;
+    }
+  }
+
   if (_isScan)
     makeScanMsg();
   else if (bpp->ridCount == 0)  // this would cause a scan
@@ -141,6 +189,111 @@ void ColumnCommand::makeStepMsg()
   // 	cout << "lbid is " << lbid << endl;
 }
 
+// Set the rows of the logical block that can match the = or IN filter to the ones the inverted
+// index of its segment file has for the filter values, if the file has an index covering the
+// block.  The index only grows, so the rows still go through the filter.
+bool ColumnCommand::lookupIndex()
+{
+  uint64_t file = bpp->baseRid >> 16;
+
+  if (!columnIndexLooked || file != columnIndexFile || bpp->dbRoot != columnIndexDbRoot)
+  {
+    uint32_t partNum;
+    uint16_t segNum;
+    rowgroup::getLocationFromRid(bpp->baseRid, &partNum, &segNum, NULL, NULL);
+    columnIndex = ColumnIndexCache::instance()->find(getOID(), bpp->dbRoot, partNum, segNum);
+    columnIndexFile = file;
+    columnIndexDbRoot = bpp->dbRoot;
+    columnIndexLooked = true;
+  }
+
+  uint64_t firstRow = rowgroup::getFileRelativeRid(bpp->baseRid);
+
+  if (!columnIndex || columnIndex->coveredRows() < firstRow + LOGICAL_BLOCK_RIDS)
+    return false;
+
+  // rows past the last block of the column are empty and a scan doesn't read them
+  uint32_t rowLimit = LOGICAL_BLOCK_RIDS;
+  int64_t oidLastLbid = getLastLbid();
+
+  if (oidLastLbid >= (int64_t)lbid && oidLastLbid < (int64_t)(lbid + colType.colWidth))
+    rowLimit = (oidLastLbid - lbid + 1) * (BLOCK_SIZE / colType.colWidth);
+
+  indexRows.resize(LOGICAL_BLOCK_RIDS);
+  uint64_t found[LOGICAL_BLOCK_RIDS / 64] = {0};
+
+  for (uint64_t key : indexKeys)
+  {
+    const WriteEngine::RowIdSet* rows = columnIndex->find(key);
+
+    if (!rows)
+      continue;
+
+    uint32_t count = rows->getRange(firstRow, LOGICAL_BLOCK_RIDS, &indexRows[0]);
+
+    for (uint32_t i = 0; i < count; i++)
+      found[indexRows[i] >> 6] |= 1ULL << (indexRows[i] & 63);
+  }
+
+  bpp->ridCount = 0;
+  bpp->ridMap = 0;
+
+  for (uint32_t word = 0; word < LOGICAL_BLOCK_RIDS / 64; word++)
+  {
+    for (uint64_t bits = found[word]; bits != 0; bits &= bits - 1)
+    {
+      uint16_t relRid = word * 64 + __builtin_ctzll(bits);
+
+      if (relRid >= rowLimit)
+        break;
+
+      bpp->relRids[bpp->ridCount++] = relRid;
+      bpp->ridMap |= 1 << (relRid >> 9);
+    }
+  }
+
+  return true;
+}
+
+// Whether the bloom filter the extent of the logical block has for it rules out all the values of
+// the = or IN filter, so none of its rows can match.  A block without a filter can have any value.
+bool ColumnCommand::bloomFiltersRuleOut()
+{
+  uint64_t extent = bpp->baseRid >> 10;
+
+  if (!bloomFiltersLooked || extent != bloomFiltersExtent || bpp->dbRoot != bloomFiltersDbRoot)
+  {
+    uint32_t partNum;
+    uint16_t segNum;
+    uint8_t extentNum;
+    rowgroup::getLocationFromRid(bpp->baseRid, &partNum, &segNum, &extentNum, NULL);
+    bloomFilters =
+        ColumnIndexCache::instance()->findBloomFilters(getOID(), bpp->dbRoot, partNum, segNum, extentNum);
+    bloomFiltersExtent = extent;
+    bloomFiltersDbRoot = bpp->dbRoot;
+    bloomFiltersLooked = true;
+  }
+
+  if (!bloomFilters)
+    return false;
+
+  static_assert(WriteEngine::BlockBloomFilters::ROWS_PER_FILTER == LOGICAL_BLOCK_RIDS,
+                "a bloom filter is kept for each logical block");
+  const WriteEngine::BloomFilter* filter =
+      bloomFilters->find(rowgroup::getFileRelativeRid(bpp->baseRid) / LOGICAL_BLOCK_RIDS);
+
+  if (!filter)
+    return false;
+
+  for (uint64_t key : indexKeys)
+  {
+    if (filter->mayContain(key))
+      return false;
+  }
+
+  return true;
+}
+
 template <int W>
 void ColumnCommand::_loadData()
 {
@@ -539,6 +692,7 @@ void ColumnCommand::createCommand(ByteStream& bs)
   bs >> filterCount;
   bs >> tmp8;
   hasAuxCol_ = tmp8;
+  bs >> (uint32_t&)colType.indexType;
   deserializeInlineVector(bs, lastLbid);
 
   Command::createCommand(bs);
@@ -573,6 +727,7 @@ void ColumnCommand::createCommand(execplan::CalpontSystemCatalog::ColType& aColT
   bs >> filterCount;
   bs >> tmp8;
   hasAuxCol_ = tmp8;
+  bs >> (uint32_t&)colType.indexType;
   deserializeInlineVector(bs, lastLbid);
 
   Command::createCommand(bs);
@@ -859,11 +1014,13 @@ void ColumnCommand::duplicate(ColumnCommand* cc)
   cc->colType.compressionType = colType.compressionType;
   cc->colType.colWidth = colType.colWidth;
   cc->colType.charsetNumber = colType.charsetNumber;
+  cc->colType.indexType = colType.indexType;
   cc->BOP = BOP;
   cc->filterCount = filterCount;
   cc->fFilterFeeder = fFilterFeeder;
   cc->parsedColumnFilter = parsedColumnFilter;
   cc->suppressFilter = suppressFilter;
+  cc->indexKeys = indexKeys;
   cc->lastLbid = lastLbid;
   cc->r = r;
   cc->rowSize = rowSize;
@@ -922,11 +1079,13 @@ ColumnCommand& ColumnCommand::operator=(const ColumnCommand& c)
   colType.colDataType = c.colType.colDataType;
   colType.compressionType = c.colType.compressionType;
   colType.colWidth = c.colType.colWidth;
+  colType.indexType = c.colType.indexType;
   BOP = c.BOP;
   filterCount = c.filterCount;
   fFilterFeeder = c.fFilterFeeder;
   parsedColumnFilter = c.parsedColumnFilter;
   suppressFilter = c.suppressFilter;
+  indexKeys = c.indexKeys;
   lastLbid = c.lastLbid;
   return *this;
 }
@@ -1005,6 +1164,29 @@ void ColumnCommand::createColumnFilter()
       primitives::_parseColumnFilter<T>(filterString.buf(), colType.colDataType, filterCount, BOP);
   /* OR hack */
   emptyFilter = primitives::_parseColumnFilter<T>(filterString.buf(), colType.colDataType, 0, BOP);
+
+  // an = or IN filter on a type the inverted index and bloom filters keep can look its values up there
+  indexKeys.clear();
+
+  if (colType.indexType != execplan::CalpontSystemCatalog::NO_COLUMN_INDEX && sizeof(T) <= 8 &&
+      filterCount > 0 && (filterCount == 1 || BOP == BOP_OR) &&
+      WriteEngine::ColumnIndex::isIndexable(colType.colDataType, colType.colWidth, colType.charsetNumber))
+  {
+    const uint32_t filterSize = sizeof(uint8_t) + sizeof(uint8_t) + sizeof(T);
+
+    for (uint32_t i = 0; i < filterCount; i++)
+    {
+      auto args = reinterpret_cast<const ColArgs*>(filterString.buf() + i * filterSize);
+
+      if (args->COP != COMPARE_EQ || args->rf != 0)
+      {
+        indexKeys.clear();
+        break;
+      }
+
+      indexKeys.push_back(WriteEngine::ColumnIndex::key(args->val, sizeof(T)));
+    }
+  }
 }
 
 ColumnCommand* ColumnCommandFabric::duplicate(const ColumnCommandUniquePtr& rhs)
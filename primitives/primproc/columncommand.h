@@ -34,6 +34,7 @@
 #include "columnwidth.h"
 #include "command.h"
 #include "calpontsystemcatalog.h"
+#include "columnindexcache.h"
 
 namespace primitiveprocessor
 {
@@ -160,6 +161,8 @@ class ColumnCommand : public Command
   void removeRowsFromRowGroup(rowgroup::RowGroup&);
   void makeScanMsg();
   void makeStepMsg();
+  bool lookupIndex();
+  bool bloomFiltersRuleOut();
   void setLBID(uint64_t rid);
   template <typename T>
   inline void fillEmptyBlock(uint8_t* dst, const uint8_t* emptyValue, const uint32_t number) const;
@@ -196,6 +199,20 @@ class ColumnCommand : public Command
   boost::shared_ptr<primitives::ParsedColumnFilter> emptyFilter;
   bool suppressFilter;
 
+  /* inverted index lookups, see lookupIndex() */
+  std::vector<uint64_t> indexKeys;  // the values of an = or IN filter as index and bloom filter keys
+  ColumnIndexCache::Index columnIndex;  // the index of the segment file of the last block
+  uint64_t columnIndexFile;             // its partition and segment, as in a base rid
+  uint32_t columnIndexDbRoot;
+  bool columnIndexLooked;
+  std::vector<uint16_t> indexRows;  // scratch for the rows of a key
+
+  /* bloom filter checks, see bloomFiltersRuleOut() */
+  ColumnIndexCache::BloomFilters bloomFilters;  // the filters of the extent of the last block
+  uint64_t bloomFiltersExtent;                  // its partition, segment and extent, as in a base rid
+  uint32_t bloomFiltersDbRoot;
+  bool bloomFiltersLooked;
+
   std::vector<uint64_t> lastLbid;
 
   /* speculative optimizations for projectintorowgroup() */
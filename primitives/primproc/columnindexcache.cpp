@@ -0,0 +1,194 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include "columnindexcache.h"
+#include "IDBPolicy.h"
+
+using namespace std;
+using namespace WriteEngine;
+
+namespace primitiveprocessor
+{
+ColumnIndexCache* ColumnIndexCache::instance()
+{
+  static ColumnIndexCache cache;
+  return &cache;
+}
+
+ColumnIndexCache::ColumnIndexCache() : size(0), maxSize(256 * 1024 * 1024), generation(0), fileOp(false)
+{
+}
+
+void ColumnIndexCache::setMaxSize(uint64_t s)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  maxSize = s;
+
+  while (size > maxSize)
+    evict();
+}
+
+ColumnIndexCache::Index ColumnIndexCache::find(uint32_t oid, uint16_t dbRoot, uint32_t partition,
+                                               uint16_t segment)
+{
+  return findEntry(entries, Key(oid, dbRoot, partition, segment),
+                   [](WriteEngine::ColumnIndex& index, const char* fileName)
+                   { return index.read(fileName, idbdatafile::IDBPolicy::PRIMPROC); });
+}
+
+ColumnIndexCache::BloomFilters ColumnIndexCache::findBloomFilters(uint32_t oid, uint16_t dbRoot,
+                                                                  uint32_t partition, uint16_t segment,
+                                                                  uint16_t extent)
+{
+  // the filters of the 1024 logical blocks of an extent, as a base rid numbers them
+  const uint64_t extentBlocks = 1 << 10;
+
+  return findEntry(bloomEntries, BloomKey(oid, dbRoot, partition, segment, extent),
+                   [extent, extentBlocks](WriteEngine::BlockBloomFilters& filters, const char* fileName)
+                   {
+                     return filters.read(fileName, extent * extentBlocks, extentBlocks,
+                                         idbdatafile::IDBPolicy::PRIMPROC);
+                   });
+}
+
+/* static */
+ColumnIndexCache::Lru::value_type ColumnIndexCache::lruKey(const Key& key)
+{
+  return make_pair(false, BloomKey(get<0>(key), get<1>(key), get<2>(key), get<3>(key), 0));
+}
+
+/* static */
+ColumnIndexCache::Lru::value_type ColumnIndexCache::lruKey(const BloomKey& key)
+{
+  return make_pair(true, key);
+}
+
+template <typename T, typename K, typename Read>
+std::shared_ptr<const T> ColumnIndexCache::findEntry(std::map<K, Entry<T> >& map, const K& key, Read read)
+{
+  uint64_t readGeneration;
+
+  {
+    boost::mutex::scoped_lock lk(mutex);
+    auto it = map.find(key);
+
+    if (it != map.end())
+    {
+      lru.splice(lru.begin(), lru, it->second.lru);
+      return it->second.value;
+    }
+
+    readGeneration = generation;
+  }
+
+  // read it unlocked; other threads may read it too, the last one keeps it
+  char fileName[WriteEngine::FILE_NAME_SIZE];
+  fileOp.getFileNameForPrimProc(std::get<0>(key), fileName, std::get<1>(key), std::get<2>(key),
+                                std::get<3>(key));
+
+  std::shared_ptr<T> entry(new T());
+  uint64_t entrySize = sizeof(K);
+
+  if (read(*entry, fileName) == NO_ERROR)
+    entrySize += entry->memorySize();
+  else
+    entry.reset();
+
+  boost::mutex::scoped_lock lk(mutex);
+
+  if (readGeneration == generation && entrySize <= maxSize && map.find(key) == map.end())
+  {
+    while (size + entrySize > maxSize)
+      evict();
+
+    lru.push_front(lruKey(key));
+    map.insert(make_pair(key, Entry<T>{entry, entrySize, lru.begin()}));
+    size += entrySize;
+  }
+
+  return entry;
+}
+
+// The mutex has to be locked for these.
+template <typename T, typename K>
+typename std::map<K, ColumnIndexCache::Entry<T> >::iterator ColumnIndexCache::eraseEntry(
+    std::map<K, Entry<T> >& map, typename std::map<K, Entry<T> >::iterator it)
+{
+  size -= it->second.size;
+  lru.erase(it->second.lru);
+  return map.erase(it);
+}
+
+// Drop the entries from first on while match(key)
+template <typename T, typename K, typename Match>
+void ColumnIndexCache::eraseEntries(std::map<K, Entry<T> >& map, const K& first, Match match)
+{
+  auto it = map.lower_bound(first);
+
+  while (it != map.end() && match(it->first))
+    it = eraseEntry(map, it);
+}
+
+// Drop the least recently used entry
+void ColumnIndexCache::evict()
+{
+  const BloomKey& key = lru.back().second;
+
+  if (lru.back().first)
+    eraseEntry(bloomEntries, bloomEntries.find(key));
+  else
+    eraseEntry(entries, entries.find(Key(get<0>(key), get<1>(key), get<2>(key), get<3>(key))));
+}
+
+void ColumnIndexCache::erase(uint32_t oid, uint16_t dbRoot, uint32_t partition, uint16_t segment)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  Key file(oid, dbRoot, partition, segment);
+
+  eraseEntries(entries, file, [&file](const Key& key) { return key == file; });
+  eraseEntries(bloomEntries, BloomKey(oid, dbRoot, partition, segment, 0),
+               [&](const BloomKey& key)
+               {
+                 return std::get<0>(key) == oid && std::get<1>(key) == dbRoot && std::get<2>(key) == partition &&
+                        std::get<3>(key) == segment;
+               });
+
+  generation++;
+}
+
+void ColumnIndexCache::erase(uint32_t oid)
+{
+  boost::mutex::scoped_lock lk(mutex);
+
+  eraseEntries(entries, Key(oid, 0, 0, 0), [oid](const Key& key) { return std::get<0>(key) == oid; });
+  eraseEntries(bloomEntries, BloomKey(oid, 0, 0, 0, 0),
+               [oid](const BloomKey& key) { return std::get<0>(key) == oid; });
+
+  generation++;
+}
+
+void ColumnIndexCache::clear()
+{
+  boost::mutex::scoped_lock lk(mutex);
+  entries.clear();
+  bloomEntries.clear();
+  lru.clear();
+  size = 0;
+  generation++;
+}
+
+}  // namespace primitiveprocessor
@@ -0,0 +1,102 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <boost/thread/mutex.hpp>
+
+#include "we_columnindex.h"
+#include "we_bloomfilter.h"
+#include "we_fileop.h"
+
+namespace primitiveprocessor
+{
+/* ColumnIndexCache keeps the inverted indexes of the column segment files read by ColumnCommand
+   (see WriteEngine::ColumnIndex), and the bloom filters of their extents (see
+   WriteEngine::BlockBloomFilters), or that a segment file has none.
+
+   The writers tell PrimProc to drop the entries of a segment file after they've changed them,
+   the same way they have it close its file descriptors.  When the entries are more than the
+   configured size, the least recently used ones are dropped, so the filters of the extents a
+   big scan goes through don't push out the indexes that are in use.
+*/
+class ColumnIndexCache
+{
+ public:
+  typedef std::shared_ptr<const WriteEngine::ColumnIndex> Index;
+  typedef std::shared_ptr<const WriteEngine::BlockBloomFilters> BloomFilters;
+
+  static ColumnIndexCache* instance();
+
+  // PrimitiveServers/ColumnIndexCacheSize, 0 turns caching off
+  void setMaxSize(uint64_t size);
+
+  // the index of a segment file, read it if it's not cached; null if the file has none
+  Index find(uint32_t oid, uint16_t dbRoot, uint32_t partition, uint16_t segment);
+
+  // the bloom filters of the blocks of an extent of a segment file, as find()
+  BloomFilters findBloomFilters(uint32_t oid, uint16_t dbRoot, uint32_t partition, uint16_t segment,
+                                uint16_t extent);
+
+  void erase(uint32_t oid, uint16_t dbRoot, uint32_t partition, uint16_t segment);
+  void erase(uint32_t oid);
+  void clear();
+
+ private:
+  ColumnIndexCache();
+
+  typedef std::tuple<uint32_t, uint16_t, uint32_t, uint16_t> Key;  // oid, dbroot, partition, segment
+  typedef std::tuple<uint32_t, uint16_t, uint32_t, uint16_t, uint16_t> BloomKey;  // and extent
+
+  // the entries from the most recently used on, as a bloom filters key or an index key and extent 0
+  typedef std::list<std::pair<bool, BloomKey> > Lru;
+
+  template <typename T>
+  struct Entry
+  {
+    std::shared_ptr<const T> value;
+    uint64_t size;
+    Lru::iterator lru;
+  };
+
+  static Lru::value_type lruKey(const Key& key);
+  static Lru::value_type lruKey(const BloomKey& key);
+
+  template <typename T, typename K, typename Read>
+  std::shared_ptr<const T> findEntry(std::map<K, Entry<T> >& map, const K& key, Read read);
+  template <typename T, typename K, typename Match>
+  void eraseEntries(std::map<K, Entry<T> >& map, const K& first, Match match);
+  template <typename T, typename K>
+  typename std::map<K, Entry<T> >::iterator eraseEntry(std::map<K, Entry<T> >& map,
+                                                       typename std::map<K, Entry<T> >::iterator it);
+  void evict();
+
+  std::map<Key, Entry<WriteEngine::ColumnIndex> > entries;
+  std::map<BloomKey, Entry<WriteEngine::BlockBloomFilters> > bloomEntries;
+  Lru lru;
+  uint64_t size;
+  uint64_t maxSize;
+  uint64_t generation;  // of the drops, so an index read before one isn't kept after it
+  WriteEngine::FileOp fileOp;
+  boost::mutex mutex;
+};
+
+}  // namespace primitiveprocessor
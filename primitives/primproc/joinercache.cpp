@@ -0,0 +1,157 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include "joinercache.h"
+#include "primitivemsg.h"
+
+using namespace std;
+using namespace messageqcpp;
+
+namespace
+{
+// roughly what one key costs in a hash table, as joblist::JoinerCacheRegistry counts it
+const uint64_t bytesPerKey = 48;
+}  // namespace
+
+namespace primitiveprocessor
+{
+JoinerCache* JoinerCache::instance()
+{
+  static JoinerCache cache;
+  return &cache;
+}
+
+JoinerCache::JoinerCache() : size(0), maxSize(512 * 1024 * 1024)
+{
+}
+
+void JoinerCache::setMaxSize(uint64_t s)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  maxSize = s;
+  makeRoom(0);
+}
+
+bool JoinerCache::insert(uint32_t owner, uint64_t digest, const Entry& e)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  auto it = entries.find(Key(owner, digest));
+
+  if (it != entries.end())
+  {
+    if (it->second.entry.generation >= e.generation)
+      return true;
+
+    eraseSlot(it);
+  }
+
+  uint64_t entrySize = e.size * bytesPerKey;
+
+  if (!makeRoom(entrySize))
+    return false;
+
+  lru.push_front(Key(owner, digest));
+  entries.insert(make_pair(Key(owner, digest), Slot{e, entrySize, lru.begin()}));
+  size += entrySize;
+  return true;
+}
+
+bool JoinerCache::find(uint32_t owner, uint64_t digest, Entry& e)
+{
+  boost::mutex::scoped_lock lk(mutex);
+  auto it = entries.find(Key(owner, digest));
+
+  if (it == entries.end())
+    return false;
+
+  lru.splice(lru.begin(), lru, it->second.lru);
+  e = it->second.entry;
+  return true;
+}
+
+void JoinerCache::erase(uint32_t owner, uint64_t digest, uint64_t generation)
+{
+  auto it = entries.find(Key(owner, digest));
+
+  if (it != entries.end() && it->second.entry.generation <= generation)
+    eraseSlot(it);
+}
+
+void JoinerCache::eraseAll(uint32_t owner, uint64_t generation)
+{
+  auto it = entries.lower_bound(Key(owner, 0));
+
+  while (it != entries.end() && it->first.first == owner)
+  {
+    if (it->second.entry.generation <= generation)
+      it = eraseSlot(it);
+    else
+      ++it;
+  }
+}
+
+std::map<JoinerCache::Key, JoinerCache::Slot>::iterator JoinerCache::eraseSlot(
+    std::map<Key, Slot>::iterator it)
+{
+  size -= it->second.size;
+  lru.erase(it->second.lru);
+  return entries.erase(it);
+}
+
+/* The queries using a dropped table keep it until they're done, so this doesn't free that memory
+   right away. */
+bool JoinerCache::makeRoom(uint64_t entrySize)
+{
+  if (entrySize > maxSize)
+    return false;
+
+  while (size + entrySize > maxSize)
+    eraseSlot(entries.find(lru.back()));
+
+  return true;
+}
+
+/* The msg is the ISMPacketHeader, session, step, and uniqueID of the step that sent it, then
+   owner, a flag and generation for dropping all of the owner's entries, a count, and count pairs
+   of digest & generation. */
+void JoinerCache::drop(ByteStream& bs)
+{
+  uint32_t owner, count, i;
+  uint64_t digest, generation;
+  uint8_t all;
+
+  bs.advance(sizeof(ISMPacketHeader) + 3 * sizeof(uint32_t));
+  bs >> owner;
+  bs >> all;
+  bs >> generation;
+
+  boost::mutex::scoped_lock lk(mutex);
+
+  if (all)
+    eraseAll(owner, generation);
+
+  bs >> count;
+
+  for (i = 0; i < count; i++)
+  {
+    bs >> digest;
+    bs >> generation;
+    erase(owner, digest, generation);
+  }
+}
+
+}  // namespace primitiveprocessor
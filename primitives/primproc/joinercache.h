@@ -0,0 +1,99 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "bytestream.h"
+#include "batchprimitiveprocessor.h"
+
+namespace primitiveprocessor
+{
+/* JoinerCache keeps the hash tables of integer PM joins after their query is done, so the next
+   query with the same small side can use them instead of receiving and building them again.
+
+   ExeMgr decides what gets stored, what gets used, and when it's dropped (see
+   joblist::JoinerCacheRegistry).  An entry is identified by the ExeMgr that owns it and a digest
+   of the keys it holds.  The generation ExeMgr assigns each table orders the stores and drops,
+   which can arrive out of order on different connections.
+
+   When the tables are more than the configured size, the least recently used ones are dropped.
+   A query using one keeps it until it's done.  A query that was told to use a table that isn't
+   here any more, because it was dropped or PrimProc restarted, has ExeMgr send it again
+   (BATCH_PRIMITIVE_JOINER_MISS).
+*/
+class JoinerCache
+{
+ public:
+  typedef std::shared_ptr<boost::shared_ptr<BatchPrimitiveProcessor::TJoiner>[]> Tables;
+
+  struct Entry
+  {
+    Tables tables;
+    uint32_t partitionCount;  // the processorThreads of the BPP that built it
+    uint32_t size;
+    bool matchNulls;
+    uint64_t generation;
+  };
+
+  static JoinerCache* instance();
+
+  // PrimitiveServers/JoinerCacheSize, 0 turns caching off
+  void setMaxSize(uint64_t size);
+
+  /* keeps e unless a newer generation of the table is already there.  Returns false if it doesn't
+     fit. */
+  bool insert(uint32_t owner, uint64_t digest, const Entry& e);
+  bool find(uint32_t owner, uint64_t digest, Entry& e);
+
+  // BATCH_PRIMITIVE_DROP_JOINER_CACHE
+  void drop(messageqcpp::ByteStream& bs);
+
+ private:
+  JoinerCache();
+
+  typedef std::pair<uint32_t, uint64_t> Key;  // owner, digest
+  typedef std::list<Key> Lru;                 // most recently used first
+
+  struct Slot
+  {
+    Entry entry;
+    uint64_t size;  // in bytes
+    Lru::iterator lru;
+  };
+
+  // these are called holding mutex
+  // erase() & eraseAll() drop what's not newer than generation
+  void erase(uint32_t owner, uint64_t digest, uint64_t generation);
+  void eraseAll(uint32_t owner, uint64_t generation);
+  std::map<Key, Slot>::iterator eraseSlot(std::map<Key, Slot>::iterator it);
+  // drops the least recently used entries until size more bytes fit
+  bool makeRoom(uint64_t size);
+
+  std::map<Key, Slot> entries;
+  Lru lru;
+  uint64_t size;
+  uint64_t maxSize;
+  boost::mutex mutex;
+};
+
+}  // namespace primitiveprocessor
@@ -53,6 +53,8 @@ using namespace boost;
 #include "primitiveserver.h"
 #include "primitivemsg.h"
 #include "umsocketselector.h"
+#include "joinercache.h"
+#include "columnindexcache.h"
 #include "brm.h"
 using namespace BRM;
 
@@ -91,6 +93,7 @@ using namespace idbdatafile;
 using namespace threadpool;
 
 #include "threadnaming.h"
+#include "threadaffinity.h"
 
 #include "atomicops.h"
 
@@ -135,6 +138,9 @@ uint32_t connectionsPerUM;
 uint32_t highPriorityThreads;
 uint32_t medPriorityThreads;
 uint32_t lowPriorityThreads;
+uint32_t processorQueueShards = 1;
+// CPUs of every NUMA node if NUMA placement is on. Cache N and its IO threads live on node N.
+std::vector<utils::CpuListT> numaNodeCpus;
 int directIOFlag = O_DIRECT;
 int noVB = 0;
 
@@ -1228,14 +1234,17 @@ struct BPPHandler
 
   struct LastJoiner : public BPPHandlerFunctor
   {
-    LastJoiner(boost::shared_ptr<BPPHandler> r, SBS b) : BPPHandlerFunctor(r, b)
+    LastJoiner(boost::shared_ptr<BPPHandler> r, SBS b, SP_UM_IOSOCK i, SP_UM_MUTEX w)
+     : BPPHandlerFunctor(r, b), ios(i), writeLock(w)
     {
     }
     int operator()()
     {
       utils::setThreadName("PPHandLastJoiner");
-      return rt->lastJoinerMsg(*bs, dieTime);
+      return rt->lastJoinerMsg(*bs, dieTime, ios, writeLock);
     }
+    SP_UM_IOSOCK ios;
+    SP_UM_MUTEX writeLock;
   };
 
   struct Create : public BPPHandlerFunctor
@@ -1494,7 +1503,8 @@ struct BPPHandler
     }
   }
 
-  int lastJoinerMsg(ByteStream& bs, const posix_time::ptime& dieTime)
+  int lastJoinerMsg(ByteStream& bs, const posix_time::ptime& dieTime, SP_UM_IOSOCK& ios,
+                    SP_UM_MUTEX& writeLock)
   {
     SBPPV bppv;
     uint32_t uniqueID, i;
@@ -1528,6 +1538,8 @@ struct BPPHandler
 
       if (err == -1)
       {
+        sendMissedJoiners(bppv, uniqueID, ios, writeLock);
+
         if (posix_time::second_clock::universal_time() > dieTime)
         {
           cout << "LastJoiner: job for id " << uniqueID
@@ -1539,6 +1551,9 @@ struct BPPHandler
       }
     }
 
+    sendMissedJoiners(bppv, uniqueID, ios, writeLock);
+    sendStoredJoiners(bppv, uniqueID, ios, writeLock);
+
     /* Note: some of the duplicate/run/join sync was moved to the BPPV class to do
     more intelligent scheduling.  Once the join data is received, BPPV will
     start letting jobs run and create more BPP instances on demand. */
@@ -1547,6 +1562,82 @@ struct BPPHandler
     return 0;
   }
 
+  /* ExeMgr only has later queries use a table PrimProc keeps once it has it, tell it which ones
+     the step's BPPs put in the JoinerCache.  See joblist::JoinerCacheRegistry. */
+  void sendStoredJoiners(SBPPV& bppv, uint32_t uniqueID, SP_UM_IOSOCK& ios, SP_UM_MUTEX& writeLock)
+  {
+    vector<pair<uint64_t, uint64_t> > stored;
+
+    for (uint32_t i = 0; i < bppv->get().size(); i++)
+      bppv->get()[i]->getStoredJoiners(stored);
+
+    if (stored.empty())
+      return;
+
+    ISMPacketHeader ism;
+    PrimitiveHeader ph;
+    memset((void*)&ism, 0, sizeof(ism));
+    memset((void*)&ph, 0, sizeof(ph));
+    ism.Command = BATCH_PRIMITIVE_JOINER_CACHED;
+    ph.UniqueID = uniqueID;
+
+    SBS msg(new ByteStream());
+    msg->append((uint8_t*)&ism, sizeof(ism));
+    msg->append((uint8_t*)&ph, sizeof(ph));
+    *msg << (uint32_t)stored.size();
+
+    for (auto& table : stored)
+    {
+      *msg << table.first;
+      *msg << table.second;
+    }
+
+    writeToExeMgr(msg, ios, writeLock);
+  }
+
+  /* The step's BPPs were told to use tables the JoinerCache doesn't have, ExeMgr sends them.  The
+     msg is the ISMPacketHeader and PrimitiveHeader, a count, and the joiner numbers. */
+  void sendMissedJoiners(SBPPV& bppv, uint32_t uniqueID, SP_UM_IOSOCK& ios, SP_UM_MUTEX& writeLock)
+  {
+    vector<uint32_t> missed;
+
+    for (uint32_t i = 0; i < bppv->get().size(); i++)
+      bppv->get()[i]->getMissedJoiners(missed);
+
+    if (missed.empty())
+      return;
+
+    ISMPacketHeader ism;
+    PrimitiveHeader ph;
+    memset((void*)&ism, 0, sizeof(ism));
+    memset((void*)&ph, 0, sizeof(ph));
+    ism.Command = BATCH_PRIMITIVE_JOINER_MISS;
+    ph.UniqueID = uniqueID;
+
+    SBS msg(new ByteStream());
+    msg->append((uint8_t*)&ism, sizeof(ism));
+    msg->append((uint8_t*)&ph, sizeof(ph));
+    *msg << (uint32_t)missed.size();
+
+    for (uint32_t joinerNum : missed)
+      *msg << joinerNum;
+
+    writeToExeMgr(msg, ios, writeLock);
+  }
+
+  void writeToExeMgr(SBS& msg, SP_UM_IOSOCK& ios, SP_UM_MUTEX& writeLock)
+  {
+    // !writeLock is a same host connection, as in DictScanJob::write()
+    if (!writeLock)
+    {
+      ios->write(msg);
+      return;
+    }
+
+    boost::mutex::scoped_lock lk(*writeLock);
+    ios->write(*msg);
+  }
+
   int destroyBPP(ByteStream& bs, const posix_time::ptime& dieTime)
   {
     uint32_t uniqueID, sessionID, stepID;
@@ -1771,6 +1862,23 @@ class DestroyEqualityFilter : public DictionaryOp
   }
 };
 
+class DropCachedJoiners : public FairThreadPool::Functor
+{
+ public:
+  DropCachedJoiners(SBS cmd) : bs(cmd)
+  {
+  }
+  int operator()()
+  {
+    utils::setThreadName("PPDropJoiners");
+    JoinerCache::instance()->drop(*bs);
+    return 0;
+  }
+
+ private:
+  SBS bs;
+};
+
 struct ReadThread
 {
   ReadThread(const string& serverName, IOSocket& ios, PrimitiveServer* ps)
@@ -1810,6 +1918,9 @@ struct ReadThread
       bc.flushOIDs(oids, count);
     }
 
+    for (uint32_t i = 0; i < count; i++)
+      ColumnIndexCache::instance()->erase(oids[i]);
+
     ios->write(buildCacheOpResp(0));
   }
 
@@ -1837,6 +1948,9 @@ struct ReadThread
       bc.flushPartition(oids, partitions);
     }
 
+    for (uint32_t i = 0; i < oids.size(); i++)
+      ColumnIndexCache::instance()->erase(oids[i]);
+
     ios->write(buildCacheOpResp(0));
   }
 
@@ -1848,6 +1962,8 @@ struct ReadThread
       bc.flushCache();
     }
 
+    ColumnIndexCache::instance()->clear();
+
     ios->write(buildCacheOpResp(0));
   }
 
@@ -1857,6 +1973,7 @@ struct ReadThread
 
     bs.advance(sizeof(ISMPacketHeader));
     dropFDCache();
+    ColumnIndexCache::instance()->clear();
     ios->write(buildCacheOpResp(0));
   }
 
@@ -1867,6 +1984,12 @@ struct ReadThread
     bs.advance(sizeof(ISMPacketHeader));
     deserializeInlineVector<BRM::FileInfo>(bs, files);
     purgeFDCache(files);
+
+    // the writers change the inverted index of a segment file before they have its FDs purged
+    for (uint32_t i = 0; i < files.size(); i++)
+      ColumnIndexCache::instance()->erase(files[i].oid, files[i].dbRoot, files[i].partitionNum,
+                                          files[i].segmentNum);
+
     ios->write(buildCacheOpResp(0));
   }
 
@@ -1920,6 +2043,7 @@ struct ReadThread
       case BATCH_PRIMITIVE_END_JOINER:
       case BATCH_PRIMITIVE_DESTROY:
       case BATCH_PRIMITIVE_ABORT:
+      case BATCH_PRIMITIVE_DROP_JOINER_CACHE:
       {
         const uint8_t* buf = sbs->buf();
         uint32_t pos = sizeof(ISMPacketHeader) - 2;
@@ -1950,7 +2074,7 @@ struct ReadThread
         else if (ismHdr->Command == BATCH_PRIMITIVE_END_JOINER)
         {
           id = fBPPHandler->getUniqueID(sbs, ismHdr->Command);
-          functor.reset(new BPPHandler::LastJoiner(fBPPHandler, sbs));
+          functor.reset(new BPPHandler::LastJoiner(fBPPHandler, sbs, outIos, writeLock));
         }
         else if (ismHdr->Command == BATCH_PRIMITIVE_DESTROY)
         {
@@ -1962,6 +2086,10 @@ struct ReadThread
           id = fBPPHandler->getUniqueID(sbs, ismHdr->Command);
           functor.reset(new BPPHandler::Abort(fBPPHandler, sbs));
         }
+        else if (ismHdr->Command == BATCH_PRIMITIVE_DROP_JOINER_CACHE)
+        {
+          functor.reset(new DropCachedJoiners(sbs));
+        }
         PriorityThreadPool::Job job(uniqueID, stepID, txnId, functor, outIos, weight, priority, id);
         OOBProcPool->addJob(job);
         break;
@@ -2014,6 +2142,14 @@ struct ReadThread
         else
         {
           FairThreadPool::Job job(uniqueID, stepID, txnId, functor, outIos, weight, priority, id);
+          // Queue the scan near the cache partition that holds its blocks.
+          if (!numaNodeCpus.empty() && ismHdr->Command == BATCH_PRIMITIVE_RUN &&
+              sbs->length() >= sizeof(ISMPacketHeader) + 20 + sizeof(uint64_t))
+          {
+            const uint64_t scannedLBID = *((uint64_t*)&sbs->buf()[sizeof(ISMPacketHeader) + 20]);
+            if (scannedLBID != BPP_NO_SCANNED_LBID)
+              job.numaNode_ = cacheNum(scannedLBID);
+          }
           procPool->addJob(job);
         }
 
@@ -2271,8 +2407,9 @@ PrimitiveServer::PrimitiveServer(int serverThreads, int serverQueueSize, int pro
   fServerpool.setQueueSize(fServerQueueSize);
   fServerpool.setName("PrimitiveServer");
 
-  fProcessorPool.reset(new threadpool::FairThreadPool(fProcessorWeight, highPriorityThreads,
-                                                      medPriorityThreads, lowPriorityThreads, 0));
+  fProcessorPool.reset(new threadpool::FairThreadPool(
+      fProcessorWeight, highPriorityThreads, medPriorityThreads, lowPriorityThreads, 0, processorQueueShards,
+      std::max<size_t>(1, numaNodeCpus.size()), numaNodeCpus));
   // We're not using either the priority or the job-clustering features, just need a threadpool
   // that can reschedule jobs, and an unlimited non-blocking queue
   fOOBPool.reset(new threadpool::PriorityThreadPool(1, 5, 0, 0, 1));
@@ -2283,11 +2420,20 @@ PrimitiveServer::PrimitiveServer(int serverThreads, int serverQueueSize, int pro
 
   BRPp = new BlockRequestProcessor*[fCacheCount];
 
+  // The IO threads of a cache inherit the affinity of this thread. They are the ones to first touch
+  // the cache memory so it is allocated on the node of the cache.
+  utils::CpuListT startupCpus = utils::getThreadAffinity();
+
   try
   {
     for (int i = 0; i < fCacheCount; i++)
+    {
+      if (i < (int)numaNodeCpus.size())
+        utils::setThreadAffinity(numaNodeCpus[i]);
+
       BRPp[i] = new BlockRequestProcessor(BRPBlocks / fCacheCount, BRPThreads / fCacheCount,
                                           fMaxBlocksPerRead, deleteBlocks / fCacheCount);
+    }
   }
   catch (...)
   {
@@ -2298,6 +2444,9 @@ PrimitiveServer::PrimitiveServer(int serverThreads, int serverQueueSize, int pro
     mlp->logMessage(logging::M0045, logging::Message::Args(), true);
     exit(1);
   }
+
+  if (!numaNodeCpus.empty())
+    utils::setThreadAffinity(startupCpus);
 }
 
 PrimitiveServer::~PrimitiveServer()
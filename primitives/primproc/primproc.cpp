@@ -57,6 +57,8 @@ using namespace logging;
 #include "MonitorProcMem.h"
 #include "pp_logger.h"
 #include "umsocketselector.h"
+#include "columnindexcache.h"
+#include "joinercache.h"
 using namespace primitiveprocessor;
 
 #include "archcheck.h"
@@ -69,6 +71,7 @@ using namespace oam;
 using namespace idbdatafile;
 
 #include "cgroupconfigurator.h"
+#include "threadaffinity.h"
 
 #include "crashtrace.h"
 #include "installdir.h"
@@ -88,6 +91,8 @@ extern uint32_t connectionsPerUM;
 extern uint32_t highPriorityThreads;
 extern uint32_t medPriorityThreads;
 extern uint32_t lowPriorityThreads;
+extern uint32_t processorQueueShards;
+extern std::vector<utils::CpuListT> numaNodeCpus;
 extern int directIOFlag;
 extern int noVB;
 
@@ -635,6 +640,31 @@ int ServicePrimProc::Child()
   if (temp > 0 && temp < (int)BPPCount)
     BPPCount = temp;
 
+  // The number of FairThreadPool queue shards. Splitting the queue reduces the lock contention
+  // on big boxes. The threads steal the jobs from the other shards when their own is empty.
+  temp = toInt(cf->getConfig(primitiveServers, "ProcessorQueueShards"));
+
+  if (temp > 0)
+    processorQueueShards = std::min((uint32_t)temp, BPPCount);
+
+  // NUMA placement: a block cache partition per node, the job queue shards and their threads
+  // bound to the nodes, and the scans queued on the node that caches the scanned extent.
+  strVal = cf->getConfig(primitiveServers, "NUMAAware");
+
+  if ((strVal == "y") || (strVal == "Y"))
+  {
+    auto nodes = cg.getNumaNodeCpus();
+
+    if (nodes.size() > 1)
+    {
+      numaNodeCpus = std::move(nodes);
+      cacheCount = numaNodeCpus.size();
+      processorQueueShards =
+          std::min<uint32_t>(std::max<uint32_t>(processorQueueShards, numaNodeCpus.size()), BPPCount);
+      BRPThreads = std::max<int>(BRPThreads, cacheCount);
+    }
+  }
+
   temp = toInt(cf->getConfig(dbbc, "NumThreads"));
 
   if (temp > 0)
@@ -647,6 +677,17 @@ int ServicePrimProc::Child()
   if ((strVal == "n") || (strVal == "N"))
     directIOFlag = 0;
 
+  // cache of the inverted indexes and bloom filters of column segment files, 256MB by default
+  strVal = cf->getConfig(primitiveServers, "ColumnIndexCacheSize");
+
+  if (strVal.length() > 0)
+    ColumnIndexCache::instance()->setMaxSize(Config::uFromText(strVal));
+
+  // the hash tables of PM joins kept for the ExeMgrs, 512MB by default
+  strVal = cf->getConfig(primitiveServers, "JoinerCacheSize");
+
+  if (strVal.length() > 0)
+    JoinerCache::instance()->setMaxSize(Config::uFromText(strVal));
 
   IDBPolicy::configIDBPolicy();
 
@@ -658,7 +699,8 @@ int ServicePrimProc::Child()
        << ", pw = " << processorWeight << ", pq = " << processorQueueSize << ", nb = " << BRPBlocks
        << ", nt = " << BRPThreads << ", nc = " << cacheCount << ", ra = " << blocksReadAhead
        << ", db = " << deleteBlocks << ", mb = " << maxBlocksPerRead << ", rd = " << rotatingDestination
-       << ", tr = " << PTTrace << ", ss = " << PMSmallSide << ", bp = " << BPPCount << endl;
+       << ", tr = " << PTTrace << ", ss = " << PMSmallSide << ", bp = " << BPPCount
+       << ", qs = " << processorQueueShards << ", nn = " << numaNodeCpus.size() << endl;
 
   PrimitiveServer server(serverThreads, serverQueueSize, processorWeight, processorQueueSize,
                          rotatingDestination, BRPBlocks, BRPThreads, cacheCount, maxBlocksPerRead,
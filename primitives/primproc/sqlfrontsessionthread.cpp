@@ -420,6 +420,14 @@ void SQLFrontSessionThread::operator()()
           analyzeTableHandleStats(bs);
           continue;
         }
+        else if (qb == RESULT_CACHE_GET_STATS)
+        {
+          bs.restart();
+          joblist::ResultCache::instance()->serializeStats(bs);
+          fIos.write(bs);
+          fIos.close();
+          break;
+        }
         else if (qb == 0)
         {
           // 0 => Nothing left to do. Sent by rnd_end() just to be sure.
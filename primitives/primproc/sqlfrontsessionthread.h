@@ -57,6 +57,7 @@
 
 #include "mariadb_my_sys.h"
 #include "statistics.h"
+#include "resultcache.h"
 #include "serviceexemgr.h"
 
 namespace exemgr
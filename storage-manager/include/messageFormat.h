@@ -86,7 +86,8 @@ enum Opcodes
   COPY,
   SYNC,
   LIST_IOTASKS,
-  TERMINATE_IOTASK
+  TERMINATE_IOTASK,
+  PREFETCH
 };
 
 /*
@@ -342,6 +343,25 @@ struct terminate_iotask_cmd
   uint64_t id;
 };
 
+/*
+    PREFETCH
+    --------
+    command format:
+    1-byte opcode|size_t count|off_t offset|4-byte filename length|filename
+
+    response format:
+
+    SM responds once the download of the objects covering the range is queued.
+*/
+struct prefetch_cmd
+{
+  uint8_t opcode;  // == PREFETCH
+  size_t count;
+  off_t offset;
+  uint32_t flen;
+  char filename[];
+};
+
 #pragma pack(pop)
 
 }  // namespace storagemanager
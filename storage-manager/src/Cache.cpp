@@ -50,6 +50,12 @@ Cache* Cache::get()
 }
 
 Cache::Cache()
+ : maxCacheSize(0)
+ , prefetchWorkers(8)
+ , prefetchBudget(256 << 20)
+ , prefetchBytesInFlight(0)
+ , objectsPrefetched(0)
+ , prefetchesDropped(0)
 {
   Config* conf = Config::get();
   logger = SMLogging::get();
@@ -92,6 +98,7 @@ Cache::Cache()
   }
   // cout << "Cache got cachePrefix " << cachePrefix << endl;
   downloader.reset(new Downloader());
+  prefetchWorkers.setName("Prefetcher");
 
   stmp = conf->getValue("ObjectStorage", "journal_path");
   if (stmp.empty())
@@ -174,6 +181,56 @@ bool Cache::exists(const bf::path& prefix, const string& key)
   return getPCache(prefix).exists(key);
 }
 
+void Cache::prefetch(const bf::path& prefix, const vector<string>& keys)
+{
+  PrefixCache& pCache = getPCache(prefix);
+  vector<string> toFetch;
+
+  boost::unique_lock<boost::mutex> s(prefetch_mutex);
+  // don't let prefetching push out more than a quarter of the cache
+  size_t budget = min(prefetchBudget, maxCacheSize / 4);
+  for (const string& key : keys)
+  {
+    if (pCache.exists(key))
+      continue;
+    if (prefetchBytesInFlight + objectSize > budget)
+    {
+      ++prefetchesDropped;
+      continue;
+    }
+    prefetchBytesInFlight += objectSize;
+    toFetch.push_back(key);
+  }
+  s.unlock();
+
+  if (!toFetch.empty())
+    prefetchWorkers.addJob(boost::shared_ptr<ThreadPool::Job>(new PrefetchJob(this, prefix, toFetch)));
+}
+
+Cache::PrefetchJob::PrefetchJob(Cache* c, const bf::path& p, const vector<string>& k)
+ : cache(c), prefix(p), keys(k)
+{
+}
+
+void Cache::PrefetchJob::operator()()
+{
+  // read() downloads whatever isn't there yet, and is a no-op for objects a real read brought in
+  // first.  A failed download (eg the object was replaced meanwhile) just isn't cached.
+  try
+  {
+    cache->read(prefix, keys);
+    cache->doneReading(prefix, keys);
+  }
+  catch (exception& e)
+  {
+    cache->logger->log(LOG_WARNING, "Cache: prefetch failed, got '%s'", e.what());
+  }
+
+  boost::unique_lock<boost::mutex> s(cache->prefetch_mutex);
+  cache->prefetchBytesInFlight -= keys.size() * cache->objectSize;
+  cache->objectsPrefetched += keys.size();
+}
+
 void Cache::newObject(const bf::path& prefix, const string& key, size_t size)
 {
   getPCache(prefix).newObject(key, size);
@@ -226,6 +283,8 @@ int Cache::ifExistsThenDelete(const bf::path& prefix, const string& key)
 void Cache::printKPIs() const
 {
   downloader->printKPIs();
+  cout << "Cache: objectsPrefetched = " << objectsPrefetched << endl;
+  cout << "Cache: prefetchesDropped = " << prefetchesDropped << endl;
 }
 size_t Cache::getCurrentCacheSize()
 {
@@ -355,5 +414,26 @@ void Cache::configListener()
   {
     logger->log(LOG_CRIT, "Cache/cache_size is not a number. Using current value = %zi", maxCacheSize);
   }
+
+  // prefetch_budget caps the bytes of prefetched objects being downloaded at once
+  stmp = conf->getValue("Cache", "prefetch_budget");
+  if (!stmp.empty())
+  {
+    try
+    {
+      size_t newBudget = stoull(stmp);
+      boost::unique_lock<boost::mutex> s(prefetch_mutex);
+      if (newBudget != prefetchBudget)
+      {
+        prefetchBudget = newBudget;
+        logger->log(LOG_INFO, "Cache/prefetch_budget = %zi", prefetchBudget);
+      }
+    }
+    catch (invalid_argument&)
+    {
+      logger->log(LOG_CRIT, "Cache/prefetch_budget is not a number. Using current value = %zi",
+                  prefetchBudget);
+    }
+  }
 }
 }  // namespace storagemanager
@@ -57,6 +57,11 @@ class Cache : public boost::noncopyable, public ConfigListener
   void exists(const boost::filesystem::path& prefix, const std::vector<std::string>& keys,
               std::vector<bool>* out);
 
+  // prefetch() starts downloading keys in the background, skipping anything already cached and
+  // anything that would put more than prefetch_budget bytes of prefetches in flight.
+  // It does not wait for the downloads.
+  void prefetch(const boost::filesystem::path& prefix, const std::vector<std::string>& keys);
+
   // writing fcns
   // new*() fcns tell the Cache data was added.  After writing a set of objects,
   // unlock the 'logical file', and call doneWriting().
@@ -114,6 +119,24 @@ class Cache : public boost::noncopyable, public ConfigListener
 
   std::map<boost::filesystem::path, PrefixCache*> prefixCaches;
   mutable boost::mutex lru_mutex;  // protects the prefixCaches
+
+  class PrefetchJob : public ThreadPool::Job
+  {
+   public:
+    PrefetchJob(Cache* c, const boost::filesystem::path& p, const std::vector<std::string>& k);
+    void operator()();
+
+   private:
+    Cache* cache;
+    boost::filesystem::path prefix;
+    std::vector<std::string> keys;
+  };
+
+  ThreadPool prefetchWorkers;
+  size_t prefetchBudget;
+  size_t prefetchBytesInFlight;
+  size_t objectsPrefetched, prefetchesDropped;
+  boost::mutex prefetch_mutex;  // protects the prefetch counters
 };
 
 }  // namespace storagemanager
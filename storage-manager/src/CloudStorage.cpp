@@ -21,9 +21,17 @@
 #include "LocalStorage.h"
 #include "SMLogging.h"
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <atomic>
 #include <string>
+#include <string.h>
 #include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <iostream>
+#include "Utilities.h"
 
 using namespace std;
 
@@ -82,9 +90,41 @@ CloudStorage* CloudStorage::get()
 CloudStorage::CloudStorage()
 {
   logger = SMLogging::get();
+  Config* conf = Config::get();
 
   bytesUploaded = bytesDownloaded = objectsDeleted = objectsCopied = objectsGotten = objectsPut =
-      existenceChecks = 0;
+      existenceChecks = multipartUploads = partsUploaded = 0;
+
+  // upload_part_size = 0 turns off multipart uploads
+  uploadPartSize = 8 << 20;
+  string stmp = conf->getValue("ObjectStorage", "upload_part_size");
+  if (!stmp.empty())
+  {
+    try
+    {
+      uploadPartSize = stoull(stmp);
+    }
+    catch (invalid_argument&)
+    {
+      logger->log(LOG_CRIT, "ObjectStorage/upload_part_size is not a number. Using default value = %zu",
+                  uploadPartSize);
+    }
+  }
+
+  uploadPartConcurrency = 4;
+  stmp = conf->getValue("ObjectStorage", "upload_part_concurrency");
+  if (!stmp.empty())
+  {
+    try
+    {
+      uploadPartConcurrency = max(1UL, stoul(stmp));
+    }
+    catch (invalid_argument&)
+    {
+      logger->log(LOG_CRIT, "ObjectStorage/upload_part_concurrency is not a number. Using default value = %u",
+                  uploadPartConcurrency);
+    }
+  }
 }
 
 void CloudStorage::printKPIs() const
@@ -97,6 +137,158 @@ void CloudStorage::printKPIs() const
   cout << "\tobjectsGotten = " << objectsGotten << endl;
   cout << "\tobjectsPut = " << objectsPut << endl;
   cout << "\texistenceChecks = " << existenceChecks << endl;
+  cout << "\tmultipartUploads = " << multipartUploads << endl;
+  cout << "\tpartsUploaded = " << partsUploaded << endl;
+}
+
+int CloudStorage::getObjectRange(const string& sourceKey, uint8_t* data, off_t offset, size_t length,
+                                 size_t* readLength)
+{
+  std::shared_ptr<uint8_t[]> obj;
+  size_t objSize = 0;
+
+  int err = getObject(sourceKey, &obj, &objSize);
+  if (err)
+    return err;
+
+  size_t count = 0;
+  if ((size_t)offset < objSize)
+  {
+    count = min(length, objSize - offset);
+    memcpy(data, &obj[offset], count);
+  }
+  if (readLength)
+    *readLength = count;
+  return 0;
+}
+
+bool CloudStorage::supportsRangedGet() const
+{
+  return false;
+}
+
+bool CloudStorage::supportsMultipartUpload() const
+{
+  return false;
+}
+
+int CloudStorage::putObjectMultipart(const string& sourceFile, const string& destKey)
+{
+  struct stat statbuf;
+  if (::stat(sourceFile.c_str(), &statbuf))
+    return -1;
+  size_t len = statbuf.st_size;
+  if (!supportsMultipartUpload() || uploadPartSize == 0 || len <= uploadPartSize)
+    return putObject(sourceFile, destKey);
+
+  char buf[80];
+  int fd = ::open(sourceFile.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    int l_errno = errno;
+    logger->log(LOG_ERR, "CloudStorage::putObjectMultipart(): Failed to open %s, got %s", sourceFile.c_str(),
+                strerror_r(l_errno, buf, 80));
+    errno = l_errno;
+    return -1;
+  }
+  ScopedCloser sc(fd);
+  std::shared_ptr<uint8_t[]> data(new uint8_t[len]);
+  size_t count = 0;
+  while (count < len)
+  {
+    ssize_t err = ::read(fd, &data[count], len - count);
+    if (err < 0)
+    {
+      int l_errno = errno;
+      logger->log(LOG_ERR, "CloudStorage::putObjectMultipart(): Failed to read %s @ position %zu, got %s",
+                  sourceFile.c_str(), count, strerror_r(l_errno, buf, 80));
+      errno = l_errno;
+      return -1;
+    }
+    if (err == 0)
+    {
+      logger->log(LOG_ERR, "CloudStorage::putObjectMultipart(): Got early EOF reading %s @ position %zu",
+                  sourceFile.c_str(), count);
+      errno = ENODATA;
+      return -1;
+    }
+    count += err;
+  }
+  return putObjectMultipart(data, len, destKey);
+}
+
+int CloudStorage::putObjectMultipart(const std::shared_ptr<uint8_t[]> data, size_t len, const string& destKey)
+{
+  if (!supportsMultipartUpload() || uploadPartSize == 0 || len <= uploadPartSize)
+    return putObject(data, len, destKey);
+
+  string uploadID;
+  int err = startMultipartUpload(destKey, &uploadID);
+  if (err)
+    return err;
+
+  // each thread takes the next part to send until they're all sent or one fails
+  const uint partCount = (len + uploadPartSize - 1) / uploadPartSize;
+  std::atomic<uint> nextPart(0);
+  std::atomic<int> firstErrno(0);
+  auto sendParts = [&]()
+  {
+    uint part;
+    while (firstErrno == 0 && (part = nextPart++) < partCount)
+    {
+      size_t offset = part * uploadPartSize;
+      if (putPart(destKey, uploadID, part + 1, &data[offset], min(uploadPartSize, len - offset)))
+      {
+        int expected = 0;
+        firstErrno.compare_exchange_strong(expected, errno ? errno : EIO);
+      }
+    }
+  };
+  boost::thread_group threads;
+  for (uint i = 1; i < min(uploadPartConcurrency, partCount); i++)
+    threads.create_thread(sendParts);
+  sendParts();
+  threads.join_all();
+
+  if (firstErrno == 0)
+    err = completeMultipartUpload(destKey, uploadID, partCount);
+  if (firstErrno != 0 || err)
+  {
+    int l_errno = (firstErrno != 0 ? firstErrno.load() : errno);
+    char buf[80];
+    logger->log(LOG_ERR, "CloudStorage::putObjectMultipart(): failed to upload %s, got %s", destKey.c_str(),
+                strerror_r(l_errno, buf, 80));
+    abortMultipartUpload(destKey, uploadID);
+    errno = l_errno;
+    return -1;
+  }
+  ++multipartUploads;
+  partsUploaded += partCount;
+  return 0;
+}
+
+int CloudStorage::startMultipartUpload(const string&, string*)
+{
+  errno = ENOTSUP;
+  return -1;
+}
+
+int CloudStorage::putPart(const string&, const string&, uint, const uint8_t*, size_t)
+{
+  errno = ENOTSUP;
+  return -1;
+}
+
+int CloudStorage::completeMultipartUpload(const string&, const string&, uint)
+{
+  errno = ENOTSUP;
+  return -1;
+}
+
+int CloudStorage::abortMultipartUpload(const string&, const string&)
+{
+  errno = ENOTSUP;
+  return -1;
 }
 
 vector<CloudStorage::IOTaskData> CloudStorage::taskList() const
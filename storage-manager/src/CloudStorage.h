@@ -18,6 +18,9 @@
 #pragma once
 
 #include <string>
+#include <memory>
+#include <vector>
+#include <sys/types.h>
 
 #include "SMLogging.h"
 
@@ -37,6 +40,21 @@ class CloudStorage
   virtual int copyObject(const std::string& sourceKey, const std::string& destKey) = 0;
   virtual int exists(const std::string& key, bool* out) = 0;
 
+  /* Reads up to length bytes starting at offset of sourceKey into data.  readLength gets the number of
+     bytes actually read, which is less than length if the object ends first.  The default implementation
+     gets the whole object and copies out the requested range.  Backends that can fetch a byte range
+     directly should override it and return true from supportsRangedGet(). */
+  virtual int getObjectRange(const std::string& sourceKey, uint8_t* data, off_t offset, size_t length,
+                             size_t* readLength);
+  virtual bool supportsRangedGet() const;
+
+  /* These upload an object as a multipart upload when the backend supports it and the object is bigger
+     than ObjectStorage/upload_part_size.  The parts are sent upload_part_concurrency at a time.
+     Otherwise they are the same as putObject(). */
+  int putObjectMultipart(const std::string& sourceFile, const std::string& destKey);
+  int putObjectMultipart(const std::shared_ptr<uint8_t[]> data, size_t len, const std::string& destKey);
+  virtual bool supportsMultipartUpload() const;
+
   virtual void printKPIs() const;
 
   struct IOTaskData
@@ -54,9 +72,22 @@ class CloudStorage
   SMLogging* logger;
   CloudStorage();
 
+  /* The multipart upload primitives for backends that return true from supportsMultipartUpload().
+     Parts are numbered from 1, and may be sent in any order and in parallel.  Completing an upload
+     assembles parts 1..partCount into destKey in order.  These behave like syscalls. */
+  virtual int startMultipartUpload(const std::string& destKey, std::string* uploadID);
+  virtual int putPart(const std::string& destKey, const std::string& uploadID, uint partNumber,
+                      const uint8_t* data, size_t len);
+  virtual int completeMultipartUpload(const std::string& destKey, const std::string& uploadID,
+                                      uint partCount);
+  virtual int abortMultipartUpload(const std::string& destKey, const std::string& uploadID);
+
+  size_t uploadPartSize;
+  uint uploadPartConcurrency;
+
   // some KPIs
   size_t bytesUploaded, bytesDownloaded, objectsDeleted, objectsCopied, objectsGotten, objectsPut,
-      existenceChecks;
+      existenceChecks, multipartUploads, partsUploaded;
 
  private:
 };
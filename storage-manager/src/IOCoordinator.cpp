@@ -50,6 +50,7 @@ IOCoordinator::IOCoordinator()
 {
   config = Config::get();
   cache = Cache::get();
+  segmentCache = SegmentCache::get();
   logger = SMLogging::get();
   replicator = Replicator::get();
 
@@ -82,7 +83,7 @@ IOCoordinator::IOCoordinator()
   journalPath = cache->getJournalPath();
 
   bytesRead = bytesWritten = filesOpened = filesCreated = filesCopied = filesDeleted = bytesCopied =
-      filesTruncated = listingCount = callsToWrite = 0;
+      filesTruncated = listingCount = callsToWrite = prefetchRequests = journalsCompacted = 0;
   iocFilesOpened = iocObjectsCreated = iocJournalsCreated = iocBytesWritten = iocFilesDeleted = iocBytesRead =
       0;
 }
@@ -115,12 +116,15 @@ void IOCoordinator::printKPIs() const
   cout << "\t\tfilesDeleted = " << filesDeleted << endl;
   cout << "\t\tfilesTruncated = " << filesTruncated << endl;
   cout << "\t\tcallsToWrite = " << callsToWrite << endl;
+  cout << "\t\tprefetchRequests = " << prefetchRequests << endl;
   cout << "\tIOC's POV" << endl;
   cout << "\t\tiocFilesOpened = " << iocFilesOpened << endl;
   cout << "\t\tiocObjectsCreated = " << iocObjectsCreated << endl;
   cout << "\t\tiocJournalsCreated = " << iocJournalsCreated << endl;
   cout << "\t\tiocBytesRead = " << iocBytesRead << endl;
   cout << "\t\tiocBytesWritten = " << iocBytesWritten << endl;
+  cout << "\t\tjournalsCompacted = " << journalsCompacted << endl;
+  mergeCache.printKPIs();
 }
 
 int IOCoordinator::loadObject(int fd, uint8_t* data, off_t offset, size_t length)
@@ -145,6 +149,42 @@ int IOCoordinator::loadObject(int fd, uint8_t* data, off_t offset, size_t length
   return 0;
 }
 
+int IOCoordinator::loadMergedObject(const bf::path& firstDir, const metadataObject& object,
+                                    const char* objFilename, const char* journalFilename, int journalFD,
+                                    uint8_t* data, off_t offset, size_t length)
+{
+  struct stat journalStat;
+
+  if (!mergeCache.enabled() || ::fstat(journalFD, &journalStat))
+    return loadObjectAndJournal(objFilename, journalFilename, data, offset, length);
+
+  size_t mergedLength = 0;
+  uint reads = 0;
+  std::shared_ptr<uint8_t[]> merged = mergeCache.get(object.key, journalStat, &mergedLength, &reads);
+  if (!merged || offset + length > mergedLength)
+  {
+    // merge the whole object once so that later reads of any part of it are served from memory
+    size_t tmp = 0;
+    merged = mergeJournal(objFilename, journalFilename, 0, object.length, &tmp);
+    if (!merged)
+      return -1;
+    iocBytesRead += tmp;
+    mergedLength = object.length;
+    mergeCache.put(object.key, journalStat, merged, mergedLength);
+    reads = 0;
+  }
+
+  // the caller holds the read lock on the file, so the journal can't be merged out from under us here
+  if (mergeCache.shouldCompact(journalStat.st_size, reads))
+  {
+    ++journalsCompacted;
+    Synchronizer::get()->compact(firstDir, object.key);
+  }
+
+  memcpy(data, &merged[offset], length);
+  return 0;
+}
+
 int IOCoordinator::loadObjectAndJournal(const char* objFilename, const char* journalFilename, uint8_t* data,
                                         off_t offset, size_t length)
 {
@@ -195,11 +235,31 @@ ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset,
   int mindersIndex = 0;
   char buf[80];
 
-  // load them into the cache
+  // Objects that are only partly covered by the read, aren't in the cache, and have no journal
+  // get read in segments straight from cloud storage instead of being downloaded whole.
+  // Journals can't appear while we hold the read lock.
+  vector<bool> partialRead(relevants.size(), false);
+  bool useSegments = segmentCache->enabled();
+
+  // load the rest into the cache
   vector<string> keys;
   keys.reserve(relevants.size());
-  for (const auto& object : relevants)
+  for (uint i = 0; i < relevants.size(); i++)
+  {
+    const auto& object = relevants[i];
+    if (useSegments)
+    {
+      off_t readStart = max(offset, object.offset);
+      off_t readEnd = min(offset + (off_t)length, object.offset + (off_t)object.length);
+      if (readEnd - readStart < (off_t)object.length && !cache->exists(firstDir, object.key) &&
+          !bf::exists(journalPath / firstDir / (object.key + ".journal")))
+      {
+        partialRead[i] = true;
+        continue;
+      }
+    }
     keys.push_back(object.key);
+  }
   cache->read(firstDir, keys);
 
   // open the journal files and objects that exist to prevent them from being
@@ -260,8 +320,9 @@ ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset,
   size_t count = 0;
   int err;
   std::shared_ptr<uint8_t[]> mergedData;
-  for (auto& object : relevants)
+  for (uint i = 0; i < relevants.size(); i++)
   {
+    const auto& object = relevants[i];
     const auto& jit = journalFDs.find(object.key);
 
     // if this is the first object, the offset to start reading at is offset - object->offset
@@ -273,11 +334,19 @@ ssize_t IOCoordinator::read(const char* _filename, uint8_t* data, off_t offset,
     // otherwise it is the length of the object - starting offset
 
     size_t thisLength = min(object.length - thisOffset, length - count);
-    if (jit == journalFDs.end())
+    if (partialRead[i])
+    {
+      ssize_t segErr = segmentCache->read(object.key, object.length, &data[count], thisOffset, thisLength);
+      err = (segErr == (ssize_t)thisLength ? 0 : -1);
+      if (!err)
+        iocBytesRead += thisLength;
+    }
+    else if (jit == journalFDs.end())
       err = loadObject(objectFDs[object.key], &data[count], thisOffset, thisLength);
     else
-      err = loadObjectAndJournal(keyToObjectName[object.key].c_str(), keyToJournalName[object.key].c_str(),
-                                 &data[count], thisOffset, thisLength);
+      err = loadMergedObject(firstDir, object, keyToObjectName[object.key].c_str(),
+                             keyToJournalName[object.key].c_str(), jit->second, &data[count], thisOffset,
+                             thisLength);
     if (err)
     {
       fileLock.unlock();
@@ -299,6 +368,31 @@ out:
   return count;
 }
 
+int IOCoordinator::prefetch(const char* _filename, off_t offset, size_t length)
+{
+  bf::path filename = ownership.get(_filename);
+  const bf::path firstDir = *(filename.begin());
+
+  ScopedReadLock fileLock(this, filename.string());
+  MetadataFile meta(filename, MetadataFile::no_create_t(), true);
+  if (!meta.exists())
+  {
+    errno = ENOENT;
+    return -1;
+  }
+  vector<metadataObject> relevants = meta.metadataRead(offset, length);
+  fileLock.unlock();
+
+  vector<string> keys;
+  keys.reserve(relevants.size());
+  for (const auto& object : relevants)
+    keys.push_back(object.key);
+  if (!keys.empty())
+    cache->prefetch(firstDir, keys);
+  ++prefetchRequests;
+  return 0;
+}
+
 ssize_t IOCoordinator::write(const char* _filename, const uint8_t* data, off_t offset, size_t length)
 {
   ++callsToWrite;
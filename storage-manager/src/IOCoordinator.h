@@ -29,6 +29,8 @@
 
 #include "Config.h"
 #include "Cache.h"
+#include "SegmentCache.h"
+#include "MergeCache.h"
 #include "SMLogging.h"
 #include "RWLock.h"
 #include "Replicator.h"
@@ -37,6 +39,8 @@
 
 namespace storagemanager
 {
+struct metadataObject;
+
 std::shared_ptr<char[]> seekToEndOfHeader1(int fd, size_t* bytesRead);
 
 class IOCoordinator : public boost::noncopyable
@@ -46,6 +50,8 @@ class IOCoordinator : public boost::noncopyable
   virtual ~IOCoordinator();
 
   ssize_t read(const char* filename, uint8_t* data, off_t offset, size_t length);
+  // queues downloads of the objects backing [offset, offset + length) of filename.  Doesn't wait for them.
+  int prefetch(const char* filename, off_t offset, size_t length);
   ssize_t write(const char* filename, const uint8_t* data, off_t offset, size_t length);
   ssize_t append(const char* filename, const uint8_t* data, size_t length);
   int open(const char* filename, int openmode, struct stat* out);
@@ -94,6 +100,7 @@ class IOCoordinator : public boost::noncopyable
   IOCoordinator();
   Config* config;
   Cache* cache;
+  SegmentCache* segmentCache;
   SMLogging* logger;
   Replicator* replicator;
   Ownership ownership;  // ACK!  Need a new name for this!
@@ -116,15 +123,20 @@ class IOCoordinator : public boost::noncopyable
   int loadObjectAndJournal(const char* objFilename, const char* journalFilename, uint8_t* data, off_t offset,
                            size_t length);
   int loadObject(int fd, uint8_t* data, off_t offset, size_t length);
+  // loadObjectAndJournal() through the merge cache.  May ask the Synchronizer to compact the journal.
+  int loadMergedObject(const boost::filesystem::path& firstDir, const metadataObject& object,
+                       const char* objFilename, const char* journalFilename, int journalFD, uint8_t* data,
+                       off_t offset, size_t length);
+  MergeCache mergeCache;
 
   // some KPIs
   // from the user's POV...
   size_t bytesRead, bytesWritten, filesOpened, filesCreated, filesCopied;
-  size_t filesDeleted, bytesCopied, filesTruncated, listingCount, callsToWrite;
+  size_t filesDeleted, bytesCopied, filesTruncated, listingCount, callsToWrite, prefetchRequests;
 
   // from IOC's pov...
   size_t iocFilesOpened, iocObjectsCreated, iocJournalsCreated, iocFilesDeleted;
-  size_t iocBytesRead, iocBytesWritten;
+  size_t iocBytesRead, iocBytesWritten, journalsCompacted;
 };
 
 }  // namespace storagemanager
@@ -17,19 +17,22 @@
 
 #include <boost/filesystem.hpp>
 #include <iostream>
+#include <sstream>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <time.h>
+#include <unistd.h>
 #include "LocalStorage.h"
 #include "Config.h"
+#include "Utilities.h"
 
 using namespace std;
 namespace bf = boost::filesystem;
 
 namespace storagemanager
 {
-LocalStorage::LocalStorage()
+LocalStorage::LocalStorage() : nextUploadID(0)
 {
   prefix = Config::get()->getValue("LocalStorage", "path");
   // cout << "LS: got prefix " << prefix << endl;
@@ -172,6 +175,47 @@ int LocalStorage::getObject(const std::string& sourceKey, std::shared_ptr<uint8_
   return 0;
 }
 
+int LocalStorage::getObjectRange(const string& sourceKey, uint8_t* data, off_t offset, size_t length,
+                                 size_t* readLength)
+{
+  addLatency();
+
+  bf::path source = prefix / sourceKey;
+  int l_errno;
+
+  int fd = ::open(source.string().c_str(), O_RDONLY);
+  if (fd < 0)
+    return fd;
+
+  size_t count = 0;
+  while (count < length)
+  {
+    ssize_t err = ::pread(fd, &data[count], length - count, offset + count);
+    if (err < 0)
+    {
+      l_errno = errno;
+      close(fd);
+      bytesRead += count;
+      errno = l_errno;
+      return err;
+    }
+    if (err == 0)
+      break;
+    count += err;
+  }
+  close(fd);
+  if (readLength)
+    *readLength = count;
+  bytesRead += count;
+  ++objectsGotten;
+  return 0;
+}
+
+bool LocalStorage::supportsRangedGet() const
+{
+  return true;
+}
+
 int LocalStorage::putObject(const string& source, const string& dest)
 {
   addLatency();
@@ -231,6 +275,121 @@ int LocalStorage::putObject(std::shared_ptr<uint8_t[]> data, size_t len, const s
   return 0;
 }
 
+bool LocalStorage::supportsMultipartUpload() const
+{
+  return true;
+}
+
+int LocalStorage::startMultipartUpload(const string& dest, string* uploadID)
+{
+  addLatency();
+
+  ostringstream oss;
+  oss << dest << "." << ::getpid() << "." << ++nextUploadID;
+  boost::system::error_code err;
+  bf::create_directories(prefix / ".multipart" / oss.str(), err);
+  if (err)
+  {
+    errno = err.value();
+    return -1;
+  }
+  *uploadID = oss.str();
+  return 0;
+}
+
+int LocalStorage::putPart(const string&, const string& uploadID, uint partNumber, const uint8_t* data,
+                          size_t len)
+{
+  addLatency();
+
+  bf::path partPath = prefix / ".multipart" / uploadID / to_string(partNumber);
+  int fd = ::open(partPath.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0)
+    return fd;
+  ScopedCloser sc(fd);
+
+  size_t count = 0;
+  while (count < len)
+  {
+    ssize_t err = ::write(fd, &data[count], len - count);
+    if (err < 0)
+      return err;
+    count += err;
+  }
+  bytesWritten += count;
+  return 0;
+}
+
+int LocalStorage::completeMultipartUpload(const string& dest, const string& uploadID, uint partCount)
+{
+  addLatency();
+
+  bf::path partDir = prefix / ".multipart" / uploadID;
+  bf::path destPath = prefix / dest;
+  int fd = ::open(destPath.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0)
+    return fd;
+
+  // appends part to dest, returns its length or -1
+  auto appendPart = [&](uint part) -> ssize_t
+  {
+    bf::path partPath = partDir / to_string(part);
+    int partFD = ::open(partPath.string().c_str(), O_RDONLY);
+    if (partFD < 0)
+      return -1;
+    ScopedCloser sc(partFD);
+    size_t len = bf::file_size(partPath);
+    std::shared_ptr<uint8_t[]> data(new uint8_t[len]);
+    size_t count = 0;
+    while (count < len)
+    {
+      ssize_t err = ::read(partFD, &data[count], len - count);
+      if (err <= 0)
+      {
+        if (err == 0)
+          errno = ENODATA;
+        return -1;
+      }
+      count += err;
+    }
+    for (count = 0; count < len;)
+    {
+      ssize_t err = ::write(fd, &data[count], len - count);
+      if (err < 0)
+        return -1;
+      count += err;
+    }
+    return len;
+  };
+
+  size_t count = 0;
+  for (uint part = 1; part <= partCount; part++)
+  {
+    ssize_t err = appendPart(part);
+    if (err < 0)
+    {
+      int l_errno = errno;
+      close(fd);
+      ::unlink(destPath.string().c_str());
+      errno = l_errno;
+      return -1;
+    }
+    count += err;
+  }
+  close(fd);
+  bf::remove_all(partDir);
+  bytesWritten += count;
+  ++objectsPut;
+  return 0;
+}
+
+int LocalStorage::abortMultipartUpload(const string&, const string& uploadID)
+{
+  boost::system::error_code err;
+  bf::remove_all(prefix / ".multipart" / uploadID, err);
+  return 0;
+}
+
 int LocalStorage::copyObject(const string& source, const string& dest)
 {
   addLatency();
@@ -22,6 +22,7 @@
 #include "SMLogging.h"
 #include <boost/filesystem/path.hpp>
 #include <memory>
+#include <atomic>
 
 namespace storagemanager
 {
@@ -38,6 +39,10 @@ class LocalStorage : public CloudStorage
   int deleteObject(const std::string& key);
   int copyObject(const std::string& sourceKey, const std::string& destKey);
   int exists(const std::string& key, bool* out);
+  int getObjectRange(const std::string& sourceKey, uint8_t* data, off_t offset, size_t length,
+                     size_t* readLength);
+  bool supportsRangedGet() const;
+  bool supportsMultipartUpload() const;
 
   const boost::filesystem::path& getPrefix() const;
   void printKPIs() const;
@@ -45,8 +50,16 @@ class LocalStorage : public CloudStorage
  protected:
   size_t bytesRead, bytesWritten;
 
+  // a multipart upload keeps its parts in their own directory under prefix/.multipart until it's completed
+  int startMultipartUpload(const std::string& destKey, std::string* uploadID);
+  int putPart(const std::string& destKey, const std::string& uploadID, uint partNumber, const uint8_t* data,
+              size_t len);
+  int completeMultipartUpload(const std::string& destKey, const std::string& uploadID, uint partCount);
+  int abortMultipartUpload(const std::string& destKey, const std::string& uploadID);
+
  private:
   boost::filesystem::path prefix;
+  std::atomic<uint64_t> nextUploadID;
   int copy(const boost::filesystem::path& sourceKey, const boost::filesystem::path& destKey);
 
   // stuff for faking the latency on cloud ops
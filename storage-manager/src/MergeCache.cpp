@@ -0,0 +1,200 @@
+/* Copyright (C) 2019 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include "MergeCache.h"
+#include <iostream>
+#include <syslog.h>
+
+using namespace std;
+
+namespace storagemanager
+{
+MergeCache::MergeCache() : maxSize(0), currentSize(0), compactJournalSize(0), compactReadCount(0)
+{
+  logger = SMLogging::get();
+  hits = misses = stale = 0;
+
+  configListener();
+  Config::get()->addConfigListener(this);
+}
+
+MergeCache::~MergeCache()
+{
+  Config::get()->removeConfigListener(this);
+}
+
+bool MergeCache::enabled() const
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+  return maxSize != 0;
+}
+
+shared_ptr<uint8_t[]> MergeCache::get(const string& key, const struct stat& journalStat, size_t* length,
+                                       uint* reads)
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+
+  *reads = 0;
+  auto it = entries.find(key);
+  if (it == entries.end())
+  {
+    ++misses;
+    return shared_ptr<uint8_t[]>();
+  }
+
+  Entry& entry = it->second;
+  if (entry.journalSize != journalStat.st_size || entry.journalMTime.tv_sec != journalStat.st_mtim.tv_sec ||
+      entry.journalMTime.tv_nsec != journalStat.st_mtim.tv_nsec)
+  {
+    // the journal has grown since this was merged
+    ++stale;
+    ++misses;
+    currentSize -= entry.length;
+    lru.erase(entry.lruPos);
+    entries.erase(it);
+    return shared_ptr<uint8_t[]>();
+  }
+
+  ++hits;
+  lru.splice(lru.begin(), lru, entry.lruPos);
+  *length = entry.length;
+  *reads = ++entry.reads;
+  return entry.data;
+}
+
+void MergeCache::put(const string& key, const struct stat& journalStat, const shared_ptr<uint8_t[]>& data,
+                     size_t length)
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+
+  if (length > maxSize)
+    return;
+
+  auto it = entries.find(key);
+  if (it != entries.end())
+  {
+    currentSize -= it->second.length;
+    lru.erase(it->second.lruPos);
+    entries.erase(it);
+  }
+
+  lru.push_front(key);
+  Entry& entry = entries[key];
+  entry.data = data;
+  entry.length = length;
+  entry.journalSize = journalStat.st_size;
+  entry.journalMTime = journalStat.st_mtim;
+  entry.reads = 0;
+  entry.lruPos = lru.begin();
+  currentSize += length;
+  evict();
+}
+
+bool MergeCache::shouldCompact(size_t journalSize, uint reads) const
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+
+  // trigger once per journal version: on the first read for size, and when the read count is reached
+  if (reads == 0 && compactJournalSize != 0 && journalSize >= compactJournalSize)
+    return true;
+  return compactReadCount != 0 && reads == compactReadCount;
+}
+
+void MergeCache::evict()
+{
+  while (currentSize > maxSize && !lru.empty())
+  {
+    auto it = entries.find(lru.back());
+    currentSize -= it->second.length;
+    entries.erase(it);
+    lru.pop_back();
+  }
+}
+
+void MergeCache::reset()
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+  entries.clear();
+  lru.clear();
+  currentSize = 0;
+}
+
+void MergeCache::printKPIs() const
+{
+  cout << "\tMergeCache" << endl;
+  cout << "\t\thits = " << hits << endl;
+  cout << "\t\tmisses = " << misses << endl;
+  cout << "\t\tstale = " << stale << endl;
+}
+
+void MergeCache::configListener()
+{
+  Config* conf = Config::get();
+  size_t newMaxSize = 128 << 20, newJournalSize = 1 << 20;
+  uint newReadCount = 8;
+
+  // merge_cache_size = 0 disables the merge cache and the read-triggered compaction
+  string stmp = conf->getValue("Cache", "merge_cache_size");
+  try
+  {
+    if (!stmp.empty())
+      newMaxSize = stoull(stmp);
+  }
+  catch (invalid_argument&)
+  {
+    logger->log(LOG_CRIT, "Cache/merge_cache_size is not a number. Using current value = %zu", maxSize);
+    newMaxSize = maxSize;
+  }
+
+  stmp = conf->getValue("ObjectStorage", "journal_compaction_size");
+  try
+  {
+    if (!stmp.empty())
+      newJournalSize = stoull(stmp);
+  }
+  catch (invalid_argument&)
+  {
+    logger->log(LOG_CRIT, "ObjectStorage/journal_compaction_size is not a number. Using current value = %zu",
+                compactJournalSize);
+    newJournalSize = compactJournalSize;
+  }
+
+  stmp = conf->getValue("ObjectStorage", "journal_compaction_reads");
+  try
+  {
+    if (!stmp.empty())
+      newReadCount = stoul(stmp);
+  }
+  catch (invalid_argument&)
+  {
+    logger->log(LOG_CRIT, "ObjectStorage/journal_compaction_reads is not a number. Using current value = %u",
+                compactReadCount);
+    newReadCount = compactReadCount;
+  }
+
+  boost::unique_lock<boost::mutex> s(mutex);
+  if (newMaxSize != maxSize)
+  {
+    maxSize = newMaxSize;
+    evict();
+    logger->log(LOG_INFO, "Cache/merge_cache_size = %zu", maxSize);
+  }
+  compactJournalSize = newJournalSize;
+  compactReadCount = newReadCount;
+}
+
+}  // namespace storagemanager
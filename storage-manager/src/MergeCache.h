@@ -0,0 +1,91 @@
+/* Copyright (C) 2019 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+/* MergeCache keeps recently merged object + journal images in memory so that repeated reads
+   of an object with a journal don't redo the merge each time.  An entry is only valid for the
+   version of the journal it was built from; journals are append-only, so that version is
+   identified by the journal's size and mtime.
+
+   It also decides when a journal has gotten big or hot enough that it should be merged into
+   a new object ahead of the Synchronizer's schedule.
+*/
+
+#include "Config.h"
+#include "SMLogging.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace storagemanager
+{
+class MergeCache : public boost::noncopyable, public ConfigListener
+{
+ public:
+  MergeCache();
+  virtual ~MergeCache();
+
+  bool enabled() const;
+
+  // returns the merged image of key if there is one for this version of its journal.  reads gets the
+  // number of times this version has been read from the cache, including this one.
+  std::shared_ptr<uint8_t[]> get(const std::string& key, const struct stat& journalStat, size_t* length,
+                                 uint* reads);
+  void put(const std::string& key, const struct stat& journalStat, const std::shared_ptr<uint8_t[]>& data,
+           size_t length);
+
+  // true if the journal should be compacted now.  Call after get() with what it returned.
+  bool shouldCompact(size_t journalSize, uint reads) const;
+
+  void reset();
+  void printKPIs() const;
+
+  virtual void configListener() override;
+
+ private:
+  struct Entry
+  {
+    std::shared_ptr<uint8_t[]> data;
+    size_t length;
+    off_t journalSize;
+    struct timespec journalMTime;
+    uint reads;
+    std::list<std::string>::iterator lruPos;
+  };
+
+  void evict();  // call holding mutex
+
+  SMLogging* logger;
+  size_t maxSize;
+  size_t currentSize;
+  size_t compactJournalSize;
+  uint compactReadCount;
+  std::map<std::string, Entry> entries;
+  std::list<std::string> lru;  // front = most recently used
+  mutable boost::mutex mutex;
+
+  // KPIs
+  size_t hits, misses, stale;
+};
+
+}  // namespace storagemanager
@@ -19,7 +19,9 @@
  * MetadataFile.cpp
  */
 #include "MetadataFile.h"
-#include <set>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 #include <boost/filesystem.hpp>
 #define BOOST_SPIRIT_THREADSAFE
 #ifndef __clang__
@@ -38,6 +40,8 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/uuid/random_generator.hpp>
 #include <unistd.h>
+#include <errno.h>
+#include <string.h>
 
 #define max(x, y) (x > y ? x : y)
 #define min(x, y) (x < y ? x : y)
@@ -51,6 +55,26 @@ namespace
 boost::mutex mdfLock;
 storagemanager::MetadataFile::MetadataConfig* inst = NULL;
 uint64_t metadataFilesAccessed = 0;
+
+/* The binary metadata format.  A header followed by objectCount entries, each followed by its key.
+   Integers are in host byte order; metadata files are local to the node that wrote them. */
+const char binaryMagic[4] = {'S', 'M', 'M', 'D'};
+const uint32_t binaryVersion = 1;
+
+struct BinaryHeader
+{
+  char magic[4];
+  uint32_t version;
+  uint32_t revision;
+  uint32_t objectCount;
+} __attribute__((packed));
+
+struct BinaryEntry
+{
+  uint64_t offset;
+  uint64_t length;
+  uint32_t keyLength;
+} __attribute__((packed));
 }  // namespace
 
 namespace storagemanager
@@ -96,6 +120,17 @@ MetadataFile::MetadataConfig::MetadataConfig()
     throw runtime_error("Please set ObjectStorage/metadata_path in the storagemanager.cnf file");
   }
 
+  string stmp = config->getValue("ObjectStorage", "metadata_format");
+  if (stmp.empty() || stmp == "json")
+    mFormat = JSON;
+  else if (stmp == "binary")
+    mFormat = BINARY;
+  else
+  {
+    logger->log(LOG_CRIT, "ObjectStorage/metadata_format must be json or binary.  Using json.");
+    mFormat = JSON;
+  }
+
   try
   {
     boost::filesystem::create_directories(msMetadataPath);
@@ -124,24 +159,23 @@ MetadataFile::MetadataFile(const boost::filesystem::path& filename)
 
   mFilename = mpConfig->msMetadataPath / (filename.string() + ".meta");
 
-  boost::unique_lock<boost::mutex> s(jsonCache.getMutex());
-  jsontree = jsonCache.get(mFilename);
-  if (!jsontree)
+  boost::unique_lock<boost::mutex> s(metadataCache.getMutex(mFilename));
+  contents = metadataCache.get(mFilename);
+  if (!contents)
   {
     if (boost::filesystem::exists(mFilename))
     {
-      jsontree.reset(new bpt::ptree());
-      boost::property_tree::read_json(mFilename.string(), *jsontree);
-      jsonCache.put(mFilename, jsontree);
+      contents = readContents(mFilename);
+      metadataCache.put(mFilename, contents);
       s.unlock();
       mVersion = 1;
-      mRevision = jsontree->get<int>("revision");
+      mRevision = contents->revision;
     }
     else
     {
       mVersion = 1;
       mRevision = 1;
-      makeEmptyJsonTree();
+      makeEmptyContents();
       s.unlock();
       writeMetadata();
     }
@@ -150,7 +184,7 @@ MetadataFile::MetadataFile(const boost::filesystem::path& filename)
   {
     s.unlock();
     mVersion = 1;
-    mRevision = jsontree->get<int>("revision");
+    mRevision = contents->revision;
   }
   ++metadataFilesAccessed;
 }
@@ -165,26 +199,25 @@ MetadataFile::MetadataFile(const boost::filesystem::path& filename, no_create_t,
   if (appendExt)
     mFilename = mpConfig->msMetadataPath / (mFilename.string() + ".meta");
 
-  boost::unique_lock<boost::mutex> s(jsonCache.getMutex());
-  jsontree = jsonCache.get(mFilename);
-  if (!jsontree)
+  boost::unique_lock<boost::mutex> s(metadataCache.getMutex(mFilename));
+  contents = metadataCache.get(mFilename);
+  if (!contents)
   {
     if (boost::filesystem::exists(mFilename))
     {
       _exists = true;
-      jsontree.reset(new bpt::ptree());
-      boost::property_tree::read_json(mFilename.string(), *jsontree);
-      jsonCache.put(mFilename, jsontree);
+      contents = readContents(mFilename);
+      metadataCache.put(mFilename, contents);
       s.unlock();
       mVersion = 1;
-      mRevision = jsontree->get<int>("revision");
+      mRevision = contents->revision;
     }
     else
     {
       mVersion = 1;
       mRevision = 1;
       _exists = false;
-      makeEmptyJsonTree();
+      makeEmptyContents();
     }
   }
   else
@@ -192,7 +225,7 @@ MetadataFile::MetadataFile(const boost::filesystem::path& filename, no_create_t,
     s.unlock();
     _exists = true;
     mVersion = 1;
-    mRevision = jsontree->get<int>("revision");
+    mRevision = contents->revision;
   }
   ++metadataFilesAccessed;
 }
@@ -201,13 +234,93 @@ MetadataFile::~MetadataFile()
 {
 }
 
-void MetadataFile::makeEmptyJsonTree()
+void MetadataFile::makeEmptyContents()
+{
+  contents.reset(new Contents());
+  contents->revision = mRevision;
+}
+
+MetadataFile::Contents_t MetadataFile::readContents(const bf::path& filename)
 {
-  jsontree.reset(new bpt::ptree());
-  boost::property_tree::ptree objs;
-  jsontree->put("version", mVersion);
-  jsontree->put("revision", mRevision);
-  jsontree->add_child("objects", objs);
+  ifstream in(filename.string(), ios::in | ios::binary);
+  if (!in)
+    throw runtime_error("MetadataFile: failed to open " + filename.string());
+  stringstream buf;
+  buf << in.rdbuf();
+  const string data = buf.str();
+
+  Contents_t ret(new Contents());
+  if (data.length() >= sizeof(BinaryHeader) && memcmp(data.data(), binaryMagic, sizeof(binaryMagic)) == 0)
+  {
+    const BinaryHeader* header = reinterpret_cast<const BinaryHeader*>(data.data());
+    if (header->version != binaryVersion)
+      throw runtime_error("MetadataFile: " + filename.string() + " has an unknown binary format version");
+    ret->revision = header->revision;
+    ret->objects.reserve(header->objectCount);
+
+    size_t pos = sizeof(BinaryHeader);
+    for (uint32_t i = 0; i < header->objectCount; i++)
+    {
+      if (pos + sizeof(BinaryEntry) > data.length())
+        throw runtime_error("MetadataFile: " + filename.string() + " is truncated");
+      const BinaryEntry* entry = reinterpret_cast<const BinaryEntry*>(&data[pos]);
+      pos += sizeof(BinaryEntry);
+      if (pos + entry->keyLength > data.length())
+        throw runtime_error("MetadataFile: " + filename.string() + " is truncated");
+      ret->objects.emplace_back(entry->offset, entry->length, data.substr(pos, entry->keyLength));
+      pos += entry->keyLength;
+    }
+  }
+  else
+  {
+    bpt::ptree jsontree;
+    stringstream ss(data);
+    bpt::read_json(ss, jsontree);
+    ret->revision = jsontree.get<int>("revision");
+    BOOST_FOREACH (const bpt::ptree::value_type& v, jsontree.get_child("objects"))
+      ret->objects.emplace_back(v.second.get<uint64_t>("offset"), v.second.get<uint64_t>("length"),
+                                v.second.get<string>("key"));
+  }
+  // everything else assumes the objects are in offset order
+  if (!is_sorted(ret->objects.begin(), ret->objects.end()))
+    sort(ret->objects.begin(), ret->objects.end());
+  return ret;
+}
+
+void MetadataFile::writeJson(const Contents& c, int version, ostream& out)
+{
+  bpt::ptree jsontree, objs;
+  jsontree.put("version", version);
+  jsontree.put("revision", c.revision);
+  for (const metadataObject& o : c.objects)
+  {
+    bpt::ptree object;
+    object.put("offset", o.offset);
+    object.put("length", o.length);
+    object.put("key", o.key);
+    objs.push_back(make_pair("", object));
+  }
+  jsontree.add_child("objects", objs);
+  bpt::write_json(out, jsontree);
+}
+
+void MetadataFile::writeBinary(const Contents& c, ostream& out)
+{
+  BinaryHeader header;
+  memcpy(header.magic, binaryMagic, sizeof(binaryMagic));
+  header.version = binaryVersion;
+  header.revision = c.revision;
+  header.objectCount = c.objects.size();
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const metadataObject& o : c.objects)
+  {
+    BinaryEntry entry;
+    entry.offset = o.offset;
+    entry.length = o.length;
+    entry.keyLength = o.key.length();
+    out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    out.write(o.key.data(), o.key.length());
+  }
 }
 
 void MetadataFile::printKPIs()
@@ -229,11 +342,10 @@ size_t MetadataFile::getLength() const
 {
   size_t totalSize = 0;
 
-  auto& objects = jsontree->get_child("objects");
-  if (!objects.empty())
+  if (!contents->objects.empty())
   {
-    auto& lastObject = objects.back().second;
-    totalSize = lastObject.get<off_t>("offset") + lastObject.get<size_t>("length");
+    const metadataObject& lastObject = contents->objects.back();
+    totalSize = lastObject.offset + lastObject.length;
   }
   return totalSize;
 }
@@ -248,25 +360,19 @@ vector<metadataObject> MetadataFile::metadataRead(off_t offset, size_t length) c
   // this version assumes mObjects is sorted by offset, and there are no gaps between objects
   vector<metadataObject> ret;
   size_t foundLen = 0;
-
-  /* For first cut of optimizations, going to generate mObjects as it was to use the existing alg
-     rather than write a new alg.
-  */
-  set<metadataObject> mObjects;
-  BOOST_FOREACH (const boost::property_tree::ptree::value_type& v, jsontree->get_child("objects"))
-  {
-    mObjects.insert(metadataObject(v.second.get<uint64_t>("offset"), v.second.get<uint64_t>("length"),
-                                   v.second.get<string>("key")));
-  }
+  const vector<metadataObject>& mObjects = contents->objects;
 
   if (mObjects.size() == 0)
     return ret;
 
   uint64_t lastOffset = mObjects.rbegin()->offset;
-  auto i = mObjects.begin();
-  // find the first object in range
+  // find the first object in range.  Objects are contiguous, so the candidate is the last object
+  // starting at or before offset.
   // Note, the last object in mObjects may not be full, compare the last one against its maximum
   // size rather than its current size.
+  auto i = upper_bound(mObjects.begin(), mObjects.end(), metadataObject(offset));
+  if (i != mObjects.begin())
+    --i;
   while (i != mObjects.end())
   {
     if ((uint64_t)offset <= (i->offset + i->length - 1) ||
@@ -298,20 +404,13 @@ metadataObject MetadataFile::addMetadataObject(const boost::filesystem::path& fi
   //
 
   metadataObject addObject;
-  auto& objects = jsontree->get_child("objects");
+  vector<metadataObject>& objects = contents->objects;
   if (!objects.empty())
-  {
-    auto& lastObject = objects.back().second;
-    addObject.offset = lastObject.get<off_t>("offset") + mpConfig->mObjectSize;
-  }
+    addObject.offset = objects.back().offset + mpConfig->mObjectSize;
 
   addObject.length = length;
   addObject.key = getNewKey(filename.string(), addObject.offset, addObject.length);
-  boost::property_tree::ptree object;
-  object.put("offset", addObject.offset);
-  object.put("length", addObject.length);
-  object.put("key", addObject.key);
-  objects.push_back(make_pair("", object));
+  objects.push_back(addObject);
 
   return addObject;
 }
@@ -322,53 +421,74 @@ int MetadataFile::writeMetadata()
   if (!boost::filesystem::exists(mFilename.parent_path()))
     boost::filesystem::create_directories(mFilename.parent_path());
 
-  write_json(mFilename.string(), *jsontree);
+  // Write a temp file and rename it over the old one so a reader never sees a partial file.
+  // A JSON file gets converted here the first time it's modified after metadata_format is set to binary.
+  bf::path tmpFilename = mFilename.string() + ".tmp";
+  {
+    ofstream out(tmpFilename.string(), ios::out | ios::binary | ios::trunc);
+    if (mpConfig->mFormat == MetadataConfig::BINARY)
+      writeBinary(*contents, out);
+    else
+      writeJson(*contents, mVersion, out);
+    out.close();
+    if (!out)
+    {
+      int l_errno = errno;
+      char buf[80];
+      mpLogger->log(LOG_ERR, "MetadataFile::writeMetadata(): failed to write %s, got %s",
+                    tmpFilename.string().c_str(), strerror_r(l_errno, buf, 80));
+      ::unlink(tmpFilename.string().c_str());
+      errno = l_errno;
+      return -1;
+    }
+  }
+  if (::rename(tmpFilename.string().c_str(), mFilename.string().c_str()))
+  {
+    int l_errno = errno;
+    char buf[80];
+    mpLogger->log(LOG_ERR, "MetadataFile::writeMetadata(): failed to rename %s, got %s",
+                  tmpFilename.string().c_str(), strerror_r(l_errno, buf, 80));
+    ::unlink(tmpFilename.string().c_str());
+    errno = l_errno;
+    return -1;
+  }
   _exists = true;
 
-  boost::unique_lock<boost::mutex> s(jsonCache.getMutex());
-  jsonCache.put(mFilename, jsontree);
+  boost::unique_lock<boost::mutex> s(metadataCache.getMutex(mFilename));
+  metadataCache.put(mFilename, contents);
 
   return 0;
 }
 
 bool MetadataFile::getEntry(off_t offset, metadataObject* out) const
 {
-  metadataObject addObject;
-  BOOST_FOREACH (const boost::property_tree::ptree::value_type& v, jsontree->get_child("objects"))
+  const vector<metadataObject>& objects = contents->objects;
+  auto it = lower_bound(objects.begin(), objects.end(), metadataObject(offset));
+  if (it != objects.end() && it->offset == (uint64_t)offset)
   {
-    if (v.second.get<off_t>("offset") == offset)
-    {
-      out->offset = offset;
-      out->length = v.second.get<size_t>("length");
-      out->key = v.second.get<string>("key");
-      return true;
-    }
+    *out = *it;
+    return true;
   }
   return false;
 }
 
 void MetadataFile::removeEntry(off_t offset)
 {
-  bpt::ptree& objects = jsontree->get_child("objects");
-  for (bpt::ptree::iterator it = objects.begin(); it != objects.end(); ++it)
-  {
-    if (it->second.get<off_t>("offset") == offset)
-    {
-      objects.erase(it);
-      break;
-    }
-  }
+  vector<metadataObject>& objects = contents->objects;
+  auto it = lower_bound(objects.begin(), objects.end(), metadataObject(offset));
+  if (it != objects.end() && it->offset == (uint64_t)offset)
+    objects.erase(it);
 }
 
 void MetadataFile::removeAllEntries()
 {
-  jsontree->get_child("objects").clear();
+  contents->objects.clear();
 }
 
 void MetadataFile::deletedMeta(const bf::path& p)
 {
-  boost::unique_lock<boost::mutex> s(jsonCache.getMutex());
-  jsonCache.erase(p);
+  boost::unique_lock<boost::mutex> s(metadataCache.getMutex(p));
+  metadataCache.erase(p);
 }
 
 // There are more efficient ways to do it.  Optimize if necessary.
@@ -466,23 +586,19 @@ void MetadataFile::setLengthInKey(string& key, size_t newLength)
 
 void MetadataFile::printObjects() const
 {
-  BOOST_FOREACH (const boost::property_tree::ptree::value_type& v, jsontree->get_child("objects"))
-  {
-    printf("Name: %s Length: %zu Offset: %lld\n", v.second.get<string>("key").c_str(),
-           v.second.get<size_t>("length"), (long long)v.second.get<off_t>("offset"));
-  }
+  for (const metadataObject& o : contents->objects)
+    printf("Name: %s Length: %zu Offset: %lld\n", o.key.c_str(), (size_t)o.length, (long long)o.offset);
 }
 
 void MetadataFile::updateEntry(off_t offset, const string& newName, size_t newLength)
 {
-  for (auto& v : jsontree->get_child("objects"))
+  vector<metadataObject>& objects = contents->objects;
+  auto it = lower_bound(objects.begin(), objects.end(), metadataObject(offset));
+  if (it != objects.end() && it->offset == (uint64_t)offset)
   {
-    if (v.second.get<off_t>("offset") == offset)
-    {
-      v.second.put("key", newName);
-      v.second.put("length", newLength);
-      return;
-    }
+    it->key = newName;
+    it->length = newLength;
+    return;
   }
   stringstream ss;
   ss << "MetadataFile::updateEntry(): failed to find object at offset " << offset;
@@ -492,13 +608,12 @@ void MetadataFile::updateEntry(off_t offset, const string& newName, size_t newLe
 
 void MetadataFile::updateEntryLength(off_t offset, size_t newLength)
 {
-  for (auto& v : jsontree->get_child("objects"))
+  vector<metadataObject>& objects = contents->objects;
+  auto it = lower_bound(objects.begin(), objects.end(), metadataObject(offset));
+  if (it != objects.end() && it->offset == (uint64_t)offset)
   {
-    if (v.second.get<off_t>("offset") == offset)
-    {
-      v.second.put("length", newLength);
-      return;
-    }
+    it->length = newLength;
+    return;
   }
   stringstream ss;
   ss << "MetadataFile::updateEntryLength(): failed to find object at offset " << offset;
@@ -508,11 +623,7 @@ void MetadataFile::updateEntryLength(off_t offset, size_t newLength)
 
 off_t MetadataFile::getMetadataNewObjectOffset()
 {
-  auto& objects = jsontree->get_child("objects");
-  if (objects.empty())
-    return 0;
-  auto& lastObject = jsontree->get_child("objects").back().second;
-  return lastObject.get<off_t>("offset") + lastObject.get<size_t>("length");
+  return getLength();
 }
 
 metadataObject::metadataObject() : offset(0), length(0)
@@ -529,55 +640,63 @@ metadataObject::metadataObject(uint64_t _offset, uint64_t _length, const std::st
 }
 
 MetadataFile::MetadataCache::MetadataCache()
- : max_lru_size(2000)  // 2000 is an arbitrary #.  Big enough for a large working set.
+ : max_lru_size(1024)  // per shard.  An arbitrary #, big enough for a large working set.
+{
+}
+
+inline MetadataFile::MetadataCache::Shard& MetadataFile::MetadataCache::getShard(const bf::path& p)
 {
+  return shards[std::hash<string>()(p.string()) % numShards];
 }
 
-inline boost::mutex& MetadataFile::MetadataCache::getMutex()
+boost::mutex& MetadataFile::MetadataCache::getMutex(const bf::path& p)
 {
-  return mutex;
+  return getShard(p).mutex;
 }
 
-MetadataFile::Jsontree_t MetadataFile::MetadataCache::get(const bf::path& p)
+MetadataFile::Contents_t MetadataFile::MetadataCache::get(const bf::path& p)
 {
-  auto it = lookup.find(p.string());
-  if (it != lookup.end())
+  Shard& shard = getShard(p);
+  auto it = shard.lookup.find(p.string());
+  if (it != shard.lookup.end())
   {
-    lru.splice(lru.end(), lru, it->second.second);
+    shard.lru.splice(shard.lru.end(), shard.lru, it->second.second);
     return it->second.first;
   }
 
-  return storagemanager::MetadataFile::Jsontree_t();
+  return storagemanager::MetadataFile::Contents_t();
 }
 
-// note, does not change an existing jsontree.  This should be OK.
-void MetadataFile::MetadataCache::put(const bf::path& p, const Jsontree_t& j)
+// note, does not change an existing entry.  This should be OK.
+void MetadataFile::MetadataCache::put(const bf::path& p, const Contents_t& c)
 {
+  Shard& shard = getShard(p);
   string sp = p.string();
-  auto it = lookup.find(sp);
-  if (it == lookup.end())
+  auto it = shard.lookup.find(sp);
+  if (it == shard.lookup.end())
   {
-    while (lru.size() >= max_lru_size)
+    while (shard.lru.size() >= max_lru_size)
     {
-      lookup.erase(lru.front());
-      lru.pop_front();
+      shard.lookup.erase(shard.lru.front());
+      shard.lru.pop_front();
     }
-    lru.push_back(sp);
-    Lru_t::iterator last = lru.end();
-    lookup.emplace(sp, make_pair(j, --last));
+    shard.lru.push_back(sp);
+    Lru_t::iterator last = shard.lru.end();
+    shard.lookup.emplace(sp, make_pair(c, --last));
   }
 }
 
 void MetadataFile::MetadataCache::erase(const bf::path& p)
 {
-  auto it = lookup.find(p.string());
-  if (it != lookup.end())
+  Shard& shard = getShard(p);
+  auto it = shard.lookup.find(p.string());
+  if (it != shard.lookup.end())
   {
-    lru.erase(it->second.second);
-    lookup.erase(it);
+    shard.lru.erase(it->second.second);
+    shard.lookup.erase(it);
   }
 }
 
-MetadataFile::MetadataCache MetadataFile::jsonCache;
+MetadataFile::MetadataCache MetadataFile::metadataCache;
 
 }  // namespace storagemanager
@@ -26,6 +26,9 @@
 #include <vector>
 #include <iostream>
 #include <unordered_map>
+#include <list>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/filesystem/path.hpp>
 
 namespace storagemanager
@@ -79,7 +82,7 @@ class MetadataFile
   void removeEntry(off_t offset);
   void removeAllEntries();
 
-  // removes p from the json cache.  p should be a fully qualified metadata file
+  // removes p from the metadata cache.  p should be a fully qualified metadata file
   static void deletedMeta(const boost::filesystem::path& p);
 
   static std::string getNewKeyFromOldKey(const std::string& oldKey, size_t length = 0);
@@ -103,6 +106,13 @@ class MetadataFile
     static MetadataConfig* get();
     size_t mObjectSize;
     boost::filesystem::path msMetadataPath;
+    // the format new and modified metadata files are written in.  Both formats are always readable.
+    enum Format
+    {
+      JSON,
+      BINARY
+    };
+    Format mFormat;
 
    private:
     MetadataConfig();
@@ -110,7 +120,14 @@ class MetadataFile
 
   static void printKPIs();
 
-  typedef boost::shared_ptr<boost::property_tree::ptree> Jsontree_t;
+  // The parsed contents of a metadata file.  Every MetadataFile instance for the same file shares
+  // one of these through the metadata cache.  objects is sorted by offset.
+  struct Contents
+  {
+    int revision;
+    std::vector<metadataObject> objects;
+  };
+  typedef boost::shared_ptr<Contents> Contents_t;
 
  private:
   MetadataConfig* mpConfig;
@@ -118,30 +135,42 @@ class MetadataFile
   int mVersion;
   int mRevision;
   boost::filesystem::path mFilename;
-  Jsontree_t jsontree;
-  // std::set<metadataObject> mObjects;
+  Contents_t contents;
   bool _exists;
-  void makeEmptyJsonTree();
+  void makeEmptyContents();
+
+  // parses either format; throws on a corrupt file
+  static Contents_t readContents(const boost::filesystem::path& filename);
+  static void writeJson(const Contents& c, int version, std::ostream& out);
+  static void writeBinary(const Contents& c, std::ostream& out);
 
+  // The cache is split into shards by path so that opening unrelated files doesn't serialize on
+  // a single mutex.  getMutex(p) returns the lock for p's shard; get/put/erase must be called
+  // holding it.
   class MetadataCache
   {
    public:
     MetadataCache();
-    Jsontree_t get(const boost::filesystem::path&);
-    void put(const boost::filesystem::path&, const Jsontree_t&);
+    Contents_t get(const boost::filesystem::path&);
+    void put(const boost::filesystem::path&, const Contents_t&);
     void erase(const boost::filesystem::path&);
-    boost::mutex& getMutex();
+    boost::mutex& getMutex(const boost::filesystem::path&);
 
    private:
-    // there's a more efficient way to do this, KISS for now.
     typedef std::list<std::string> Lru_t;
-    typedef std::unordered_map<std::string, std::pair<Jsontree_t, Lru_t::iterator> > Lookup_t;
-    Lookup_t lookup;
-    Lru_t lru;
-    uint max_lru_size;
-    boost::mutex mutex;
+    typedef std::unordered_map<std::string, std::pair<Contents_t, Lru_t::iterator> > Lookup_t;
+    struct Shard
+    {
+      Lookup_t lookup;
+      Lru_t lru;
+      boost::mutex mutex;
+    };
+    static const uint numShards = 16;
+    Shard& getShard(const boost::filesystem::path&);
+    Shard shards[numShards];
+    uint max_lru_size;  // per shard
   };
-  static MetadataCache jsonCache;
+  static MetadataCache metadataCache;
 };
 
 }  // namespace storagemanager
@@ -28,6 +28,7 @@
 #include "ListIOTask.h"
 #include "OpenTask.h"
 #include "PingTask.h"
+#include "PrefetchTask.h"
 #include "ReadTask.h"
 #include "StatTask.h"
 #include "TerminateIOTask.h"
@@ -97,6 +98,7 @@ void ProcessTask::operator()()
     case COPY: task.reset(new CopyTask(sock, length)); break;
     case LIST_IOTASKS: task.reset(new ListIOTask(sock, length)); break;
     case TERMINATE_IOTASK: task.reset(new TerminateIOTask(sock, length)); break;
+    case PREFETCH: task.reset(new PrefetchTask(sock, length)); break;
     default: throw runtime_error("ProcessTask: got an unknown opcode");
   }
   task->primeBuffer();
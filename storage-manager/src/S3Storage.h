@@ -43,6 +43,9 @@ class S3Storage : public CloudStorage
   int deleteObject(const std::string& key) override;
   int copyObject(const std::string& sourceKey, const std::string& destKey) override;
   int exists(const std::string& key, bool* out) override;
+  // libmarias3 has no ranged get, so getObjectRange() uses the whole-object fallback in CloudStorage
+  // and supportsRangedGet() stays false.
+  // Likewise it has no multipart upload API, so putObjectMultipart() sends a single PUT.
 
   std::vector<IOTaskData> taskList() const override;
   bool killTask(uint64_t task_id) override;
@@ -0,0 +1,275 @@
+/* Copyright (C) 2019 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include "SegmentCache.h"
+#include <iostream>
+#include <vector>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <syslog.h>
+
+using namespace std;
+
+namespace
+{
+boost::mutex m;
+storagemanager::SegmentCache* inst = NULL;
+}  // namespace
+
+namespace storagemanager
+{
+SegmentCache* SegmentCache::get()
+{
+  if (inst)
+    return inst;
+  boost::unique_lock<boost::mutex> s(m);
+  if (inst)
+    return inst;
+  inst = new SegmentCache();
+  return inst;
+}
+
+SegmentCache::SegmentCache() : segmentSize(0), maxSize(0), currentSize(0)
+{
+  cs = CloudStorage::get();
+  logger = SMLogging::get();
+  hits = misses = rangedGets = bytesFetched = 0;
+
+  configListener();
+  Config::get()->addConfigListener(this);
+}
+
+SegmentCache::~SegmentCache()
+{
+  Config::get()->removeConfigListener(this);
+}
+
+bool SegmentCache::enabled() const
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+  return segmentSize != 0 && maxSize != 0 && cs->supportsRangedGet();
+}
+
+size_t SegmentCache::getSegmentSize() const
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+  return segmentSize;
+}
+
+size_t SegmentCache::getCurrentSize() const
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+  return currentSize;
+}
+
+ssize_t SegmentCache::read(const string& key, size_t objectLength, uint8_t* data, off_t offset,
+                           size_t length)
+{
+  if ((size_t)offset >= objectLength)
+    return 0;
+  length = min(length, objectLength - offset);
+  if (length == 0)
+    return 0;
+
+  boost::unique_lock<boost::mutex> s(mutex);
+  const size_t segSize = segmentSize;
+  if (segSize == 0)
+  {
+    errno = EINVAL;
+    return -1;
+  }
+  const size_t first = offset / segSize;
+  const size_t numSegs = (offset + length - 1) / segSize - first + 1;
+  vector<std::shared_ptr<uint8_t[]> > segs(numSegs);
+  for (size_t i = 0; i < numSegs; i++)
+  {
+    segs[i] = lookup(SegmentID(key, first + i));
+    if (segs[i])
+      ++hits;
+    else
+      ++misses;
+  }
+  s.unlock();
+
+  // fetch each run of consecutive missing segments with a single ranged get
+  size_t i = 0;
+  while (i < numSegs)
+  {
+    if (segs[i])
+    {
+      ++i;
+      continue;
+    }
+    size_t runEnd = i + 1;
+    while (runEnd < numSegs && !segs[runEnd])
+      ++runEnd;
+
+    off_t runOffset = (first + i) * segSize;
+    size_t runLength = min((first + runEnd) * segSize, objectLength) - runOffset;
+    std::shared_ptr<uint8_t[]> run(new uint8_t[runLength]);
+    size_t readLength = 0;
+
+    int err = cs->getObjectRange(key, run.get(), runOffset, runLength, &readLength);
+    if (err)
+      return -1;
+    if (readLength != runLength)
+    {
+      logger->log(LOG_ERR, "SegmentCache::read(): %s is shorter than its metadata says (%zu < %zu)",
+                  key.c_str(), runOffset + readLength, runOffset + runLength);
+      errno = ENODATA;
+      return -1;
+    }
+
+    // the segments of a run share its buffer
+    s.lock();
+    ++rangedGets;
+    bytesFetched += runLength;
+    for (size_t j = i; j < runEnd; j++)
+    {
+      size_t segOffset = (j - i) * segSize;
+      segs[j] = std::shared_ptr<uint8_t[]>(run, &run[segOffset]);
+      // segment_size may have changed while we were downloading
+      if (segSize == segmentSize)
+        insert(SegmentID(key, first + j), segs[j], min(segSize, runLength - segOffset));
+    }
+    s.unlock();
+    i = runEnd;
+  }
+
+  size_t count = 0;
+  for (i = 0; i < numSegs; i++)
+  {
+    size_t segOffset = (i == 0 ? offset - first * segSize : 0);
+    size_t toCopy = min(segSize - segOffset, length - count);
+    memcpy(&data[count], &segs[i][segOffset], toCopy);
+    count += toCopy;
+  }
+  return count;
+}
+
+std::shared_ptr<uint8_t[]> SegmentCache::lookup(const SegmentID& id)
+{
+  auto it = segments.find(id);
+  if (it == segments.end())
+    return std::shared_ptr<uint8_t[]>();
+  lru.splice(lru.begin(), lru, it->second.lruPos);
+  return it->second.data;
+}
+
+void SegmentCache::insert(const SegmentID& id, const std::shared_ptr<uint8_t[]>& data, size_t length)
+{
+  auto it = segments.find(id);
+  if (it != segments.end())
+  {
+    // another reader fetched it first
+    lru.splice(lru.begin(), lru, it->second.lruPos);
+    return;
+  }
+  lru.push_front(id);
+  Segment& seg = segments[id];
+  seg.data = data;
+  seg.length = length;
+  seg.lruPos = lru.begin();
+  currentSize += length;
+  evict();
+}
+
+void SegmentCache::evict()
+{
+  while (currentSize > maxSize && !lru.empty())
+  {
+    auto it = segments.find(lru.back());
+    assert(it != segments.end());
+    currentSize -= it->second.length;
+    segments.erase(it);
+    lru.pop_back();
+  }
+}
+
+void SegmentCache::reset()
+{
+  boost::unique_lock<boost::mutex> s(mutex);
+  segments.clear();
+  lru.clear();
+  currentSize = 0;
+}
+
+void SegmentCache::printKPIs() const
+{
+  cout << "SegmentCache" << endl;
+  cout << "\thits = " << hits << endl;
+  cout << "\tmisses = " << misses << endl;
+  cout << "\trangedGets = " << rangedGets << endl;
+  cout << "\tbytesFetched = " << bytesFetched << endl;
+}
+
+void SegmentCache::configListener()
+{
+  Config* conf = Config::get();
+  size_t newSegmentSize = segmentSize, newMaxSize = maxSize;
+
+  // segment_size = 0 turns off partial-object reads
+  string stmp = conf->getValue("Cache", "segment_size");
+  if (stmp.empty())
+    newSegmentSize = 1 << 20;
+  else
+  {
+    try
+    {
+      newSegmentSize = stoull(stmp);
+    }
+    catch (invalid_argument&)
+    {
+      logger->log(LOG_CRIT, "Cache/segment_size is not a number. Using current value = %zu", segmentSize);
+    }
+  }
+
+  stmp = conf->getValue("Cache", "segment_cache_size");
+  if (stmp.empty())
+    newMaxSize = 256 << 20;
+  else
+  {
+    try
+    {
+      newMaxSize = stoull(stmp);
+    }
+    catch (invalid_argument&)
+    {
+      logger->log(LOG_CRIT, "Cache/segment_cache_size is not a number. Using current value = %zu", maxSize);
+    }
+  }
+
+  boost::unique_lock<boost::mutex> s(mutex);
+  if (newSegmentSize != segmentSize)
+  {
+    // cached segments are indexed by segment_size; start over
+    segments.clear();
+    lru.clear();
+    currentSize = 0;
+    segmentSize = newSegmentSize;
+    logger->log(LOG_INFO, "Cache/segment_size = %zu", segmentSize);
+  }
+  if (newMaxSize != maxSize)
+  {
+    maxSize = newMaxSize;
+    evict();
+    logger->log(LOG_INFO, "Cache/segment_cache_size = %zu", maxSize);
+  }
+}
+
+}  // namespace storagemanager
@@ -0,0 +1,91 @@
+/* Copyright (C) 2019 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#pragma once
+
+/* SegmentCache holds fixed-size pieces of cloud objects in memory so that small reads
+   of objects that are not in the Cache don't have to download the whole object.  Objects
+   in cloud storage never change once written (a modified object gets a new key), so cached
+   segments never need to be invalidated; they age out of the LRU.
+*/
+
+#include "CloudStorage.h"
+#include "Config.h"
+#include "SMLogging.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace storagemanager
+{
+class SegmentCache : public boost::noncopyable, public ConfigListener
+{
+ public:
+  static SegmentCache* get();
+  virtual ~SegmentCache();
+
+  // true if segment_size is non-zero and the cloud backend can fetch byte ranges
+  bool enabled() const;
+
+  // Copies [offset, offset + length) of key into data, fetching only the segments that cover
+  // that range and are not already cached.  objectLength is the object's size according to
+  // the metadata.  Behaves like a syscall; returns the number of bytes copied, or -1 and sets errno.
+  ssize_t read(const std::string& key, size_t objectLength, uint8_t* data, off_t offset, size_t length);
+
+  size_t getSegmentSize() const;
+  size_t getCurrentSize() const;
+  // empties the cache.  Used by the unit tests.
+  void reset();
+  void printKPIs() const;
+
+  virtual void configListener() override;
+
+ private:
+  SegmentCache();
+
+  typedef std::pair<std::string, size_t> SegmentID;  // key, segment index
+  struct Segment
+  {
+    std::shared_ptr<uint8_t[]> data;
+    size_t length;
+    std::list<SegmentID>::iterator lruPos;
+  };
+
+  // call these holding mutex
+  std::shared_ptr<uint8_t[]> lookup(const SegmentID& id);
+  void insert(const SegmentID& id, const std::shared_ptr<uint8_t[]>& data, size_t length);
+  void evict();
+
+  CloudStorage* cs;
+  SMLogging* logger;
+
+  size_t segmentSize;
+  size_t maxSize;
+  size_t currentSize;
+  std::map<SegmentID, Segment> segments;
+  std::list<SegmentID> lru;  // front = most recently used
+  mutable boost::mutex mutex;
+
+  // KPIs
+  size_t hits, misses, rangedGets, bytesFetched;
+};
+
+}  // namespace storagemanager
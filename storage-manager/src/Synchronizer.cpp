@@ -48,7 +48,7 @@ Synchronizer* Synchronizer::get()
   return instance;
 }
 
-Synchronizer::Synchronizer() : maxUploads(0)
+Synchronizer::Synchronizer() : maxUploads(0), pressureThreshold(75)
 {
   Config* config = Config::get();
   logger = SMLogging::get();
@@ -59,7 +59,7 @@ Synchronizer::Synchronizer() : maxUploads(0)
 
   numBytesRead = numBytesWritten = numBytesUploaded = numBytesDownloaded = mergeDiff =
       flushesTriggeredBySize = flushesTriggeredByTimer = journalsMerged = objectsSyncedWithNoJournal =
-          bytesReadBySync = bytesReadBySyncWithJournal = 0;
+          bytesReadBySync = bytesReadBySyncWithJournal = compactionsRequested = uploadsPrioritized = 0;
 
   journalPath = cache->getJournalPath();
   cachePath = cache->getCachePath();
@@ -152,14 +152,22 @@ void Synchronizer::newJournalEntries(const bf::path& prefix, const vector<pair<s
 
 void Synchronizer::newObjects(const bf::path& prefix, const vector<string>& keys)
 {
+  // New objects can't leave the cache until they're uploaded, and when the cache is nearly full,
+  // making space for more writes has to wait for those uploads.  So under pressure, start uploading
+  // them now, ahead of anything already queued, rather than at the next periodic sync.
+  bool urgent = underCachePressure();
   boost::unique_lock<boost::mutex> s(mutex);
 
   for (const string& _key : keys)
   {
     bf::path key(prefix / _key);
     assert(pendingOps.find(key.string()) == pendingOps.end());
-    // makeJob(key);
     pendingOps[key.string()] = boost::shared_ptr<PendingOps>(new PendingOps(NEW_OBJECT));
+    if (urgent && !blockNewJobs)
+    {
+      makeJob(key.string(), true);
+      ++uploadsPrioritized;
+    }
   }
 }
 
@@ -266,6 +274,18 @@ void Synchronizer::flushObject(const bf::path& prefix, const string& _key)
   }
 }
 
+void Synchronizer::compact(const bf::path& prefix, const string& _key)
+{
+  string key = (prefix / _key).string();
+  boost::unique_lock<boost::mutex> s(mutex);
+
+  // if it's not pending, it's either being merged already or there's nothing to merge
+  if (blockNewJobs || pendingOps.find(key) == pendingOps.end())
+    return;
+  ++compactionsRequested;
+  makeJob(key);
+}
+
 void Synchronizer::periodicSync()
 {
   boost::unique_lock<boost::mutex> lock(mutex);
@@ -282,6 +302,7 @@ void Synchronizer::periodicSync()
       // logger->log(LOG_DEBUG,"Synchronizer Force Flush.");
       wasTriggeredBySize = true;
     }
+    bool underPressure = underCachePressure();
     lock.lock();
     if (blockNewJobs)
       continue;
@@ -294,8 +315,18 @@ void Synchronizer::periodicSync()
     }
     // cout << "Sync'ing " << pendingOps.size() << " objects" << " queue size is " <<
     //    threadPool.currentQueueSize() << endl;
+    // under cache pressure, queue the uploads of new objects ahead of journal merges & deletes.
+    // Those are what makeSpace() would otherwise have to wait for.
+    if (underPressure)
+      for (auto& job : pendingOps)
+        if (job.second->opFlags == NEW_OBJECT)
+        {
+          makeJob(job.first, true);
+          ++uploadsPrioritized;
+        }
     for (auto& job : pendingOps)
-      makeJob(job.first);
+      if (!underPressure || job.second->opFlags != NEW_OBJECT)
+        makeJob(job.first);
     for (auto it = uncommittedJournalSize.begin(); it != uncommittedJournalSize.end(); ++it)
       it->second = 0;
   }
@@ -355,12 +386,19 @@ void Synchronizer::forceFlush()
   syncThread.interrupt();
 }
 
-void Synchronizer::makeJob(const string& key)
+void Synchronizer::makeJob(const string& key, bool urgent)
 {
   objNames.push_front(key);
 
   boost::shared_ptr<Job> j(new Job(this, objNames.begin()));
-  threadPool->addJob(j);
+  threadPool->addJob(j, urgent);
+}
+
+bool Synchronizer::underCachePressure()
+{
+  if (pressureThreshold == 0)
+    return false;
+  return cache->getCurrentCacheSize() > cache->getMaxCacheSize() / 100 * pressureThreshold;
 }
 
 void Synchronizer::process(list<string>::iterator name)
@@ -531,7 +569,7 @@ void Synchronizer::synchronize(const string& sourceFile, list<string>::iterator&
     return;
   }
 
-  err = cs->putObject(objectPath.string(), cloudKey);
+  err = cs->putObjectMultipart(objectPath.string(), cloudKey);
   if (err)
     throw runtime_error(string("synchronize(): uploading ") + key + ", got " + strerror_r(errno, buf, 80));
 
@@ -723,7 +761,7 @@ void Synchronizer::synchronizeWithJournal(const string& sourceFile, list<string>
   // get a new key for the resolved version & upload it
   string newCloudKey = MetadataFile::getNewKeyFromOldKey(cloudKey, size);
   string newKey = (prefix / newCloudKey).string();
-  err = cs->putObject(data, size, newCloudKey);
+  err = cs->putObjectMultipart(data, size, newCloudKey);
   if (err)
   {
     // try to delete it in cloud storage... unlikely it is there in the first place, and if it is
@@ -840,6 +878,8 @@ void Synchronizer::printKPIs() const
   cout << "\tflushesTriggeredBySize: " << flushesTriggeredBySize << endl;
   cout << "\tflushesTriggeredByTimer: " << flushesTriggeredByTimer << endl;
   cout << "\tjournalsMerged: " << journalsMerged << endl;
+  cout << "\tcompactionsRequested: " << compactionsRequested << endl;
+  cout << "\tuploadsPrioritized: " << uploadsPrioritized << endl;
   cout << "\tobjectsSyncedWithNoJournal: " << objectsSyncedWithNoJournal << endl;
 }
 
@@ -907,5 +947,25 @@ void Synchronizer::configListener()
   {
     logger->log(LOG_CRIT, "max_concurrent_uploads is not a number. Using current value = %u", maxUploads);
   }
+
+  // 0 turns off prioritizing uploads by cache pressure
+  stmp = Config::get()->getValue("ObjectStorage", "upload_pressure_threshold");
+  if (!stmp.empty())
+  {
+    try
+    {
+      uint newValue = stoul(stmp);
+      if (newValue != pressureThreshold)
+      {
+        pressureThreshold = newValue;
+        logger->log(LOG_INFO, "upload_pressure_threshold = %u", pressureThreshold);
+      }
+    }
+    catch (invalid_argument&)
+    {
+      logger->log(LOG_CRIT, "upload_pressure_threshold is not a number. Using current value = %u",
+                  pressureThreshold);
+    }
+  }
 }
 }  // namespace storagemanager
@@ -50,6 +50,8 @@ class Synchronizer : public boost::noncopyable, public ConfigListener
   void newObjects(const boost::filesystem::path& firstDir, const std::vector<std::string>& keys);
   void deletedObjects(const boost::filesystem::path& firstDir, const std::vector<std::string>& keys);
   void flushObject(const boost::filesystem::path& firstDir, const std::string& key);
+  // queues the merge of key's journal now instead of at the next periodic sync.  Doesn't wait for it.
+  void compact(const boost::filesystem::path& firstDir, const std::string& key);
   void forceFlush();  // ideally, make a version of this that takes a firstDir parameter
   void syncNow();     // synchronous version of force for SyncTask
 
@@ -72,7 +74,9 @@ class Synchronizer : public boost::noncopyable, public ConfigListener
   void synchronizeDelete(const std::string& sourceFile, std::list<std::string>::iterator& it);
   void synchronizeWithJournal(const std::string& sourceFile, std::list<std::string>::iterator& it);
   void rename(const std::string& oldkey, const std::string& newkey);
-  void makeJob(const std::string& key);
+  void makeJob(const std::string& key, bool urgent = false);
+  // true if the cache is fuller than upload_pressure_threshold.  Don't call it holding mutex.
+  bool underCachePressure();
 
   // this struct kind of got sloppy.  Need to clean it at some point.
   struct PendingOps
@@ -114,6 +118,7 @@ class Synchronizer : public boost::noncopyable, public ConfigListener
   void periodicSync();
   std::map<boost::filesystem::path, size_t> uncommittedJournalSize;
   size_t journalSizeThreshold;
+  uint pressureThreshold;  // percent of the cache size
   bool blockNewJobs;
 
   void syncNow(const boost::filesystem::path& prefix);  // a synchronous version of forceFlush()
@@ -121,7 +126,7 @@ class Synchronizer : public boost::noncopyable, public ConfigListener
   // some KPIs
   size_t numBytesRead, numBytesWritten, numBytesUploaded, numBytesDownloaded, flushesTriggeredBySize,
       flushesTriggeredByTimer, journalsMerged, objectsSyncedWithNoJournal, bytesReadBySync,
-      bytesReadBySyncWithJournal;
+      bytesReadBySyncWithJournal, compactionsRequested, uploadsPrioritized;
   ssize_t mergeDiff;
 
   SMLogging* logger;
@@ -58,13 +58,16 @@ void ThreadPool::setName(const string& _name)
   name = _name;
 }
 
-void ThreadPool::addJob(const boost::shared_ptr<Job>& j)
+void ThreadPool::addJob(const boost::shared_ptr<Job>& j, bool urgent)
 {
   boost::unique_lock<boost::mutex> s(mutex);
   if (die)
     return;
 
-  jobs.push_back(j);
+  if (urgent)
+    jobs.push_front(j);
+  else
+    jobs.push_back(j);
   // Start another thread if necessary
   if (threadsWaiting == 0 && (threads.size() - pruneable.size()) < maxThreads)
   {
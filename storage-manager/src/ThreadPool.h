@@ -41,7 +41,8 @@ class ThreadPool : public boost::noncopyable
     virtual void operator()() = 0;
   };
 
-  void addJob(const boost::shared_ptr<Job>& j);
+  // an urgent job goes to the front of the queue
+  void addJob(const boost::shared_ptr<Job>& j, bool urgent = false);
   void setMaxThreads(uint newMax);
   int currentQueueSize() const;
   void setName(const std::string&);  // set the name of this threadpool (for debugging)
@@ -31,6 +31,7 @@ using namespace std;
 #include "SessionManager.h"
 #include "IOCoordinator.h"
 #include "Cache.h"
+#include "SegmentCache.h"
 #include "Synchronizer.h"
 #include "Replicator.h"
 #include "crashtrace.h"
@@ -85,6 +86,7 @@ void printKPIs(int sig)
 {
   IOCoordinator::get()->printKPIs();
   Cache::get()->printKPIs();
+  SegmentCache::get()->printKPIs();
   Synchronizer::get()->printKPIs();
   CloudStorage::get()->printKPIs();
   Replicator::get()->printKPIs();
@@ -27,6 +27,8 @@
 #include "messageFormat.h"
 #include "Config.h"
 #include "Cache.h"
+#include "SegmentCache.h"
+#include "MergeCache.h"
 #include "LocalStorage.h"
 #include "MetadataFile.h"
 #include "Replicator.h"
@@ -1124,7 +1126,25 @@ bool localstorageTest1()
 {
   LocalStorage ls;
 
-  /* TODO: Some stuff */
+  // a multipart upload should reassemble its parts in order and clean up after itself
+  Config* config = Config::get();
+  bf::path fakeCloud = config->getValue("LocalStorage", "path");
+  const size_t len = 20000;  // 7 parts of 3k
+  std::shared_ptr<uint8_t[]> data(new uint8_t[len]);
+  for (size_t i = 0; i < len; i++)
+    data[i] = i * 31 + (i >> 8);
+  assert(ls.supportsMultipartUpload());
+  int err = ls.putObjectMultipart(data, len, "multipartTest");
+  assert(!err);
+  std::shared_ptr<uint8_t[]> readBack;
+  size_t readLen = 0;
+  err = ls.getObject("multipartTest", &readBack, &readLen);
+  assert(!err);
+  assert(readLen == len);
+  assert(!memcmp(data.get(), readBack.get(), len));
+  assert(!bf::exists(fakeCloud / ".multipart") || bf::is_empty(fakeCloud / ".multipart"));
+  ls.deleteObject("multipartTest");
+
   cout << "local storage test 1 OK" << endl;
   return true;
 }
@@ -1186,6 +1206,47 @@ bool cacheTest1()
   return true;
 }
 
+void mergeCacheTest()
+{
+  MergeCache mc;
+  struct stat jstat;
+  size_t len;
+  uint reads;
+
+  if (!mc.enabled())
+  {
+    cout << "merge cache test skipped, Cache/merge_cache_size is 0" << endl;
+    return;
+  }
+
+  makeTestJournal("test-journal");
+  assert(::stat("test-journal", &jstat) == 0);
+
+  assert(!mc.get("key", jstat, &len, &reads));
+  assert(reads == 0);
+
+  std::shared_ptr<uint8_t[]> merged(new uint8_t[8192]);
+  mc.put("key", jstat, merged, 8192);
+  assert(mc.get("key", jstat, &len, &reads) == merged);
+  assert(len == 8192 && reads == 1);
+  assert(mc.get("key", jstat, &len, &reads) == merged);
+  assert(reads == 2);
+
+  // a grown journal invalidates the entry
+  int fd = ::open("test-journal", O_WRONLY | O_APPEND);
+  assert(fd >= 0);
+  uint64_t offlen[2] = {0, 4};
+  assert(::write(fd, offlen, 16) == 16);
+  assert(::write(fd, offlen, 4) == 4);
+  ::close(fd);
+  assert(::stat("test-journal", &jstat) == 0);
+  assert(!mc.get("key", jstat, &len, &reads));
+  assert(!mc.get("key", jstat, &len, &reads));
+
+  bf::remove("test-journal");
+  cout << "merge cache test OK" << endl;
+}
+
 bool mergeJournalTest()
 {
   /*
@@ -1388,6 +1449,66 @@ void metadataUpdateTest()
   ::unlink(metaFilePath.c_str());
 }
 
+void metadataFormatTest()
+{
+  Config* config = Config::get();
+  bf::path metaPath = config->getValue("ObjectStorage", "metadata_path");
+  bf::path metaFilePath = metaPath / "metadataFormatTest.meta";
+  MetadataFile::MetadataConfig* mdConfig = MetadataFile::MetadataConfig::get();
+  MetadataFile::MetadataConfig::Format savedFormat = mdConfig->mFormat;
+  vector<metadataObject> objects;
+
+  // start with a json file
+  mdConfig->mFormat = MetadataFile::MetadataConfig::JSON;
+  {
+    MetadataFile mdf("metadataFormatTest");
+    mdf.addMetadataObject("metadataFormatTest", mdConfig->mObjectSize);
+    mdf.addMetadataObject("metadataFormatTest", 100);
+    mdf.writeMetadata();
+    objects = mdf.metadataRead(0, mdf.getLength());
+  }
+  char c;
+  int fd = ::open(metaFilePath.string().c_str(), O_RDONLY);
+  assert(fd >= 0);
+  assert(::read(fd, &c, 1) == 1);
+  assert(c == '{');
+  ::close(fd);
+
+  // modifying it with the format set to binary converts it
+  mdConfig->mFormat = MetadataFile::MetadataConfig::BINARY;
+  {
+    MetadataFile mdf("metadataFormatTest");
+    mdf.updateEntryLength(mdConfig->mObjectSize, 200);
+    mdf.writeMetadata();
+  }
+  fd = ::open(metaFilePath.string().c_str(), O_RDONLY);
+  assert(fd >= 0);
+  assert(::read(fd, &c, 1) == 1);
+  assert(c == 'S');
+  ::close(fd);
+
+  // and it reads back the same from disk
+  MetadataFile::deletedMeta(metaFilePath);
+  {
+    MetadataFile mdf("metadataFormatTest", MetadataFile::no_create_t(), true);
+    assert(mdf.exists());
+    assert(mdf.getLength() == mdConfig->mObjectSize + 200);
+    vector<metadataObject> readBack = mdf.metadataRead(0, mdf.getLength());
+    assert(readBack.size() == objects.size());
+    for (uint i = 0; i < objects.size(); i++)
+    {
+      assert(readBack[i].offset == objects[i].offset);
+      assert(readBack[i].key == objects[i].key);
+    }
+    assert(readBack[1].length == 200);
+  }
+
+  mdConfig->mFormat = savedFormat;
+  MetadataFile::deletedMeta(metaFilePath);
+  ::unlink(metaFilePath.string().c_str());
+  cout << "metadata format test OK" << endl;
+}
+
 void s3storageTest1()
 {
   try
@@ -1553,6 +1674,113 @@ void IOCReadTest1()
   cout << "IOC read test 1 OK" << endl;
 }
 
+void IOCPartialReadTest()
+{
+  Cache* cache = Cache::get();
+  SegmentCache* segCache = SegmentCache::get();
+  CloudStorage* cs = CloudStorage::get();
+  IOCoordinator* ioc = IOCoordinator::get();
+  Config* config = Config::get();
+  LocalStorage* ls = dynamic_cast<LocalStorage*>(cs);
+  if (!ls)
+  {
+    cout << "IOC partial read test requires LocalStorage for now." << endl;
+    return;
+  }
+  testObjKey = "12345_0_8192_" + prefix + "~test-file";
+
+  cache->reset();
+  segCache->reset();
+
+  bf::path storagePath = ls->getPrefix();
+  bf::path cachePath = cache->getCachePath();
+  bf::path metaPath = config->getValue("ObjectStorage", "metadata_path");
+  bf::create_directories(metaPath / prefix);
+  string objFilename = (storagePath / testObjKey).string();
+  string metaFilename = (metaPath / metaTestFile).string() + ".meta";
+  makeTestObject(objFilename.c_str());
+  makeTestMetadata(metaFilename.c_str(), testObjKey);
+
+  // ranged get, including one that runs past the end of the object
+  uint8_t buf[1024];
+  int* buf32 = (int*)buf;
+  size_t readLength = 0;
+  int err = ls->getObjectRange(testObjKey, buf, 4000, 100, &readLength);
+  assert(err == 0);
+  assert(readLength == 100);
+  for (int i = 0; i < 25; i++)
+    assert(buf32[i] == 1000 + i);
+  err = ls->getObjectRange(testObjKey, buf, 8000, 1000, &readLength);
+  assert(err == 0);
+  assert(readLength == 192);
+
+  // a small read should be served from the segment cache without pulling the object into the Cache
+  assert(segCache->enabled());
+  size_t segSize = segCache->getSegmentSize();
+  assert(segSize < 8192);
+  err = ioc->read(testFile, buf, 4000, 200);
+  assert(err == 200);
+  for (int i = 0; i < 50; i++)
+    assert(buf32[i] == 1000 + i);
+  assert(!bf::exists(cachePath / prefix / testObjKey));
+  size_t fetched = segCache->getCurrentSize();
+  assert(fetched > 0 && fetched <= 8192);
+
+  // the same read again should not fetch anything new
+  err = ioc->read(testFile, buf, 4000, 200);
+  assert(err == 200);
+  assert(segCache->getCurrentSize() == fetched);
+
+  // reading the whole object goes through the Cache as before
+  uint8_t whole[8192];
+  err = ioc->read(testFile, whole, 0, 8192);
+  assert(err == 8192);
+  assert(bf::exists(cachePath / prefix / testObjKey));
+
+  cache->reset();
+  segCache->reset();
+  err = ioc->unlink(testFile);
+  assert(err >= 0);
+
+  cout << "IOC partial read test OK" << endl;
+}
+
+void IOCPrefetchTest()
+{
+  Cache* cache = Cache::get();
+  CloudStorage* cs = CloudStorage::get();
+  IOCoordinator* ioc = IOCoordinator::get();
+  Config* config = Config::get();
+  LocalStorage* ls = dynamic_cast<LocalStorage*>(cs);
+  if (!ls)
+  {
+    cout << "IOC prefetch test requires LocalStorage for now." << endl;
+    return;
+  }
+  testObjKey = "12345_0_8192_" + prefix + "~test-file";
+
+  cache->reset();
+
+  bf::path storagePath = ls->getPrefix();
+  bf::path metaPath = config->getValue("ObjectStorage", "metadata_path");
+  bf::create_directories(metaPath / prefix);
+  makeTestObject((storagePath / testObjKey).string().c_str());
+  makeTestMetadata(((metaPath / metaTestFile).string() + ".meta").c_str(), testObjKey);
+
+  int err = ioc->prefetch(testFile, 0, 8192);
+  assert(err == 0);
+  // the download happens in the background
+  for (int i = 0; i < 100 && !cache->exists(prefix, testObjKey); i++)
+    usleep(100000);
+  assert(cache->exists(prefix, testObjKey));
+
+  cache->reset();
+  err = ioc->unlink(testFile);
+  assert(err >= 0);
+
+  cout << "IOC prefetch test OK" << endl;
+}
+
 void IOCUnlink()
 {
   IOCoordinator* ioc = IOCoordinator::get();
@@ -1916,6 +2144,7 @@ int main(int argc, char* argv[])
 
   opentask();
   metadataUpdateTest();
+  metadataFormatTest();
 
   // create the metadatafile to use
   // requires 8K object size to test boundries
@@ -1960,6 +2189,7 @@ int main(int argc, char* argv[])
   localstorageTest1();
   cacheTest1();
   mergeJournalTest();
+  mergeCacheTest();
 
   replicatorTest();
   syncTest1();
@@ -1967,6 +2197,8 @@ int main(int argc, char* argv[])
 
 
   IOCReadTest1();
+  IOCPartialReadTest();
+  IOCPrefetchTest();
 
   // broken
   //IOCTruncate();
@@ -6,6 +6,7 @@ from pathlib import Path
 import os
 import configparser
 import re
+import struct
 import traceback
 
 
@@ -51,9 +52,27 @@ def parseArgs():
 def key_breakout(key):
     return key.split("_", 3)
 
+# See MetadataFile.cpp for the binary format.  Offsets and lengths are returned as strings
+# to match what the json format stores.
+def loadMetadata(metafile):
+    with open(metafile, "rb") as f:
+        data = f.read()
+    if data[:4] != b"SMMD":
+        return json.loads(data)
+    version, revision, count = struct.unpack_from("<III", data, 4)
+    pos = 16
+    objects = []
+    for i in range(count):
+        offset, length, keyLength = struct.unpack_from("<QQI", data, pos)
+        pos += 20
+        key = data[pos:pos + keyLength].decode()
+        pos += keyLength
+        objects.append({"offset": str(offset), "length": str(length), "key": key})
+    return {"version": version, "revision": revision, "objects": objects}
+
 def validateMetadata(metafile):
     try:
-        metadata = json.load(open(metafile))
+        metadata = loadMetadata(metafile)
 
         for obj in metadata["objects"]:
             bigObjectSet.add(obj["key"])
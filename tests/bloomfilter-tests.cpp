@@ -0,0 +1,286 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "we_bloomfilter.h"
+#include "we_columnindex.h"
+#include "we_define.h"
+#include "IDBPolicy.h"
+
+using namespace WriteEngine;
+using namespace idbdatafile;
+
+namespace
+{
+const uint64_t ROWS = BlockBloomFilters::ROWS_PER_FILTER;
+
+// the key of a string stored in a CHAR column of width bytes
+uint64_t stringKey(const std::string& value, int width)
+{
+  char stored[8] = {0};
+  memcpy(stored, value.data(), std::min<size_t>(value.size(), width));
+  return ColumnIndex::key(stored, width);
+}
+
+// how many of count keys that weren't added from first on the filter has
+uint32_t falsePositives(const BloomFilter& filter, uint64_t first, uint32_t count)
+{
+  uint32_t found = 0;
+
+  for (uint64_t key = first; key < first + count; key++)
+    found += filter.mayContain(key);
+
+  return found;
+}
+
+class BlockBloomFiltersTest : public testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    IDBPolicy::init(false, false, "", 0);
+    char dirTemplate[] = "/tmp/bloomfilter-tests.XXXXXX";
+    ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+    fDir = dirTemplate;
+    fSegFile = fDir + "/FILE000.cdf";
+  }
+
+  void TearDown() override
+  {
+    boost::filesystem::remove_all(fDir);
+  }
+
+  std::string fDir;
+  std::string fSegFile;
+};
+}  // namespace
+
+TEST(BloomFilterTest, Empty)
+{
+  BloomFilter filter;
+  EXPECT_EQ(falsePositives(filter, 0, 1000), 0U);
+}
+
+TEST(BloomFilterTest, AddedKeys)
+{
+  BloomFilter filter;
+
+  for (uint64_t key = 0; key < ROWS; key++)
+    filter.add(key * 3);
+
+  for (uint64_t key = 0; key < ROWS; key++)
+    EXPECT_TRUE(filter.mayContain(key * 3)) << key;
+
+  // a full block of distinct keys: about 2.4% with 64K bits and 4 hashes
+  EXPECT_LT(falsePositives(filter, ROWS * 3, 10000), 500U);
+}
+
+TEST(BloomFilterTest, MergeAndFill)
+{
+  BloomFilter a, b;
+  a.add(1);
+  b.add(2);
+  a.merge(b);
+
+  EXPECT_TRUE(a.mayContain(1));
+  EXPECT_TRUE(a.mayContain(2));
+  EXPECT_FALSE(b.mayContain(1));
+
+  b.fill();
+  EXPECT_EQ(falsePositives(b, 100, 1000), 1000U);
+}
+
+TEST(BloomFilterTest, StringKeys)
+{
+  // short keys of a binary collation column, like the first bytes of UUIDs or codes
+  EXPECT_NE(stringKey("ab", 4), stringKey("abc", 4));
+  EXPECT_NE(stringKey("abc", 4), stringKey("abd", 4));
+  EXPECT_EQ(stringKey("abc", 4), stringKey(std::string("abc\0", 4), 4));
+
+  BloomFilter filter;
+  char value[16];
+
+  for (uint32_t i = 0; i < ROWS; i++)
+  {
+    snprintf(value, sizeof(value), "%08x", i * 2654435761U);
+    filter.add(stringKey(value, 8));
+  }
+
+  snprintf(value, sizeof(value), "%08x", 5 * 2654435761U);
+  EXPECT_TRUE(filter.mayContain(stringKey(value, 8)));
+
+  uint32_t found = 0;
+
+  for (uint32_t i = 0; i < 10000; i++)
+  {
+    snprintf(value, sizeof(value), "k%07u", i);
+    found += filter.mayContain(stringKey(value, 8));
+  }
+
+  EXPECT_LT(found, 500U);
+}
+
+TEST(BlockBloomFiltersStaticTest, Blocks)
+{
+  BlockBloomFilters filters, other;
+  EXPECT_TRUE(filters.empty());
+
+  filters.add(7, 0);
+  filters.add(8, 2 * ROWS + 5);
+  other.add(9, 2 * ROWS);
+  filters.merge(other);
+
+  ASSERT_NE(filters.find(0), nullptr);
+  EXPECT_EQ(filters.find(1), nullptr);
+  ASSERT_NE(filters.find(2), nullptr);
+  EXPECT_TRUE(filters.find(0)->mayContain(7));
+  EXPECT_FALSE(filters.find(0)->mayContain(8));
+  EXPECT_TRUE(filters.find(2)->mayContain(8));
+  EXPECT_TRUE(filters.find(2)->mayContain(9));
+}
+
+TEST_F(BlockBloomFiltersTest, SaveAndRead)
+{
+  BlockBloomFilters filters, read;
+  EXPECT_EQ(read.read(fSegFile, 0, 4, IDBPolicy::PRIMPROC), ERR_FILE_NOT_EXIST);
+
+  filters.add(1, 0);
+  filters.add(2, 2 * ROWS);
+  ASSERT_EQ(filters.save(fSegFile, true), NO_ERROR);
+
+  ASSERT_EQ(read.read(fSegFile, 0, 4, IDBPolicy::PRIMPROC), NO_ERROR);
+  ASSERT_NE(read.find(0), nullptr);
+  ASSERT_NE(read.find(2), nullptr);
+  EXPECT_TRUE(read.find(0)->mayContain(1));
+  EXPECT_FALSE(read.find(0)->mayContain(2));
+  EXPECT_TRUE(read.find(2)->mayContain(2));
+
+  // a missing slot rules nothing out: the block has no filter
+  EXPECT_EQ(read.find(1), nullptr);
+
+  // the blocks read are numbered in the file
+  ASSERT_EQ(read.read(fSegFile, 2, 1, IDBPolicy::PRIMPROC), NO_ERROR);
+  EXPECT_EQ(read.find(0), nullptr);
+  EXPECT_NE(read.find(2), nullptr);
+}
+
+TEST_F(BlockBloomFiltersTest, ShortFileReturnsFewerSlots)
+{
+  BlockBloomFilters filters, read;
+  filters.add(1, 0);
+  filters.add(2, ROWS);
+  ASSERT_EQ(filters.save(fSegFile, true), NO_ERROR);
+
+  ASSERT_EQ(read.read(fSegFile, 0, 1024, IDBPolicy::PRIMPROC), NO_ERROR);
+  EXPECT_NE(read.find(0), nullptr);
+  EXPECT_NE(read.find(1), nullptr);
+  EXPECT_EQ(read.find(2), nullptr);
+
+  ASSERT_EQ(read.read(fSegFile, 1024, 1024, IDBPolicy::PRIMPROC), NO_ERROR);
+  EXPECT_TRUE(read.empty());
+}
+
+TEST_F(BlockBloomFiltersTest, SaveOrsIntoTheSlots)
+{
+  BlockBloomFilters first, second, read;
+  first.add(1, 0);
+  ASSERT_EQ(first.save(fSegFile, true), NO_ERROR);
+
+  second.add(2, 5);
+  ASSERT_EQ(second.save(fSegFile, false), NO_ERROR);
+
+  ASSERT_EQ(read.read(fSegFile, 0, 1, IDBPolicy::PRIMPROC), NO_ERROR);
+  ASSERT_NE(read.find(0), nullptr);
+  EXPECT_TRUE(read.find(0)->mayContain(1));
+  EXPECT_TRUE(read.find(0)->mayContain(2));
+  EXPECT_FALSE(read.find(0)->mayContain(3));
+}
+
+TEST_F(BlockBloomFiltersTest, UpdateFillsABlockWithoutASlot)
+{
+  BlockBloomFilters first, update, read;
+  first.add(1, 0);
+  ASSERT_EQ(first.save(fSegFile, true), NO_ERROR);
+
+  // the other rows of block 1 were never added
+  update.add(2, ROWS + 3);
+  ASSERT_EQ(update.save(fSegFile, false), NO_ERROR);
+
+  ASSERT_EQ(read.read(fSegFile, 0, 2, IDBPolicy::PRIMPROC), NO_ERROR);
+  ASSERT_NE(read.find(1), nullptr);
+  EXPECT_EQ(falsePositives(*read.find(1), 100, 1000), 1000U);
+}
+
+TEST_F(BlockBloomFiltersTest, AppendedBlockGetsItsFilter)
+{
+  BlockBloomFilters first, appended, read;
+  first.add(1, 0);
+  ASSERT_EQ(first.save(fSegFile, true), NO_ERROR);
+
+  // the rows of block 1 that weren't added are empty
+  appended.add(2, ROWS + 3);
+  ASSERT_EQ(appended.save(fSegFile, true), NO_ERROR);
+
+  ASSERT_EQ(read.read(fSegFile, 0, 2, IDBPolicy::PRIMPROC), NO_ERROR);
+  ASSERT_NE(read.find(1), nullptr);
+  EXPECT_TRUE(read.find(1)->mayContain(2));
+  EXPECT_FALSE(read.find(1)->mayContain(1));
+}
+
+TEST_F(BlockBloomFiltersTest, RestartedFileFillsItsFirstAppendedBlock)
+{
+  {
+    std::ofstream garbage(BlockBloomFilters::getFileName(fSegFile).c_str());
+    garbage << "not a bloom filter file";
+  }
+
+  BlockBloomFilters appended, read;
+  EXPECT_EQ(read.read(fSegFile, 0, 4, IDBPolicy::PRIMPROC), ERR_FILE_READ);
+
+  // block 3 can have rows from before the file was started over, block 4 can't
+  appended.add(1, 3 * ROWS + 100);
+  appended.add(2, 4 * ROWS);
+  ASSERT_EQ(appended.save(fSegFile, true), NO_ERROR);
+
+  ASSERT_EQ(read.read(fSegFile, 0, 8, IDBPolicy::PRIMPROC), NO_ERROR);
+  EXPECT_EQ(read.find(2), nullptr);
+  ASSERT_NE(read.find(3), nullptr);
+  ASSERT_NE(read.find(4), nullptr);
+  EXPECT_EQ(falsePositives(*read.find(3), 100, 1000), 1000U);
+  EXPECT_TRUE(read.find(4)->mayContain(2));
+  EXPECT_FALSE(read.find(4)->mayContain(1));
+}
+
+TEST_F(BlockBloomFiltersTest, Remove)
+{
+  BlockBloomFilters filters, read;
+  filters.add(1, 1);
+  ASSERT_EQ(filters.save(fSegFile, true), NO_ERROR);
+
+  EXPECT_EQ(BlockBloomFilters::remove(fSegFile), NO_ERROR);
+  EXPECT_EQ(read.read(fSegFile, 0, 1, IDBPolicy::PRIMPROC), ERR_FILE_NOT_EXIST);
+  EXPECT_EQ(BlockBloomFilters::remove(fSegFile), NO_ERROR);
+}
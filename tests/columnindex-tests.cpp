@@ -0,0 +1,369 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "we_columnindex.h"
+#include "we_define.h"
+#include "IDBPolicy.h"
+
+using namespace WriteEngine;
+using namespace idbdatafile;
+
+namespace
+{
+// the rows of set in [first, first + count)
+std::vector<uint32_t> getRows(const RowIdSet& set, uint32_t first, uint32_t count)
+{
+  std::vector<uint16_t> rows(count);
+  rows.resize(set.getRange(first, count, rows.data()));
+  return std::vector<uint32_t>(rows.begin(), rows.end());
+}
+
+std::vector<uint32_t> relative(const std::set<uint32_t>& rows, uint32_t first, uint32_t count)
+{
+  std::vector<uint32_t> ret;
+
+  for (auto it = rows.lower_bound(first); it != rows.end() && *it < first + count; ++it)
+    ret.push_back(*it - first);
+
+  return ret;
+}
+
+void expectSameRows(const RowIdSet& set, const std::set<uint32_t>& expected, uint32_t groups)
+{
+  for (uint32_t first = 0; first < groups << 16; first += 8192)
+    EXPECT_EQ(getRows(set, first, 8192), relative(expected, first, 8192)) << first;
+}
+
+class ColumnIndexTest : public testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    IDBPolicy::init(false, false, "", 0);
+    char dirTemplate[] = "/tmp/columnindex-tests.XXXXXX";
+    ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+    fDir = dirTemplate;
+    fSegFile = fDir + "/FILE000.cdf";
+  }
+
+  void TearDown() override
+  {
+    boost::filesystem::remove_all(fDir);
+  }
+
+  std::string fDir;
+  std::string fSegFile;
+};
+}  // namespace
+
+TEST(RowIdSetTest, ArrayGroups)
+{
+  RowIdSet set;
+  std::set<uint32_t> expected;
+
+  EXPECT_TRUE(set.empty());
+
+  // out of order and repeated, in two groups
+  for (uint32_t row : {70000U, 5U, 3U, 65535U, 5U, 131071U, 64U, 70000U, 0U})
+  {
+    set.add(row);
+    expected.insert(row);
+  }
+
+  EXPECT_FALSE(set.empty());
+  expectSameRows(set, expected, 2);
+
+  EXPECT_EQ(getRows(set, 0, 64), std::vector<uint32_t>({0, 3, 5}));
+  EXPECT_EQ(getRows(set, 64, 64), std::vector<uint32_t>({0}));
+  EXPECT_EQ(getRows(set, 65536 + 4096, 4096), std::vector<uint32_t>({70000 - 65536 - 4096}));
+  EXPECT_TRUE(getRows(set, 3 << 16, 65536).empty());
+}
+
+TEST(RowIdSetTest, BitmapGroups)
+{
+  RowIdSet set;
+  std::set<uint32_t> expected;
+
+  // more than fit an array in group 0, a few in group 1
+  for (uint32_t row = 0; row < 65536; row += 3)
+  {
+    set.add(row);
+    expected.insert(row);
+  }
+
+  set.add(65536 + 100);
+  expected.insert(65536 + 100);
+
+  expectSameRows(set, expected, 2);
+  EXPECT_EQ(getRows(set, 0, 64).size(), 22U);
+  EXPECT_GT(set.memorySize(), 65536U / 8);
+}
+
+TEST(RowIdSetTest, Merge)
+{
+  RowIdSet a, b, bitmap;
+  std::set<uint32_t> expected;
+
+  for (uint32_t row = 0; row < 1000; row += 2)
+  {
+    a.add(row);
+    expected.insert(row);
+  }
+
+  for (uint32_t row = 1; row < 1000; row += 7)
+  {
+    b.add(row);
+    expected.insert(row);
+  }
+
+  for (uint32_t row = 65536; row < 2 * 65536; row += 2)
+  {
+    bitmap.add(row);
+    expected.insert(row);
+  }
+
+  a.merge(b);
+  a.merge(bitmap);
+  expectSameRows(a, expected, 2);
+
+  // a bitmap merged into an array
+  RowIdSet c;
+  c.add(65536 + 1);
+  c.merge(bitmap);
+  expected.clear();
+
+  for (uint32_t row = 65536; row < 2 * 65536; row += 2)
+    expected.insert(row);
+
+  expected.insert(65536 + 1);
+  expectSameRows(c, expected, 2);
+}
+
+TEST(RowIdSetTest, Serialize)
+{
+  RowIdSet set, copy;
+  std::set<uint32_t> expected;
+
+  for (uint32_t row = 0; row < 65536; row += 2)
+  {
+    set.add(row);
+    expected.insert(row);
+  }
+
+  for (uint32_t row : {65536U * 3 + 7, 65536U * 3 + 9})
+  {
+    set.add(row);
+    expected.insert(row);
+  }
+
+  messageqcpp::ByteStream bs;
+  set.serialize(bs);
+  copy.deserialize(bs);
+
+  EXPECT_EQ(bs.length(), 0U);
+  expectSameRows(copy, expected, 4);
+}
+
+TEST(RowIdSetTest, DeserializeTruncated)
+{
+  RowIdSet set, copy;
+
+  for (uint32_t row = 0; row < 100; row++)
+    set.add(row);
+
+  messageqcpp::ByteStream bs, truncated;
+  set.serialize(bs);
+  truncated.append(bs.buf(), bs.length() - 10);
+
+  EXPECT_ANY_THROW(copy.deserialize(truncated));
+}
+
+TEST(ColumnIndexStaticTest, Key)
+{
+  int16_t s = -2;
+  int64_t l = -2;
+
+  EXPECT_EQ(ColumnIndex::key(&s, 2), 0xfffeULL);
+  EXPECT_EQ(ColumnIndex::key(&l, 8), 0xfffffffffffffffeULL);
+  EXPECT_TRUE(ColumnIndex::isIndexable(execplan::CalpontSystemCatalog::INT, 4, 0));
+  EXPECT_TRUE(ColumnIndex::isIndexable(execplan::CalpontSystemCatalog::DATETIME, 8, 0));
+  EXPECT_FALSE(ColumnIndex::isIndexable(execplan::CalpontSystemCatalog::DOUBLE, 8, 0));
+  EXPECT_FALSE(ColumnIndex::isIndexable(execplan::CalpontSystemCatalog::DECIMAL, 16, 0));
+
+  // strings stored in the column that compare by their bytes
+  EXPECT_TRUE(ColumnIndex::isIndexable(execplan::CalpontSystemCatalog::CHAR, 8, my_charset_bin.number));
+  EXPECT_TRUE(ColumnIndex::isIndexable(execplan::CalpontSystemCatalog::VARBINARY, 4, my_charset_bin.number));
+  EXPECT_FALSE(ColumnIndex::isIndexable(execplan::CalpontSystemCatalog::VARCHAR, 8, my_charset_latin1.number));
+  EXPECT_FALSE(ColumnIndex::isIndexable(execplan::CalpontSystemCatalog::VARCHAR, 16, my_charset_bin.number));
+}
+
+TEST(ColumnIndexStaticTest, Cover)
+{
+  ColumnIndex index;
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(index.coveredRows(), 0U);
+
+  // a range that doesn't start at 0 isn't a prefix of the file
+  index.cover(100, 50);
+  EXPECT_FALSE(index.empty());
+  EXPECT_EQ(index.coveredRows(), 0U);
+
+  // touching ranges join
+  index.cover(50, 50);
+  index.cover(0, 50);
+  EXPECT_EQ(index.coveredRows(), 150U);
+
+  // of two ranges that don't touch the first is kept
+  index.cover(200, 10);
+  EXPECT_EQ(index.coveredRows(), 150U);
+  index.cover(150, 100);
+  EXPECT_EQ(index.coveredRows(), 250U);
+
+  index.cover(10, 0);
+  EXPECT_EQ(index.coveredRows(), 250U);
+}
+
+TEST(ColumnIndexStaticTest, Merge)
+{
+  ColumnIndex a, b;
+  a.add(1, 10);
+  a.add(2, 20);
+  a.cover(0, 30);
+  b.add(1, 40);
+  b.add(3, 50);
+  b.cover(30, 30);
+
+  a.merge(b);
+
+  EXPECT_EQ(a.coveredRows(), 60U);
+  ASSERT_NE(a.find(1), nullptr);
+  EXPECT_EQ(getRows(*a.find(1), 0, 64), std::vector<uint32_t>({10, 40}));
+  EXPECT_EQ(getRows(*a.find(3), 0, 64), std::vector<uint32_t>({50}));
+  EXPECT_EQ(a.find(4), nullptr);
+}
+
+TEST_F(ColumnIndexTest, SaveAndRead)
+{
+  ColumnIndex index, read;
+  EXPECT_EQ(read.read(fSegFile, IDBPolicy::PRIMPROC), ERR_FILE_NOT_EXIST);
+
+  for (uint32_t row = 0; row < 100000; row++)
+    index.add(row % 7, row);
+
+  index.cover(0, 100000);
+  ASSERT_EQ(index.save(fSegFile), NO_ERROR);
+  ASSERT_EQ(read.read(fSegFile, IDBPolicy::PRIMPROC), NO_ERROR);
+
+  EXPECT_EQ(read.coveredRows(), 100000U);
+
+  for (uint64_t key = 0; key < 7; key++)
+  {
+    ASSERT_NE(read.find(key), nullptr) << key;
+
+    for (uint32_t first = 0; first < 100000; first += 8192)
+      EXPECT_EQ(getRows(*read.find(key), first, 8192), getRows(*index.find(key), first, 8192));
+  }
+
+  EXPECT_EQ(read.find(7), nullptr);
+}
+
+TEST_F(ColumnIndexTest, SaveMergesIntoTheFile)
+{
+  ColumnIndex first, second, read;
+  first.add(1, 0);
+  first.cover(0, 10);
+  ASSERT_EQ(first.save(fSegFile), NO_ERROR);
+
+  second.add(1, 12);
+  second.add(2, 11);
+  second.cover(10, 5);
+  ASSERT_EQ(second.save(fSegFile), NO_ERROR);
+
+  ASSERT_EQ(read.read(fSegFile, IDBPolicy::PRIMPROC), NO_ERROR);
+  EXPECT_EQ(read.coveredRows(), 15U);
+  EXPECT_EQ(getRows(*read.find(1), 0, 64), std::vector<uint32_t>({0, 12}));
+  EXPECT_EQ(getRows(*read.find(2), 0, 64), std::vector<uint32_t>({11}));
+}
+
+TEST_F(ColumnIndexTest, AppendedRowsExtendAnExistingCover)
+{
+  ColumnIndex first, appended, read;
+  first.cover(0, 10);
+  ASSERT_EQ(first.save(fSegFile), NO_ERROR);
+
+  // rows 10 to 19 are empty
+  appended.add(5, 20);
+  appended.coverAppended(20, 5);
+  ASSERT_EQ(appended.save(fSegFile), NO_ERROR);
+
+  ASSERT_EQ(read.read(fSegFile, IDBPolicy::PRIMPROC), NO_ERROR);
+  EXPECT_EQ(read.coveredRows(), 25U);
+}
+
+TEST_F(ColumnIndexTest, AppendedRowsWithoutAnIndex)
+{
+  ColumnIndex appended, read;
+
+  // the rows before 20 were never added
+  appended.add(5, 20);
+  appended.coverAppended(20, 5);
+  ASSERT_EQ(appended.save(fSegFile), NO_ERROR);
+
+  ASSERT_EQ(read.read(fSegFile, IDBPolicy::PRIMPROC), NO_ERROR);
+  EXPECT_EQ(read.coveredRows(), 0U);
+  EXPECT_EQ(getRows(*read.find(5), 0, 64), std::vector<uint32_t>({20}));
+}
+
+TEST_F(ColumnIndexTest, UnreadableIndexStartsOver)
+{
+  {
+    std::ofstream garbage(ColumnIndex::getFileName(fSegFile).c_str());
+    garbage << "not an index";
+  }
+
+  ColumnIndex index, read;
+  EXPECT_EQ(read.read(fSegFile, IDBPolicy::PRIMPROC), ERR_FILE_READ);
+
+  index.add(1, 30);
+  index.coverAppended(30, 10);
+  ASSERT_EQ(index.save(fSegFile), NO_ERROR);
+
+  ASSERT_EQ(read.read(fSegFile, IDBPolicy::PRIMPROC), NO_ERROR);
+  EXPECT_EQ(read.coveredRows(), 0U);
+  EXPECT_NE(read.find(1), nullptr);
+}
+
+TEST_F(ColumnIndexTest, Remove)
+{
+  ColumnIndex index, read;
+  index.add(1, 1);
+  ASSERT_EQ(index.save(fSegFile), NO_ERROR);
+
+  EXPECT_EQ(ColumnIndex::remove(fSegFile), NO_ERROR);
+  EXPECT_EQ(read.read(fSegFile, IDBPolicy::PRIMPROC), ERR_FILE_NOT_EXIST);
+  EXPECT_EQ(ColumnIndex::remove(fSegFile), NO_ERROR);
+}
@@ -0,0 +1,152 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "compacthashtable.h"
+
+using namespace joiner;
+
+namespace
+{
+uint8_t* rowPtr(size_t i)
+{
+  // the table never dereferences the rows, only tells NULL from the rest
+  return reinterpret_cast<uint8_t*>((i + 1) * 8);
+}
+
+std::vector<uint8_t*> rowsOf(const CompactHashTable& table, int64_t key)
+{
+  std::vector<uint8_t*> rows;
+  auto range = table.equal_range(key);
+
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    EXPECT_EQ(it->first, key);
+    rows.push_back(it->second);
+  }
+
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+}  // namespace
+
+TEST(CompactHashTableTest, Empty)
+{
+  CompactHashTable table;
+
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(table.size(), 0U);
+  EXPECT_TRUE(table.begin() == table.end());
+  EXPECT_TRUE(table.find(0) == table.end());
+  EXPECT_TRUE(table.equal_range(42).first == table.end());
+  EXPECT_EQ(table.getMemUsage(), 0U);
+  table.prefetch(42);
+}
+
+TEST(CompactHashTableTest, UniqueKeys)
+{
+  CompactHashTable table;
+  const int64_t count = 10000;
+
+  // negative, zero and keys that collide in the low bits
+  for (int64_t i = 0; i < count; i++)
+    table.insert(CompactHashTable::value_type((i - count / 2) << 16, rowPtr(i)));
+
+  EXPECT_EQ(table.size(), (size_t)count);
+  EXPECT_FALSE(table.empty());
+  EXPECT_GT(table.getMemUsage(), 0U);
+
+  for (int64_t i = 0; i < count; i++)
+  {
+    auto it = table.find((i - count / 2) << 16);
+    ASSERT_TRUE(it != table.end());
+    EXPECT_EQ(it->second, rowPtr(i));
+    EXPECT_TRUE(++it == table.end());
+  }
+
+  EXPECT_TRUE(table.find(1) == table.end());
+  EXPECT_TRUE(table.find(count << 16) == table.end());
+}
+
+TEST(CompactHashTableTest, RepeatedKeys)
+{
+  CompactHashTable table;
+  std::map<int64_t, std::vector<uint8_t*>> expected;
+  size_t row = 0;
+
+  for (int64_t key = 0; key < 1000; key++)
+  {
+    for (int64_t i = 0; i <= key % 5; i++, row++)
+    {
+      table.insert(CompactHashTable::value_type(key * 7919, rowPtr(row)));
+      expected[key * 7919].push_back(rowPtr(row));
+    }
+  }
+
+  EXPECT_EQ(table.size(), row);
+
+  for (auto& e : expected)
+  {
+    std::sort(e.second.begin(), e.second.end());
+    EXPECT_EQ(rowsOf(table, e.first), e.second);
+  }
+}
+
+TEST(CompactHashTableTest, IterateAllRows)
+{
+  CompactHashTable table;
+  std::vector<std::pair<int64_t, uint8_t*>> expected;
+
+  for (size_t i = 0; i < 5000; i++)
+  {
+    int64_t key = i % 1234;
+    table.insert(CompactHashTable::value_type(key, rowPtr(i)));
+    expected.push_back(std::make_pair(key, rowPtr(i)));
+  }
+
+  std::vector<std::pair<int64_t, uint8_t*>> seen;
+
+  for (auto it = table.begin(); it != table.end(); ++it)
+    seen.push_back(*it);
+
+  std::sort(expected.begin(), expected.end());
+  std::sort(seen.begin(), seen.end());
+  EXPECT_EQ(seen, expected);
+}
+
+TEST(CompactHashTableTest, RangeInsert)
+{
+  CompactHashTable table;
+  table.insert(CompactHashTable::value_type(-1, rowPtr(0)));
+
+  std::vector<std::pair<int64_t, uint8_t*>> batch;
+
+  for (size_t i = 1; i <= 3000; i++)
+    batch.push_back(std::make_pair((int64_t)(i % 1000) - 1, rowPtr(i)));
+
+  table.insert(batch.begin(), batch.end());
+
+  EXPECT_EQ(table.size(), 3001U);
+  EXPECT_EQ(rowsOf(table, -1).size(), 4U);
+  EXPECT_EQ(rowsOf(table, 500).size(), 3U);
+  EXPECT_TRUE(table.find(999) == table.end());
+}
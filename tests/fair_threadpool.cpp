@@ -16,8 +16,12 @@
    MA 02110-1301, USA. */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 #include "utils/threadpool/fair_threadpool.h"
@@ -36,10 +40,10 @@ class FairThreadPoolTest : public testing::Test
   void SetUp() override
   {
     results.clear();
-    threadPool = new FairThreadPool(1, 1, 0, 0);
+    threadPool.reset(new FairThreadPool(1, 1, 0, 0));
   }
 
-  FairThreadPool* threadPool;
+  std::unique_ptr<FairThreadPool> threadPool;
 };
 
 class TestFunctor : public FairThreadPool::Functor
@@ -206,4 +210,153 @@ TEST_F(FairThreadPoolTest, FairThreadPoolReschedule)
   EXPECT_EQ(results.size(), 3ULL);
   EXPECT_EQ(results[0], 1);
   EXPECT_TRUE(isThisOrThat(results, 1, 2, 2, 3));
-}
\ No newline at end of file
+}
+class RunCountFunctor : public FairThreadPool::Functor
+{
+ public:
+  RunCountFunctor(std::atomic<uint32_t>& runs) : runs_(runs)
+  {
+  }
+  int operator()() override
+  {
+    runs_.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+  }
+
+ private:
+  std::atomic<uint32_t>& runs_;
+};
+
+// Every job waits until all of them run at the same time, so they can only finish if
+// that many workers run them.
+class RendezvousFunctor : public FairThreadPool::Functor
+{
+ public:
+  RendezvousFunctor(std::atomic<size_t>& arrived, const size_t expected,
+                    std::vector<std::thread::id>& workers)
+   : arrived_(arrived), expected_(expected), workers_(workers)
+  {
+  }
+  int operator()() override
+  {
+    {
+      std::lock_guard<std::mutex> gl(globMutex);
+      workers_.push_back(std::this_thread::get_id());
+    }
+    arrived_.fetch_add(1);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (arrived_.load() < expected_ && std::chrono::steady_clock::now() < deadline)
+      usleep(1000);
+    std::lock_guard<std::mutex> gl(globMutex);
+    results.push_back(arrived_.load() >= expected_);
+    return 0;
+  }
+
+ private:
+  std::atomic<size_t>& arrived_;
+  const size_t expected_;
+  std::vector<std::thread::id>& workers_;
+};
+
+TEST_F(FairThreadPoolTest, FairThreadPoolSteal)
+{
+  // 2 shards with one thread each. The jobs' txns all land in shard 0 and every job blocks until the
+  // other one runs, so while the home thread of shard 0 is busy with one of them the thread of shard 1
+  // must steal the other one.
+  std::unique_ptr<FairThreadPool> stealingPool(new FairThreadPool(1, 2, 0, 0, 0, 2, 1));
+  EXPECT_EQ(stealingPool->queueShards(), 2ULL);
+  SP_UM_IOSOCK sock(new messageqcpp::IOSocket);
+  std::atomic<size_t> arrived{0};
+  std::vector<std::thread::id> workers;
+  const size_t jobsNumber = 2;
+  for (size_t i = 0; i < jobsNumber; ++i)
+  {
+    auto functor =
+        boost::shared_ptr<FairThreadPool::Functor>(new RendezvousFunctor(arrived, jobsNumber, workers));
+    FairThreadPool::Job job(i, 1, 2 * i, functor, sock, 1, 0, i);
+    stealingPool->addJob(job);
+  }
+
+  while (true)
+  {
+    {
+      std::lock_guard<std::mutex> gl(globMutex);
+      if (results.size() == jobsNumber)
+        break;
+    }
+    usleep(10000);
+  }
+
+  ASSERT_EQ(results.size(), jobsNumber);
+  EXPECT_EQ(results[0], 1);
+  EXPECT_EQ(results[1], 1);
+  ASSERT_EQ(workers.size(), jobsNumber);
+  EXPECT_NE(workers[0], workers[1]);
+}
+
+TEST_F(FairThreadPoolTest, FairThreadPoolNumaNodeHint)
+{
+  // Both nodes get all the CPUs available so that the binding always succeeds.
+  utils::CpuListT cpus = utils::getThreadAffinity();
+  std::unique_ptr<FairThreadPool> numaPool(new FairThreadPool(1, 4, 0, 0, 0, 4, 2, {cpus, cpus}));
+  EXPECT_EQ(numaPool->numaNodes(), 2ULL);
+  SP_UM_IOSOCK sock(new messageqcpp::IOSocket);
+  const size_t jobsNumber = 8;
+  for (size_t i = 0; i < jobsNumber; ++i)
+  {
+    auto functor = boost::shared_ptr<FairThreadPool::Functor>(new TestFunctor(i, 10000));
+    FairThreadPool::Job job(i, 1, i, functor, sock, 1, 0, i);
+    job.numaNode_ = 1;
+    numaPool->addJob(job);
+  }
+
+  while (numaPool->queueSize() || numaPool->jobsRunning())
+  {
+    usleep(250000);
+  }
+
+  EXPECT_EQ(results.size(), jobsNumber);
+}
+
+// Producers feeding many txns concurrently into a sharded pool: every job runs exactly once
+// and the pool drains, whichever shard the job lands on or gets stolen from.
+TEST_F(FairThreadPoolTest, FairThreadPoolShardedContention)
+{
+  const size_t threadsNumber = 4;
+  const size_t producersNumber = 4;
+  const size_t txnsNumber = 64;
+  const size_t jobsPerProducer = 2000;
+  const size_t jobsNumber = producersNumber * jobsPerProducer;
+  SP_UM_IOSOCK sock(new messageqcpp::IOSocket);
+  std::vector<std::atomic<uint32_t>> runs(jobsNumber);
+  std::unique_ptr<FairThreadPool> pool(new FairThreadPool(1, threadsNumber, 0, 0, 0, 4, 2));
+  EXPECT_EQ(pool->queueShards(), 4ULL);
+
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < producersNumber; ++p)
+  {
+    producers.emplace_back(
+        [&, p]()
+        {
+          for (size_t i = 0; i < jobsPerProducer; ++i)
+          {
+            size_t id = p * jobsPerProducer + i;
+            auto functor = boost::shared_ptr<FairThreadPool::Functor>(new RunCountFunctor(runs[id]));
+            FairThreadPool::Job job(id, 1, id % txnsNumber, functor, sock, 1);
+            pool->addJob(job);
+          }
+        });
+  }
+  for (auto& producer : producers)
+    producer.join();
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+  while ((pool->queueSize() || pool->jobsRunning()) && std::chrono::steady_clock::now() < deadline)
+  {
+    usleep(1000);
+  }
+
+  ASSERT_EQ(pool->queueSize(), 0ULL);
+  for (size_t i = 0; i < jobsNumber; ++i)
+    EXPECT_EQ(runs[i].load(), 1U) << "job " << i;
+}
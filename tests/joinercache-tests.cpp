@@ -0,0 +1,340 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "joinercache.h"
+#include "joinercacheregistry.h"
+#include "primitivemsg.h"
+
+using namespace joblist;
+using namespace messageqcpp;
+using primitiveprocessor::JoinerCache;
+
+namespace
+{
+// JoinerCache is PrimProc's, each test uses owners of its own
+JoinerCache::Entry makeEntry(uint64_t generation, uint32_t size = 10)
+{
+  JoinerCache::Entry e;
+  e.partitionCount = 1;
+  e.size = size;
+  e.matchNulls = false;
+  e.generation = generation;
+  return e;
+}
+
+bool has(uint32_t owner, uint64_t digest, uint64_t generation)
+{
+  JoinerCache::Entry e;
+  return JoinerCache::instance()->find(owner, digest, e) && e.generation == generation;
+}
+
+// a BATCH_PRIMITIVE_DROP_JOINER_CACHE msg, the way JoinerCacheRegistry builds it
+ByteStream makeDropMsg(uint32_t owner, bool all, uint64_t allGeneration,
+                       const std::vector<std::pair<uint64_t, uint64_t> >& drops)
+{
+  ISMPacketHeader ism;
+  memset((void*)&ism, 0, sizeof(ism));
+  ism.Command = BATCH_PRIMITIVE_DROP_JOINER_CACHE;
+
+  ByteStream bs;
+  bs.load((uint8_t*)&ism, sizeof(ism));
+  bs << (uint32_t)1 << (uint32_t)2 << (uint32_t)3;  // session, step, uniqueID
+  bs << owner;
+  bs << (uint8_t)all;
+  bs << allGeneration;
+  bs << (uint32_t)drops.size();
+
+  for (auto& drop : drops)
+    bs << drop.first << drop.second;
+
+  return bs;
+}
+
+// a BATCH_PRIMITIVE_JOINER_CACHED msg, the way PrimProc builds it
+ByteStream makeStoredMsg(const std::vector<std::pair<uint64_t, uint64_t> >& stored)
+{
+  ISMPacketHeader ism;
+  PrimitiveHeader ph;
+  memset((void*)&ism, 0, sizeof(ism));
+  memset((void*)&ph, 0, sizeof(ph));
+  ism.Command = BATCH_PRIMITIVE_JOINER_CACHED;
+
+  ByteStream bs;
+  bs.append((uint8_t*)&ism, sizeof(ism));
+  bs.append((uint8_t*)&ph, sizeof(ph));
+  bs << (uint32_t)stored.size();
+
+  for (auto& table : stored)
+    bs << table.first << table.second;
+
+  return bs;
+}
+
+// stores digest in a registry the way a query sends it to pmCount PrimProcs that all keep it
+uint64_t store(JoinerCacheRegistry& registry, uint64_t digest, uint64_t rows, uint32_t pmCount = 1)
+{
+  uint64_t generation;
+  EXPECT_EQ(registry.acquire(digest, rows, generation), JOINER_CACHE_STORE);
+  registry.sent(digest, generation, pmCount);
+
+  for (uint32_t i = 0; i < pmCount; i++)
+    registry.stored(digest, generation);
+
+  registry.release(digest, JOINER_CACHE_STORE, generation);
+  return generation;
+}
+}  // namespace
+
+TEST(JoinerCacheTest, GenerationOrdering)
+{
+  JoinerCache* cache = JoinerCache::instance();
+  const uint32_t owner = 101;
+
+  cache->insert(owner, 1, makeEntry(20));
+  EXPECT_TRUE(has(owner, 1, 20));
+
+  // an older store that arrives late doesn't replace the newer table
+  cache->insert(owner, 1, makeEntry(10));
+  EXPECT_TRUE(has(owner, 1, 20));
+
+  cache->insert(owner, 1, makeEntry(30));
+  EXPECT_TRUE(has(owner, 1, 30));
+
+  // a drop only removes the generations it knows about
+  ByteStream bs = makeDropMsg(owner, false, 0, {{1, 20}});
+  cache->drop(bs);
+  EXPECT_TRUE(has(owner, 1, 30));
+
+  bs = makeDropMsg(owner, false, 0, {{1, 30}});
+  cache->drop(bs);
+  JoinerCache::Entry e;
+  EXPECT_FALSE(cache->find(owner, 1, e));
+}
+
+TEST(JoinerCacheTest, Drop)
+{
+  JoinerCache* cache = JoinerCache::instance();
+  const uint32_t owner = 102, other = 103;
+
+  cache->insert(owner, 1, makeEntry(10));
+  cache->insert(owner, 2, makeEntry(11));
+  cache->insert(owner, 3, makeEntry(50));
+  cache->insert(other, 1, makeEntry(10));
+
+  // drop all of the owner's tables up to generation 20, and table 3 at its generation
+  ByteStream bs = makeDropMsg(owner, true, 20, {{3, 50}, {4, 60}});
+  cache->drop(bs);
+
+  JoinerCache::Entry e;
+  EXPECT_FALSE(cache->find(owner, 1, e));
+  EXPECT_FALSE(cache->find(owner, 2, e));
+  EXPECT_FALSE(cache->find(owner, 3, e));
+  EXPECT_TRUE(has(other, 1, 10));
+
+  // a drop all keeps what's newer
+  cache->insert(owner, 1, makeEntry(30));
+  bs = makeDropMsg(owner, true, 20, {});
+  cache->drop(bs);
+  EXPECT_TRUE(has(owner, 1, 30));
+}
+
+TEST(JoinerCacheTest, EvictsLeastRecentlyUsed)
+{
+  JoinerCache* cache = JoinerCache::instance();
+  const uint32_t owner = 104;
+  JoinerCache::Entry e;
+
+  // room for two tables of 100 keys
+  cache->setMaxSize(100 * 48 * 2);
+  EXPECT_TRUE(cache->insert(owner, 1, makeEntry(10, 100)));
+  EXPECT_TRUE(cache->insert(owner, 2, makeEntry(11, 100)));
+  EXPECT_TRUE(cache->find(owner, 1, e));
+
+  // 2 is the least recently used
+  EXPECT_TRUE(cache->insert(owner, 3, makeEntry(12, 100)));
+  EXPECT_TRUE(has(owner, 1, 10));
+  EXPECT_FALSE(cache->find(owner, 2, e));
+  EXPECT_TRUE(has(owner, 3, 12));
+
+  // one that can't fit isn't kept, and doesn't push out the others
+  EXPECT_FALSE(cache->insert(owner, 4, makeEntry(13, 300)));
+  EXPECT_FALSE(cache->find(owner, 4, e));
+  EXPECT_TRUE(has(owner, 1, 10));
+  EXPECT_TRUE(has(owner, 3, 12));
+
+  cache->setMaxSize(512 * 1024 * 1024);
+}
+
+TEST(JoinerCacheRegistryTest, Disabled)
+{
+  JoinerCacheRegistry registry(1, 0);
+  uint64_t generation;
+
+  EXPECT_FALSE(registry.enabled());
+  EXPECT_EQ(registry.acquire(1, 10, generation), JOINER_CACHE_NONE);
+}
+
+TEST(JoinerCacheRegistryTest, UsedOnceEveryPrimProcConfirmed)
+{
+  JoinerCacheRegistry registry(1, 1 << 20);
+  uint64_t generation, used;
+
+  ASSERT_EQ(registry.acquire(1, 10, generation), JOINER_CACHE_STORE);
+
+  // not sent yet, then not confirmed by both PrimProcs
+  EXPECT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_NONE);
+  registry.sent(1, generation, 2);
+  EXPECT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_NONE);
+
+  ByteStream bs = makeStoredMsg({{1, generation}});
+  registry.storedMsg(bs);
+  EXPECT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_NONE);
+
+  registry.stored(1, generation);
+  ASSERT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_USE);
+  EXPECT_EQ(used, generation);
+  registry.release(1, JOINER_CACHE_USE, used);
+
+  // the storing query is done with it, it stays
+  registry.release(1, JOINER_CACHE_STORE, generation);
+  EXPECT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_USE);
+}
+
+TEST(JoinerCacheRegistryTest, ConfirmedBeforeSent)
+{
+  JoinerCacheRegistry registry(1, 1 << 20);
+  uint64_t generation, used;
+
+  ASSERT_EQ(registry.acquire(1, 10, generation), JOINER_CACHE_STORE);
+  registry.stored(1, generation);
+  EXPECT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_NONE);
+
+  registry.sent(1, generation, 1);
+  EXPECT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_USE);
+}
+
+TEST(JoinerCacheRegistryTest, UnconfirmedStoreIsDropped)
+{
+  JoinerCacheRegistry registry(7, 1 << 20);
+  uint64_t generation, next;
+  ByteStream bs;
+
+  // the first drop msg clears what a previous ExeMgr left
+  ASSERT_TRUE(registry.getDropMsg(bs, 0, 0, 0));
+  EXPECT_FALSE(registry.getDropMsg(bs, 0, 0, 0));
+
+  // the query stops before PrimProc says it has the table
+  ASSERT_EQ(registry.acquire(1, 10, generation), JOINER_CACHE_STORE);
+  registry.sent(1, generation, 1);
+  registry.release(1, JOINER_CACHE_STORE, generation);
+
+  // a later query sends it again rather than waiting for it
+  ASSERT_EQ(registry.acquire(1, 10, next), JOINER_CACHE_STORE);
+  EXPECT_GT(next, generation);
+
+  // and PrimProc is told to drop what it kept, confirmed late or not
+  registry.stored(1, generation);
+  bs.restart();
+  ASSERT_TRUE(registry.getDropMsg(bs, 0, 0, 0));
+
+  JoinerCache::instance()->insert(7, 1, makeEntry(generation));
+  JoinerCache::instance()->drop(bs);
+  JoinerCache::Entry e;
+  EXPECT_FALSE(JoinerCache::instance()->find(7, 1, e));
+}
+
+TEST(JoinerCacheRegistryTest, EvictsUnpinned)
+{
+  // room for two tables of 100 rows
+  JoinerCacheRegistry registry(1, 100 * 48 * 2);
+  uint64_t g1, g3, used;
+
+  g1 = store(registry, 1, 100);
+  store(registry, 2, 100);
+  ASSERT_EQ(registry.acquire(1, 100, used), JOINER_CACHE_USE);
+
+  // 1 is pinned, 2 goes
+  g3 = store(registry, 3, 100);
+  EXPECT_EQ(registry.acquire(2, 100, used), JOINER_CACHE_STORE);
+  EXPECT_EQ(registry.acquire(3, 100, used), JOINER_CACHE_USE);
+  registry.release(3, JOINER_CACHE_USE, g3);
+  registry.release(1, JOINER_CACHE_USE, g1);
+}
+
+TEST(JoinerCacheRegistryTest, ResetOnNewPMOnline)
+{
+  JoinerCacheRegistry registry(9, 1 << 20);
+  ByteStream bs;
+  uint64_t generation, used;
+
+  ASSERT_TRUE(registry.getDropMsg(bs, 0, 0, 0));
+  generation = store(registry, 1, 10);
+  ASSERT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_USE);
+
+  // a PrimProc came online without its cache
+  registry.reset();
+  EXPECT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_STORE);
+
+  // the queries that used it before are done with it
+  registry.release(1, JOINER_CACHE_USE, generation);
+
+  // the drop msg drops all of this owner's tables from before the reset
+  JoinerCache::instance()->insert(9, 1, makeEntry(generation));
+  JoinerCache::instance()->insert(9, 2, makeEntry(generation + 1));
+  bs.restart();
+  ASSERT_TRUE(registry.getDropMsg(bs, 0, 0, 0));
+  JoinerCache::instance()->drop(bs);
+
+  JoinerCache::Entry e;
+  EXPECT_FALSE(JoinerCache::instance()->find(9, 1, e));
+  EXPECT_FALSE(JoinerCache::instance()->find(9, 2, e));
+}
+
+TEST(JoinerCacheRegistryTest, MissedIsSentAgain)
+{
+  JoinerCacheRegistry registry(11, 1 << 20);
+  ByteStream bs;
+  uint64_t generation, used, next;
+
+  ASSERT_TRUE(registry.getDropMsg(bs, 0, 0, 0));
+  generation = store(registry, 1, 10, 2);
+  ASSERT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_USE);
+
+  // one of the PrimProcs restarted, or dropped it to make room
+  registry.missed(1, used);
+  ASSERT_EQ(registry.acquire(1, 10, next), JOINER_CACHE_STORE);
+  EXPECT_GT(next, generation);
+
+  // the query that used it is done with it, the new copy isn't confirmed yet
+  registry.release(1, JOINER_CACHE_USE, used);
+  EXPECT_EQ(registry.acquire(1, 10, used), JOINER_CACHE_NONE);
+
+  // the other PrimProc drops its copy
+  JoinerCache::instance()->insert(11, 1, makeEntry(generation));
+  bs.restart();
+  ASSERT_TRUE(registry.getDropMsg(bs, 0, 0, 0));
+  JoinerCache::instance()->drop(bs);
+
+  JoinerCache::Entry e;
+  EXPECT_FALSE(JoinerCache::instance()->find(11, 1, e));
+}
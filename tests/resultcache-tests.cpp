@@ -0,0 +1,173 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "resultcache.h"
+
+using namespace joblist;
+using namespace messageqcpp;
+
+namespace
+{
+const uint64_t CacheSize = 1 << 20;
+const uint32_t BandBytes = 50000;
+
+ResultCacheKey makeKey(uint64_t plan, uint64_t dataVersion)
+{
+  ResultCacheKey key;
+  key.plan = plan;
+  key.dataVersion = dataVersion;
+  return key;
+}
+
+// a result of one band of BandBytes and the empty band that ends it
+boost::shared_ptr<CachedResult> makeResult(ResultCache& cache, const ResultCacheKey& key)
+{
+  boost::shared_ptr<CachedResult> result = cache.newResult(key, rowgroup::RowGroup());
+  ByteStream band, end;
+  band << std::string(BandBytes, 'x');
+
+  EXPECT_TRUE(result->addBand(band, 100));
+  EXPECT_TRUE(result->addBand(end, 0));
+  return result;
+}
+
+struct Stats
+{
+  uint64_t entries, size, maxSize, hits, misses, inserts, evictions, invalidations;
+};
+
+Stats getStats(ResultCache& cache)
+{
+  ByteStream bs;
+  Stats s;
+
+  cache.serializeStats(bs);
+  bs >> s.entries >> s.size >> s.maxSize >> s.hits >> s.misses >> s.inserts >> s.evictions >>
+      s.invalidations;
+  return s;
+}
+}  // namespace
+
+TEST(ResultCacheTest, Disabled)
+{
+  ResultCache cache(0);
+  EXPECT_FALSE(cache.enabled());
+}
+
+TEST(ResultCacheTest, HitAndMiss)
+{
+  ResultCache cache(CacheSize);
+  ASSERT_TRUE(cache.enabled());
+
+  EXPECT_FALSE(cache.find(makeKey(1, 1)));
+
+  boost::shared_ptr<CachedResult> result = makeResult(cache, makeKey(1, 1));
+  cache.insert(result);
+
+  boost::shared_ptr<const CachedResult> found = cache.find(makeKey(1, 1));
+  ASSERT_TRUE(found);
+  EXPECT_EQ(found.get(), result.get());
+  ASSERT_EQ(found->bands.size(), 2U);
+  EXPECT_EQ(found->bands[0].second, 100U);
+  EXPECT_EQ(found->bands[1].second, 0U);
+
+  // another plan
+  EXPECT_FALSE(cache.find(makeKey(2, 1)));
+
+  Stats s = getStats(cache);
+  EXPECT_EQ(s.entries, 1U);
+  EXPECT_EQ(s.size, result->size);
+  EXPECT_EQ(s.hits, 1U);
+  EXPECT_EQ(s.misses, 2U);
+  EXPECT_EQ(s.inserts, 1U);
+}
+
+TEST(ResultCacheTest, NewDataVersionInvalidates)
+{
+  ResultCache cache(CacheSize);
+  cache.insert(makeResult(cache, makeKey(1, 1)));
+
+  // the data changed: the stale result is dropped, not just skipped
+  EXPECT_FALSE(cache.find(makeKey(1, 2)));
+  EXPECT_FALSE(cache.find(makeKey(1, 1)));
+
+  Stats s = getStats(cache);
+  EXPECT_EQ(s.entries, 0U);
+  EXPECT_EQ(s.size, 0U);
+  EXPECT_EQ(s.invalidations, 1U);
+
+  // the result of the new version replaces it
+  cache.insert(makeResult(cache, makeKey(1, 2)));
+  EXPECT_TRUE(cache.find(makeKey(1, 2)));
+}
+
+TEST(ResultCacheTest, InsertReplaces)
+{
+  ResultCache cache(CacheSize);
+  boost::shared_ptr<CachedResult> first = makeResult(cache, makeKey(1, 1));
+  boost::shared_ptr<CachedResult> second = makeResult(cache, makeKey(1, 2));
+
+  cache.insert(first);
+  cache.insert(second);
+
+  EXPECT_EQ(cache.find(makeKey(1, 2)).get(), second.get());
+
+  Stats s = getStats(cache);
+  EXPECT_EQ(s.entries, 1U);
+  EXPECT_EQ(s.size, second->size);
+}
+
+TEST(ResultCacheTest, LRUEviction)
+{
+  ResultCache probe(CacheSize);
+  uint64_t resultSize = makeResult(probe, makeKey(0, 0))->size;
+
+  // room for five results
+  ResultCache cache(resultSize * 5 + resultSize / 2);
+
+  for (uint64_t plan = 1; plan <= 5; plan++)
+    cache.insert(makeResult(cache, makeKey(plan, 1)));
+
+  // 1 is now the most recently used, 2 the least
+  EXPECT_TRUE(cache.find(makeKey(1, 1)));
+  cache.insert(makeResult(cache, makeKey(6, 1)));
+
+  EXPECT_FALSE(cache.find(makeKey(2, 1)));
+
+  for (uint64_t plan : {1, 3, 4, 5, 6})
+    EXPECT_TRUE(cache.find(makeKey(plan, 1))) << plan;
+
+  Stats s = getStats(cache);
+  EXPECT_EQ(s.entries, 5U);
+  EXPECT_EQ(s.evictions, 1U);
+  EXPECT_LE(s.size, s.maxSize);
+}
+
+TEST(ResultCacheTest, ResultTooLarge)
+{
+  // one result can take a quarter of the cache
+  ResultCache cache(BandBytes * 2);
+  boost::shared_ptr<CachedResult> result = cache.newResult(makeKey(1, 1), rowgroup::RowGroup());
+  ByteStream band;
+  band << std::string(BandBytes, 'x');
+
+  EXPECT_FALSE(result->addBand(band, 100));
+}
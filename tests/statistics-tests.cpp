@@ -0,0 +1,148 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <cmath>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "statistics.h"
+
+using namespace statistics;
+
+namespace
+{
+// 4096 registers give ~1.6% standard error, allow for more than three of them
+void expectEstimate(const HLLSketch& sketch, uint64_t distinct)
+{
+  EXPECT_NEAR((double)sketch.estimate(), (double)distinct, distinct * 0.05 + 1) << distinct;
+}
+}  // namespace
+
+TEST(HLLSketchTest, Empty)
+{
+  HLLSketch sketch;
+  EXPECT_EQ(sketch.estimate(), 0U);
+}
+
+TEST(HLLSketchTest, Estimate)
+{
+  for (uint64_t distinct : {1, 10, 100, 1000, 10000, 100000, 1000000})
+  {
+    HLLSketch sketch;
+    std::mt19937_64 gen(distinct);
+
+    for (uint64_t i = 0; i < distinct; i++)
+      sketch.add(gen());
+
+    expectEstimate(sketch, distinct);
+  }
+}
+
+TEST(HLLSketchTest, Duplicates)
+{
+  HLLSketch sketch;
+
+  for (uint32_t repeat = 0; repeat < 10; repeat++)
+    for (uint64_t i = 0; i < 5000; i++)
+      sketch.add(i);
+
+  expectEstimate(sketch, 5000);
+}
+
+TEST(HLLSketchTest, Merge)
+{
+  HLLSketch a, b, both;
+
+  // overlapping halves of [0, 30000)
+  for (uint64_t i = 0; i < 20000; i++)
+  {
+    a.add(i);
+    both.add(i);
+  }
+
+  for (uint64_t i = 10000; i < 30000; i++)
+  {
+    b.add(i);
+    both.add(i);
+  }
+
+  a.merge(b);
+  EXPECT_EQ(a.estimate(), both.estimate());
+  expectEstimate(a, 30000);
+
+  // merging is idempotent
+  a.merge(b);
+  EXPECT_EQ(a.estimate(), both.estimate());
+}
+
+TEST(ColumnHistogramTest, Empty)
+{
+  ColumnHistogram histogram;
+  EXPECT_EQ(histogram.lessOrEqualFraction(0), 0.0);
+  EXPECT_EQ(histogram.lessOrEqualFraction(100), 0.0);
+}
+
+TEST(ColumnHistogramTest, LessOrEqualFraction)
+{
+  // four buckets of [0, 100]
+  ColumnHistogram histogram;
+  histogram.minValue = 0;
+  histogram.bounds = {25, 50, 75, 100};
+
+  EXPECT_EQ(histogram.lessOrEqualFraction(-1), 0.0);
+  EXPECT_DOUBLE_EQ(histogram.lessOrEqualFraction(0), 0.0);
+  EXPECT_DOUBLE_EQ(histogram.lessOrEqualFraction(10), 0.1);
+  EXPECT_DOUBLE_EQ(histogram.lessOrEqualFraction(25), 0.25);
+  EXPECT_DOUBLE_EQ(histogram.lessOrEqualFraction(60), 0.6);
+  EXPECT_DOUBLE_EQ(histogram.lessOrEqualFraction(99), 0.99);
+  EXPECT_EQ(histogram.lessOrEqualFraction(100), 1.0);
+  EXPECT_EQ(histogram.lessOrEqualFraction(1000), 1.0);
+}
+
+TEST(ColumnHistogramTest, SkewedBuckets)
+{
+  // half the rows are 0
+  ColumnHistogram histogram;
+  histogram.minValue = 0;
+  histogram.bounds = {0, 0, 500, 1000};
+
+  EXPECT_DOUBLE_EQ(histogram.lessOrEqualFraction(0), 0.5);
+  EXPECT_DOUBLE_EQ(histogram.lessOrEqualFraction(250), 0.625);
+  EXPECT_DOUBLE_EQ(histogram.lessOrEqualFraction(750), 0.875);
+}
+
+TEST(ColumnHistogramTest, Monotonic)
+{
+  ColumnHistogram histogram;
+  histogram.minValue = -1000;
+
+  for (int64_t b = -900; b <= 1000; b += 100)
+    histogram.bounds.push_back(b * (b < 0 ? 1 : 3));
+
+  double last = 0.0;
+
+  for (int64_t v = -1100; v <= 3100; v += 7)
+  {
+    double f = histogram.lessOrEqualFraction(v);
+    EXPECT_GE(f, last) << v;
+    EXPECT_LE(f, 1.0);
+    last = f;
+  }
+
+  EXPECT_EQ(last, 1.0);
+}
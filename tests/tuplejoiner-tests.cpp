@@ -0,0 +1,172 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "constantcolumn.h"
+#include "funcexpwrapper.h"
+#include "parsetree.h"
+#include "predicateoperator.h"
+#include "simplecolumn.h"
+#include "simplefilter.h"
+#include "tuplejoiner.h"
+
+using namespace execplan;
+using namespace joiner;
+using namespace rowgroup;
+
+namespace
+{
+// a RowGroup of columnCount BIGINT columns
+RowGroup makeRG(uint32_t columnCount)
+{
+  std::vector<uint32_t> offsets, oids, keys, scale, precision, charsets;
+  std::vector<CalpontSystemCatalog::ColDataType> types;
+  uint32_t offset = 2;
+
+  offsets.push_back(offset);
+
+  for (uint32_t i = 0; i < columnCount; i++)
+  {
+    offset += 8;
+    offsets.push_back(offset);
+    oids.push_back(3000 + i);
+    keys.push_back(i + 1);
+    types.push_back(CalpontSystemCatalog::BIGINT);
+    scale.push_back(0);
+    precision.push_back(18);
+    charsets.push_back(8);
+  }
+
+  return RowGroup(columnCount, offsets, oids, keys, types, charsets, scale, precision, 20, false);
+}
+
+// the join filter 'small.val = val', small.val being column 1 of the small side
+boost::shared_ptr<funcexp::FuncExpWrapper> makeValFilter(int64_t val)
+{
+  CalpontSystemCatalog::ColType bigint;
+  bigint.colDataType = CalpontSystemCatalog::BIGINT;
+  bigint.colWidth = 8;
+
+  SimpleColumn* sc = new SimpleColumn("val", SimpleColumn::ForTestPurposeWithoutOID());
+  sc->inputIndex(1);
+  sc->resultType(bigint);
+  ConstantColumn* cc = new ConstantColumn(std::to_string(val), ConstantColumn::NUM);
+  cc->resultType(bigint);
+
+  SOP op(new PredicateOperator("="));
+  op->setOpType(sc->resultType(), cc->resultType());
+
+  boost::shared_ptr<funcexp::FuncExpWrapper> fe(new funcexp::FuncExpWrapper());
+  fe->addFilter(boost::shared_ptr<ParseTree>(new ParseTree(new SimpleFilter(op, sc, cc))));
+  return fe;
+}
+
+class TupleJoinerSemiJoinTest : public ::testing::Test
+{
+ protected:
+  void SetUp() override
+  {
+    smallRG = makeRG(2);
+    largeRG = makeRG(1);
+
+    // small side (key, val): (1, 10), (1, 20), (2, 30)
+    smallData.reinit(smallRG, 3);
+    smallRG.setData(&smallData);
+    smallRG.resetRowGroup(0);
+    Row r;
+    smallRG.initRow(&r);
+    smallRG.getRow(0, &r);
+
+    for (auto& row : std::vector<std::pair<int64_t, int64_t> >{{1, 10}, {1, 20}, {2, 30}})
+    {
+      r.setIntField(row.first, 0);
+      r.setIntField(row.second, 1);
+      r.nextRow();
+    }
+
+    smallRG.setRowCount(3);
+
+    largeData.reinit(largeRG, 1);
+    largeRG.setData(&largeData);
+    largeRG.resetRowGroup(0);
+    largeRG.initRow(&largeRow);
+    largeRG.getRow(0, &largeRow);
+    largeRow.setIntField(1, 0);
+    largeRG.setRowCount(1);
+  }
+
+  // builds the UM join table the way TupleHashJoinStep::startSmallRunners() does
+  void build(TupleJoiner& joiner, const boost::shared_ptr<funcexp::FuncExpWrapper>& fe)
+  {
+    joiner.setFcnExpFilter(fe);
+    joiner.setInUM();
+    joiner.insertRGData(smallRG, 0);
+    joiner.doneInserting();
+    joiner.setThreadCount(1);
+  }
+
+  std::vector<Row::Pointer> matches(TupleJoiner& joiner)
+  {
+    std::vector<Row::Pointer> ret;
+    joiner.match(largeRow, 0, 0, &ret);
+    return ret;
+  }
+
+  RowGroup smallRG, largeRG;
+  RGData smallData, largeData;
+  Row largeRow;
+};
+}  // namespace
+
+TEST_F(TupleJoinerSemiJoinTest, ExistenceJoinKeepsOneRowPerKey)
+{
+  TupleJoiner joiner(smallRG, largeRG, 0, 0, joblist::SEMI, nullptr);
+  build(joiner, boost::shared_ptr<funcexp::FuncExpWrapper>());
+
+  EXPECT_TRUE(joiner.existenceJoin());
+  EXPECT_EQ(matches(joiner).size(), 1U);
+}
+
+TEST_F(TupleJoinerSemiJoinTest, JoinFilterMatchesNonFirstDuplicate)
+{
+  TupleJoiner joiner(smallRG, largeRG, 0, 0, joblist::SEMI, nullptr);
+  // only the second row of key 1 passes the filter
+  build(joiner, makeValFilter(20));
+  EXPECT_FALSE(joiner.existenceJoin());
+
+  std::vector<Row::Pointer> rows = matches(joiner);
+  EXPECT_EQ(rows.size(), 2U);
+  Row r;
+  smallRG.initRow(&r);
+  uint32_t passed = 0;
+
+  for (auto& row : rows)
+  {
+    r.setPointer(row);
+
+    if (joiner.evaluateFilter(r, 0))
+    {
+      EXPECT_EQ(r.getIntField(1), 20);
+      passed++;
+    }
+  }
+
+  EXPECT_EQ(passed, 1U);
+}
@@ -205,16 +205,26 @@ int main(int argc, char* argv[])
                                                     // same in SystemCatalog::upgrade().
     upgradeOidMap[OID_SYSCOLUMN_CHARSETNUM] =
       std::make_pair(OID_SYSCOLUMN_OBJECTID, false);
+    upgradeOidMap[OID_SYSCOLUMN_SORTKEY] =
+      std::make_pair(OID_SYSCOLUMN_OBJECTID, false);
+    upgradeOidMap[OID_SYSCOLUMN_INDEXTYPE] =
+      std::make_pair(OID_SYSCOLUMN_OBJECTID, false);
 
     std::unordered_map<int, OidTypeT> upgradeOidTypeMap;
     upgradeOidTypeMap[OID_SYSTABLE_AUXCOLUMNOID] =
       std::make_pair(CalpontSystemCatalog::INT, 4);
     upgradeOidTypeMap[OID_SYSCOLUMN_CHARSETNUM] =
       std::make_pair(CalpontSystemCatalog::INT, 4);
+    upgradeOidTypeMap[OID_SYSCOLUMN_SORTKEY] =
+      std::make_pair(CalpontSystemCatalog::INT, 4);
+    upgradeOidTypeMap[OID_SYSCOLUMN_INDEXTYPE] =
+      std::make_pair(CalpontSystemCatalog::INT, 4);
 
     std::unordered_map<int, std::string> upgradeOidDefaultValStrMap;
     upgradeOidDefaultValStrMap[OID_SYSTABLE_AUXCOLUMNOID] = "0";
     upgradeOidDefaultValStrMap[OID_SYSCOLUMN_CHARSETNUM] = "0";
+    upgradeOidDefaultValStrMap[OID_SYSCOLUMN_SORTKEY] = "0";
+    upgradeOidDefaultValStrMap[OID_SYSCOLUMN_INDEXTYPE] = "0";
 
     try
     {
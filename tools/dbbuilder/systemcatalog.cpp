@@ -273,6 +273,8 @@ void SystemCatalog::build()
     oids[OID_SYSCOLUMN_COMPRESSIONTYPE] = OID_SYSCOLUMN_COMPRESSIONTYPE;
     oids[OID_SYSCOLUMN_NEXTVALUE] = OID_SYSCOLUMN_NEXTVALUE;
     oids[OID_SYSCOLUMN_CHARSETNUM] = OID_SYSCOLUMN_CHARSETNUM;
+    oids[OID_SYSCOLUMN_SORTKEY] = OID_SYSCOLUMN_SORTKEY;
+    oids[OID_SYSCOLUMN_INDEXTYPE] = OID_SYSCOLUMN_INDEXTYPE;
   }
 
   cout << endl;
@@ -585,6 +587,28 @@ void SystemCatalog::build()
 
   msg.str("");
 
+  // sortkey
+  msg << "  Creating SORTKEY column OID: " << OID_SYSCOLUMN_SORTKEY;
+  cout << msg.str() << endl;
+  rc = fWriteEngine.createColumn(txnID, OID_SYSCOLUMN_SORTKEY, CalpontSystemCatalog::INT, 4, dbRoot,
+                                 partition, compressionType);
+
+  if (rc)
+    throw runtime_error(msg.str() + ec.errorString(rc));
+
+  msg.str("");
+
+  // indextype
+  msg << "  Creating INDEXTYPE column OID: " << OID_SYSCOLUMN_INDEXTYPE;
+  cout << msg.str() << endl;
+  rc = fWriteEngine.createColumn(txnID, OID_SYSCOLUMN_INDEXTYPE, CalpontSystemCatalog::INT, 4, dbRoot,
+                                 partition, compressionType);
+
+  if (rc)
+    throw runtime_error(msg.str() + ec.errorString(rc));
+
+  msg.str("");
+
   // flush data files
   fWriteEngine.flushDataFiles(rc, 1, oids);
   // save brm
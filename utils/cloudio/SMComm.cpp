@@ -18,6 +18,7 @@
 #include "SMComm.h"
 #include "bytestream.h"
 #include "messageFormat.h"
+#include <boost/thread/thread.hpp>
 
 using namespace std;
 using namespace messageqcpp;
@@ -26,6 +27,10 @@ namespace
 {
 idbdatafile::SMComm* instance = NULL;
 boost::mutex m;
+
+// prefetch hints waiting for the sender past this are dropped; the scans that sent them
+// have moved on or are reading the data already
+const size_t MAX_QUEUED_PREFETCHES = 256;
 };  // namespace
 
 namespace idbdatafile
@@ -71,7 +76,7 @@ SMComm* SMComm::get()
       errno = 0;                           \
   }
 
-SMComm::SMComm()
+SMComm::SMComm() : prefetchSenderRunning(false)
 {
   char buf[4096];
   cwd = ::getcwd(buf, 4096);
@@ -208,6 +213,61 @@ int SMComm::truncate(const string& filename, const off64_t length)
   common_exit(command, response, err);
 }
 
+int SMComm::prefetch(const string& filename, const off_t offset, const size_t length)
+{
+  PrefetchRequest request = {getAbsFilename(filename), offset, length};
+  boost::mutex::scoped_lock lk(prefetchMutex);
+
+  if (prefetchQueue.size() >= MAX_QUEUED_PREFETCHES)
+    return 0;
+
+  prefetchQueue.push_back(request);
+
+  if (!prefetchSenderRunning)
+  {
+    boost::thread t(&SMComm::prefetchSender, this);
+    t.detach();
+    prefetchSenderRunning = true;
+  }
+
+  prefetchReady.notify_one();
+  return 0;
+}
+
+// Sends the queued prefetch hints so the threads that read the files never wait on SM for one.
+// SMComm is never destroyed, neither is this thread.
+void SMComm::prefetchSender()
+{
+  while (true)
+  {
+    PrefetchRequest request;
+    {
+      boost::mutex::scoped_lock lk(prefetchMutex);
+
+      while (prefetchQueue.empty())
+        prefetchReady.wait(lk);
+
+      request = prefetchQueue.front();
+      prefetchQueue.pop_front();
+    }
+    sendPrefetch(request);
+  }
+}
+
+int SMComm::sendPrefetch(const PrefetchRequest& request)
+{
+  ByteStream* command = buffers.getByteStream();
+  ByteStream* response = buffers.getByteStream();
+  ssize_t err;
+
+  *command << (uint8_t)storagemanager::PREFETCH << request.length << request.offset << request.filename;
+  err = sockets.send_recv(*command, response);
+  if (err)
+    common_exit(command, response, err);
+  check_for_error(command, response, err);
+  common_exit(command, response, err);
+}
+
 int SMComm::listDirectory(const string& path, list<string>* entries)
 {
   ByteStream* command = buffers.getByteStream();
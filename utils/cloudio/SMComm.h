@@ -18,7 +18,10 @@
 #pragma once
 
 #include <sys/stat.h>
+#include <deque>
 #include <string>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include "SocketPool.h"
 #include "bytestream.h"
 #include "bytestreampool.h"
@@ -56,6 +59,11 @@ class SMComm : public boost::noncopyable
   // operation in SMDataFile.
   int truncate(const std::string& filename, const off64_t length);
 
+  // asks SM to start downloading the objects backing [offset, offset + length) of filename.
+  // It's a hint, so it doesn't wait for SM: the request is queued for a thread of its own to send,
+  // and dropped if too many are already waiting.  Returns 0.
+  int prefetch(const std::string& filename, const off_t offset, const size_t length);
+
   int listDirectory(const std::string& path, std::list<std::string>* entries);
 
   // health indicator.  0 = processes are talking to each other and SM has read/write access to
@@ -76,7 +84,21 @@ class SMComm : public boost::noncopyable
 
   std::string getAbsFilename(const std::string& filename);
 
+  struct PrefetchRequest
+  {
+    std::string filename;
+    off_t offset;
+    size_t length;
+  };
+
+  void prefetchSender();
+  int sendPrefetch(const PrefetchRequest& request);
+
   SocketPool sockets;
+  boost::mutex prefetchMutex;
+  boost::condition_variable prefetchReady;
+  std::deque<PrefetchRequest> prefetchQueue;
+  bool prefetchSenderRunning;
   messageqcpp::ByteStreamPool buffers;
   std::string cwd;
 };
@@ -94,6 +94,11 @@ int SMDataFile::fallocate(int mode, off64_t offset, off64_t length)
   return comm->truncate(name(), offset + length);
 }
 
+int SMDataFile::prefetch(off64_t offset, off64_t length)
+{
+  return comm->prefetch(name(), offset, length);
+}
+
 off64_t SMDataFile::size()
 {
   struct stat _stat;
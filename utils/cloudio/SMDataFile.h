@@ -35,6 +35,7 @@ class SMDataFile : public IDBDataFile
   int seek(off64_t offset, int whence);
   int truncate(off64_t length);
   int fallocate(int mode, off64_t offset, off64_t length);
+  int prefetch(off64_t offset, off64_t length);
   off64_t size();
   off64_t tell();
   int flush();
@@ -18,6 +18,8 @@
 #include "cgroupconfigurator.h"
 #include "configcpp.h"
 #include "logger.h"
+#include "threadaffinity.h"
+#include <algorithm>
 #include <charconv>
 #include <fstream>
 #include <iostream>
@@ -64,6 +66,30 @@ void log(logging::LOG_TYPE whichLogFile, const string& msg)
   logger.logMessage(whichLogFile, msg, logging::LoggingID(12));
 }
 
+// Parses the kernel cpu list format, e.g. "0-7,9,11-12".
+std::vector<uint32_t> parseCpuList(const string& cpusString)
+{
+  std::vector<uint32_t> cpus;
+  istringstream in(cpusString);
+  string oneRange;
+
+  while (getline(in, oneRange, ','))
+  {
+    if (oneRange.empty())
+      continue;
+
+    const char* data = oneRange.c_str();
+    size_t dash = oneRange.find('-');
+    uint32_t firstCPU = strtol(data, NULL, 10);
+    uint32_t lastCPU = (dash == string::npos) ? firstCPU : strtol(&data[dash + 1], NULL, 10);
+
+    for (uint32_t cpu = firstCPU; cpu <= lastCPU; ++cpu)
+      cpus.push_back(cpu);
+  }
+
+  return cpus;
+}
+
 }  // namespace
 
 namespace utils
@@ -155,6 +181,71 @@ uint32_t CGroupConfigurator::getNumCoresFromCGroup()
   return cpus;
 }
 
+std::vector<uint32_t> CGroupConfigurator::getCpusFromCGroup()
+{
+  ostringstream filenameOs;
+  if (cGroupVersion_ == v1)
+  {
+    filenameOs << "/sys/fs/cgroup/cpuset/" << cGroupName << "/cpuset.cpus";
+  }
+  else
+  {
+    filenameOs << "/sys/fs/cgroup/" << cGroupName << "/cpuset.cpus";
+  }
+
+  ifstream in(filenameOs.str().c_str());
+  string cpusString;
+
+  if (!in || !(in >> cpusString))
+    return {};
+
+  return parseCpuList(cpusString);
+}
+
+std::vector<std::vector<uint32_t>> CGroupConfigurator::getNumaNodeCpus()
+{
+  std::vector<uint32_t> allowedCpus;
+
+  if (cGroupDefined)
+    allowedCpus = getCpusFromCGroup();
+
+  // The affinity mask already reflects the cpuset of the cgroup the process runs in.
+  if (allowedCpus.empty())
+    allowedCpus = utils::getThreadAffinity();
+
+  std::sort(allowedCpus.begin(), allowedCpus.end());
+
+  std::vector<std::vector<uint32_t>> nodes;
+  for (uint32_t node = 0;; ++node)
+  {
+    ostringstream filenameOs;
+    filenameOs << "/sys/devices/system/node/node" << node << "/cpulist";
+    ifstream in(filenameOs.str().c_str());
+    string cpusString;
+
+    if (!in)
+      break;
+
+    if (!(in >> cpusString))
+      continue;
+
+    std::vector<uint32_t> nodeCpus;
+    for (auto cpu : parseCpuList(cpusString))
+    {
+      if (std::binary_search(allowedCpus.begin(), allowedCpus.end(), cpu))
+        nodeCpus.push_back(cpu);
+    }
+
+    if (!nodeCpus.empty())
+      nodes.push_back(std::move(nodeCpus));
+  }
+
+  if (nodes.empty())
+    nodes.push_back(allowedCpus);
+
+  return nodes;
+}
+
 uint32_t CGroupConfigurator::getNumCoresFromProc()
 {
   uint32_t nc = sysconf(_SC_NPROCESSORS_ONLN);
@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <inttypes.h>
 #include <string>
+#include <vector>
 
 #include "configcpp.h"
 
@@ -42,6 +43,9 @@ class CGroupConfigurator
   uint32_t getNumCores();
   uint64_t getTotalMemory();
   uint64_t getFreeMemory();
+  // CPUs of every NUMA node restricted to the CPUs this process may run on.
+  // The nodes w/o usable CPUs are skipped. A host w/o NUMA info is reported as a single node.
+  std::vector<std::vector<uint32_t>> getNumaNodeCpus();
 
   bool usingCGroup()
   {
@@ -55,6 +59,7 @@ class CGroupConfigurator
   uint64_t getTotalMemoryFromCGroup();
   uint64_t getFreeMemoryFromProc();
   uint64_t getMemUsageFromCGroup();
+  std::vector<uint32_t> getCpusFromCGroup();
 
   std::string cGroupName;
   std::string memUsageFilename;
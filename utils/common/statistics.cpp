@@ -17,6 +17,8 @@
 
 #include <iostream>
 #include <atomic>
+#include <algorithm>
+#include <cmath>
 #include <boost/filesystem.hpp>
 
 #include "IDBPolicy.h"
@@ -31,6 +33,60 @@ using namespace logging;
 
 namespace statistics
 {
+void HLLSketch::add(uint64_t value)
+{
+  const uint64_t hash = utils::fmix(value);
+  const uint32_t index = hash >> (64 - precision);
+  const uint64_t rest = hash << precision;
+  const uint8_t rank = rest ? __builtin_clzll(rest) + 1 : 64 - precision + 1;
+  if (registers[index] < rank)
+    registers[index] = rank;
+}
+
+void HLLSketch::merge(const HLLSketch& other)
+{
+  for (uint32_t i = 0; i < numRegisters; ++i)
+    registers[i] = std::max(registers[i], other.registers[i]);
+}
+
+uint64_t HLLSketch::estimate() const
+{
+  const double m = numRegisters;
+  double sum = 0;
+  uint32_t zeros = 0;
+  for (const auto reg : registers)
+  {
+    sum += std::ldexp(1.0, -reg);
+    if (!reg)
+      ++zeros;
+  }
+
+  double estimate = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+  // Small range correction.
+  if (estimate <= 2.5 * m && zeros)
+    estimate = m * std::log(m / zeros);
+
+  return static_cast<uint64_t>(estimate + 0.5);
+}
+
+double ColumnHistogram::lessOrEqualFraction(int64_t value) const
+{
+  if (bounds.empty() || value < minValue)
+    return 0.0;
+
+  // Buckets which lie completely below or at the `value`.
+  const auto it = std::upper_bound(bounds.begin(), bounds.end(), value);
+  const size_t fullBuckets = it - bounds.begin();
+  if (fullBuckets == bounds.size())
+    return 1.0;
+
+  // Assume uniform distribution inside the bucket.
+  const double lo = fullBuckets ? bounds[fullBuckets - 1] : minValue;
+  const double hi = *it;
+  const double inBucket = hi > lo ? (static_cast<double>(value) - lo) / (hi - lo) : 1.0;
+  return (fullBuckets + inBucket) / bounds.size();
+}
+
 StatisticsManager* StatisticsManager::instance()
 {
   static StatisticsManager* sm = new StatisticsManager();
@@ -61,6 +117,13 @@ void StatisticsManager::collectSample(const rowgroup::RowGroup& rowGroup)
   // Generate a uniform distribution.
   for (uint32_t i = 0; i < rowCount; ++i)
   {
+    // NDV statistics see every row.
+    for (uint32_t j = 0; j < columnCount; ++j)
+    {
+      if (!r.isNullValue(j))
+        sketches[oids[j]].add(r.getIntField(j));
+    }
+
     if (currentSampleSize < maxSampleSize)
     {
       for (uint32_t j = 0; j < columnCount; ++j)
@@ -120,16 +183,40 @@ void StatisticsManager::analyzeSample(bool traceOn)
                 return a.second > b.second;
               });
 
-    // 200 buckets as Microsoft does.
-    const auto mcvSize = std::min(columnMCV.size(), static_cast<uint64_t>(200));
+    const auto mcvSize = std::min(columnMCV.size(), static_cast<uint64_t>(maxBuckets));
     mcv[oid] = std::unordered_map<uint64_t, uint32_t>(mcvList.begin(), mcvList.begin() + mcvSize);
+
+    // HISTOGRAM statistics.
+    if (currentSampleSize)
+    {
+      std::vector<int64_t> sortedSample(sample.begin(), sample.begin() + currentSampleSize);
+      std::sort(sortedSample.begin(), sortedSample.end());
+      const uint32_t bucketCount = std::min(currentSampleSize, maxBuckets);
+
+      ColumnHistogram histogram;
+      histogram.sampleSize = currentSampleSize;
+      histogram.minValue = sortedSample.front();
+      histogram.bounds.reserve(bucketCount);
+      for (uint32_t i = 1; i <= bucketCount; ++i)
+        histogram.bounds.push_back(sortedSample[(uint64_t)i * currentSampleSize / bucketCount - 1]);
+      histograms[oid] = std::move(histogram);
+    }
+
+    // NDV statistics.
+    auto sketchIt = sketches.find(oid);
+    if (sketchIt != sketches.end())
+      distinctCounts[oid] = sketchIt->second.estimate();
   }
 
+  // New statistics are always in the current format.
+  version = currentVersion;
+
   if (traceOn)
     output();
 
   // Clear sample.
   columnGroups.clear();
+  sketches.clear();
   currentSampleSize = 0;
 }
 
@@ -155,6 +242,21 @@ void StatisticsManager::output()
       std::cout << value << ": " << count << ", ";
     cout << "]" << endl;
   }
+
+  std::cout << "Statistics type [HISTOGRAM]: " << std::endl;
+  for (const auto& [oid, histogram] : histograms)
+  {
+    std::cout << "[OID: " << oid << ", sample: " << histogram.sampleSize << std::endl;
+    std::cout << histogram.minValue;
+    for (const auto bound : histogram.bounds)
+      std::cout << ", " << bound;
+    cout << "]" << endl;
+  }
+
+  std::cout << "Statistics type [NDV]: " << std::endl;
+  for (const auto& [oid, distinctCount] : distinctCounts)
+    std::cout << "[OID: " << oid << ": " << distinctCount << "] ";
+  cout << endl;
 }
 
 // Someday it will be a virtual method, based on statistics type we processing.
@@ -173,6 +275,16 @@ std::unique_ptr<char[]> StatisticsManager::convertStatsToDataStream(uint64_t& da
         (sizeof(uint32_t) + sizeof(uint32_t) + ((sizeof(uint64_t) + sizeof(uint32_t)) * mcvColumn.size()));
   }
 
+  // Count the size of the histograms.
+  // count, [[oid, sample size, min value, bounds size, bounds], ... ]
+  dataStreamSize += sizeof(uint64_t);
+  for (const auto& [oid, histogram] : histograms)
+    dataStreamSize += sizeof(uint32_t) + sizeof(uint32_t) + sizeof(int64_t) + sizeof(uint32_t) +
+                      sizeof(int64_t) * histogram.bounds.size();
+
+  // count, [[oid, distinct count], ... ]
+  dataStreamSize += sizeof(uint64_t) + distinctCounts.size() * (sizeof(uint32_t) + sizeof(uint64_t));
+
   // Allocate memory for data stream.
   std::unique_ptr<char[]> dataStreamSmartPtr(new char[dataStreamSize]);
   auto* dataStream = dataStreamSmartPtr.get();
@@ -217,6 +329,37 @@ std::unique_ptr<char[]> StatisticsManager::convertStatsToDataStream(uint64_t& da
       offset += sizeof(uint32_t);
     }
   }
+
+  // For each [oid, sample size, min value, bounds size, bounds].
+  uint64_t histogramCount = histograms.size();
+  std::memcpy(&dataStream[offset], reinterpret_cast<char*>(&histogramCount), sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+  for (const auto& [oid, histogram] : histograms)
+  {
+    std::memcpy(&dataStream[offset], &oid, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    std::memcpy(&dataStream[offset], &histogram.sampleSize, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    std::memcpy(&dataStream[offset], &histogram.minValue, sizeof(int64_t));
+    offset += sizeof(int64_t);
+    uint32_t size = histogram.bounds.size();
+    std::memcpy(&dataStream[offset], reinterpret_cast<char*>(&size), sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    std::memcpy(&dataStream[offset], histogram.bounds.data(), sizeof(int64_t) * size);
+    offset += sizeof(int64_t) * size;
+  }
+
+  // For each [oid, distinct count].
+  uint64_t ndvCount = distinctCounts.size();
+  std::memcpy(&dataStream[offset], reinterpret_cast<char*>(&ndvCount), sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+  for (const auto& [oid, distinctCount] : distinctCounts)
+  {
+    std::memcpy(&dataStream[offset], &oid, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    std::memcpy(&dataStream[offset], &distinctCount, sizeof(uint64_t));
+    offset += sizeof(uint64_t);
+  }
   return dataStreamSmartPtr;
 }
 
@@ -262,6 +405,45 @@ void StatisticsManager::convertStatsFromDataStream(std::unique_ptr<char[]> dataS
     }
     mcv[oid] = std::move(columnMCV);
   }
+
+  // Version 1 files end here.
+  if (version < 2)
+    return;
+
+  uint64_t histogramCount = 0;
+  std::memcpy(reinterpret_cast<char*>(&histogramCount), &dataStream[offset], sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+  for (uint64_t i = 0; i < histogramCount; ++i)
+  {
+    uint32_t oid, size;
+    ColumnHistogram histogram;
+    std::memcpy(reinterpret_cast<char*>(&oid), &dataStream[offset], sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    std::memcpy(reinterpret_cast<char*>(&histogram.sampleSize), &dataStream[offset], sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    std::memcpy(reinterpret_cast<char*>(&histogram.minValue), &dataStream[offset], sizeof(int64_t));
+    offset += sizeof(int64_t);
+    std::memcpy(reinterpret_cast<char*>(&size), &dataStream[offset], sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    histogram.bounds.resize(size);
+    std::memcpy(histogram.bounds.data(), &dataStream[offset], sizeof(int64_t) * size);
+    offset += sizeof(int64_t) * size;
+    histograms[oid] = std::move(histogram);
+  }
+
+  uint64_t ndvCount = 0;
+  std::memcpy(reinterpret_cast<char*>(&ndvCount), &dataStream[offset], sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+  for (uint64_t i = 0; i < ndvCount; ++i)
+  {
+    uint32_t oid;
+    uint64_t distinctCount;
+    std::memcpy(reinterpret_cast<char*>(&oid), &dataStream[offset], sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    std::memcpy(reinterpret_cast<char*>(&distinctCount), &dataStream[offset], sizeof(uint64_t));
+    offset += sizeof(uint64_t);
+    distinctCounts[oid] = distinctCount;
+  }
 }
 
 void StatisticsManager::saveToFile()
@@ -409,6 +591,26 @@ void StatisticsManager::serialize(messageqcpp::ByteStream& bs)
       bs << mcvPair.second;
     }
   }
+
+  // HISTOGRAM
+  bs << static_cast<uint64_t>(histograms.size());
+  for (const auto& [oid, histogram] : histograms)
+  {
+    bs << oid;
+    bs << histogram.sampleSize;
+    bs << histogram.minValue;
+    bs << static_cast<uint32_t>(histogram.bounds.size());
+    for (const auto bound : histogram.bounds)
+      bs << bound;
+  }
+
+  // NDV
+  bs << static_cast<uint64_t>(distinctCounts.size());
+  for (const auto& [oid, distinctCount] : distinctCounts)
+  {
+    bs << oid;
+    bs << distinctCount;
+  }
 }
 
 void StatisticsManager::unserialize(messageqcpp::ByteStream& bs)
@@ -446,6 +648,34 @@ void StatisticsManager::unserialize(messageqcpp::ByteStream& bs)
 
     mcv[oid] = std::move(mcvColumn);
   }
+
+  // HISTOGRAM
+  bs >> count;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    uint32_t oid, size;
+    ColumnHistogram histogram;
+    bs >> oid;
+    bs >> histogram.sampleSize;
+    bs >> histogram.minValue;
+    bs >> size;
+    histogram.bounds.resize(size);
+    for (uint32_t j = 0; j < size; ++j)
+      bs >> histogram.bounds[j];
+
+    histograms[oid] = std::move(histogram);
+  }
+
+  // NDV
+  bs >> count;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    uint32_t oid;
+    uint64_t distinctCount;
+    bs >> oid;
+    bs >> distinctCount;
+    distinctCounts[oid] = distinctCount;
+  }
 }
 
 bool StatisticsManager::hasKey(uint32_t oid)
@@ -458,6 +688,29 @@ KeyType StatisticsManager::getKeyType(uint32_t oid)
   return keyTypes[oid];
 }
 
+uint64_t StatisticsManager::getDistinctCount(uint32_t oid)
+{
+  std::lock_guard<std::mutex> lock(mut);
+  auto it = distinctCounts.find(oid);
+  return it != distinctCounts.end() ? it->second : 0;
+}
+
+bool StatisticsManager::getColumnStatistics(uint32_t oid, ColumnStatistics& columnStatistics)
+{
+  std::lock_guard<std::mutex> lock(mut);
+  auto histogramIt = histograms.find(oid);
+  if (histogramIt == histograms.end() || !histogramIt->second.sampleSize)
+    return false;
+
+  columnStatistics.histogram = histogramIt->second;
+  auto ndvIt = distinctCounts.find(oid);
+  columnStatistics.distinctCount = ndvIt != distinctCounts.end() ? ndvIt->second : 0;
+  auto mcvIt = mcv.find(oid);
+  if (mcvIt != mcv.end())
+    columnStatistics.mcv = mcvIt->second;
+  return true;
+}
+
 StatisticsDistributor* StatisticsDistributor::instance()
 {
   static StatisticsDistributor* sd = new StatisticsDistributor();
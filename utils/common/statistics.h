@@ -53,7 +53,11 @@ enum class StatisticsType : uint32_t
   // A special statistics type, specifies whether a column a primary key or foreign key.
   PK_FK,
   // Most common values.
-  MCV
+  MCV,
+  // Equi-depth histogram built from the sample.
+  HISTOGRAM,
+  // Number of distinct values, estimated with HyperLogLog over every analyzed row.
+  NDV
 };
 
 // Represetns a header for the statistics file.
@@ -66,10 +70,53 @@ struct StatisticsFileHeader
   uint8_t offset[1024];
 };
 
+// HyperLogLog sketch estimating the number of distinct values in a column.
+// Sketches built over different parts of the same column can be merged.
+class HLLSketch
+{
+ public:
+  HLLSketch() : registers(numRegisters, 0)
+  {
+  }
+  void add(uint64_t value);
+  void merge(const HLLSketch& other);
+  uint64_t estimate() const;
+
+ private:
+  // 4096 registers, ~1.6% standard error.
+  static constexpr uint32_t precision = 12;
+  static constexpr uint32_t numRegisters = 1 << precision;
+  std::vector<uint8_t> registers;
+};
+
+// Equi-depth histogram: every bucket holds the same number of sampled rows,
+// `bounds[i]` is the upper bound of the i-th bucket, `minValue` is the lower bound of the first one.
+struct ColumnHistogram
+{
+  uint32_t sampleSize{0};
+  int64_t minValue{0};
+  std::vector<int64_t> bounds;
+
+  // Returns the estimated fraction of the rows with the value less or equal to the given `value`.
+  double lessOrEqualFraction(int64_t value) const;
+};
+
+// Statistics collected for a single column, used by the row estimator.
+struct ColumnStatistics
+{
+  ColumnHistogram histogram;
+  // Estimated number of distinct values, 0 if unknown.
+  uint64_t distinctCount{0};
+  std::unordered_map<uint64_t, uint32_t> mcv;
+};
+
 using ColumnsCache = std::unordered_map<uint32_t, std::unordered_set<uint64_t>>;
 using ColumnGroup = std::unordered_map<uint32_t, std::vector<uint64_t>>;
 using KeyTypes = std::unordered_map<uint32_t, KeyType>;
 using MCVList = std::unordered_map<uint32_t, std::unordered_map<uint64_t, uint32_t>>;
+using Histograms = std::unordered_map<uint32_t, ColumnHistogram>;
+using DistinctCounts = std::unordered_map<uint32_t, uint64_t>;
+using Sketches = std::unordered_map<uint32_t, HLLSketch>;
 
 // This class is responsible for processing and storing statistics.
 // On each `analyze table` iteration it increases an epoch and stores
@@ -103,9 +150,13 @@ class StatisticsManager
   bool hasKey(uint32_t oid);
   // Returns a KeyType for the given `oid`.
   KeyType getKeyType(uint32_t oid);
+  // Returns the estimated number of distinct values for the given `oid`, 0 if unknown.
+  uint64_t getDistinctCount(uint32_t oid);
+  // Copies histogram, NDV and MCV statistics for the given `oid`, returns false if there is no histogram.
+  bool getColumnStatistics(uint32_t oid, ColumnStatistics& columnStatistics);
 
  private:
-  StatisticsManager() : currentSampleSize(0), epoch(0), version(1)
+  StatisticsManager() : currentSampleSize(0), epoch(0), version(currentVersion)
   {
     // Initialize plugins.
     IDBPolicy::configIDBPolicy();
@@ -127,9 +178,19 @@ class StatisticsManager
   KeyTypes keyTypes;
   // Internal data for MCV list [OID, list[value, count]]
   MCVList mcv;
+  // Internal data for histograms [OID, histogram].
+  Histograms histograms;
+  // Internal data for NDV statistics [OID, distinct count].
+  DistinctCounts distinctCounts;
+  // Sketches fed with every analyzed row, not only the sampled ones [OID, sketch].
+  Sketches sketches;
 
   // TODO: Think about sample size.
   const uint32_t maxSampleSize = 64000;
+  // 200 buckets as Microsoft does.
+  const uint32_t maxBuckets = 200;
+  // Version 2 adds histograms and NDV.
+  static constexpr uint32_t currentVersion = 2;
   uint32_t currentSampleSize;
   uint32_t epoch;
   uint32_t version;
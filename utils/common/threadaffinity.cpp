@@ -0,0 +1,54 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+#include <pthread.h>
+#include <sched.h>
+#include "threadaffinity.h"
+
+namespace utils
+{
+bool setThreadAffinity(const CpuListT& cpus)
+{
+  if (cpus.empty())
+    return false;
+
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (auto cpu : cpus)
+  {
+    if (cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &cpuSet);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+}
+
+CpuListT getThreadAffinity()
+{
+  CpuListT cpus;
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0)
+    return cpus;
+
+  for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+  {
+    if (CPU_ISSET(cpu, &cpuSet))
+      cpus.push_back(cpu);
+  }
+  return cpus;
+}
+}  // namespace utils
@@ -0,0 +1,31 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace utils
+{
+using CpuListT = std::vector<uint32_t>;
+
+// Binds the calling thread to the CPUs. Threads it creates afterwards inherit the binding.
+// Returns false if the CPU list is empty or the kernel refused the mask.
+bool setThreadAffinity(const CpuListT& cpus);
+// Returns the CPUs the calling thread is allowed to run on.
+CpuListT getThreadAffinity();
+}  // namespace utils
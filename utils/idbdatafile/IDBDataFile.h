@@ -191,6 +191,17 @@ class IDBDataFile
    */
   virtual int fallocate(int mode, off64_t offset, off64_t length) = 0;
 
+  /**
+   * The prefetch() method is a hint that length bytes starting at
+   * offset will be read soon.  File types that can fetch data ahead
+   * of use (currently StorageManager files) start doing so; the others
+   * ignore it.  Returns 0 on success, -1 on error.
+   */
+  virtual int prefetch(off64_t offset, off64_t length)
+  {
+    return 0;
+  }
+
   int colWidth()
   {
     return m_fColWidth;
@@ -0,0 +1,258 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "hasher.h"
+
+namespace joiner
+{
+/* CompactHashTable is the table behind one hash partition of a UM join on integer keys.
+
+   It's an open-addressed, linear-probing table.  The first row of every key lives in the slot itself, so
+   a probe for a unique key usually touches one cache line.  The rows of a repeated key are chained through
+   a flat vector.  The interface is the subset of unordered_multimap that TupleJoiner uses.
+*/
+class CompactHashTable
+{
+  struct Slot
+  {
+    int64_t key;
+    uint8_t* row;  // NULL means the slot is empty
+    uint32_t dups;  // 1-based index of the first repeated row in fDups, 0 if none
+  };
+
+  struct Dup
+  {
+    uint8_t* row;
+    uint32_t next;  // 1-based, 0 ends the chain
+  };
+
+  static const size_t npos = (size_t)-1;
+
+ public:
+  typedef std::pair<int64_t, uint8_t*> value_type;
+
+  /* Walks either all rows of the table or the rows of one key.  A position is a slot and a place
+     in its chain, 0 being the row stored in the slot. */
+  class iterator
+  {
+   public:
+    iterator() : fTable(NULL), fSlot(npos), fDup(0), fAllRows(false)
+    {
+    }
+    const value_type& operator*() const
+    {
+      return fValue;
+    }
+    const value_type* operator->() const
+    {
+      return &fValue;
+    }
+    iterator& operator++()
+    {
+      const Slot& slot = fTable->fSlots[fSlot];
+      fDup = (fDup == 0 ? slot.dups : fTable->fDups[fDup - 1].next);
+
+      if (fDup == 0)
+      {
+        if (fAllRows)
+          fSlot = fTable->nextOccupied(fSlot + 1);
+        else
+          fSlot = npos;
+      }
+
+      load();
+      return *this;
+    }
+    bool operator==(const iterator& it) const
+    {
+      return fSlot == it.fSlot && fDup == it.fDup;
+    }
+    bool operator!=(const iterator& it) const
+    {
+      return !(*this == it);
+    }
+
+   private:
+    friend class CompactHashTable;
+    iterator(const CompactHashTable* table, size_t slot, bool allRows)
+     : fTable(table), fSlot(slot), fDup(0), fAllRows(allRows)
+    {
+      load();
+    }
+    void load()
+    {
+      if (fSlot == npos)
+        return;
+
+      const Slot& slot = fTable->fSlots[fSlot];
+      fValue.first = slot.key;
+      fValue.second = (fDup == 0 ? slot.row : fTable->fDups[fDup - 1].row);
+    }
+
+    const CompactHashTable* fTable;
+    size_t fSlot;
+    uint32_t fDup;
+    bool fAllRows;
+    value_type fValue;
+  };
+
+  CompactHashTable() : fMask(0), fUsedSlots(0), fSize(0)
+  {
+  }
+
+  void insert(const value_type& v)
+  {
+    if ((fUsedSlots + 1) * 10 > fSlots.size() * 7)
+      grow(fSlots.empty() ? 16 : fSlots.size() * 2);
+
+    Slot& slot = findSlot(v.first);
+
+    if (slot.row == NULL)
+    {
+      slot.key = v.first;
+      slot.row = v.second;
+      slot.dups = 0;
+      fUsedSlots++;
+    }
+    else
+    {
+      fDups.push_back(Dup{v.second, slot.dups});
+      slot.dups = fDups.size();
+    }
+
+    fSize++;
+  }
+
+  template <typename It>
+  void insert(It first, It last)
+  {
+    // sized for the case where every key is new
+    size_t needed = fSlots.empty() ? 16 : fSlots.size();
+
+    while ((fUsedSlots + (last - first)) * 10 > needed * 7)
+      needed *= 2;
+
+    if (needed != fSlots.size())
+      grow(needed);
+
+    for (; first != last; ++first)
+      insert(value_type(first->first, first->second));
+  }
+
+  std::pair<iterator, iterator> equal_range(int64_t key) const
+  {
+    if (fSlots.empty())
+      return std::make_pair(end(), end());
+
+    const Slot& slot = findSlot(key);
+
+    if (slot.row == NULL)
+      return std::make_pair(end(), end());
+
+    return std::make_pair(iterator(this, &slot - &fSlots[0], false), end());
+  }
+
+  iterator find(int64_t key) const
+  {
+    return equal_range(key).first;
+  }
+
+  // Issued a few rows ahead of the probe for `key`.
+  void prefetch(int64_t key) const
+  {
+    if (!fSlots.empty())
+      __builtin_prefetch(&fSlots[homeSlot(key)]);
+  }
+
+  iterator begin() const
+  {
+    return iterator(this, nextOccupied(0), true);
+  }
+  iterator end() const
+  {
+    return iterator();
+  }
+  size_t size() const
+  {
+    return fSize;
+  }
+  bool empty() const
+  {
+    return fSize == 0;
+  }
+  uint64_t getMemUsage() const
+  {
+    return fSlots.capacity() * sizeof(Slot) + fDups.capacity() * sizeof(Dup);
+  }
+
+ private:
+  size_t homeSlot(int64_t key) const
+  {
+    // The partition was picked with Hasher_r, use a different hash here.
+    return utils::fmix((uint64_t)key) & fMask;
+  }
+
+  Slot& findSlot(int64_t key)
+  {
+    size_t i = homeSlot(key);
+
+    while (fSlots[i].row != NULL && fSlots[i].key != key)
+      i = (i + 1) & fMask;
+
+    return fSlots[i];
+  }
+
+  const Slot& findSlot(int64_t key) const
+  {
+    return const_cast<CompactHashTable*>(this)->findSlot(key);
+  }
+
+  size_t nextOccupied(size_t i) const
+  {
+    for (; i < fSlots.size(); i++)
+      if (fSlots[i].row != NULL)
+        return i;
+
+    return npos;
+  }
+
+  void grow(size_t newSize)
+  {
+    std::vector<Slot> old(newSize, Slot{0, NULL, 0});
+    old.swap(fSlots);
+    fMask = newSize - 1;
+
+    for (const Slot& s : old)
+    {
+      if (s.row != NULL)
+        findSlot(s.key) = s;
+    }
+  }
+
+  std::vector<Slot> fSlots;
+  std::vector<Dup> fDups;
+  size_t fMask;
+  size_t fUsedSlots;
+  size_t fSize;
+};
+
+}  // namespace joiner
@@ -81,14 +81,10 @@ TupleJoiner::TupleJoiner(const rowgroup::RowGroup& smallInput, const rowgroup::R
   }
   else
   {
+    // CompactHashTable keeps its own memory and counts it, it has no pool
     h.reset(new boost::scoped_ptr<hash_t>[bucketCount]);
-    _pool.reset(new boost::shared_ptr<PoolAllocator>[bucketCount]);
     for (i = 0; i < bucketCount; i++)
-    {
-      STLPoolAllocator<pair<const int64_t, uint8_t*>> alloc;
-      _pool[i] = alloc.getPoolAllocator();
-      h[i].reset(new hash_t(10, hasher(), hash_t::key_equal(), alloc));
-    }
+      h[i].reset(new hash_t());
   }
 
   smallRG.initRow(&smallNullRow);
@@ -267,6 +263,7 @@ template <typename buckets_t, typename hash_table_t>
 void TupleJoiner::bucketsToTables(buckets_t* buckets, hash_table_t* tables)
 {
   uint i;
+  bool distinctKeys = existenceJoin();
 
   bool done = false, wasProductive;
   while (!done)
@@ -283,7 +280,13 @@ void TupleJoiner::bucketsToTables(buckets_t* buckets, hash_table_t* tables)
         done = false;
         continue;
       }
-      tables[i]->insert(buckets[i].begin(), buckets[i].end());
+      if (distinctKeys)
+      {
+        for (auto& element : buckets[i])
+          insertElement(tables[i].get(), element);
+      }
+      else
+        tables[i]->insert(buckets[i].begin(), buckets[i].end());
       m_bucketLocks[i].unlock();
       wasProductive = true;
       buckets[i].clear();
@@ -293,6 +296,14 @@ void TupleJoiner::bucketsToTables(buckets_t* buckets, hash_table_t* tables)
   }
 }
 
+template <typename hash_table_t, typename element_t>
+void TupleJoiner::insertElement(hash_table_t* table, const element_t& element)
+{
+  // the rest of the rows of a key can't change the result of an existence join
+  if (!existenceJoin() || table->find(element.first) == table->end())
+    table->insert(element);
+}
+
 void TupleJoiner::um_insertTypeless(uint threadID, uint rowCount, Row& r)
 {
   utils::VLArray<TypelessData> td(rowCount);
@@ -429,7 +440,7 @@ void TupleJoiner::insert(Row& r, bool zeroTheRid)
       if (td.len > 0)
       {
         uint bucket = bucketPicker((char*)td.data, td.len, bpSeed) & bucketMask;
-        ht[bucket]->insert(pair<TypelessData, Row::Pointer>(td, r.getPointer()));
+        insertElement(ht[bucket].get(), pair<TypelessData, Row::Pointer>(td, r.getPointer()));
       }
     }
     else if (r.getColType(smallKeyColumns[0]) == execplan::CalpontSystemCatalog::LONGDOUBLE)
@@ -438,9 +449,10 @@ void TupleJoiner::insert(Row& r, bool zeroTheRid)
       uint bucket = bucketPicker((char*)&smallKey, 10, bpSeed) &
                     bucketMask;  // change if we decide to support windows again
       if (UNLIKELY(smallKey == joblist::LONGDOUBLENULL))
-        ld[bucket]->insert(pair<long double, Row::Pointer>(joblist::LONGDOUBLENULL, r.getPointer()));
+        insertElement(ld[bucket].get(),
+                      pair<long double, Row::Pointer>(joblist::LONGDOUBLENULL, r.getPointer()));
       else
-        ld[bucket]->insert(pair<long double, Row::Pointer>(smallKey, r.getPointer()));
+        insertElement(ld[bucket].get(), pair<long double, Row::Pointer>(smallKey, r.getPointer()));
     }
     else if (!smallRG.usesStringTable())
     {
@@ -452,9 +464,10 @@ void TupleJoiner::insert(Row& r, bool zeroTheRid)
         smallKey = (int64_t)r.getUintField(smallKeyColumns[0]);
       uint bucket = bucketPicker((char*)&smallKey, sizeof(smallKey), bpSeed) & bucketMask;
       if (UNLIKELY(smallKey == nullValueForJoinColumn))
-        h[bucket]->insert(pair<int64_t, uint8_t*>(getJoinNullValue(), r.getData()));
+        insertElement(h[bucket].get(), pair<int64_t, uint8_t*>(getJoinNullValue(), r.getData()));
       else
-        h[bucket]->insert(pair<int64_t, uint8_t*>(smallKey, r.getData()));  // Normal path for integers
+        // Normal path for integers
+        insertElement(h[bucket].get(), pair<int64_t, uint8_t*>(smallKey, r.getData()));
     }
     else
     {
@@ -466,9 +479,9 @@ void TupleJoiner::insert(Row& r, bool zeroTheRid)
         smallKey = (int64_t)r.getUintField(smallKeyColumns[0]);
       uint bucket = bucketPicker((char*)&smallKey, sizeof(smallKey), bpSeed) & bucketMask;
       if (UNLIKELY(smallKey == nullValueForJoinColumn))
-        sth[bucket]->insert(pair<int64_t, Row::Pointer>(getJoinNullValue(), r.getPointer()));
+        insertElement(sth[bucket].get(), pair<int64_t, Row::Pointer>(getJoinNullValue(), r.getPointer()));
       else
-        sth[bucket]->insert(pair<int64_t, Row::Pointer>(smallKey, r.getPointer()));
+        insertElement(sth[bucket].get(), pair<int64_t, Row::Pointer>(smallKey, r.getPointer()));
     }
   }
   else
@@ -480,6 +493,7 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
 {
   uint32_t i;
   bool isNull = hasNullJoinColumn(largeSideRow);
+  bool firstOnly = existenceJoin();
   matches->clear();
 
   if (inPM())
@@ -514,7 +528,11 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
         return;
 
       for (; range.first != range.second; ++range.first)
+      {
         matches->push_back(range.first->second);
+        if (firstOnly)
+          break;
+      }
     }
     else if (largeSideRow.getColType(largeKeyColumns[0]) == CalpontSystemCatalog::LONGDOUBLE && ld)
     {
@@ -533,6 +551,8 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
       for (; range.first != range.second; ++range.first)
       {
         matches->push_back(range.first->second);
+        if (firstOnly)
+          break;
       }
     }
     else if (!smallRG.usesStringTable())
@@ -563,7 +583,11 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
           return;
 
         for (; range.first != range.second; ++range.first)
+        {
           matches->push_back(range.first->second);
+          if (firstOnly)
+            break;
+        }
       }
       else
       {
@@ -574,7 +598,11 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
           return;
 
         for (; range.first != range.second; ++range.first)
+        {
           matches->emplace_back(rowgroup::Row::Pointer(range.first->second));
+          if (firstOnly)
+            break;
+        }
       }
     }
     else
@@ -587,7 +615,11 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
         return;
 
       for (; range.first != range.second; ++range.first)
+      {
         matches->push_back(range.first->second);
+        if (firstOnly)
+          break;
+      }
     }
   }
 
@@ -597,7 +629,9 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
     matches->push_back(smallNullRow.getPointer());
   }
 
-  if (UNLIKELY(inUM() && (joinType & MATCHNULLS) && !isNull && !typelessJoin))
+  // an existence join that matched already doesn't need the NULL keys
+  if (UNLIKELY(inUM() && (joinType & MATCHNULLS) && !isNull && !typelessJoin &&
+               !(firstOnly && !matches->empty())))
   {
     if (largeRG.getColType(largeKeyColumns[0]) == CalpontSystemCatalog::LONGDOUBLE)
     {
@@ -606,7 +640,11 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
       pair<ldIterator, ldIterator> range = ld[bucket]->equal_range(joblist::LONGDOUBLENULL);
 
       for (; range.first != range.second; ++range.first)
+      {
         matches->push_back(range.first->second);
+        if (firstOnly)
+          break;
+      }
     }
     else if (!largeRG.usesStringTable())
     {
@@ -615,7 +653,11 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
       pair<iterator, iterator> range = h[bucket]->equal_range(nullVal);
 
       for (; range.first != range.second; ++range.first)
+      {
         matches->emplace_back(rowgroup::Row::Pointer(range.first->second));
+        if (firstOnly)
+          break;
+      }
     }
     else
     {
@@ -624,11 +666,16 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
       pair<sthash_t::iterator, sthash_t::iterator> range = sth[bucket]->equal_range(nullVal);
 
       for (; range.first != range.second; ++range.first)
+      {
         matches->push_back(range.first->second);
+        if (firstOnly)
+          break;
+      }
     }
   }
 
   /* Bug 3524.  For 'not in' queries this matches everything.
+     An existence join only needs to know the small side isn't empty.
    */
   if (UNLIKELY(inUM() && isNull && antiJoin() && (joinType & MATCHNULLS)))
   {
@@ -638,24 +685,24 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
       {
         ldIterator it;
 
-        for (uint i = 0; i < bucketCount; i++)
-          for (it = ld[i]->begin(); it != ld[i]->end(); ++it)
+        for (uint i = 0; i < bucketCount && !(firstOnly && !matches->empty()); i++)
+          for (it = ld[i]->begin(); it != ld[i]->end() && !(firstOnly && !matches->empty()); ++it)
             matches->push_back(it->second);
       }
       else if (!smallRG.usesStringTable())
       {
         iterator it;
 
-        for (uint i = 0; i < bucketCount; i++)
-          for (it = h[i]->begin(); it != h[i]->end(); ++it)
+        for (uint i = 0; i < bucketCount && !(firstOnly && !matches->empty()); i++)
+          for (it = h[i]->begin(); it != h[i]->end() && !(firstOnly && !matches->empty()); ++it)
             matches->emplace_back(rowgroup::Row::Pointer(it->second));
       }
       else
       {
         sthash_t::iterator it;
 
-        for (uint i = 0; i < bucketCount; i++)
-          for (it = sth[i]->begin(); it != sth[i]->end(); ++it)
+        for (uint i = 0; i < bucketCount && !(firstOnly && !matches->empty()); i++)
+          for (it = sth[i]->begin(); it != sth[i]->end() && !(firstOnly && !matches->empty()); ++it)
             matches->push_back(it->second);
       }
     }
@@ -663,13 +710,33 @@ void TupleJoiner::match(rowgroup::Row& largeSideRow, uint32_t largeRowIndex, uin
     {
       thIterator it;
 
-      for (uint i = 0; i < bucketCount; i++)
-        for (it = ht[i]->begin(); it != ht[i]->end(); ++it)
+      for (uint i = 0; i < bucketCount && !(firstOnly && !matches->empty()); i++)
+        for (it = ht[i]->begin(); it != ht[i]->end() && !(firstOnly && !matches->empty()); ++it)
           matches->push_back(it->second);
     }
   }
 }
 
+void TupleJoiner::prefetch(const rowgroup::Row& largeSideRow) const
+{
+  // mirrors the key computation in match()
+  uint32_t colIndex = largeKeyColumns[0];
+  int64_t largeKey;
+
+  if (largeSideRow.isNullValue(colIndex))
+    return;
+
+  if (largeSideRow.getColType(colIndex) == CalpontSystemCatalog::LONGDOUBLE)
+    largeKey = (int64_t)largeSideRow.getLongDoubleField(colIndex);
+  else if (largeSideRow.isUnsigned(colIndex))
+    largeKey = (int64_t)largeSideRow.getUintField(colIndex);
+  else
+    largeKey = largeSideRow.getIntField(colIndex);
+
+  uint bucket = bucketPicker((char*)&largeKey, sizeof(largeKey), bpSeed) & bucketMask;
+  h[bucket]->prefetch(largeKey);
+}
+
 using unordered_set_int128 = std::unordered_set<int128_t, utils::Hash128, utils::Equal128>;
 
 void TupleJoiner::doneInserting()
@@ -1074,8 +1141,12 @@ uint64_t TupleJoiner::getMemUsage() const
   else if (inUM())
   {
     size_t ret = 0;
-    for (uint i = 0; i < bucketCount; i++)
-      ret += _pool[i]->getMemUsage();
+    if (_pool)
+      for (uint i = 0; i < bucketCount; i++)
+        ret += _pool[i]->getMemUsage();
+    if (h)
+      for (uint i = 0; i < bucketCount; i++)
+        ret += h[i]->getMemUsage();
     return ret;
   }
   else
@@ -1791,7 +1862,6 @@ void TupleJoiner::setTableName(const string& tname)
 
 void TupleJoiner::clearData()
 {
-  _pool.reset(new boost::shared_ptr<utils::PoolAllocator>[bucketCount]);
   if (typelessJoin)
     ht.reset(new boost::scoped_ptr<typelesshash_t>[bucketCount]);
   else if (smallRG.getColTypes()[smallKeyColumns[0]] == CalpontSystemCatalog::LONGDOUBLE)
@@ -1801,10 +1871,17 @@ void TupleJoiner::clearData()
   else
     h.reset(new boost::scoped_ptr<hash_t>[bucketCount]);
 
+  // CompactHashTable has no pool
+  if (h)
+    _pool.reset();
+  else
+    _pool.reset(new boost::shared_ptr<utils::PoolAllocator>[bucketCount]);
+
   for (uint i = 0; i < bucketCount; i++)
   {
     STLPoolAllocator<pair<const TypelessData, Row::Pointer>> alloc;
-    _pool[i] = alloc.getPoolAllocator();
+    if (_pool)
+      _pool[i] = alloc.getPoolAllocator();
     if (typelessJoin)
       ht[i].reset(new typelesshash_t(10, hasher(), typelesshash_t::key_equal(), alloc));
     else if (smallRG.getColTypes()[smallKeyColumns[0]] == CalpontSystemCatalog::LONGDOUBLE)
@@ -1812,7 +1889,7 @@ void TupleJoiner::clearData()
     else if (smallRG.usesStringTable())
       sth[i].reset(new sthash_t(10, hasher(), sthash_t::key_equal(), alloc));
     else
-      h[i].reset(new hash_t(10, hasher(), hash_t::key_equal(), alloc));
+      h[i].reset(new hash_t());
   }
 
   std::vector<rowgroup::Row::Pointer> empty;
@@ -36,6 +36,7 @@
 #include "threadpool.h"
 #include "columnwidth.h"
 #include "mcs_string.h"
+#include "compacthashtable.h"
 
 namespace joiner
 {
@@ -297,6 +298,15 @@ class TupleJoiner
   /* For small outer joins, this is how matches are marked now. */
   void markMatches(uint32_t threadID, const std::vector<rowgroup::Row::Pointer>& matches);
 
+  /* On a UM join with a large small side, the caller hints the large-side rows it will match()
+      next so their hash table slots are in cache by then.
+  */
+  inline bool canPrefetch() const
+  {
+    return joinAlg == UM && h && size() > prefetchThreshold;
+  }
+  void prefetch(const rowgroup::Row& largeSideRow) const;
+
   /* Some accessors */
   inline bool inPM() const
   {
@@ -426,6 +436,13 @@ class TupleJoiner
   {
     return ((joinType & joblist::MATCHNULLS) != 0);
   }
+  /* A semi or anti join w/o a function expression only asks whether a large-side row has a match.
+     The UM tables keep one row per distinct key and match() returns at most one row. */
+  inline bool existenceJoin() const
+  {
+    return (joinType & (joblist::SEMI | joblist::ANTI)) &&
+           !(joinType & (joblist::SCALAR | joblist::WITHFCNEXP));
+  }
   inline bool hasFEFilter()
   {
     return fe.get();
@@ -464,9 +481,8 @@ class TupleJoiner
   void setConvertToDiskJoin();
 
  private:
-  typedef std::unordered_multimap<int64_t, uint8_t*, hasher, std::equal_to<int64_t>,
-                                  utils::STLPoolAllocator<std::pair<const int64_t, uint8_t*> > >
-      hash_t;
+  // The common case, integer keys with inline rows, uses flat tables instead of node based ones
+  typedef CompactHashTable hash_t;
   typedef std::unordered_multimap<int64_t, rowgroup::Row::Pointer, hasher, std::equal_to<int64_t>,
                                   utils::STLPoolAllocator<std::pair<const int64_t, rowgroup::Row::Pointer> > >
       sthash_t;
@@ -492,6 +508,8 @@ class TupleJoiner
   rowgroup::RGData smallNullMemory;
 
   boost::scoped_array<boost::scoped_ptr<hash_t> > h;  // used for UM joins on ints
+  // below this many rows the tables stay in cache and prefetching doesn't pay off
+  static const size_t prefetchThreshold = 1 << 16;
   boost::scoped_array<boost::scoped_ptr<sthash_t> >
       sth;  // used for UM join on ints where the backing table uses a string table
   boost::scoped_array<boost::scoped_ptr<ldhash_t> > ld;  // used for UM join on long double
@@ -560,6 +578,8 @@ class TupleJoiner
 
   template <typename buckets_t, typename hash_table_t>
   void bucketsToTables(buckets_t*, hash_table_t*);
+  template <typename hash_table_t, typename element_t>
+  void insertElement(hash_table_t*, const element_t&);
 
   bool _convertToDiskJoin;
 };
@@ -400,6 +400,16 @@ void RGData::serialize(ByteStream& bs, uint32_t amount) const
 }
 
 void RGData::deserialize(ByteStream& bs, uint32_t defAmount)
+{
+  deserialize(bs, defAmount, true);
+}
+
+void RGData::deserializeInPlace(ByteStream& bs)
+{
+  deserialize(bs, 0, false);
+}
+
+void RGData::deserialize(ByteStream& bs, uint32_t defAmount, bool copyRowData)
 {
   uint32_t amount, sig;
   uint8_t* buf;
@@ -426,9 +436,14 @@ void RGData::deserialize(ByteStream& bs, uint32_t defAmount)
       columnCount = colCountTemp;
       rowSize = rowSizeTemp;
     }
-    rowData.reset(new uint8_t[std::max(amount, defAmount)]);
     buf = bs.buf();
-    memcpy(rowData.get(), buf, amount);
+    if (copyRowData)
+    {
+      rowData.reset(new uint8_t[std::max(amount, defAmount)]);
+      memcpy(rowData.get(), buf, amount);
+    }
+    else
+      rowData = std::shared_ptr<uint8_t[]>(buf, [](uint8_t*) {});  // bs owns it
     bs.advance(amount);
     bs >> tmp8;
 
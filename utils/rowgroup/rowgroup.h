@@ -276,6 +276,9 @@ class RGData
   // inline data with a length field.  Once that's converted to string table format, that
   // option can go away.
   void deserialize(messageqcpp::ByteStream&, uint32_t amount = 0);  // returns the # of bytes read
+  // Like deserialize(), but the row data is left in the ByteStream's buffer rather than copied out of
+  // it.  The ByteStream has to outlive this RGData's use of the data and can't be modified meanwhile.
+  void deserializeInPlace(messageqcpp::ByteStream&);
 
   inline uint64_t getStringTableMemUsage();
   void clear();
@@ -326,6 +329,8 @@ class RGData
   std::shared_ptr<StringStore> strings;
   std::shared_ptr<UserDataStore> userDataStore;
 
+  void deserialize(messageqcpp::ByteStream&, uint32_t amount, bool copyRowData);
+
   // Need sig to support backward compat.  RGData can deserialize both forms.
   static const uint32_t RGDATA_SIG = 0xffffffff;  // won't happen for 'old' Rowgroup data
 
@@ -15,7 +15,9 @@
    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
    MA 02110-1301, USA. */
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <stdexcept>
 #include <unistd.h>
 #include <exception>
@@ -33,18 +35,61 @@ using namespace boost;
 
 namespace threadpool
 {
+// A thread that found nothing in its home shard and failed to steal re-checks the other shards
+// after this period. addJob() wakes idle threads directly so this is only a safety net.
+constexpr const std::chrono::milliseconds IdleStealPeriod{5};
+// A thread that failed to steal only b/c the victims were locked backs off for this period before it
+// retries. The victims likely still have jobs so it is much shorter than IdleStealPeriod.
+constexpr const std::chrono::microseconds BusyVictimBackoff{100};
+
 FairThreadPool::FairThreadPool(uint targetWeightPerRun, uint highThreads, uint midThreads, uint lowThreads,
-                               uint ID)
- : weightPerRun(targetWeightPerRun), id(ID), stopExtra_(false)
+                               uint ID, uint queueShards, uint numaNodes, const NumaNodeCpusT& numaNodeCpus)
+ : weightPerRun(targetWeightPerRun), id(ID), numaNodeCpus_(numaNodeCpus), stopExtra_(false)
 {
-  boost::thread* newThread;
+  if (!numaNodeCpus_.empty())
+    numaNodes = numaNodeCpus_.size();
+  queueShards = std::max(1U, queueShards);
+  numaNodes = std::max(1U, std::min(numaNodes, queueShards));
+  if (numaNodeCpus_.size() > numaNodes)
+    numaNodeCpus_.resize(numaNodes);
+
+  shards_.reserve(queueShards);
+  for (uint32_t i = 0; i < queueShards; ++i)
+  {
+    shards_.emplace_back(new Shard);
+    // Spread the shards over the NUMA nodes in contiguous ranges.
+    shards_.back()->numaNode_ = i * numaNodes / queueShards;
+  }
+
+  nodeShards_.resize(numaNodes);
+  for (size_t i = 0; i < queueShards; ++i)
+  {
+    nodeShards_[shards_[i]->numaNode_].push_back(i);
+  }
+
+  // Victims of the same NUMA node go first, then the remote ones. Both groups are walked starting
+  // from the neighbour so that thieves of different shards don't hit the same victim.
+  victims_.resize(queueShards);
+  for (size_t home = 0; home < queueShards; ++home)
+  {
+    for (bool sameNode : {true, false})
+    {
+      for (size_t d = 1; d < queueShards; ++d)
+      {
+        size_t victim = (home + d) % queueShards;
+        if ((shards_[victim]->numaNode_ == shards_[home]->numaNode_) == sameNode)
+          victims_[home].push_back(victim);
+      }
+    }
+  }
+
   size_t numberOfThreads = highThreads + midThreads + lowThreads;
   for (uint32_t i = 0; i < numberOfThreads; ++i)
   {
-    newThread = threads.create_thread(ThreadHelper(this, PriorityThreadPool::Priority::HIGH));
-    newThread->detach();
+    createThread(PriorityThreadPool::Priority::HIGH);
   }
-  cout << "FairThreadPool started " << numberOfThreads << " thread/-s.\n";
+  cout << "FairThreadPool started " << numberOfThreads << " thread/-s using " << queueShards
+       << " queue shard/-s over " << numaNodes << " NUMA node/-s.\n";
   threadCounts_.store(numberOfThreads, std::memory_order_relaxed);
   defaultThreadCounts = numberOfThreads;
 }
@@ -52,30 +97,39 @@ FairThreadPool::FairThreadPool(uint targetWeightPerRun, uint highThreads, uint m
 FairThreadPool::~FairThreadPool()
 {
   stop();
+  // The threads use the shards so they must be gone before the pool.
+  threads.join_all();
 }
 
-void FairThreadPool::addJob(const Job& job)
+void FairThreadPool::createThread(const PriorityThreadPool::Priority preferredQueue)
 {
-  boost::thread* newThread;
-  std::unique_lock<std::mutex> lk(mutex, std::defer_lock_t());
+  size_t homeShard = nextHomeShard_.fetch_add(1, std::memory_order_relaxed) % shards_.size();
+  threads.create_thread(ThreadHelper(this, preferredQueue, homeShard));
+}
 
+void FairThreadPool::addJob(const Job& job)
+{
   // Create any missing threads
   if (defaultThreadCounts != threadCounts_.load(std::memory_order_relaxed))
   {
-    newThread = threads.create_thread(ThreadHelper(this, PriorityThreadPool::Priority::HIGH));
-    newThread->detach();
+    createThread(PriorityThreadPool::Priority::HIGH);
     threadCounts_.fetch_add(1, std::memory_order_relaxed);
   }
 
-  lk.lock();
+  size_t shardIdx = shardIdxForJob(job);
+  Shard& shard = *shards_[shardIdx];
+  std::unique_lock<std::mutex> lk(shard.mutex);
   // If some threads have blocked (because of output queue full)
   // Temporarily add some extra worker threads to make up for the blocked threads.
-  if (blockedThreads_ > extraThreads_)
+  // There is no pool-wide lock so CAS prevents concurrent addJob() calls from overshooting.
+  uint32_t extraThreads = extraThreads_.load();
+  if (blockedThreads_ > extraThreads)
   {
-    stopExtra_ = false;
-    newThread = threads.create_thread(ThreadHelper(this, PriorityThreadPool::Priority::EXTRA));
-    newThread->detach();
-    ++extraThreads_;
+    if (extraThreads_.compare_exchange_strong(extraThreads, extraThreads + 1))
+    {
+      stopExtra_ = false;
+      createThread(PriorityThreadPool::Priority::EXTRA);
+    }
   }
   else if (blockedThreads_ == 0)
   {
@@ -83,138 +137,218 @@ void FairThreadPool::addJob(const Job& job)
     stopExtra_ = true;
   }
 
-  auto jobsListMapIter = txn2JobsListMap_.find(job.txnIdx_);
-  if (jobsListMapIter == txn2JobsListMap_.end())  // there is no txn in the map
+  auto& txn2JobsListMap = shard.txn2JobsListMap_;
+  auto& weightedTxnsQueue = shard.weightedTxnsQueue_;
+  auto jobsListMapIter = txn2JobsListMap.find(job.txnIdx_);
+  if (jobsListMapIter == txn2JobsListMap.end())  // there is no txn in the map
   {
     ThreadPoolJobsList* jobsList = new ThreadPoolJobsList;
     jobsList->push_back(job);
-    txn2JobsListMap_[job.txnIdx_] = jobsList;
-    weightedTxnsQueue_.push({job.weight_, job.txnIdx_});
+    txn2JobsListMap[job.txnIdx_] = jobsList;
+    weightedTxnsQueue.push({job.weight_, job.txnIdx_});
   }
   else  // txn is in the map
   {
     if (jobsListMapIter->second->empty())  // there are no jobs for the txn
     {
-      weightedTxnsQueue_.push({job.weight_, job.txnIdx_});
+      weightedTxnsQueue.push({job.weight_, job.txnIdx_});
     }
     jobsListMapIter->second->push_back(job);
   }
+  shard.queueSize_.store(weightedTxnsQueue.size(), std::memory_order_relaxed);
+
+  shard.newJob.notify_one();
+  bool homeThreadsBusy = shard.idleThreads_.load(std::memory_order_relaxed) == 0;
+  lk.unlock();
 
-  newJob.notify_one();
+  // Nobody sleeps on the shard so wake up an idle thread elsewhere to steal the job.
+  if (homeThreadsBusy)
+    notifyIdleThread(shardIdx);
 }
 
-void FairThreadPool::removeJobs(uint32_t id)
+void FairThreadPool::notifyIdleThread(const size_t shardIdx)
 {
-  std::unique_lock<std::mutex> lk(mutex);
-
-  auto txnJobsMapIter = txn2JobsListMap_.begin();
-  while (txnJobsMapIter != txn2JobsListMap_.end())
+  for (size_t victimOf : victims_[shardIdx])
   {
-    auto& txnJobsMapPair = *txnJobsMapIter;
-    ThreadPoolJobsList* txnJobsList = txnJobsMapPair.second;
-    // txnJobsList must not be nullptr
-    if (txnJobsList && txnJobsList->empty())
+    Shard& shard = *shards_[victimOf];
+    if (shard.idleThreads_.load(std::memory_order_relaxed) > 0)
     {
-      txnJobsMapIter = txn2JobsListMap_.erase(txnJobsMapIter);
-      delete txnJobsList;
-      continue;
-      // There is no clean-up for PQ. It will happen later in threadFcn
+      // The notification can be lost if the thread is about to wait. IdleStealPeriod covers this.
+      shard.newJob.notify_one();
+      return;
     }
-    auto job = txnJobsList->begin();
-    while (job != txnJobsList->end())
+  }
+}
+
+void FairThreadPool::removeJobs(uint32_t id)
+{
+  for (auto& shardPtr : shards_)
+  {
+    Shard& shard = *shardPtr;
+    std::unique_lock<std::mutex> lk(shard.mutex);
+
+    auto& txn2JobsListMap = shard.txn2JobsListMap_;
+    auto txnJobsMapIter = txn2JobsListMap.begin();
+    while (txnJobsMapIter != txn2JobsListMap.end())
     {
-      if (job->id_ == id)
+      auto& txnJobsMapPair = *txnJobsMapIter;
+      ThreadPoolJobsList* txnJobsList = txnJobsMapPair.second;
+      // txnJobsList must not be nullptr
+      if (txnJobsList && txnJobsList->empty())
       {
-        job = txnJobsList->erase(job);  // update the job iter
-        continue;                       // go-on skiping job iter increment
+        txnJobsMapIter = txn2JobsListMap.erase(txnJobsMapIter);
+        delete txnJobsList;
+        continue;
+        // There is no clean-up for PQ. It will happen later in threadFcn
       }
-      ++job;
+      auto job = txnJobsList->begin();
+      while (job != txnJobsList->end())
+      {
+        if (job->id_ == id)
+        {
+          job = txnJobsList->erase(job);  // update the job iter
+          continue;                       // go-on skiping job iter increment
+        }
+        ++job;
+      }
+
+      if (txnJobsList->empty())
+      {
+        txnJobsMapIter = txn2JobsListMap.erase(txnJobsMapIter);
+        delete txnJobsList;
+        continue;
+        // There is no clean-up for PQ. It will happen later in threadFcn
+      }
+      ++txnJobsMapIter;
     }
+  }
+}
 
-    if (txnJobsList->empty())
+bool FairThreadPool::popJob(Shard& shard, Job& job)
+{
+  auto& txn2JobsListMap = shard.txn2JobsListMap_;
+  auto& weightedTxnsQueue = shard.weightedTxnsQueue_;
+  // Looking for non-empty jobsList in a loop
+  while (!weightedTxnsQueue.empty())
+  {
+    WeightedTxnT weightedTxn = weightedTxnsQueue.top();
+    // Remove the txn from a queue first to add it later
+    weightedTxnsQueue.pop();
+    auto txnAndJobListPair = txn2JobsListMap.find(weightedTxn.second);
+    if (txnAndJobListPair == txn2JobsListMap.end())
+    {
+      continue;
+    }
+    ThreadPoolJobsList* jobsList = txnAndJobListPair->second;
+    // JobList is empty. This can happen when this method pops the last Job.
+    if (jobsList->empty())
     {
-      txnJobsMapIter = txn2JobsListMap_.erase(txnJobsMapIter);
-      delete txnJobsList;
+      delete jobsList;
+      txn2JobsListMap.erase(txnAndJobListPair);
       continue;
-      // There is no clean-up for PQ. It will happen later in threadFcn
     }
-    ++txnJobsMapIter;
+
+    // We have non-empty jobsList at this point.
+    job = jobsList->front();
+    jobsList->pop_front();
+    // Add the jobList back into the PQ adding some weight to it
+    // Current algo doesn't reduce total txn weight if the job is rescheduled.
+    if (!jobsList->empty())
+    {
+      weightedTxnsQueue.push({weightedTxn.first + job.weight_, weightedTxn.second});
+    }
+    shard.queueSize_.store(weightedTxnsQueue.size(), std::memory_order_relaxed);
+    return true;
   }
+
+  shard.queueSize_.store(0, std::memory_order_relaxed);
+  return false;
 }
 
-void FairThreadPool::threadFcn(const PriorityThreadPool::Priority preferredQueue)
+void FairThreadPool::threadFcn(const PriorityThreadPool::Priority preferredQueue, const size_t homeShard)
 {
   utils::setThreadName("Idle");
   RunListT runList(1);  // This is a vector to allow to grab multiple jobs
   RescheduleVecType reschedule;
   bool running = false;
   bool rescheduleJob = false;
+  Shard& home = *shards_[homeShard];
+  const auto& victims = victims_[homeShard];
+
+  if (home.numaNode_ < numaNodeCpus_.size())
+  {
+    utils::setThreadAffinity(numaNodeCpus_[home.numaNode_]);
+  }
 
   try
   {
     while (!stop_.load(std::memory_order_relaxed))
     {
       runList.clear();  // remove the job
-      std::unique_lock<std::mutex> lk(mutex);
-
-      if (weightedTxnsQueue_.empty())
+      Job job;
+      bool found = false;
       {
-        // If this is an EXTRA thread due toother threads blocking, and all blockers are unblocked,
-        // we don't want this one any more.
-        if (preferredQueue == PriorityThreadPool::Priority::EXTRA && stopExtra_)
+        std::unique_lock<std::mutex> lk(home.mutex);
+        found = popJob(home, job);
+
+        // The single shard pool waits on the only queue there is.
+        if (!found && victims.empty())
         {
-          --extraThreads_;
-          return;
+          // stop() notifies under the lock so the flag can't change b/w this check and the wait.
+          if (stop_.load(std::memory_order_relaxed))
+            break;
+          // If this is an EXTRA thread due toother threads blocking, and all blockers are unblocked,
+          // we don't want this one any more.
+          if (preferredQueue == PriorityThreadPool::Priority::EXTRA && stopExtra_)
+          {
+            --extraThreads_;
+            return;
+          }
+          home.idleThreads_.fetch_add(1, std::memory_order_relaxed);
+          home.newJob.wait(lk);
+          home.idleThreads_.fetch_sub(1, std::memory_order_relaxed);
+          continue;  // just go on w/o re-taking the lock
         }
-        newJob.wait(lk);
-        continue;  // just go on w/o re-taking the lock
       }
 
-      WeightedTxnT weightedTxn = weightedTxnsQueue_.top();
-      auto txnAndJobListPair = txn2JobsListMap_.find(weightedTxn.second);
-      // Looking for non-empty jobsList in a loop
-      // The loop waits on newJob cond_var if PQ is empty(no jobs in this thread pool)
-      while (txnAndJobListPair == txn2JobsListMap_.end() || txnAndJobListPair->second->empty())
+      // The home shard is empty so try to steal from the others. A busy victim is skipped rather than
+      // waited for b/c its owners are likely to drain it anyway.
+      bool victimBusy = false;
+      for (size_t i = 0; !found && i < victims.size(); ++i)
       {
-        // JobList is empty. This can happen when this method pops the last Job.
-        if (txnAndJobListPair != txn2JobsListMap_.end())
+        Shard& victim = *shards_[victims[i]];
+        if (victim.queueSize_.load(std::memory_order_relaxed) == 0)
+          continue;
+        std::unique_lock<std::mutex> vlk(victim.mutex, std::try_to_lock);
+        if (!vlk.owns_lock())
         {
-          ThreadPoolJobsList* txnJobsList = txnAndJobListPair->second;
-          delete txnJobsList;
-          // !txnAndJobListPair is invalidated after this!
-          txn2JobsListMap_.erase(txnAndJobListPair->first);
+          victimBusy = true;
+          continue;
         }
-        weightedTxnsQueue_.pop();
-        if (weightedTxnsQueue_.empty())  // remove the empty
-        {
-          break;
-        }
-        weightedTxn = weightedTxnsQueue_.top();
-        txnAndJobListPair = txn2JobsListMap_.find(weightedTxn.second);
+        found = popJob(victim, job);
       }
 
-      if (weightedTxnsQueue_.empty())
+      if (!found)
       {
-        newJob.wait(lk);  // might need a lock here
+        if (preferredQueue == PriorityThreadPool::Priority::EXTRA && stopExtra_)
+        {
+          --extraThreads_;
+          return;
+        }
+        std::unique_lock<std::mutex> lk(home.mutex);
+        if (home.queueSize_.load(std::memory_order_relaxed) == 0 && !stop_.load(std::memory_order_relaxed))
+        {
+          home.idleThreads_.fetch_add(1, std::memory_order_relaxed);
+          if (victimBusy)
+            home.newJob.wait_for(lk, BusyVictimBackoff);
+          else
+            home.newJob.wait_for(lk, IdleStealPeriod);
+          home.idleThreads_.fetch_sub(1, std::memory_order_relaxed);
+        }
         continue;
       }
 
-      // We have non-empty jobsList at this point.
-      // Remove the txn from a queue first to add it later
-      weightedTxnsQueue_.pop();
-      TransactionIdxT txnIdx = txnAndJobListPair->first;
-      ThreadPoolJobsList* jobsList = txnAndJobListPair->second;
-      runList.push_back(jobsList->front());
-
-      jobsList->pop_front();
-      // Add the jobList back into the PQ adding some weight to it
-      // Current algo doesn't reduce total txn weight if the job is rescheduled.
-      if (!jobsList->empty())
-      {
-        weightedTxnsQueue_.push({weightedTxn.first + runList[0].weight_, txnIdx});
-      }
-
-      lk.unlock();
+      runList.push_back(job);
 
       running = true;
       jobsRunning_.fetch_add(1, std::memory_order_relaxed);
@@ -306,6 +440,12 @@ void FairThreadPool::threadFcn(const PriorityThreadPool::Priority preferredQueue
 void FairThreadPool::stop()
 {
   stop_.store(true, std::memory_order_relaxed);
+  // Wake up the idle threads so they see the flag and exit.
+  for (auto& shard : shards_)
+  {
+    std::lock_guard<std::mutex> lk(shard->mutex);
+    shard->newJob.notify_all();
+  }
 }
 
 }  // namespace threadpool
\ No newline at end of file
@@ -33,9 +33,13 @@
 #include <unordered_map>
 #include <list>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
 
 #include "primitives/primproc/umsocketselector.h"
 #include "prioritythreadpool.h"
+#include "threadaffinity.h"
 
 namespace threadpool
 {
@@ -45,6 +49,8 @@ namespace threadpool
 // except these meta jobs.
 constexpr const uint32_t RescheduleWeightIncrement = 10000;
 constexpr const uint32_t MetaJobsInitialWeight = 1;
+// The Job has no NUMA node preference.
+constexpr const uint32_t AnyNumaNode = std::numeric_limits<uint32_t>::max();
 
 // The idea of this thread pool is to run morsel jobs(primitive job) is to equaly distribute CPU time
 // b/w multiple parallel queries(thread maps morsel to query using txnId). Query(txnId) has its weight
@@ -52,6 +58,13 @@ constexpr const uint32_t MetaJobsInitialWeight = 1;
 // done(ThreadPoolJobsList is empty) it is removed from PQ and the Map(txn to ThreadPoolJobsList).
 // I tested multiple morsels per one loop iteration in ::threadFcn. This approach reduces CPU consumption
 // and increases query timings.
+// With a single mutex guarding PQ+Map all the threads contend on it at high core counts so the pool can
+// be split into a number of queue shards. Every shard is a PQ+Map pair with its own lock and a txn always
+// lands in the same shard so the per-txn weighting described above holds within the shard. A thread
+// serves its home shard first and steals from the other shards when it is empty, preferring the
+// shards that belong to the same NUMA node. A Job that carries a NUMA node hint goes to a shard of that
+// node, so a txn is then fairly scheduled per node. If the CPUs of the nodes are known the threads of
+// a shard are bound to the CPUs of its node.
 class FairThreadPool
 {
  public:
@@ -85,7 +98,10 @@ class FairThreadPool
     uint32_t weight_;
     uint32_t priority_;
     uint32_t id_;
+    // The node that is the closest to the data the Job reads.
+    uint32_t numaNode_ = AnyNumaNode;
   };
+  using NumaNodeCpusT = std::vector<utils::CpuListT>;
 
   /*********************************************
    *  ctor/dtor
@@ -93,9 +109,15 @@ class FairThreadPool
    *********************************************/
 
   /** @brief ctor
+   *
+   * @param queueShards the number of PQ+Map shards. 1 gives the classic single queue pool.
+   * @param numaNodes the number of NUMA nodes the shards are spread over. Used for victim selection.
+   * @param numaNodeCpus the CPUs of every NUMA node. If set it overrides numaNodes and the threads
+   *        are bound to the CPUs of their shard's node.
    */
 
-  FairThreadPool(uint targetWeightPerRun, uint highThreads, uint midThreads, uint lowThreads, uint id = 0);
+  FairThreadPool(uint targetWeightPerRun, uint highThreads, uint midThreads, uint lowThreads, uint id = 0,
+                 uint queueShards = 1, uint numaNodes = 1, const NumaNodeCpusT& numaNodeCpus = {});
   virtual ~FairThreadPool();
 
   void removeJobs(uint32_t id);
@@ -108,7 +130,18 @@ class FairThreadPool
 
   size_t queueSize() const
   {
-    return weightedTxnsQueue_.size();
+    size_t result = 0;
+    for (auto& shard : shards_)
+      result += shard->queueSize_.load(std::memory_order_relaxed);
+    return result;
+  }
+  size_t queueShards() const
+  {
+    return shards_.size();
+  }
+  size_t numaNodes() const
+  {
+    return nodeShards_.size();
   }
   // This method enables a pool current workload estimate.
   size_t jobsRunning() const
@@ -137,27 +170,28 @@ class FairThreadPool
  private:
   struct ThreadHelper
   {
-    ThreadHelper(FairThreadPool* impl, PriorityThreadPool::Priority queue) : ptp(impl), preferredQueue(queue)
+    ThreadHelper(FairThreadPool* impl, PriorityThreadPool::Priority queue, size_t homeShard)
+     : ptp(impl), preferredQueue(queue), homeShard(homeShard)
     {
     }
     void operator()()
     {
-      ptp->threadFcn(preferredQueue);
+      ptp->threadFcn(preferredQueue, homeShard);
     }
     FairThreadPool* ptp;
     PriorityThreadPool::Priority preferredQueue;
+    size_t homeShard;
   };
 
   explicit FairThreadPool();
   explicit FairThreadPool(const FairThreadPool&);
   FairThreadPool& operator=(const FairThreadPool&);
 
-  void threadFcn(const PriorityThreadPool::Priority preferredQueue);
+  void threadFcn(const PriorityThreadPool::Priority preferredQueue, const size_t homeShard);
   void sendErrorMsg(uint32_t id, uint32_t step, primitiveprocessor::SP_UM_IOSOCK sock);
+  void createThread(const PriorityThreadPool::Priority preferredQueue);
 
   uint32_t defaultThreadCounts;
-  std::mutex mutex;
-  std::condition_variable newJob;
   boost::thread_group threads;
   uint32_t weightPerRun;
   volatile uint id;  // prevent it from being optimized out
@@ -179,15 +213,49 @@ class FairThreadPool
   using WeightedTxnPrioQueue = std::priority_queue<WeightedTxnT, WeightedTxnVec, PrioQueueCmp>;
   using ThreadPoolJobsList = std::list<Job>;
   using Txn2ThreadPoolJobsListMap = std::unordered_map<TransactionIdxT, ThreadPoolJobsList*>;
-  Txn2ThreadPoolJobsListMap txn2JobsListMap_;
-  WeightedTxnPrioQueue weightedTxnsQueue_;
+
+  struct Shard
+  {
+    std::mutex mutex;
+    std::condition_variable newJob;
+    Txn2ThreadPoolJobsListMap txn2JobsListMap_;
+    WeightedTxnPrioQueue weightedTxnsQueue_;
+    // Mirrors weightedTxnsQueue_.size() so that thieves and queueSize() can peek w/o the lock.
+    std::atomic<size_t> queueSize_{0};
+    std::atomic<uint32_t> idleThreads_{0};
+    uint32_t numaNode_{0};
+  };
+  using ShardsT = std::vector<std::unique_ptr<Shard>>;
+  using VictimsT = std::vector<std::vector<size_t>>;
+
+  size_t shardIdxForJob(const Job& job) const
+  {
+    if (job.numaNode_ != AnyNumaNode && nodeShards_.size() > 1)
+    {
+      const auto& nodeShards = nodeShards_[job.numaNode_ % nodeShards_.size()];
+      return nodeShards[job.txnIdx_ % nodeShards.size()];
+    }
+    return job.txnIdx_ % shards_.size();
+  }
+  // Pops the next Job of the least weighted txn. Returns false if the shard has no jobs.
+  // Must be called with shard.mutex locked.
+  bool popJob(Shard& shard, Job& job);
+  void notifyIdleThread(const size_t shardIdx);
+
+  ShardsT shards_;
+  // Per home shard list of the other shards ordered by the steal preference.
+  VictimsT victims_;
+  // Shards of every NUMA node.
+  VictimsT nodeShards_;
+  NumaNodeCpusT numaNodeCpus_;
+  std::atomic<size_t> nextHomeShard_{0};
   std::atomic<size_t> jobsRunning_{0};
   std::atomic<size_t> threadCounts_{0};
   std::atomic<bool> stop_{false};
 
   std::atomic<uint32_t> blockedThreads_{0};
   std::atomic<uint32_t> extraThreads_{0};
-  bool stopExtra_;
+  std::atomic<bool> stopExtra_;
 };
 
 }  // namespace threadpool
\ No newline at end of file
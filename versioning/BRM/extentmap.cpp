@@ -35,6 +35,9 @@
 #include <sstream>
 #include <vector>
 #include <limits>
+#include <map>
+#include <memory>
+#include <unordered_map>
 #include <boost/scoped_array.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/thread.hpp>
@@ -56,6 +59,7 @@
 #include "IDBDataFile.h"
 #include "IDBPolicy.h"
 #include "columncommand-jl.h"
+#include "hasher.h"
 #ifdef BRM_INFO
 #include "tracer.h"
 #include "configcpp.h"
@@ -72,6 +76,7 @@
 #define EM_MAGIC_V3 0x76f78b1e
 #define EM_MAGIC_V4 0x76f78b1f
 #define EM_MAGIC_V5 0x76f78b20
+#define EM_DELTA_MAGIC_V1 0x76f78c01
 
 #ifndef NDEBUG
 #define ASSERT(x)                                                                          \
@@ -105,6 +110,45 @@ inline void incSeqNum(int32_t& seqNum)
     seqNum = 0;
 }
 
+// A checkpoint in the EM delta file. It is followed by numChanged EMEntries
+// and numDeleted LBIDs of the extents that were dropped.
+struct EMDeltaHeader
+{
+  int32_t magic;
+  uint32_t numChanged;
+  uint32_t numDeleted;
+  uint32_t reserved;
+  uint64_t checksum;
+};
+
+uint64_t deltaChecksum(const char* data, const size_t size)
+{
+  utils::Hasher64_r hasher;
+  const size_t chunkSize = 1ULL << 30;
+  uint64_t result = 0;
+
+  for (size_t offset = 0; offset < size; offset += chunkSize)
+    result = hasher(data + offset, std::min(chunkSize, size - offset), result);
+
+  return result;
+}
+
+// Returns the number of bytes read that is less than size only at EOF or on error.
+size_t readFully(IDBDataFile* in, char* buffer, const size_t size)
+{
+  size_t progress = 0;
+
+  while (progress < size)
+  {
+    auto err = in->read(buffer + progress, size - progress);
+    if (err <= 0)
+      break;
+    progress += err;
+  }
+
+  return progress;
+}
+
 }  // namespace
 
 namespace BRM
@@ -614,6 +658,178 @@ ExtentMap::~ExtentMap()
   fPmDbRootMap.clear();
 }
 
+//------------------------------------------------------------------------------
+// EMSnapshot methods
+//------------------------------------------------------------------------------
+
+const EMEntry* EMSnapshot::findByLBID(const LBID_t lbid) const
+{
+  auto it = std::upper_bound(byLBID.begin(), byLBID.end(), lbid,
+                             [this](const LBID_t l, const uint32_t i) { return l < entries[i].range.start; });
+  if (it == byLBID.begin())
+    return nullptr;
+
+  const auto& emEntry = entries[*std::prev(it)];
+  if (lbid >= emEntry.range.start + (static_cast<LBID_t>(emEntry.range.size) * 1024))
+    return nullptr;
+
+  return &emEntry;
+}
+
+/* The process-wide cache of the EM snapshots. Readers of different ExtentMap instances
+   share it b/c they all map the same EM segment. When it grows above MaxEntries the least
+   recently used snapshots are dropped until the new one fits. */
+class EMSnapshotCache
+{
+ public:
+  static EMSnapshotCache& instance()
+  {
+    static EMSnapshotCache cache;
+    return cache;
+  }
+
+  EMSnapshotSPtr get(int oid) const
+  {
+    boost::shared_lock<boost::shared_mutex> lk(fMutex);
+    auto it = fOIDs.find(oid);
+    return (it != fOIDs.end()) ? it->second.use(fTick) : EMSnapshotSPtr();
+  }
+
+  // Returns the snapshot of the OID that owned the closest extent starting at or before lbid.
+  EMSnapshotSPtr getByLBID(const LBID_t lbid) const
+  {
+    boost::shared_lock<boost::shared_mutex> lk(fMutex);
+    auto it = fLBIDs.upper_bound(lbid);
+    if (it == fLBIDs.begin())
+      return EMSnapshotSPtr();
+
+    auto oidIt = fOIDs.find(std::prev(it)->second);
+    return (oidIt != fOIDs.end()) ? oidIt->second.use(fTick) : EMSnapshotSPtr();
+  }
+
+  void put(const EMSnapshotSPtr& snapshot)
+  {
+    // Don't let a single huge OID push out everything else.
+    if (snapshot->entries.size() > MaxEntries / 4)
+      return;
+
+    boost::unique_lock<boost::shared_mutex> lk(fMutex);
+    auto it = fOIDs.find(snapshot->oid);
+    if (it != fOIDs.end())
+    {
+      // A concurrent reader might have put a newer copy already.
+      if (it->second.snapshot->generation == snapshot->generation &&
+          it->second.snapshot->seq > snapshot->seq)
+        return;
+
+      erase(it);
+    }
+
+    if (fEntriesCount + snapshot->entries.size() > MaxEntries)
+      evict(MaxEntries - snapshot->entries.size());
+
+    for (const auto& emEntry : snapshot->entries)
+      fLBIDs[emEntry.range.start] = snapshot->oid;
+    fEntriesCount += snapshot->entries.size();
+    auto& slot = fOIDs[snapshot->oid];
+    slot.snapshot = snapshot;
+    slot.use(fTick);
+  }
+
+ private:
+  EMSnapshotCache() = default;
+
+  struct Slot
+  {
+    EMSnapshotSPtr snapshot;
+    // The readers hold the mutex shared, so the LRU order is a use counter.
+    mutable std::atomic<uint64_t> lastUse{0};
+
+    const EMSnapshotSPtr& use(std::atomic<uint64_t>& tick) const
+    {
+      lastUse.store(tick.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+      return snapshot;
+    }
+  };
+
+  // The mutex has to be locked exclusively for these.
+  void erase(std::unordered_map<int, Slot>::iterator it)
+  {
+    for (const auto& emEntry : it->second.snapshot->entries)
+    {
+      auto lbidIt = fLBIDs.find(emEntry.range.start);
+      if (lbidIt != fLBIDs.end() && lbidIt->second == it->first)
+        fLBIDs.erase(lbidIt);
+    }
+    fEntriesCount -= it->second.snapshot->entries.size();
+    fOIDs.erase(it);
+  }
+
+  // Drop the least recently used snapshots until at most maxEntries are left.
+  void evict(size_t maxEntries)
+  {
+    std::vector<std::pair<uint64_t, int>> byUse;
+    byUse.reserve(fOIDs.size());
+    for (const auto& slot : fOIDs)
+      byUse.emplace_back(slot.second.lastUse.load(std::memory_order_relaxed), slot.first);
+    std::sort(byUse.begin(), byUse.end());
+
+    for (auto it = byUse.begin(); it != byUse.end() && fEntriesCount > maxEntries; ++it)
+      erase(fOIDs.find(it->second));
+  }
+
+  static const constexpr size_t MaxEntries = 1024 * 1024;
+
+  mutable boost::shared_mutex fMutex;
+  mutable std::atomic<uint64_t> fTick{0};
+  std::unordered_map<int, Slot> fOIDs;
+  // The first LBID of every cached extent to its OID.
+  std::map<LBID_t, int> fLBIDs;
+  size_t fEntriesCount = 0;
+};
+
+bool ExtentMap::isSnapshotCurrent(const EMSnapshot& snapshot) const
+{
+  return snapshot.generation == fMST.getEMGeneration() && snapshot.seq == fMST.getEMOIDSeq(snapshot.oid);
+}
+
+EMSnapshotSPtr ExtentMap::makeSnapshot(int OID, const DBRootVec& dbRoots)
+{
+  auto snapshot = std::make_shared<EMSnapshot>();
+  // The sequences can't change while the read locks are held.
+  snapshot->oid = OID;
+  snapshot->generation = fMST.getEMGeneration();
+  snapshot->seq = fMST.getEMOIDSeq(OID);
+  snapshot->dbRoots = dbRoots;
+
+  for (auto dbRoot : dbRoots)
+  {
+    const auto lbids = fPExtMapIndexImpl_->find(dbRoot, OID);
+    auto emIdents = getEmIdentsByLbids(lbids);
+    snapshot->entries.insert(snapshot->entries.end(), emIdents.begin(), emIdents.end());
+  }
+
+  snapshot->byLBID.resize(snapshot->entries.size());
+  for (uint32_t i = 0; i < snapshot->byLBID.size(); ++i)
+    snapshot->byLBID[i] = i;
+  std::sort(snapshot->byLBID.begin(), snapshot->byLBID.end(),
+            [&snapshot](const uint32_t a, const uint32_t b)
+            { return snapshot->entries[a].range.start < snapshot->entries[b].range.start; });
+
+  EMSnapshotSPtr result(std::move(snapshot));
+  EMSnapshotCache::instance().put(result);
+  return result;
+}
+
+const EMEntry* ExtentMap::findInSnapshot(const LBID_t lbid, EMSnapshotSPtr& snapshot) const
+{
+  snapshot = EMSnapshotCache::instance().getByLBID(lbid);
+  if (!snapshot || !isSnapshotCurrent(*snapshot))
+    return nullptr;
+
+  return snapshot->findByLBID(lbid);
+}
+
 ExtentMapRBTree::iterator ExtentMap::findByLBID(const LBID_t lbid)
 {
   auto emIt = fExtentMapRBTree->lower_bound(lbid);
@@ -1368,6 +1584,29 @@ int ExtentMap::getMaxMin(const LBID_t lbid, T& max, T& min, int32_t& seqNum)
 
 #endif
 
+  auto getCP = [&](const EMEntry& emEntry)
+  {
+    if (typeid(T) == typeid(int128_t))
+    {
+      max = emEntry.partition.cprange.bigHiVal;
+      min = emEntry.partition.cprange.bigLoVal;
+    }
+    else
+    {
+      max = emEntry.partition.cprange.hiVal;
+      min = emEntry.partition.cprange.loVal;
+    }
+    seqNum = emEntry.partition.cprange.sequenceNum;
+    isValid = emEntry.partition.cprange.isValid;
+  };
+
+  EMSnapshotSPtr snapshot;
+  if (auto* emEntry = findInSnapshot(lbid, snapshot))
+  {
+    getCP(*emEntry);
+    return isValid;
+  }
+
   grabEMEntryTable(READ);
   grabEMIndex(READ);
 
@@ -1375,19 +1614,7 @@ int ExtentMap::getMaxMin(const LBID_t lbid, T& max, T& min, int32_t& seqNum)
   if (emIt == fExtentMapRBTree->end())
     throw logic_error("ExtentMap::getMaxMin(): that lbid isn't allocated");
 
-  auto& emEntry = emIt->second;
-  if (typeid(T) == typeid(int128_t))
-  {
-    max = emEntry.partition.cprange.bigHiVal;
-    min = emEntry.partition.cprange.bigLoVal;
-  }
-  else
-  {
-    max = emEntry.partition.cprange.hiVal;
-    min = emEntry.partition.cprange.loVal;
-  }
-  seqNum = emEntry.partition.cprange.sequenceNum;
-  isValid = emEntry.partition.cprange.isValid;
+  getCP(emIt->second);
 
   releaseEMIndex(READ);
   releaseEMEntryTable(READ);
@@ -1431,18 +1658,29 @@ void ExtentMap::getCPMaxMin(const BRM::LBID_t lbid, BRM::CPMaxMin& cpMaxMin)
     throw invalid_argument("ExtentMap::getMaxMin(): lbid must be >= 0");
 #endif
 
+  auto getCP = [&cpMaxMin](const EMEntry& emEntry)
+  {
+    cpMaxMin.bigMax = emEntry.partition.cprange.bigHiVal;
+    cpMaxMin.bigMin = emEntry.partition.cprange.bigLoVal;
+    cpMaxMin.max = emEntry.partition.cprange.hiVal;
+    cpMaxMin.min = emEntry.partition.cprange.loVal;
+    cpMaxMin.seqNum = emEntry.partition.cprange.sequenceNum;
+  };
+
+  EMSnapshotSPtr snapshot;
+  if (auto* emEntry = findInSnapshot(lbid, snapshot))
+  {
+    getCP(*emEntry);
+    return;
+  }
+
   grabEMEntryTable(READ);
   grabEMIndex(READ);
   auto emIt = findByLBID(lbid);
   if (emIt == fExtentMapRBTree->end())
     throw logic_error("ExtentMap::getMaxMin(): that lbid isn't allocated");
 
-  auto& emEntry = emIt->second;
-  cpMaxMin.bigMax = emEntry.partition.cprange.bigHiVal;
-  cpMaxMin.bigMin = emEntry.partition.cprange.bigLoVal;
-  cpMaxMin.max = emEntry.partition.cprange.hiVal;
-  cpMaxMin.min = emEntry.partition.cprange.loVal;
-  cpMaxMin.seqNum = emEntry.partition.cprange.sequenceNum;
+  getCP(emIt->second);
 
   releaseEMIndex(READ);
   releaseEMEntryTable(READ);
@@ -1554,7 +1792,7 @@ void ExtentMap::reserveLBIDRange(LBID_t start, uint8_t size)
 */
 
 template <class T>
-void ExtentMap::loadVersion4or5(T* in, bool upgradeV4ToV5)
+void ExtentMap::loadVersion4or5(T* in, bool upgradeV4ToV5, IDBDataFile* delta)
 {
   uint32_t emNumElements = 0;
   uint32_t flNumElements = 0;
@@ -1571,6 +1809,7 @@ void ExtentMap::loadVersion4or5(T* in, bool upgradeV4ToV5)
   }
 
   // Clear the extent map.
+  fMST.bumpEMGeneration();
   fExtentMapRBTree->clear();
   fEMRBTreeShminfo->currentSize = 0;
 
@@ -1662,6 +1901,9 @@ void ExtentMap::loadVersion4or5(T* in, bool upgradeV4ToV5)
     std::cout << emNumElements << " extents successfully upgraded" << std::endl;
   }
 
+  if (delta)
+    loadDelta(delta);
+
   for (auto& lbidEMEntryPair : *fExtentMapRBTree)
   {
     EMEntry& emEntry = lbidEMEntryPair.second;
@@ -1680,7 +1922,7 @@ void ExtentMap::loadVersion4or5(T* in, bool upgradeV4ToV5)
       logAndSetEMIndexReadOnly("loadVersion4");
   }
 
-  fEMRBTreeShminfo->currentSize = (emNumElements * EM_RB_TREE_NODE_SIZE) + EM_RB_TREE_EMPTY_SIZE;
+  fEMRBTreeShminfo->currentSize = (fExtentMapRBTree->size() * EM_RB_TREE_NODE_SIZE) + EM_RB_TREE_EMPTY_SIZE;
 
 #ifdef DUMP_EXTENT_MAP
   cout << "lbid\tsz\toid\tfbo\thwm\tpart#\tseg#\tDBRoot\twid\tst\thi\tlo\tsq\tv" << endl;
@@ -1744,9 +1986,16 @@ void ExtentMap::load(const string& filename, bool fixFL)
     throw ios_base::failure("ExtentMap::load(): open failed. Check the error log.");
   }
 
+  const string deltaFilename = filename + "_delta";
+  scoped_ptr<IDBDataFile> delta;
+
+  if (IDBPolicy::exists(deltaFilename.c_str()))
+    delta.reset(IDBDataFile::open(IDBPolicy::getType(deltaFilename.c_str(), IDBPolicy::WRITEENG),
+                                  deltaFilename.c_str(), "r", 0));
+
   try
   {
-    load(in.get());
+    load(in.get(), delta.get());
   }
 
   catch (...)
@@ -1757,13 +2006,20 @@ void ExtentMap::load(const string& filename, bool fixFL)
     throw;
   }
 
+  {
+    // The image of another instance can't be a base for the deltas of this one.
+    boost::mutex::scoped_lock lk(fDeltaMutex);
+    fDirtyLBIDs.clear();
+    fDeltaBase.clear();
+  }
+
   releaseFreeList(WRITE);
   releaseEMIndex(WRITE);
   releaseEMEntryTable(WRITE);
 }
 
 template <typename T>
-void ExtentMap::load(T* in)
+void ExtentMap::load(T* in, IDBDataFile* delta)
 {
   if (!in)
     return;
@@ -1775,7 +2031,7 @@ void ExtentMap::load(T* in)
 
     if (bytes == (int)sizeof(int) && (emVersion == EM_MAGIC_V4 || emVersion == EM_MAGIC_V5))
     {
-      loadVersion4or5(in, emVersion == EM_MAGIC_V4);
+      loadVersion4or5(in, emVersion == EM_MAGIC_V4, delta);
     }
     else
     {
@@ -1789,6 +2045,150 @@ void ExtentMap::load(T* in)
   }
 }
 
+/* Applies the checkpoints of the delta file to the EM tree. A truncated or
+   corrupted checkpoint ends the file, it is the tail of an interrupted saveDelta(). */
+void ExtentMap::loadDelta(IDBDataFile* delta)
+{
+  constexpr const uint32_t freeShmemThreshold = EM_RB_TREE_INITIAL_SIZE >> 4;
+  uint32_t checkpoints = 0;
+
+  while (true)
+  {
+    EMDeltaHeader header;
+
+    if (readFully(delta, reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header))
+      break;
+
+    if (header.magic != EM_DELTA_MAGIC_V1)
+    {
+      log("ExtentMap::loadDelta(): bad checkpoint magic, ignoring the rest of the delta file");
+      break;
+    }
+
+    const size_t changedSize = header.numChanged * sizeof(EMEntry);
+    const size_t payloadSize = changedSize + header.numDeleted * sizeof(LBID_t);
+    std::unique_ptr<char[]> payload(new char[payloadSize]);
+
+    if (readFully(delta, payload.get(), payloadSize) != payloadSize ||
+        deltaChecksum(payload.get(), payloadSize) != header.checksum)
+    {
+      log("ExtentMap::loadDelta(): incomplete checkpoint, ignoring the rest of the delta file");
+      break;
+    }
+
+    const LBID_t* deleted = reinterpret_cast<const LBID_t*>(&payload[changedSize]);
+    for (uint32_t i = 0; i < header.numDeleted; ++i)
+      fExtentMapRBTree->erase(deleted[i]);
+
+    for (uint32_t i = 0; i < header.numChanged; ++i)
+    {
+      if (fPExtMapRBTreeImpl->getFreeMemory() < freeShmemThreshold)
+        growEMShmseg(EM_RB_TREE_INCREMENT);
+
+      EMEntry emEntry;
+      memcpy(&emEntry, &payload[i * sizeof(EMEntry)], sizeof(EMEntry));
+      fExtentMapRBTree->erase(emEntry.range.start);
+      fExtentMapRBTree->insert(make_pair(emEntry.range.start, emEntry));
+    }
+
+    ++checkpoints;
+  }
+
+  ostringstream os;
+  os << "ExtentMap::loadDelta(): applied " << checkpoints << " checkpoints";
+  log(os.str(), logging::LOG_TYPE_DEBUG);
+}
+
+bool ExtentMap::saveDelta(const string& filename)
+{
+#ifdef BRM_INFO
+
+  if (fDebug)
+  {
+    TRACER_WRITELATER("saveDelta");
+    TRACER_ADDSTRINPUT(filename);
+    TRACER_WRITE;
+  }
+
+#endif
+
+  std::vector<EMEntry> changed;
+  std::vector<LBID_t> deleted;
+  std::unordered_set<LBID_t> dirty;
+
+  grabEMEntryTable(READ);
+  grabEMIndex(READ);
+
+  {
+    boost::mutex::scoped_lock lk(fDeltaMutex);
+
+    if (fDeltaBase != filename)
+    {
+      lk.unlock();
+      releaseEMIndex(READ);
+      releaseEMEntryTable(READ);
+      return false;
+    }
+
+    dirty.swap(fDirtyLBIDs);
+  }
+
+  changed.reserve(dirty.size());
+
+  for (auto lbid : dirty)
+  {
+    auto emIt = fExtentMapRBTree->find(lbid);
+
+    if (emIt != fExtentMapRBTree->end())
+      changed.push_back(emIt->second);
+    else
+      deleted.push_back(lbid);
+  }
+
+  releaseEMIndex(READ);
+  releaseEMEntryTable(READ);
+
+  const size_t changedSize = changed.size() * sizeof(EMEntry);
+  const size_t deletedSize = deleted.size() * sizeof(LBID_t);
+  std::unique_ptr<char[]> buffer(new char[sizeof(EMDeltaHeader) + changedSize + deletedSize]);
+  char* payload = &buffer[sizeof(EMDeltaHeader)];
+  memcpy(payload, changed.data(), changedSize);
+  memcpy(payload + changedSize, deleted.data(), deletedSize);
+
+  EMDeltaHeader header;
+  header.magic = EM_DELTA_MAGIC_V1;
+  header.numChanged = changed.size();
+  header.numDeleted = deleted.size();
+  header.reserved = 0;
+  header.checksum = deltaChecksum(payload, changedSize + deletedSize);
+  memcpy(buffer.get(), &header, sizeof(header));
+
+  const string deltaFilename = filename + "_delta";
+  const size_t writeSize = sizeof(EMDeltaHeader) + changedSize + deletedSize;
+  scoped_ptr<IDBDataFile> out(IDBDataFile::open(IDBPolicy::getType(deltaFilename.c_str(), IDBPolicy::WRITEENG),
+                                                deltaFilename.c_str(), "a", 0));
+  size_t progress = 0;
+
+  while (out && progress < writeSize)
+  {
+    auto err = out->write(&buffer[progress], writeSize - progress);
+    if (err < 0)
+      break;
+    progress += err;
+  }
+
+  if (!out || progress < writeSize || out->flush() != 0)
+  {
+    log_errno("ExtentMap::saveDelta(): write");
+    // Keep the extents for the next attempt.
+    boost::mutex::scoped_lock lk(fDeltaMutex);
+    fDirtyLBIDs.insert(dirty.begin(), dirty.end());
+    throw ios_base::failure("ExtentMap::saveDelta(): write failed. Check the error log.");
+  }
+
+  return true;
+}
+
 void ExtentMap::save(const string& filename)
 {
 #ifdef BRM_INFO
@@ -1825,6 +2225,11 @@ void ExtentMap::save(const string& filename)
     throw runtime_error("ExtentMap::save(): got request to save an empty BRM");
   }
 
+  // The checkpoints of the previous image don't apply to the new one.
+  const string deltaFilename = filename + "_delta";
+  if (IDBPolicy::exists(deltaFilename.c_str()))
+    IDBPolicy::remove(deltaFilename.c_str());
+
   const char* filename_p = filename.c_str();
   scoped_ptr<IDBDataFile> out(IDBDataFile::open(IDBPolicy::getType(filename_p, IDBPolicy::WRITEENG),
                                                 filename_p, "wb", IDBDataFile::USE_VBUF));
@@ -1915,6 +2320,12 @@ void ExtentMap::save(const string& filename)
     progress += err;
   }
 
+  {
+    boost::mutex::scoped_lock lk(fDeltaMutex);
+    fDirtyLBIDs.clear();
+    fDeltaBase = filename;
+  }
+
   releaseFreeList(READ);
   releaseEMIndex(READ);
   releaseEMEntryTable(READ);
@@ -2278,6 +2689,15 @@ int ExtentMap::lookup(LBID_t lbid, LBID_t& firstLbid, LBID_t& lastLbid)
 
 #endif
 
+  EMSnapshotSPtr snapshot;
+  auto* emEntry = findInSnapshot(lbid, snapshot);
+  if (emEntry)
+  {
+    firstLbid = emEntry->range.start;
+    lastLbid = emEntry->range.start + (static_cast<LBID_t>(emEntry->range.size) * 1024) - 1;
+    return 0;
+  }
+
   grabEMEntryTable(READ);
   grabEMIndex(READ);
 
@@ -2289,9 +2709,9 @@ int ExtentMap::lookup(LBID_t lbid, LBID_t& firstLbid, LBID_t& lastLbid)
     return -1;
   }
 
-  auto& emEntry = emIt->second;
-  LBID_t lastBlock = emEntry.range.start + (static_cast<LBID_t>(emEntry.range.size) * 1024) - 1;
-  firstLbid = emEntry.range.start;
+  emEntry = &emIt->second;
+  LBID_t lastBlock = emEntry->range.start + (static_cast<LBID_t>(emEntry->range.size) * 1024) - 1;
+  firstLbid = emEntry->range.start;
   lastLbid = lastBlock;
 
   releaseEMIndex(READ);
@@ -2341,6 +2761,25 @@ int ExtentMap::lookupLocal(LBID_t lbid, int& OID, uint16_t& dbRoot, uint32_t& pa
     throw invalid_argument(oss.str());
   }
 
+  auto getLocal = [&](const EMEntry& emEntry)
+  {
+    OID = emEntry.fileID;
+    dbRoot = emEntry.dbRoot;
+    segmentNum = emEntry.segmentNum;
+    partitionNum = emEntry.partitionNum;
+
+    // TODO:  Offset logic.
+    auto offset = lbid - emEntry.range.start;
+    fileBlockOffset = emEntry.blockOffset + offset;
+  };
+
+  EMSnapshotSPtr snapshot;
+  if (auto* emEntry = findInSnapshot(lbid, snapshot))
+  {
+    getLocal(*emEntry);
+    return 0;
+  }
+
   grabEMEntryTable(READ);
   grabEMIndex(READ);
 
@@ -2352,15 +2791,7 @@ int ExtentMap::lookupLocal(LBID_t lbid, int& OID, uint16_t& dbRoot, uint32_t& pa
     return -1;
   }
 
-  auto& emEntry = emIt->second;
-  OID = emEntry.fileID;
-  dbRoot = emEntry.dbRoot;
-  segmentNum = emEntry.segmentNum;
-  partitionNum = emEntry.partitionNum;
-
-  // TODO:  Offset logic.
-  auto offset = lbid - emEntry.range.start;
-  fileBlockOffset = emEntry.blockOffset + offset;
+  getLocal(emIt->second);
 
   releaseEMIndex(READ);
   releaseEMEntryTable(READ);
@@ -4946,6 +5377,8 @@ void ExtentMap::bulkUpdateDBRoot(const vector<BulkUpdateDBRootArg>& args)
   for (auto& lbidDbroot : args)
   {
     auto emIter = findByLBID(lbidDbroot.startLBID);
+    fMST.bumpEMOIDSeq(emIter->second.fileID);
+    markDirty(lbidDbroot.startLBID);
     emIter->second.dbRoot = lbidDbroot.dbRoot;
   }
 }
@@ -4974,35 +5407,34 @@ void ExtentMap::getExtents(int OID, vector<struct EMEntry>& entries, bool sorted
     throw invalid_argument(oss.str());
   }
 
-  grabEMEntryTable(READ);
-  grabEMIndex(READ);
-  // Artibtrary sized constant
-  entries.reserve(100);
-
   DBRootVec dbRootVec(getAllDbRoots());
 
-  for (auto dbRoot : dbRootVec)
+  // Only take the EM locks if the OID extents have changed since the last call.
+  auto snapshot = EMSnapshotCache::instance().get(OID);
+  if (!snapshot || !isSnapshotCurrent(*snapshot) || snapshot->dbRoots != dbRootVec)
   {
-    const auto lbids = fPExtMapIndexImpl_->find(dbRoot, OID);
-    entries.reserve(entries.size() + lbids.size());
-    const auto emIdents = getEmIdentsByLbids(lbids);
-    for (auto& emEntry : emIdents)
+    grabEMEntryTable(READ);
+    grabEMIndex(READ);
+    snapshot = makeSnapshot(OID, dbRootVec);
+    releaseEMIndex(READ);
+    releaseEMEntryTable(READ);
+  }
+
+  entries.reserve(snapshot->entries.size());
+
+  for (auto& emEntry : snapshot->entries)
+  {
+    if (incOutOfService)
     {
-      if (incOutOfService)
-      {
+      entries.push_back(emEntry);
+    }
+    else
+    {
+      if (emEntry.status != EXTENTOUTOFSERVICE)
         entries.push_back(emEntry);
-      }
-      else
-      {
-        if (emEntry.status != EXTENTOUTOFSERVICE)
-          entries.push_back(emEntry);
-      }
     }
   }
 
-  releaseEMIndex(READ);
-  releaseEMEntryTable(READ);
-
   if (sorted)
     sort<vector<struct EMEntry>::iterator>(entries.begin(), entries.end());
 }
@@ -5981,13 +6413,25 @@ void ExtentMap::finishChanges()
 
 void ExtentMap::makeUndoRecordRBTree(UndoRecordType type, const EMEntry& emEntry)
 {
+  // Every EM change goes through here, invalidate the snapshots of the OID.
+  fMST.bumpEMOIDSeq(emEntry.fileID);
+  markDirty(emEntry.range.start);
   undoRecordsRBTree.push_back(make_pair(type, emEntry));
 }
 
+void ExtentMap::markDirty(const LBID_t lbid)
+{
+  boost::mutex::scoped_lock lk(fDeltaMutex);
+  if (!fDeltaBase.empty())
+    fDirtyLBIDs.insert(lbid);
+}
+
 void ExtentMap::undoChangesRBTree()
 {
   for (const auto& undoPair : undoRecordsRBTree)
   {
+    fMST.bumpEMOIDSeq(undoPair.second.fileID);
+
     if (undoPair.first == UndoRecordType::INSERT)
     {
       const auto key = undoPair.second.range.start;
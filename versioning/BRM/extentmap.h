@@ -32,7 +32,9 @@
 #include <set>
 #include <unordered_map>
 #include <tr1/unordered_map>
+#include <memory>
 #include <mutex>
+#include <unordered_set>
 
 // #define NDEBUG
 #include <cassert>
@@ -470,6 +472,26 @@ class ExtentMapIndexImpl
   static const constexpr size_t freeSpaceThreshold_ = 256 * 1024;
 };
 
+/** @brief A process-local copy of all extents of an OID
+ *
+ * The copy is valid as long as the EM generation and the OID bucket write sequence
+ * stored in the MST equal the ones it was made with. See EMWriteSeqs.
+ */
+struct EMSnapshot
+{
+  int oid;
+  uint64_t generation;
+  uint64_t seq;
+  DBRootVec dbRoots;
+  // In getExtents() order, including the out-of-service extents.
+  std::vector<EMEntry> entries;
+  // Indexes into entries ordered by the first LBID of the extent.
+  std::vector<uint32_t> byLBID;
+
+  const EMEntry* findByLBID(const LBID_t lbid) const;
+};
+using EMSnapshotSPtr = std::shared_ptr<const EMSnapshot>;
+
 /** @brief This class encapsulates the extent map functionality of the system
  *
  * This class encapsulates the extent map functionality of the system.  It
@@ -489,7 +511,8 @@ class ExtentMap : public Undoable
    * Loads the ExtentMap entries from a file.  This will
    * clear out any existing entries.  The intention is that before
    * the system starts, an external tool instantiates a single Extent
-   * Map and loads the stored entries.
+   * Map and loads the stored entries.  The checkpoints appended by
+   * saveDelta() to filename_delta are applied on top of the image.
    * @param filename The file to load from.
    * @note Throws an ios_base::failure exception on an IO error, runtime_error
    * if the file "looks" bad.
@@ -513,6 +536,17 @@ class ExtentMap : public Undoable
    */
   EXPORT void save(const std::string& filename);
 
+  /** @brief Appends the ExtentMap entries changed since the last save to filename_delta
+   *
+   * Appends a checkpoint with the extents this instance changed since it saved
+   * the image to filename.  The EM locks are held only while the changed entries
+   * are copied.
+   * @param filename The image file the last save() of this instance wrote to.
+   * @return false if this instance didn't save filename, a full save() is needed then.
+   * @note Throws an ios_base::failure exception on an IO error.
+   */
+  EXPORT bool saveDelta(const std::string& filename);
+
   // @bug 1509.  Added new version of lookup below.
   /** @brief Returns the first and last LBID in the range for a given LBID
    *
@@ -1182,16 +1216,30 @@ class ExtentMap : public Undoable
   void _releaseTable(const OPS op, std::atomic<bool>& lockedState, const int table);
 
   template <typename T>
-  void load(T* in);
+  void load(T* in, idbdatafile::IDBDataFile* delta = nullptr);
 
   template <typename T>
-  void loadVersion4or5(T* in, bool upgradeV4ToV5);
+  void loadVersion4or5(T* in, bool upgradeV4ToV5, idbdatafile::IDBDataFile* delta);
+  void loadDelta(idbdatafile::IDBDataFile* delta);
+  void markDirty(const LBID_t lbid);
 
   ExtentMapRBTree::iterator findByLBID(const LBID_t lbid);
 
+  // Lock-free readers. makeSnapshot() makes a new copy of the OID extents and must be called
+  // holding the EM and EM Index read locks. Only getExtents() makes them, the LBID lookups
+  // use a current snapshot when there is one and the RB tree otherwise.
+  bool isSnapshotCurrent(const EMSnapshot& snapshot) const;
+  EMSnapshotSPtr makeSnapshot(int OID, const DBRootVec& dbRoots);
+  const EMEntry* findInSnapshot(const LBID_t lbid, EMSnapshotSPtr& snapshot) const;
+
   using UndoRecordPair = std::pair<UndoRecordType, EMEntry>;
   std::vector<UndoRecordPair> undoRecordsRBTree;
 
+  // The first LBIDs of the extents changed since the image fDeltaBase was saved.
+  boost::mutex fDeltaMutex;
+  std::unordered_set<LBID_t> fDirtyLBIDs;
+  std::string fDeltaBase;
+
   ExtentMapRBTreeImpl* fPExtMapRBTreeImpl;
   FreeListImpl* fPFreeListImpl;
   ExtentMapIndexImpl* fPExtMapIndexImpl_;
@@ -22,6 +22,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <ctime>
 #include <stdexcept>
 #include <sys/types.h>
 #include <cerrno>
@@ -89,6 +90,10 @@ MasterSegmentTableImpl::MasterSegmentTableImpl(int key, int size)
       try
       {
         bi::shared_memory_object shm(bi::open_only, keyName.c_str(), bi::read_write);
+        // A segment made by an older version doesn't have the room for the EM write sequences.
+        bi::offset_t currentSize = 0;
+        if (shm.get_size(currentSize) && currentSize < size)
+          shm.truncate(size);
         fShmobj.swap(shm);
       }
       catch (exception& e)
@@ -174,12 +179,15 @@ void MasterSegmentTable::makeMSTSegment()
 {
   fPImpl = MasterSegmentTableImpl::makeMasterSegmentTableImpl(fShmKeys.MST_SYSVKEY, MSTshmsize);
   fShmDescriptors = static_cast<MSTEntry*>(fPImpl->fMapreg.get_address());
+  fEMWriteSeqs = reinterpret_cast<EMWriteSeqs*>(reinterpret_cast<char*>(fShmDescriptors) + MSTEntriesSize);
 }
 
 void MasterSegmentTable::initMSTData()
 {
-  void* dp = static_cast<void*>(&fShmDescriptors);
+  void* dp = static_cast<void*>(fShmDescriptors);
   memset(dp, 0, MSTshmsize);
+  // A re-created segment must not validate EM copies made against the previous one.
+  fEMWriteSeqs->generation = static_cast<uint64_t>(time(nullptr)) << 32;
 }
 
 MSTEntry* MasterSegmentTable::getTable_read(int num, bool block) const
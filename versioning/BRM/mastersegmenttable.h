@@ -33,6 +33,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <stdexcept>
 #include <sys/types.h>
 #include <boost/thread.hpp>
@@ -55,6 +57,18 @@ struct MSTEntry
   EXPORT MSTEntry();
 };
 
+/* The write sequences of the Extent Map. They live in the MST segment right after the MSTEntries.
+   A writer bumps the sequence of the OID bucket before it changes an extent of the OID, the generation
+   changes if the whole map is replaced. Both are read w/o locking to check if a process-local copy of
+   the OID extents is still current. */
+struct EMWriteSeqs
+{
+  static const int OIDBuckets = 4096;
+  std::atomic<uint64_t> generation;
+  std::atomic<uint64_t> oidSeqs[OIDBuckets];
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "EMWriteSeqs are shared b/w processes");
+
 class MasterSegmentTableImpl
 {
  public:
@@ -186,6 +200,27 @@ class MasterSegmentTable
     return fShmDescriptors[VSSSegment].tableShmkey;
   }
 
+  /** @brief These functions read and bump the EM write sequences w/o locking.
+   *
+   * The bump functions must be called holding the EM write lock before the change.
+   */
+  inline uint64_t getEMGeneration() const
+  {
+    return fEMWriteSeqs->generation.load(std::memory_order_acquire);
+  }
+  inline uint64_t getEMOIDSeq(int oid) const
+  {
+    return fEMWriteSeqs->oidSeqs[emOIDBucket(oid)].load(std::memory_order_acquire);
+  }
+  inline void bumpEMGeneration() const
+  {
+    fEMWriteSeqs->generation.fetch_add(1);
+  }
+  inline void bumpEMOIDSeq(int oid) const
+  {
+    fEMWriteSeqs->oidSeqs[emOIDBucket(oid)].fetch_add(1);
+  }
+
  private:
   MasterSegmentTable(const MasterSegmentTable& mst);
   MasterSegmentTable& operator=(const MasterSegmentTable& mst);
@@ -193,11 +228,19 @@ class MasterSegmentTable
   int shmid;
   mutable boost::scoped_ptr<rwlock::RWLock> rwlock[nTables];
 
-  static const int MSTshmsize = nTables * sizeof(MSTEntry);
+  static const int MSTEntriesSize = nTables * sizeof(MSTEntry);
+  static_assert(MSTEntriesSize % alignof(EMWriteSeqs) == 0, "EMWriteSeqs must be aligned");
+  static const int MSTshmsize = MSTEntriesSize + sizeof(EMWriteSeqs);
   int RWLockKeys[nTables];
 
+  static inline uint32_t emOIDBucket(int oid)
+  {
+    return static_cast<uint32_t>(oid) % EMWriteSeqs::OIDBuckets;
+  }
+
   /// indexed by EMTable, EMFreeList, and VBBMTable
   MSTEntry* fShmDescriptors;
+  EMWriteSeqs* fEMWriteSeqs;
 
   void makeMSTSegment();
   void initMSTData();
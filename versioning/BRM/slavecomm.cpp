@@ -127,6 +127,21 @@ SlaveComm::SlaveComm(string hostname)
 
     journalCount = 0;
 
+    tmp = "";
+
+    try
+    {
+      tmp = config->getConfig("SystemConfig", "DBRMIncrementalSnapshots");
+    }
+    catch (exception& e)
+    {
+    }
+
+    if (tmp == "")
+      incrementalSnapshots = 16;
+    else
+      incrementalSnapshots = config->fromText(tmp);
+
     firstSlave = true;
     journalName = savefile + "_journal";
     const char* filename = journalName.c_str();
@@ -139,10 +154,12 @@ SlaveComm::SlaveComm(string hostname)
   {
     savefile = "";
     firstSlave = false;
+    incrementalSnapshots = 0;
   }
 
   takeSnapshot = false;
   doSaveDelta = false;
+  incrementalCount = 0;
   saveFileToggle = true;  // start with the suffix "A" rather than "B".  Arbitrary.
   release = false;
   die = false;
@@ -181,6 +198,8 @@ SlaveComm::SlaveComm()
 
   takeSnapshot = false;
   doSaveDelta = false;
+  incrementalSnapshots = 0;
+  incrementalCount = 0;
   saveFileToggle = true;  // start with the suffix "A" rather than "B".  Arbitrary.
   release = false;
   die = false;
@@ -1921,51 +1940,35 @@ void SlaveComm::do_confirm()
 
   slave->confirmChanges();
 
-  string tmp = savefile + "_current";
-
   if (firstSlave && (takeSnapshot || (journalCount >= snapshotInterval && snapshotInterval >= 0)))
   {
-    if (!currentSaveFile)
-    {
-      currentSaveFile.reset(
-          IDBDataFile::open(IDBPolicy::getType(tmp.c_str(), IDBPolicy::WRITEENG), tmp.c_str(), "wb", 0));
-    }
+    // The periodic snapshots between the full ones only append the changed extents
+    // to the EM delta file of the last full snapshot. A requested snapshot is always
+    // a full one, that compacts the delta file away.
+    bool incremental = false;
+
+    if (!takeSnapshot && !lastSaveFile.empty() && incrementalCount < incrementalSnapshots)
+      incremental = (slave->saveStateIncremental(lastSaveFile) == 0);
 
-    if (currentSaveFile == NULL)
+    if (incremental)
     {
-      ostringstream os;
-      os << "WorkerComm: failed to open the current savefile. errno: " << strerror(errno);
-      log(os.str());
-      throw runtime_error(os.str());
+      saveCurrentFile(lastSaveFile);
+      incrementalCount++;
     }
-
-    tmp = savefile + (saveFileToggle ? 'A' : 'B');
-    slave->saveState(tmp);
-    tmp += '\n';
-    int err = 0;
-
-    // MCOL-1558.  Make the _current file relative to DBRMRoot.
-    string relative = tmp.substr(tmp.find_last_of('/') + 1);
-    err = currentSaveFile->write(relative.c_str(), relative.length());
-
-    if (err < (int)relative.length())
+    else
     {
-      ostringstream os;
-      os << "WorkerComm: currentfile write() returned " << err << " file pointer is "
-         << currentSaveFile.get();
+      string tmp = savefile + (saveFileToggle ? 'A' : 'B');
 
-      if (err < 0)
-        os << " errno: " << strerror(errno);
+      if (slave->saveState(tmp) == 0)
+        lastSaveFile = tmp;
+      else
+        lastSaveFile.clear();
 
-      log(os.str());
+      saveCurrentFile(tmp);
+      incrementalCount = 0;
+      saveFileToggle = !saveFileToggle;
     }
 
-    currentSaveFile->flush();
-
-    currentSaveFile = nullptr;
-    saveFileToggle = !saveFileToggle;
-
-    ;
     journalh.reset(IDBDataFile::open(IDBPolicy::getType(journalName.c_str(), IDBPolicy::WRITEENG),
                                      journalName.c_str(), "w+b", 0));
 
@@ -1978,6 +1981,47 @@ void SlaveComm::do_confirm()
   }
 }
 
+void SlaveComm::saveCurrentFile(const string& prefix)
+{
+  string tmp = savefile + "_current";
+
+  if (!currentSaveFile)
+  {
+    currentSaveFile.reset(
+        IDBDataFile::open(IDBPolicy::getType(tmp.c_str(), IDBPolicy::WRITEENG), tmp.c_str(), "wb", 0));
+  }
+
+  if (currentSaveFile == NULL)
+  {
+    ostringstream os;
+    os << "WorkerComm: failed to open the current savefile. errno: " << strerror(errno);
+    log(os.str());
+    throw runtime_error(os.str());
+  }
+
+  tmp = prefix + '\n';
+  int err = 0;
+
+  // MCOL-1558.  Make the _current file relative to DBRMRoot.
+  string relative = tmp.substr(tmp.find_last_of('/') + 1);
+  err = currentSaveFile->write(relative.c_str(), relative.length());
+
+  if (err < (int)relative.length())
+  {
+    ostringstream os;
+    os << "WorkerComm: currentfile write() returned " << err << " file pointer is " << currentSaveFile.get();
+
+    if (err < 0)
+      os << " errno: " << strerror(errno);
+
+    log(os.str());
+  }
+
+  currentSaveFile->flush();
+
+  currentSaveFile = nullptr;
+}
+
 void SlaveComm::do_flushInodeCache()
 {
   ByteStream reply;
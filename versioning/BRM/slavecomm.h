@@ -112,6 +112,7 @@ class SlaveComm
   void do_ownerCheck(messageqcpp::ByteStream& msg);
   void do_takeSnapshot();
   void saveDelta();
+  void saveCurrentFile(const std::string& prefix);
   bool processExists(const uint32_t pid, const std::string& pname);
 
   std::unique_ptr<messageqcpp::MessageQueueServer> server;
@@ -124,6 +125,9 @@ class SlaveComm
   std::string journalName;
   std::unique_ptr<idbdatafile::IDBDataFile> journalh;
   int64_t snapshotInterval, journalCount;
+  // The number of incremental snapshots b/w the full ones and the prefix of the last full one.
+  int64_t incrementalSnapshots, incrementalCount;
+  std::string lastSaveFile;
   struct timespec MSG_TIMEOUT;
 };
 
@@ -45,6 +45,7 @@
 #include "errorcodes.h"
 #include "idberrorinfo.h"
 #include "cacheutils.h"
+#include "IDBPolicy.h"
 using namespace std;
 using namespace logging;
 
@@ -1054,6 +1055,63 @@ int SlaveDBRMNode::saveState(string filename) throw()
   return 0;
 }
 
+int SlaveDBRMNode::saveStateIncremental(string filename) throw()
+{
+  string emFilename = filename + "_em";
+  string vssFilename = filename + "_vss";
+  string vbbmFilename = filename + "_vbbm";
+  string vssTmpFilename = vssFilename + "_tmp";
+  string vbbmTmpFilename = vbbmFilename + "_tmp";
+  bool locked[2] = {false, false};
+  int rc = 0;
+
+  try
+  {
+    vbbm.lock(VBBM::READ);
+    locked[0] = true;
+    vss.lock(VSS::READ);
+    locked[1] = true;
+
+    // The EM checkpoint is the commit point, the VSS and VBBM images of filename
+    // are replaced only after it.
+    vbbm.save(vbbmTmpFilename);
+    vss.save(vssTmpFilename);
+
+    if (em.saveDelta(emFilename))
+    {
+      if (idbdatafile::IDBPolicy::rename(vbbmTmpFilename.c_str(), vbbmFilename.c_str()) != 0 ||
+          idbdatafile::IDBPolicy::rename(vssTmpFilename.c_str(), vssFilename.c_str()) != 0)
+      {
+        log("SlaveDBRMNode::saveStateIncremental(): failed to rename the VSS/VBBM images");
+        rc = -1;
+      }
+    }
+    else
+    {
+      idbdatafile::IDBPolicy::remove(vbbmTmpFilename.c_str());
+      idbdatafile::IDBPolicy::remove(vssTmpFilename.c_str());
+      rc = 1;
+    }
+
+    vss.release(VSS::READ);
+    locked[1] = false;
+    vbbm.release(VBBM::READ);
+    locked[0] = false;
+  }
+  catch (exception& e)
+  {
+    if (locked[1])
+      vss.release(VSS::READ);
+
+    if (locked[0])
+      vbbm.release(VBBM::READ);
+
+    return -1;
+  }
+
+  return rc;
+}
+
 int SlaveDBRMNode::loadState(string filename) throw()
 {
   string emFilename = filename + "_em";
@@ -455,6 +455,13 @@ class SlaveDBRMNode
   EXPORT int loadState(std::string filename) throw();
   EXPORT int saveState(std::string filename) throw();
 
+  /** @brief Checkpoints the BRM state over the image saveState() wrote to filename
+   *
+   * Appends the changed extents to the EM delta file and rewrites the VSS and VBBM images.
+   * @return 0 on success, 1 if a full saveState() is needed, -1 on error.
+   */
+  EXPORT int saveStateIncremental(std::string filename) throw();
+
   EXPORT const std::atomic<bool>* getEMFLLockStatus();
   EXPORT const std::atomic<bool>* getEMLockStatus();
   EXPORT const std::atomic<bool>* getEMIndexLockStatus();
@@ -69,6 +69,14 @@ void BRMReporter::addToHWMInfo(const BRM::BulkSetHWMArg& hwmEntry)
   fHWMInfo.push_back(hwmEntry);
 }
 
+//------------------------------------------------------------------------------
+// Add the rows of an aggregate projection to "this" BRMReporter's collection
+//------------------------------------------------------------------------------
+void BRMReporter::addToProjectionInfo(const std::string& projTable, const std::string& fileName)
+{
+  fProjectionInfo.push_back(std::make_pair(projTable, fileName));
+}
+
 //------------------------------------------------------------------------------
 // Add Column File infomation to "this" BRMReporter's collection
 //------------------------------------------------------------------------------
@@ -206,6 +214,7 @@ int BRMReporter::sendBRMInfo(const std::string& rptFileName, const std::vector<s
 
     sendCPToFile();
     sendHWMToFile();
+    sendProjectionsToFile();
 
     // Log the list of *.err and *.bad files
     for (unsigned k = 0; k < errFiles.size(); k++)
@@ -313,6 +322,31 @@ void BRMReporter::sendCPToFile()
   }
 }
 
+//------------------------------------------------------------------------------
+// Save the rows of the aggregate projections to a file, for the front end to
+// load into the projections once the import is committed
+//------------------------------------------------------------------------------
+void BRMReporter::sendProjectionsToFile()
+{
+  for (unsigned int i = 0; i < fProjectionInfo.size(); i++)
+  {
+    std::ifstream rows(fProjectionInfo[i].second.c_str());
+    std::string row;
+    uint64_t rowCount = 0;
+
+    while (std::getline(rows, row))
+    {
+      fRptFile << "AGG: " << fProjectionInfo[i].first << ' ' << row << '\n';
+      rowCount++;
+    }
+
+    std::ostringstream oss;
+    oss << "Writing " << rowCount << " rows of aggregate projection " << fProjectionInfo[i].first
+        << " to report file " << fRptFileName;
+    fLog->logMsg(oss.str(), MSGLVL_INFO2);
+  }
+}
+
 //------------------------------------------------------------------------------
 // Report Summary totals; only applicable if we are generating a report file.
 //------------------------------------------------------------------------------
@@ -398,6 +432,7 @@ int BRMReporter::openRptFile()
   fRptFile << "#ERR:  error message file" << std::endl;
   fRptFile << "#BAD:  bad data file, with rejected rows" << std::endl;
   fRptFile << "#MERR: critical error messages in cpimport.bin" << std::endl;
+  fRptFile << "#AGG:  aggregate projection table and row" << std::endl;
 
   return NO_ERROR;
 }
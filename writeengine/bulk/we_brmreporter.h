@@ -77,6 +77,12 @@ class BRMReporter
    */
   void addToDctnryFileInfo(const BRM::FileInfo& fileEntry);
 
+  /** @brief Add the rows of an aggregate projection to the report file
+   *  @param projTable Schema and name of the projection table
+   *  @param fileName File with the rows, as ProjectionAggregator wrote them
+   */
+  void addToProjectionInfo(const std::string& projTable, const std::string& fileName);
+
   /** @brief Add a ErrMsg entry to the output list
    *  @param Critical Error Message
    */
@@ -123,6 +129,7 @@ class BRMReporter
   int sendHWMandCPToBRM();  // send HWM and CP updates to BRM
   void sendHWMToFile();     // save HWM updates to a report file
   void sendCPToFile();      // save CP  updates to a report file
+  void sendProjectionsToFile();  // save aggregate projection rows to a report file
   int openRptFile();        // open BRM Report file
   void closeRptFile();      // close BRM Report file
 
@@ -135,6 +142,7 @@ class BRMReporter
   std::ofstream fRptFile;                      // BRM report file that is generated
   std::vector<BRM::FileInfo> fFileInfo;        // Column files to flush from FDcache
   std::vector<BRM::FileInfo> fDctnryFileInfo;  // Dct files to flush from FDcache
+  std::vector<std::pair<std::string, std::string> > fProjectionInfo;  // Projection table, row file
 };
 
 }  // namespace WriteEngine
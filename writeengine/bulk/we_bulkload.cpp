@@ -25,6 +25,7 @@
 #include "we_bulkload.h"
 #undef WE_BULKLOAD_DLLEXPORT
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <climits>
@@ -39,6 +40,7 @@
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <pwd.h>
+#include <sys/wait.h>
 
 #include "we_bulkstatus.h"
 #include "we_rbmetawriter.h"
@@ -54,6 +56,8 @@
 #include "calpontsystemcatalog.h"
 #include "we_ddlcommandclient.h"
 #include "mcsconfig.h"
+#include "installdir.h"
+#include "aggregateprojection.h"
 
 using namespace std;
 using namespace boost;
@@ -65,6 +69,9 @@ const std::string IMPORT_PATH_STDIN("STDIN");
 const std::string IMPORT_PATH_CWD(".");
 const std::string LOG_SUFFIX = ".log";      // Job log file suffix
 const std::string ERR_LOG_SUFFIX = ".err";  // Job err log file suffix
+
+// Largest read buffer a table with a sort key gets (it's an int)
+const uint64_t MAX_SORT_READ_BUFFER_SIZE = 1024 * 1024 * 1024;
 }  // namespace
 
 // extern WriteEngine::BRMWrapper* brmWrapperPtr;
@@ -708,6 +715,14 @@ int BulkLoad::preProcess(Job& job, int tableNo, TableInfo* tableInfo)
     return rc;
   }
 
+  std::vector<int> indexTypes;
+  rc = preProcessColumnIndexes(job, tableNo, indexTypes);
+
+  if (rc != NO_ERROR)
+  {
+    return rc;
+  }
+
   //--------------------------------------------------------------------------
   // Third loop thru the columns for the "tableNo" table in jobTableList[].
   // In this pass through the columns we create the ColumnInfo object,
@@ -741,6 +756,9 @@ int BulkLoad::preProcess(Job& job, int tableNo, TableInfo* tableInfo)
     if (pwd)
       info->setUIDGID(pwd->pw_uid, pwd->pw_gid);
 
+    if (indexTypes[i] != execplan::CalpontSystemCatalog::NO_COLUMN_INDEX)
+      info->setIndexType(indexTypes[i]);
+
     // For auto increment column, we need to get the starting value
     if (info->column.autoIncFlag)
     {
@@ -835,16 +853,340 @@ int BulkLoad::preProcess(Job& job, int tableNo, TableInfo* tableInfo)
     fLog.logMsg(oss12.str(), MSGLVL_INFO2);
   }
 
+  preProcessSortKey(job, tableNo, tableInfo);
+
   // Initialize BulkLoadBuffers after we have added all the columns
   rc = tableInfo->initializeBuffers(fNoOfBuffers, job.jobTableList[tableNo].fFldRefs, fixedBinaryRecLen);
   if (rc)
     return rc;
 
+  rc = preProcessProjections(job, tableNo, tableInfo);
+  if (rc)
+    return rc;
+
   fTableInfo.push_back(tableInfo);
 
   return NO_ERROR;
 }
 
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    Looks up which columns of the specified table have an inverted index or
+//    bloom filters, to add the rows loaded to.  Unlike the sort key this is no
+//    optimization that can be skipped: an index that misses rows gives wrong
+//    query results.
+// PARAMETERS:
+//    job - current job
+//    tableNo - table number of current job
+//    indexTypes - (out) the ColumnIndexType bits of each column of the job table
+// RETURN:
+//    NO_ERROR if success
+//    other if fail
+//------------------------------------------------------------------------------
+int BulkLoad::preProcessColumnIndexes(Job& job, int tableNo, std::vector<int>& indexTypes)
+{
+  const std::vector<JobColumn>& colList = job.jobTableList[tableNo].colList;
+  indexTypes.assign(colList.size(), execplan::CalpontSystemCatalog::NO_COLUMN_INDEX);
+
+  try
+  {
+    boost::shared_ptr<execplan::CalpontSystemCatalog> cat =
+        execplan::CalpontSystemCatalog::makeCalpontSystemCatalog(BULK_SYSCAT_SESSION_ID);
+
+    for (unsigned i = 0; i < colList.size(); i++)
+    {
+      execplan::CalpontSystemCatalog::ColType colType = cat->colType(colList[i].mapOid);
+
+      if (ColumnIndex::isIndexable(colList[i].dataType, colList[i].width, colType.charsetNumber))
+      {
+        indexTypes[i] = colType.indexType & (execplan::CalpontSystemCatalog::INVERTED_INDEX |
+                                             execplan::CalpontSystemCatalog::BLOOM_FILTER);
+      }
+    }
+  }
+  catch (std::exception& ex)
+  {
+    int rc = ERR_TBL_SYSCAT_ERROR;
+    std::ostringstream oss;
+    oss << "Error getting column indexes of table " << job.jobTableList[tableNo].tblName
+        << " due to:  " << ex.what();
+    fLog.logMsg(oss.str(), rc, MSGLVL_ERROR);
+    return rc;
+  }
+
+  return NO_ERROR;
+}
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    Looks up the sort key of the specified table.  If it has one, the rows of
+//    each read buffer are sorted on it before they are parsed, and the read
+//    buffers are enlarged to share the sort buffer memory, so the extents get
+//    narrow casual partitioning ranges on the key.  Columns filled in by
+//    cpimport itself are left out of the key.
+// PARAMETERS:
+//    job - current job
+//    tableNo - table number of current job
+//    tableInfo - TableInfo object corresponding to tableNo table.
+//------------------------------------------------------------------------------
+void BulkLoad::preProcessSortKey(Job& job, int tableNo, TableInfo* tableInfo)
+{
+  const std::vector<JobColumn>& colList = job.jobTableList[tableNo].colList;
+  std::vector<std::pair<int32_t, unsigned> > keyPositions;
+
+  try
+  {
+    boost::shared_ptr<execplan::CalpontSystemCatalog> cat =
+        execplan::CalpontSystemCatalog::makeCalpontSystemCatalog(BULK_SYSCAT_SESSION_ID);
+
+    for (unsigned i = 0; i < colList.size(); i++)
+    {
+      int32_t position = cat->colType(colList[i].mapOid).sortKeyPosition;
+
+      if (position > 0 && !colList[i].autoIncFlag && !colList[i].fWithDefault)
+        keyPositions.push_back(std::make_pair(position, i));
+    }
+  }
+  catch (std::exception& ex)
+  {
+    std::ostringstream oss;
+    oss << "Sort key of table " << job.jobTableList[tableNo].tblName << " not looked up; rows are "
+        << "loaded in input order; " << ex.what();
+    fLog.logMsg(oss.str(), MSGLVL_WARNING);
+    return;
+  }
+
+  if (keyPositions.empty())
+    return;
+
+  if (fImportDataMode != IMPORT_DATA_TEXT)
+  {
+    std::ostringstream oss;
+    oss << "Table " << job.jobTableList[tableNo].tblName << " has a sort key, but only a text import "
+        << "sorts rows; rows are loaded in input order";
+    fLog.logMsg(oss.str(), MSGLVL_WARNING);
+    return;
+  }
+
+  std::sort(keyPositions.begin(), keyPositions.end());
+  std::vector<unsigned> sortKey;
+
+  for (unsigned k = 0; k < keyPositions.size(); k++)
+    sortKey.push_back(keyPositions[k].second);
+
+  tableInfo->setSortKey(sortKey);
+
+  uint64_t bufferSize = Config::getSortBufferSize() / (fNoOfBuffers > 0 ? fNoOfBuffers : 1);
+
+  if (bufferSize > MAX_SORT_READ_BUFFER_SIZE)
+    bufferSize = MAX_SORT_READ_BUFFER_SIZE;
+
+  if (bufferSize > (uint64_t)fBufferSize)
+    tableInfo->setBufferSize(bufferSize);
+
+  std::ostringstream oss;
+  oss << "Rows of table " << job.jobTableList[tableNo].tblName << " will be sorted on " << sortKey.size()
+      << " column(s) in runs of up to " << std::max(bufferSize, (uint64_t)fBufferSize) << " bytes";
+  fLog.logMsg(oss.str(), MSGLVL_INFO2);
+}
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    Sets up the aggregate projections of the specified table (see
+//    execplan::AggregateProjection) to be maintained with this import.  A
+//    projection that can't be maintained is marked stale before anything is
+//    loaded, so queries stop using it; the import itself goes on.  A stale
+//    projection is left alone until it's rebuilt.
+// PARAMETERS:
+//    job - current job
+//    tableNo - table number of current job
+//    tableInfo - TableInfo object corresponding to tableNo table.
+// RETURN:
+//    NO_ERROR if success
+//    other if a stale projection can't be marked
+//------------------------------------------------------------------------------
+int BulkLoad::preProcessProjections(Job& job, int tableNo, TableInfo* tableInfo)
+{
+  const std::string& fullTableName = job.jobTableList[tableNo].tblName;
+  execplan::CalpontSystemCatalog::TableName table(job.schema,
+                                                  fullTableName.substr(fullTableName.rfind('.') + 1));
+  std::vector<execplan::AggregateProjection> projections;
+  std::vector<std::string> errors;
+
+  try
+  {
+    boost::shared_ptr<execplan::CalpontSystemCatalog> cat =
+        execplan::CalpontSystemCatalog::makeCalpontSystemCatalog(BULK_SYSCAT_SESSION_ID);
+    projections = execplan::AggregateProjection::find(cat.get(), table, &errors);
+  }
+  catch (std::exception& ex)
+  {
+    std::ostringstream oss;
+    oss << "Aggregate projections of table " << table << " not looked up; they are stale and must be "
+        << "rebuilt; " << ex.what();
+    fLog.logMsg(oss.str(), MSGLVL_WARNING);
+
+    return markProjectionsStale(table, job.jobTableList[tableNo].mapOid);
+  }
+
+  for (unsigned k = 0; k < errors.size(); k++)
+  {
+    fLog.logMsg("Aggregate projection ignored: " + errors[k], MSGLVL_WARNING);
+  }
+
+  for (unsigned k = 0; k < projections.size(); k++)
+  {
+    const execplan::CalpontSystemCatalog::TableName& projTable = projections[k].table;
+
+    if (projections[k].isStale())
+    {
+      std::ostringstream oss;
+      oss << "Aggregate projection " << projTable << " is stale and won't be maintained until it's rebuilt";
+      fLog.logMsg(oss.str(), MSGLVL_INFO2);
+      continue;
+    }
+
+    std::string errMsg = "it can only be maintained by a text import";
+    ProjectionAggregator* aggregator = 0;
+
+    if (fImportDataMode == IMPORT_DATA_TEXT)
+    {
+      std::ostringstream fileName;
+      fileName << startup::StartUp::tmpDir() << '/' << projTable << '_' << getpid() << ".agg";
+      aggregator = ProjectionAggregator::create(projections[k], job.jobTableList[tableNo].colList,
+                                                fileName.str(), errMsg);
+    }
+
+    if (aggregator)
+    {
+      tableInfo->addProjection(aggregator);
+
+      std::ostringstream oss;
+      oss << "Aggregate projection " << projTable << " will be maintained";
+      fLog.logMsg(oss.str(), MSGLVL_INFO2);
+    }
+    else
+    {
+      std::ostringstream oss;
+      oss << "Aggregate projection " << projTable << " is stale and must be rebuilt; " << errMsg;
+      fLog.logMsg(oss.str(), MSGLVL_WARNING);
+
+      int rc = markProjectionsStale(projTable, projections[k].tableOid);
+
+      if (rc != NO_ERROR)
+        return rc;
+    }
+  }
+
+  return NO_ERROR;
+}
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    Marks an aggregate projection stale, or all the projections of a base
+//    table (see execplan::AggregateProjection::markStale()).
+// PARAMETERS:
+//    table - the projection or the base table, for the log
+//    tableOid - its OID
+// RETURN:
+//    NO_ERROR if success
+//    ERR_FILE_CREATE if the marker can't be written
+//------------------------------------------------------------------------------
+int BulkLoad::markProjectionsStale(const execplan::CalpontSystemCatalog::TableName& table,
+                                   execplan::CalpontSystemCatalog::OID tableOid)
+{
+  try
+  {
+    execplan::AggregateProjection::markStale(tableOid);
+  }
+  catch (std::exception& ex)
+  {
+    int rc = ERR_FILE_CREATE;
+    std::ostringstream oss;
+    oss << "Error marking the aggregate projections of " << table << " stale due to:  " << ex.what();
+    fLog.logMsg(oss.str(), rc, MSGLVL_ERROR);
+    return rc;
+  }
+
+  return NO_ERROR;
+}
+
+//------------------------------------------------------------------------------
+// DESCRIPTION:
+//    In mode 3, loads the rows aggregated for the projections of each table
+//    that was loaded, by running cpimport.bin on them.  The import of the
+//    table is committed by now; a projection that fails to load is stale.
+//    A table that is itself a projection is populated now, so it's current
+//    (see execplan::AggregateProjection::loaded()).
+//------------------------------------------------------------------------------
+void BulkLoad::loadProjections()
+{
+  for (unsigned i = 0; i < fTableInfo.size(); i++)
+  {
+    if (fTableInfo[i].getStatusTI() != WriteEngine::PARSE_COMPLETE)
+      continue;
+
+    std::string tableName = fTableInfo[i].getTableName();
+    std::string::size_type pos = tableName.find('.');
+
+    try
+    {
+      execplan::AggregateProjection::loaded(
+          execplan::CalpontSystemCatalog::TableName(tableName.substr(0, pos), tableName.substr(pos + 1)),
+          fTableInfo[i].getTableOID());
+    }
+    catch (std::exception& ex)
+    {
+      std::ostringstream oss;
+      oss << "Aggregate projection " << tableName << " is still stale; " << ex.what();
+      fLog.logMsg(oss.str(), MSGLVL_WARNING);
+    }
+
+    boost::ptr_vector<ProjectionAggregator>& projections = fTableInfo[i].getProjections();
+
+    for (unsigned k = 0; k < projections.size(); k++)
+    {
+      if (!projections[k].isFinished())
+        continue;
+
+      const execplan::CalpontSystemCatalog::TableName& projTable = projections[k].projection().table;
+      std::vector<std::string> args{"cpimport.bin", "-s", "|", "-E", "\"", "-C", "\\", "-e", "0",
+                                    projTable.schema, projTable.table, projections[k].fileName()};
+      std::vector<char*> argv;
+
+      for (unsigned j = 0; j < args.size(); j++)
+        argv.push_back(const_cast<char*>(args[j].c_str()));
+
+      argv.push_back(0);
+
+      std::ostringstream oss;
+      oss << "Loading " << projections[k].rowCount() << " rows into aggregate projection " << projTable;
+      fLog.logMsg(oss.str(), MSGLVL_INFO1);
+
+      int status = -1;
+      pid_t pid = fork();
+
+      if (pid == 0)
+      {
+        execv("/proc/self/exe", &argv[0]);
+        _exit(127);
+      }
+
+      if (pid > 0)
+        waitpid(pid, &status, 0);
+
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      {
+        std::ostringstream ossErr;
+        ossErr << "Loading aggregate projection " << projTable << " failed; it is stale and must be "
+               << "rebuilt";
+        fLog.logMsg(ossErr.str(), MSGLVL_WARNING);
+        markProjectionsStale(projTable, projections[k].projection().tableOid);
+      }
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 // DESCRIPTION:
 //    Saves snapshot of extentmap into a bulk rollback meta data file, for
@@ -1177,6 +1519,9 @@ int BulkLoad::processJob()
   if ((fBulkMode != BULK_MODE_REMOTE_SINGLE_SRC) && (fBulkMode != BULK_MODE_REMOTE_MULTIPLE_SRC))
   {
     BRMWrapper::getInstance()->takeSnapshot();
+
+    // In modes 1 and 2 the front end loads the projections after its commit
+    loadProjections();
   }
 
   stopTimer();
@@ -274,6 +274,20 @@ class BulkLoad : public FileOp
   int preProcessAutoInc(const std::string& fullTableName,  // schema.table
                         ColumnInfo* colInfo);              // ColumnInfo associated with AI column
 
+  // Set up the aggregate projections of a table to maintain with this import
+  int preProcessProjections(Job& job, int tableNo, TableInfo* tableInfo);
+  int markProjectionsStale(const execplan::CalpontSystemCatalog::TableName& table,
+                           execplan::CalpontSystemCatalog::OID tableOid);
+
+  // Set up sorting the rows of a table on its sort key
+  void preProcessSortKey(Job& job, int tableNo, TableInfo* tableInfo);
+
+  // Set up adding the rows loaded to the inverted indexes and bloom filters of a table
+  int preProcessColumnIndexes(Job& job, int tableNo, std::vector<int>& indexTypes);
+
+  // Load the rows aggregated for the projections of the tables loaded (mode 3)
+  void loadProjections();
+
   // Determine starting HWM and LBID after block skipping added to HWM
   int preProcessHwmLbid(const ColumnInfo* info, int minWidth, uint32_t partition, uint16_t segment, HWM& hwm,
                         BRM::LBID_t& lbid, bool& bSkippedToNewExtent);
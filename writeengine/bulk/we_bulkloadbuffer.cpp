@@ -30,12 +30,18 @@
 #include <cmath>
 #include <ctype.h>
 #include <cfloat>
+#include <algorithm>
+#include <vector>
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#endif
 
 #include "we_bulkload.h"
 #include "we_bulkloadbuffer.h"
 #include "we_brm.h"
 #include "we_convertor.h"
 #include "we_log.h"
+#include "we_projectionaggregator.h"
 #include "brmtypes.h"
 #include "dataconvert.h"
 #include "exceptclasses.h"
@@ -89,6 +95,92 @@ inline void resizeRowDataArray(char** pRowData, unsigned int dataLength, unsigne
   *pRowData = tmpRaw;
 }
 
+//------------------------------------------------------------------------------
+// Append "length" bytes to pRowData, growing the array as needed
+//------------------------------------------------------------------------------
+inline void appendRowData(char** pRowData, unsigned int& dataLength, unsigned int& arrayCapacity,
+                          const char* data, unsigned int length)
+{
+  if (dataLength + length > arrayCapacity)
+  {
+    unsigned int newArrayCapacity = arrayCapacity * 2;
+
+    while (dataLength + length > newArrayCapacity)
+      newArrayCapacity *= 2;
+
+    resizeRowDataArray(pRowData, dataLength, newArrayCapacity);
+    arrayCapacity = newArrayCapacity;
+  }
+
+  memcpy(*pRowData + dataLength, data, length);
+  dataLength += length;
+}
+
+//------------------------------------------------------------------------------
+// Return a pointer to the first byte in [p, end) that is equal to "a" or "b",
+// or end if there is none.  Compares 16 bytes at a time where SSE2 is
+// available; tokenize() uses this to skip over the body of a field.
+//------------------------------------------------------------------------------
+inline const char* findEitherChar(const char* p, const char* end, char a, char b)
+{
+#if defined(__x86_64__)
+  const __m128i va = _mm_set1_epi8(a);
+  const __m128i vb = _mm_set1_epi8(b);
+
+  while (end - p >= 16)
+  {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    unsigned int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)));
+
+    if (mask)
+      return p + __builtin_ctz(mask);
+
+    p += 16;
+  }
+#endif
+
+  while ((p < end) && (*p != a) && (*p != b))
+    p++;
+
+  return p;
+}
+
+//------------------------------------------------------------------------------
+// Parse a field consisting of an optional sign followed by at most 18 digits.
+// Anything else (blanks, "true", decimal points, overflow candidates...) is
+// left to the general purpose strtol() based code in convert().
+//------------------------------------------------------------------------------
+inline bool parsePlainInt(const char* field, int fieldLength, int64_t& value)
+{
+  const char* p = field;
+  const char* end = field + fieldLength;
+  bool bNegative = false;
+
+  if ((*p == '-') || (*p == '+'))
+  {
+    bNegative = (*p == '-');
+    p++;
+  }
+
+  if ((p == end) || (end - p > 18))
+    return false;
+
+  int64_t val = 0;
+
+  for (; p < end; p++)
+  {
+    unsigned int digit = static_cast<unsigned char>(*p) - '0';
+
+    if (digit > 9)
+      return false;
+
+    val = val * 10 + digit;
+  }
+
+  value = bNegative ? -val : val;
+  return true;
+}
+
 }  // namespace
 
 // #define DEBUG_TOKEN_PARSING 1
@@ -1546,6 +1638,104 @@ void BulkLoadBuffer::convert(char* field, int fieldLength, bool nullFlag, unsign
   memcpy(output, pVal, width);
 }
 
+//------------------------------------------------------------------------------
+// Plain signed integer columns imported from text are by far the most common
+// non-dictionary columns, so parseCol() handles their typical values with
+// convertTextInt() and only sends the odd field through convert().
+//------------------------------------------------------------------------------
+bool BulkLoadBuffer::isTextIntColumn(const JobColumn& column) const
+{
+  if (fImportDataMode != IMPORT_DATA_TEXT)
+    return false;
+
+  switch (column.weType)
+  {
+    case WriteEngine::WR_BYTE:
+    case WriteEngine::WR_SHORT:
+    case WriteEngine::WR_MEDINT:
+    case WriteEngine::WR_INT:
+    case WriteEngine::WR_LONGLONG: break;
+
+    default: return false;
+  }
+
+  switch (column.dataType)
+  {
+    case CalpontSystemCatalog::TINYINT:
+    case CalpontSystemCatalog::SMALLINT:
+    case CalpontSystemCatalog::MEDINT:
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::BIGINT: return true;
+
+    default: return false;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Convert a non-null integer text field in place, with the same saturation and
+// min/max bookkeeping as convert().  Returns false without touching output or
+// bufStats if the field is not a plain integer.
+//------------------------------------------------------------------------------
+bool BulkLoadBuffer::convertTextInt(const char* field, int fieldLength, unsigned char* output,
+                                    const JobColumn& column, BLBufferStats& bufStats)
+{
+  int64_t origVal;
+
+  if (!parsePlainInt(field, fieldLength, origVal))
+    return false;
+
+  // Saturate the value
+  if (origVal < column.fMinIntSat)
+  {
+    origVal = column.fMinIntSat;
+    bufStats.satCount++;
+  }
+  else if (origVal > static_cast<int64_t>(column.fMaxIntSat))
+  {
+    origVal = static_cast<int64_t>(column.fMaxIntSat);
+    bufStats.satCount++;
+  }
+
+  // Update min/max range
+  if (origVal < bufStats.minBufferVal)
+    bufStats.minBufferVal = origVal;
+
+  if (origVal > bufStats.maxBufferVal)
+    bufStats.maxBufferVal = origVal;
+
+  switch (column.width)
+  {
+    case 1:
+    {
+      int8_t val = origVal;
+      memcpy(output, &val, sizeof(val));
+      break;
+    }
+
+    case 2:
+    {
+      int16_t val = origVal;
+      memcpy(output, &val, sizeof(val));
+      break;
+    }
+
+    case 4:
+    {
+      int32_t val = origVal;
+      memcpy(output, &val, sizeof(val));
+      break;
+    }
+
+    default:
+    {
+      memcpy(output, &origVal, sizeof(origVal));
+      break;
+    }
+  }
+
+  return true;
+}
+
 //------------------------------------------------------------------------------
 // Parse the contents of the Read buffer based on whether it is a dictionary
 // column or not.
@@ -1572,6 +1762,7 @@ int BulkLoadBuffer::parse(ColumnInfo& columnInfo)
     else
     {
       fParquetBatchParser = fParquetBatch;
+      fParquetBatchStatsParser = fParquetBatchStats;
     }
 
     fStartRowForLoggingParser = fStartRowForLogging;
@@ -1670,7 +1861,7 @@ int BulkLoadBuffer::parseColParquet(ColumnInfo& columnInfo)
     // not aux column
     if (isNonAuxColumn)
     {
-      columnData = fParquetBatch->column(columnId);
+      columnData = fParquetBatchParser->column(columnId);
     }
     else  // aux column
     {
@@ -1691,8 +1882,19 @@ int BulkLoadBuffer::parseColParquet(ColumnInfo& columnInfo)
       }
     }
 
-    convertParquet(columnData, buf, columnInfo.column, bufStats, lastInputRowInExtent, columnInfo,
-                   updateCPInfoPendingFlag, section);
+    // The direct copy only works if the batch stays within one extent,
+    // since CP min/max is kept per extent.
+    if (isNonAuxColumn && (nullCount == 0) &&
+        (fStartRowParser + fTotalReadRowsParser - 1 <= lastInputRowInExtent) &&
+        copyParquetIntColumn(columnId, columnData, buf, columnInfo.column, bufStats))
+    {
+      updateCPInfoPendingFlag = true;
+    }
+    else
+    {
+      convertParquet(columnData, buf, columnInfo.column, bufStats, lastInputRowInExtent, columnInfo,
+                     updateCPInfoPendingFlag, section);
+    }
 
     if (updateCPInfoPendingFlag)
     {
@@ -1754,6 +1956,97 @@ int BulkLoadBuffer::parseColParquet(ColumnInfo& columnInfo)
   return rc;
 }
 
+//------------------------------------------------------------------------------
+// Combine the footer statistics of every row group that overlaps the rows of
+// the batch being parsed.  The result may be wider than the batch's actual
+// range when the batch only covers part of a row group, which is fine for CP.
+//------------------------------------------------------------------------------
+bool BulkLoadBuffer::getParquetBatchMinMax(unsigned columnId, int64_t& minVal, int64_t& maxVal) const
+{
+  if (!fParquetBatchStatsParser || columnId >= fParquetBatchStatsParser->size())
+    return false;
+
+  const int64_t firstRow = fStartRowForLoggingParser;
+  const int64_t lastRow = firstRow + fTotalReadRowsParser - 1;
+  bool bFound = false;
+
+  for (const ParquetChunkStats& chunk : (*fParquetBatchStatsParser)[columnId])
+  {
+    if ((chunk.firstRow + chunk.numRows <= firstRow) || (chunk.firstRow > lastRow))
+      continue;
+
+    if (!chunk.hasMinMax)
+      return false;
+
+    if (!bFound)
+    {
+      minVal = chunk.minVal;
+      maxVal = chunk.maxVal;
+      bFound = true;
+    }
+    else
+    {
+      minVal = std::min(minVal, chunk.minVal);
+      maxVal = std::max(maxVal, chunk.maxVal);
+    }
+  }
+
+  return bFound;
+}
+
+//------------------------------------------------------------------------------
+// Signed integer columns without nulls whose Parquet statistics show that no
+// value can saturate are stored exactly as Arrow holds them, so the batch can
+// be copied as is instead of converting one value at a time.
+//------------------------------------------------------------------------------
+bool BulkLoadBuffer::copyParquetIntColumn(unsigned columnId, std::shared_ptr<arrow::Array> columnData,
+                                          unsigned char* buf, const JobColumn& column,
+                                          BLBufferStats& bufStats)
+{
+  switch (column.dataType)
+  {
+    case CalpontSystemCatalog::TINYINT:
+    case CalpontSystemCatalog::SMALLINT:
+    case CalpontSystemCatalog::MEDINT:
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::BIGINT: break;
+
+    default: return false;
+  }
+
+  int arrowWidth;
+
+  switch (columnData->type_id())
+  {
+    case arrow::Type::type::INT8: arrowWidth = 1; break;
+    case arrow::Type::type::INT16: arrowWidth = 2; break;
+    case arrow::Type::type::INT32: arrowWidth = 4; break;
+    case arrow::Type::type::INT64: arrowWidth = 8; break;
+    default: return false;
+  }
+
+  if (arrowWidth != column.width)
+    return false;
+
+  int64_t minVal;
+  int64_t maxVal;
+
+  if (!getParquetBatchMinMax(columnId, minVal, maxVal))
+    return false;
+
+  // Saturation range also excludes the NULL and empty row markers
+  if ((minVal < column.fMinIntSat) || (maxVal > static_cast<int64_t>(column.fMaxIntSat)))
+    return false;
+
+  const uint8_t* dataPtr = columnData->data()->GetValues<uint8_t>(1, columnData->offset() * arrowWidth);
+  memcpy(buf, dataPtr, fTotalReadRowsParser * arrowWidth);
+
+  bufStats.minBufferVal = minVal;
+  bufStats.maxBufferVal = maxVal;
+
+  return true;
+}
+
 //-----------------------------------------------------------------------------------
 // Convert arrow/parquet column data
 // columnData                          (in) - the input column data of one batch
@@ -3142,6 +3435,145 @@ inline void BulkLoadBuffer::updateCPMinMax(ColumnInfo& columnInfo, RID& lastInpu
   }
 }
 
+//------------------------------------------------------------------------------
+// Add the valid rows just read into the buffer to an aggregate projection.
+// Keys are taken as the text read; the aggregated values are converted the
+// way parseCol() will convert them, so NULLs and defaults count the same.
+//------------------------------------------------------------------------------
+void BulkLoadBuffer::aggregate(ProjectionAggregator& aggregator,
+                               const boost::ptr_vector<ColumnInfo>& columnsInfo)
+{
+  const std::vector<unsigned>& keyColumns = aggregator.keyColumns();
+  const std::vector<unsigned>& valueColumns = aggregator.valueColumns();
+  std::vector<ProjectionAggregator::Value> values(valueColumns.size());
+  std::string key;
+  char* field = new char[MAX_FIELD_SIZE + 1];
+  unsigned char output[datatypes::MAXDECIMALWIDTH];
+
+  for (uint32_t i = 0; i < fTotalReadRows; ++i)
+  {
+    key.clear();
+
+    for (unsigned col : keyColumns)
+      ProjectionAggregator::appendKey(key, fData + fTokens[i][col].start, fTokens[i][col].offset);
+
+    for (unsigned v = 0; v < valueColumns.size(); v++)
+    {
+      const JobColumn& column = columnsInfo[valueColumns[v]].column;
+      const ColPosPair& token = fTokens[i][valueColumns[v]];
+      BLBufferStats bufStats(column.dataType);
+      int tokenLength = (token.offset > 0) ? token.offset : 0;
+
+      memcpy(field, fData + token.start, tokenLength);
+      field[tokenLength] = '\0';
+      convert(field, tokenLength, token.offset <= 0, output, column, bufStats);
+      ProjectionAggregator::decodeValue(output, column, values[v]);
+    }
+
+    aggregator.addRow(key, values.data());
+  }
+
+  delete[] field;
+}
+
+//------------------------------------------------------------------------------
+// Sort the rows read into the buffer on the sort key of the table, so that the
+// extents they go to get narrow casual partitioning ranges on it.  Only the
+// order of the row pointers in fTokens changes.  Character fields are compared
+// as read, in the collation of the column; other fields as converted.  NULLs
+// sort first.
+//------------------------------------------------------------------------------
+void BulkLoadBuffer::sortRows(const std::vector<unsigned>& sortKey,
+                              const boost::ptr_vector<ColumnInfo>& columnsInfo)
+{
+  if (fTotalReadRows < 2)
+    return;
+
+  const unsigned keyCount = sortKey.size();
+  std::vector<ProjectionAggregator::Value> values((size_t)fTotalReadRows * keyCount);
+  std::vector<bool> isChar(keyCount);
+  char* field = new char[MAX_FIELD_SIZE + 1];
+  unsigned char output[datatypes::MAXDECIMALWIDTH];
+
+  for (unsigned k = 0; k < keyCount; k++)
+  {
+    const JobColumn& column = columnsInfo[sortKey[k]].column;
+    isChar[k] = datatypes::isCharType(column.dataType);
+
+    if (isChar[k])
+      continue;
+
+    for (uint32_t i = 0; i < fTotalReadRows; ++i)
+    {
+      const ColPosPair& token = fTokens[i][sortKey[k]];
+      BLBufferStats bufStats(column.dataType);
+      int tokenLength = (token.offset > 0) ? token.offset : 0;
+
+      memcpy(field, fData + token.start, tokenLength);
+      field[tokenLength] = '\0';
+      convert(field, tokenLength, token.offset <= 0, output, column, bufStats);
+      ProjectionAggregator::decodeValue(output, column, values[(size_t)i * keyCount + k]);
+    }
+  }
+
+  delete[] field;
+
+  auto compareField = [&](uint32_t a, uint32_t b, unsigned k) -> int
+  {
+    if (isChar[k])
+    {
+      const JobColumn& column = columnsInfo[sortKey[k]].column;
+      const ColPosPair& tokenA = fTokens[a][sortKey[k]];
+      const ColPosPair& tokenB = fTokens[b][sortKey[k]];
+
+      if (tokenA.offset <= 0 || tokenB.offset <= 0)
+        return (tokenA.offset > 0) - (tokenB.offset > 0);
+
+      if (column.cs && datatypes::typeHasCollation(column.dataType))
+        return column.cs->strnncollsp(fData + tokenA.start, tokenA.offset, fData + tokenB.start,
+                                      tokenB.offset);
+
+      int rc = memcmp(fData + tokenA.start, fData + tokenB.start, std::min(tokenA.offset, tokenB.offset));
+      return rc ? rc : (tokenA.offset > tokenB.offset) - (tokenA.offset < tokenB.offset);
+    }
+
+    const ProjectionAggregator::Value& valueA = values[(size_t)a * keyCount + k];
+    const ProjectionAggregator::Value& valueB = values[(size_t)b * keyCount + k];
+
+    if (valueA.isNull || valueB.isNull)
+      return (!valueA.isNull) - (!valueB.isNull);
+
+    if (valueA.doubleVal != valueB.doubleVal)
+      return valueA.doubleVal < valueB.doubleVal ? -1 : 1;
+
+    return (valueA.intVal > valueB.intVal) - (valueA.intVal < valueB.intVal);
+  };
+
+  std::vector<uint32_t> order(fTotalReadRows);
+
+  for (uint32_t i = 0; i < fTotalReadRows; ++i)
+    order[i] = i;
+
+  std::stable_sort(order.begin(), order.end(),
+                   [&](uint32_t a, uint32_t b)
+                   {
+                     for (unsigned k = 0; k < keyCount; k++)
+                     {
+                       int rc = compareField(a, b, k);
+
+                       if (rc)
+                         return rc < 0;
+                     }
+
+                     return false;
+                   });
+
+  std::vector<ColPosPair*> rows(fTokens, fTokens + fTotalReadRows);
+
+  for (uint32_t i = 0; i < fTotalReadRows; ++i)
+    fTokens[i] = rows[order[i]];
+}
+
 //------------------------------------------------------------------------------
 // Parse nonDictionary column Read buffer.  Parsed row values are added to
 // fColBufferMgr, which stores them into an output buffer before writing them
@@ -3206,28 +3638,39 @@ int BulkLoadBuffer::parseCol(ColumnInfo& columnInfo)
     int tokenLength = 0;
     bool tokenNullFlag = false;
 
+    // Pick the converter once for the whole column rather than per field
+    const bool bTextInt = isTextIntColumn(columnInfo.column);
+
     for (uint32_t i = 0; i < fTotalReadRowsParser; ++i)
     {
       char* p = fDataParser + fTokensParser[i][columnInfo.id].start;
+      unsigned char* output = buf + i * columnInfo.column.width;
 
-      if (fTokensParser[i][columnInfo.id].offset > 0)
+      if (bTextInt && (fTokensParser[i][columnInfo.id].offset > 0) &&
+          convertTextInt(p, fTokensParser[i][columnInfo.id].offset, output, columnInfo.column, bufStats))
       {
-        memcpy(field, p, fTokensParser[i][columnInfo.id].offset);
-        field[fTokensParser[i][columnInfo.id].offset] = '\0';
-        tokenLength = fTokensParser[i][columnInfo.id].offset;
-        tokenNullFlag = false;
+        updateCPInfoPendingFlag = true;
       }
       else
       {
-        field[0] = '\0';
-        tokenLength = 0;
-        tokenNullFlag = true;
-      }
+        if (fTokensParser[i][columnInfo.id].offset > 0)
+        {
+          memcpy(field, p, fTokensParser[i][columnInfo.id].offset);
+          field[fTokensParser[i][columnInfo.id].offset] = '\0';
+          tokenLength = fTokensParser[i][columnInfo.id].offset;
+          tokenNullFlag = false;
+        }
+        else
+        {
+          field[0] = '\0';
+          tokenLength = 0;
+          tokenNullFlag = true;
+        }
 
-      // convert the data into appropriate format and update CP values
-      convert(field, tokenLength, tokenNullFlag, buf + i * columnInfo.column.width, columnInfo.column,
-              bufStats);
-      updateCPInfoPendingFlag = true;
+        // convert the data into appropriate format and update CP values
+        convert(field, tokenLength, tokenNullFlag, output, columnInfo.column, bufStats);
+        updateCPInfoPendingFlag = true;
+      }
 
       // Update CP min/max if this is last row in this extent
       if ((fStartRowParser + i) == lastInputRowInExtent)
@@ -3725,6 +4168,7 @@ int BulkLoadBuffer::fillFromFileParquet(RID& totalReadRows, RID& correctTotalRow
   try
   {
     PARQUET_THROW_NOT_OK(fParquetReader->ReadNext(&fParquetBatch));
+    fParquetBatchStats = fParquetStats;
     fStartRow = correctTotalRows;
     fStartRowForLogging = totalReadRows;
     fTotalReadRows = fParquetBatch->num_rows();
@@ -3968,8 +4412,15 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
         }
         else
         {
-          offset++;
-          p++;
+          // Skip ahead to the end of the field
+          const char* pEnd = findEitherChar(p + 1, pEndOfData, FIELD_DELIM_CHAR, NEWLINE_CHAR);
+          unsigned int nBytes = pEnd - p;
+
+          if (rawDataRowLength > 0)
+            appendRowData(&pRawDataRow, rawDataRowLength, rawDataRowCapacity, p + 1, nBytes - 1);
+
+          offset += nBytes;
+          p += nBytes;
           continue;  // process next byte
         }
 
@@ -4070,7 +4521,7 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
           fieldState = FLD_PARSE_TRAILING_CHAR_STATE;
         }
 
-        else
+        else if (c == ESCAPE_CHAR)
         {
           if (idxTo != idxFrom)
             fData[idxTo] = fData[idxFrom];
@@ -4080,6 +4531,25 @@ void BulkLoadBuffer::tokenize(const boost::ptr_vector<ColumnInfo>& columnsInfo,
           offset++;
         }
 
+        else
+        {
+          // Copy everything up to the next escape or enclosing char
+          const char* pEnd = findEitherChar(p + 1, pEndOfData, ESCAPE_CHAR, STRING_ENCLOSED_CHAR);
+          unsigned int nBytes = pEnd - p;
+
+          if (rawDataRowLength > 0)
+            appendRowData(&pRawDataRow, rawDataRowLength, rawDataRowCapacity, p + 1, nBytes - 1);
+
+          if (idxTo != idxFrom)
+            memmove(fData + idxTo, fData + idxFrom, nBytes);
+
+          idxFrom += nBytes;
+          idxTo += nBytes;
+          offset += nBytes;
+          p += nBytes;
+          continue;  // process next byte
+        }
+
         p++;
         continue;  // process next byte
       }
@@ -34,6 +34,7 @@
 namespace WriteEngine
 {
 class Log;
+class ProjectionAggregator;
 
 // Used to collect stats about a BulkLoadBuffer buffer that is being parsed
 class BLBufferStats
@@ -71,6 +72,19 @@ class BLBufferStats
   }
 };
 
+// Integer min/max taken from the Parquet footer for one column chunk
+struct ParquetChunkStats
+{
+  int64_t firstRow;  // first row of the row group, relative to start of file
+  int64_t numRows;   // rows in the row group
+  bool hasMinMax;    // false if the writer stored no (usable) statistics
+  int64_t minVal;
+  int64_t maxVal;
+};
+
+// Statistics for a whole Parquet file, indexed by [column][row group]
+typedef std::vector<std::vector<ParquetChunkStats> > ParquetFileStats;
+
 class BulkLoadBuffer
 {
  private:
@@ -87,6 +101,9 @@ class BulkLoadBuffer
   std::shared_ptr<arrow::RecordBatch> fParquetBatch;          // Batch of parquet file to be parsed
   std::shared_ptr<arrow::RecordBatch> fParquetBatchParser;    // for temporary use by parser
   std::shared_ptr<::arrow::RecordBatchReader> fParquetReader; // Reader for read batches of parquet data
+  std::shared_ptr<const ParquetFileStats> fParquetStats;       // Footer statistics of the file being read
+  std::shared_ptr<const ParquetFileStats> fParquetBatchStats;  // Footer statistics of fParquetBatch's file
+  std::shared_ptr<const ParquetFileStats> fParquetBatchStatsParser;  // for temporary use by parser
   // Information about the locker and status for each column in this buffer.
   // Note that TableInfo::fSyncUpdatesTI mutex is used to synchronize
   // access to fColumnLocks and fParseComplete from both read and parse
@@ -177,10 +194,35 @@ class BulkLoadBuffer
   void convert(char* field, int fieldLength, bool nullFlag, unsigned char* output, const JobColumn& column,
                BLBufferStats& bufStats);
 
+  /** @brief Returns true if the text import of this column can use convertTextInt()
+   */
+  bool isTextIntColumn(const JobColumn& column) const;
+
+  /** @brief Convert a plain integer text field without going through convert().
+   *  Returns false if the field is not just an optional sign and digits, in
+   *  which case the caller should fall back to convert().
+   */
+  bool convertTextInt(const char* field, int fieldLength, unsigned char* output, const JobColumn& column,
+                      BLBufferStats& bufStats);
+
   /** @brief Parse a batch of parquet data in read buffer for a nonDictionary column
    */
   int parseColParquet(ColumnInfo& columnInfo);
 
+  /** @brief Get the footer min/max of a column over the row groups that
+   *  the batch being parsed was read from.  Returns false if any of those
+   *  row groups has no statistics for the column.
+   */
+  bool getParquetBatchMinMax(unsigned columnId, int64_t& minVal, int64_t& maxVal) const;
+
+  /** @brief Copy a batch of a NOT NULL integer column straight from the
+   *  Arrow buffer, taking the CP min/max from the Parquet statistics.
+   *  Returns false, without touching buf or bufStats, if the column or
+   *  batch does not qualify; convertParquet() must be used instead.
+   */
+  bool copyParquetIntColumn(unsigned columnId, std::shared_ptr<arrow::Array> columnData, unsigned char* buf,
+                            const JobColumn& column, BLBufferStats& bufStats);
+
   /** @brief Convert batch parquet data depending upon the data type
    */
   void convertParquet(std::shared_ptr<arrow::Array> columnData, unsigned char* buf, const JobColumn& column,
@@ -279,9 +321,11 @@ class BulkLoadBuffer
     fStatusBLB = status;
   }
 
-  void setParquetReader(std::shared_ptr<::arrow::RecordBatchReader> reader)
+  void setParquetReader(std::shared_ptr<::arrow::RecordBatchReader> reader,
+                        std::shared_ptr<const ParquetFileStats> stats)
   {
     fParquetReader = reader;
+    fParquetStats = stats;
   }
 
   /** @brief Try to lock a column for the buffer
@@ -294,6 +338,15 @@ class BulkLoadBuffer
                      size_t* parse_length, RID& totalReadRows, RID& correctTotalRows,
                      const boost::ptr_vector<ColumnInfo>& columnsInfo, unsigned int allowedErrCntThisCall);
 
+  /** @brief Sort the rows read into the buffer on the sort key of the table
+   *  @param sortKey Indexes of the key columns in columnsInfo
+   */
+  void sortRows(const std::vector<unsigned>& sortKey, const boost::ptr_vector<ColumnInfo>& columnsInfo);
+
+  /** @brief Add the rows read into the buffer to an aggregate projection
+   */
+  void aggregate(ProjectionAggregator& aggregator, const boost::ptr_vector<ColumnInfo>& columnsInfo);
+
   /** @brief Read the batch data into the buffer
    */
   int fillFromFileParquet(RID& totalReadRows, RID& correctTotalRows);
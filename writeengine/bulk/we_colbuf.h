@@ -66,6 +66,13 @@ class ColumnBuffer
     return fBufSize;
   }
 
+  /** @brief Returns the internal buffer
+   */
+  const unsigned char* getData() const
+  {
+    return fBuffer;
+  }
+
   /** @brief Reset the ColBuf to-be-compressed buffer prior to importing the
    *  next extent.  This is a no-op for uncompressed columns.
    * @param startFileOffset (output) File offset to start of active chunk
@@ -554,6 +554,14 @@ int ColumnBufferManager::writeToFileExtentCheck(uint32_t startOffset, uint32_t w
       return rc;
     }
 
+    if (fColInfo->isIndexed())
+    {
+      rc = fColInfo->indexRows(fCBuf->getData() + startOffset, writeSize);
+
+      if (rc != NO_ERROR)
+        return rc;
+    }
+
     // MCOL-498 Fill this block up to its boundary.
     if (fillUpWEmpties)
     {
@@ -584,6 +592,14 @@ int ColumnBufferManager::writeToFileExtentCheck(uint32_t startOffset, uint32_t w
         return rc;
       }
 
+      if (fColInfo->isIndexed())
+      {
+        rc = fColInfo->indexRows(fCBuf->getData() + startOffset, writeSize1);
+
+        if (rc != NO_ERROR)
+          return rc;
+      }
+
       fColInfo->updateBytesWrittenCounts(writeSize1);
     }
 
@@ -610,6 +626,14 @@ int ColumnBufferManager::writeToFileExtentCheck(uint32_t startOffset, uint32_t w
       return rc;
     }
 
+    if (fColInfo->isIndexed())
+    {
+      rc = fColInfo->indexRows(fCBuf->getData() + startOffset + writeSize1, writeSize2);
+
+      if (rc != NO_ERROR)
+        return rc;
+    }
+
     // MCOL-498 Fill this block up to its boundary.
     if (fillUpWEmpties)
     {
@@ -38,6 +38,7 @@
 
 #include "we_tableinfo.h"
 #include "IDBDataFile.h"
+#include "cacheutils.h"
 using namespace idbdatafile;
 
 namespace
@@ -159,6 +160,7 @@ ColumnInfo::ColumnInfo(Log* logger, int idIn, const JobColumn& columnIn, DBRootE
  , fColWidthFactor(1)
  , fDelayedFileCreation(INITIAL_DBFILE_STAT_FILE_EXISTS)
  , fRowsPerExtent(0)
+ , fIndexType(execplan::CalpontSystemCatalog::NO_COLUMN_INDEX)
 {
   column = columnIn;
 
@@ -1176,6 +1178,115 @@ void ColumnInfo::getBRMUpdateInfo(BRMReporter& brmReporter)
     getCPInfoForBRM(brmReporter);
 }
 
+//------------------------------------------------------------------------------
+// Add rows being written to the current segment file to the rows to save to
+// its inverted index, and to its bloom filters.  All the rows are appended to
+// the file.
+//------------------------------------------------------------------------------
+int ColumnInfo::indexRows(const unsigned char* data, unsigned size)
+{
+  char fileName[FILE_NAME_SIZE];
+  int rc = colOp->getFileName(curCol.dataFile.fid, fileName, curCol.dataFile.fDbRoot,
+                              curCol.dataFile.fPartition, curCol.dataFile.fSegment);
+
+  if (rc != NO_ERROR)
+  {
+    WErrorCodes ec;
+    std::ostringstream oss;
+    oss << "indexRows: error getting segment file name of OID " << curCol.dataFile.fid << "; "
+        << ec.errorString(rc);
+    fLog->logMsg(oss.str(), rc, MSGLVL_ERROR);
+    return rc;
+  }
+
+  std::map<std::string, ColumnIndex>::iterator it = fColumnIndexes.find(fileName);
+
+  if (it == fColumnIndexes.end())
+  {
+    it = fColumnIndexes.insert(std::make_pair(std::string(fileName), ColumnIndex())).first;
+
+    BRM::FileInfo aFile;
+    aFile.oid = curCol.dataFile.fid;
+    aFile.partitionNum = curCol.dataFile.fPartition;
+    aFile.segmentNum = curCol.dataFile.fSegment;
+    aFile.dbRoot = curCol.dataFile.fDbRoot;
+    aFile.compType = curCol.compressionType;
+    fIndexedFiles.push_back(aFile);
+  }
+
+  RID firstRow = fSizeWritten / curCol.colWidth;
+  unsigned rowCount = size / curCol.colWidth;
+
+  if (fIndexType & execplan::CalpontSystemCatalog::INVERTED_INDEX)
+  {
+    ColumnIndex& index = it->second;
+
+    for (unsigned i = 0; i < rowCount; i++)
+      index.add(ColumnIndex::key(data + i * curCol.colWidth, curCol.colWidth), firstRow + i);
+
+    index.coverAppended(firstRow, rowCount);
+  }
+
+  // The bloom filters are saved as the rows are written; they'd take a byte a
+  // row until EOJ.  Filters of rows that end up rolled back only rule out less.
+  if (fIndexType & execplan::CalpontSystemCatalog::BLOOM_FILTER)
+  {
+    BlockBloomFilters bloomFilters;
+
+    for (unsigned i = 0; i < rowCount; i++)
+      bloomFilters.add(ColumnIndex::key(data + i * curCol.colWidth, curCol.colWidth), firstRow + i);
+
+    rc = bloomFilters.save(fileName, true);
+
+    if (rc != NO_ERROR)
+    {
+      WErrorCodes ec;
+      std::ostringstream oss;
+      oss << "indexRows: error saving bloom filters of " << fileName << "; " << ec.errorString(rc);
+      fLog->logMsg(oss.str(), rc, MSGLVL_ERROR);
+      return rc;
+    }
+  }
+
+  return NO_ERROR;
+}
+
+//------------------------------------------------------------------------------
+// Save the rows loaded to the inverted indexes of the segment files at EOJ,
+// and have PrimProc drop the indexes and bloom filters it has cached.
+//------------------------------------------------------------------------------
+int ColumnInfo::saveColumnIndexes()
+{
+  boost::mutex::scoped_lock lock(fColMutex);
+
+  for (std::map<std::string, ColumnIndex>::const_iterator it = fColumnIndexes.begin();
+       it != fColumnIndexes.end(); ++it)
+  {
+    // the bloom filters are saved already
+    if (it->second.empty())
+      continue;
+
+    int rc = it->second.save(it->first);
+
+    if (rc != NO_ERROR)
+    {
+      WErrorCodes ec;
+      std::ostringstream oss;
+      oss << "saveColumnIndexes: error saving inverted index of " << it->first << "; "
+          << ec.errorString(rc);
+      fLog->logMsg(oss.str(), rc, MSGLVL_ERROR);
+      return rc;
+    }
+  }
+
+  if (!fIndexedFiles.empty())
+    cacheutils::purgePrimProcFdCache(fIndexedFiles, Config::getLocalModuleID());
+
+  fColumnIndexes.clear();
+  fIndexedFiles.clear();
+  return NO_ERROR;
+}
+
 //------------------------------------------------------------------------------
 // Get updated Casual Partition (CP) information for BRM for this column at EOJ.
 //------------------------------------------------------------------------------
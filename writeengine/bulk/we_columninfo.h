@@ -36,6 +36,8 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <sys/time.h>
+#include <map>
+#include <string>
 #include <vector>
 
 #include "atomicops.h"
@@ -390,6 +392,29 @@ class ColumnInfo : public WeUIDGID
    */
   unsigned rowsPerExtent();
 
+  /** @brief Have the rows loaded added to the inverted indexes and bloom
+   *  filters of the segment files (see WriteEngine::ColumnIndex and
+   *  WriteEngine::BlockBloomFilters).
+   *  @param indexType The CalpontSystemCatalog::ColumnIndexType bits
+   */
+  void setIndexType(int indexType);
+
+  /** @brief Are the rows loaded added to inverted indexes or bloom filters
+   */
+  bool isIndexed() const;
+
+  /** @brief Add rows about to be written to the current segment file, at its
+   *  current size, to the rows to save to its inverted index, and to its
+   *  bloom filters.
+   *  @param data The rows being written
+   *  @param size Size of the rows in bytes
+   */
+  int indexRows(const unsigned char* data, unsigned size);
+
+  /** @brief Save the rows loaded to the inverted indexes of the segment files.
+   */
+  int saveColumnIndexes();
+
   void setUIDGID(const uid_t uid, const gid_t gid) override;
 
  protected:
@@ -495,6 +520,12 @@ class ColumnInfo : public WeUIDGID
   // to be created after preprocessing
 
   unsigned fRowsPerExtent;  // Number of rows per column extent
+
+  int fIndexType;  // ColumnIndexType bits of the indexes to add rows loaded to
+
+  // Rows loaded per segment file name, to add to the inverted indexes
+  std::map<std::string, ColumnIndex> fColumnIndexes;
+  std::vector<BRM::FileInfo> fIndexedFiles;  // Segment files of fColumnIndexes, to purge from PrimProc
 };
 
 //------------------------------------------------------------------------------
@@ -557,6 +588,16 @@ inline unsigned ColumnInfo::rowsPerExtent()
   return fRowsPerExtent;
 }
 
+inline void ColumnInfo::setIndexType(int indexType)
+{
+  fIndexType = indexType;
+}
+
+inline bool ColumnInfo::isIndexed() const
+{
+  return fIndexType != execplan::CalpontSystemCatalog::NO_COLUMN_INDEX;
+}
+
 template <typename T>
 inline void ColumnInfo::updateCPInfo(RID lastInputRow, T minVal, T maxVal, ColDataType colDataType, int width)
 {
@@ -0,0 +1,449 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file we_projectionaggregator.cpp
+ * Aggregates the rows of an import for an aggregate projection of the table.
+ */
+
+#include "we_projectionaggregator.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+#include "mcs_decimal.h"
+#include "nullvaluemanip.h"
+#include "we_convertor.h"
+
+using namespace execplan;
+
+namespace
+{
+// Groups kept before they're written out
+const size_t MAX_GROUPS = 1000000;
+
+// What a BRM report file line can hold (see BrmReportParser), and how many rows
+// are sent through it
+const size_t MAX_REPORT_LINE_LENGTH = 9000;
+const uint64_t MAX_REPORT_ROWS = 1000000;
+
+// The format of the file, what cpimport is run with to load it
+const char FIELD_DELIM = '|';
+const char ENCLOSED_BY = '"';
+const char ESCAPE = '\\';
+
+bool isDoubleType(CalpontSystemCatalog::ColDataType type)
+{
+  return type == CalpontSystemCatalog::FLOAT || type == CalpontSystemCatalog::UFLOAT ||
+         type == CalpontSystemCatalog::DOUBLE || type == CalpontSystemCatalog::UDOUBLE;
+}
+}  // namespace
+
+namespace WriteEngine
+{
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ProjectionAggregator::ProjectionAggregator(const AggregateProjection& projection,
+                                           const std::string& fileName)
+ : fProjection(projection)
+ , fFileName(fileName)
+ , fRowCount(0)
+ , fMaxRowLength(0)
+ , fHasLineBreak(false)
+ , fFinished(false)
+{
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+ProjectionAggregator::~ProjectionAggregator()
+{
+  if (fFile.is_open())
+    fFile.close();
+
+  unlink(fFileName.c_str());
+}
+
+//------------------------------------------------------------------------------
+// Map the columns of the projection to the columns of the import.  Values
+// filled in by cpimport itself can't be grouped on by their text.
+//------------------------------------------------------------------------------
+/* static */
+ProjectionAggregator* ProjectionAggregator::create(const AggregateProjection& projection,
+                                                   const std::vector<JobColumn>& columns,
+                                                   const std::string& fileName, std::string& error)
+{
+  ProjectionAggregator* aggregator = new ProjectionAggregator(projection, fileName);
+
+  for (const auto& projColumn : projection.columns)
+  {
+    Output output;
+    output.function = projColumn.function;
+    output.index = 0;
+    output.isDouble = false;
+
+    if (projColumn.function != AggregateProjection::COUNT_STAR)
+    {
+      unsigned i = 0;
+
+      while (i < columns.size() && columns[i].mapOid != projColumn.baseOid)
+        i++;
+
+      if (i == columns.size())
+      {
+        error = "column " + projColumn.baseName + " is not imported";
+        delete aggregator;
+        return 0;
+      }
+
+      if (columns[i].autoIncFlag ||
+          (projColumn.function == AggregateProjection::GROUP_KEY && columns[i].fWithDefault))
+      {
+        error = "column " + projColumn.baseName + " has an auto-increment or default value";
+        delete aggregator;
+        return 0;
+      }
+
+      if (projColumn.function == AggregateProjection::GROUP_KEY)
+      {
+        output.index = aggregator->fKeyColumns.size();
+        aggregator->fKeyColumns.push_back(i);
+      }
+      else
+      {
+        std::vector<unsigned>& values = aggregator->fValueColumns;
+        output.index = std::find(values.begin(), values.end(), i) - values.begin();
+        output.isDouble = isDoubleType(columns[i].dataType);
+
+        if (output.index == values.size())
+          values.push_back(i);
+      }
+    }
+
+    if (projColumn.function != AggregateProjection::GROUP_KEY)
+      aggregator->fAccOutputs.push_back(aggregator->fOutputs.size());
+
+    aggregator->fOutputs.push_back(output);
+  }
+
+  aggregator->fFile.open(fileName.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+  if (!aggregator->fFile.is_open())
+  {
+    std::string eMsg;
+    Convertor::mapErrnoToString(errno, eMsg);
+    error = "can't create " + fileName + "; " + eMsg;
+    delete aggregator;
+    return 0;
+  }
+
+  return aggregator;
+}
+
+//------------------------------------------------------------------------------
+// A key field is a flag byte, then for a value its length and bytes
+//------------------------------------------------------------------------------
+/* static */
+void ProjectionAggregator::appendKey(std::string& key, const char* field, int length)
+{
+  if (length <= 0)
+  {
+    key.push_back('\0');
+    return;
+  }
+
+  uint32_t len = length;
+  key.push_back('\1');
+  key.append(reinterpret_cast<const char*>(&len), sizeof(len));
+  key.append(field, length);
+}
+
+//------------------------------------------------------------------------------
+// Read back a numeric value stored by BulkLoadBuffer::convert()
+//------------------------------------------------------------------------------
+/* static */
+void ProjectionAggregator::decodeValue(const unsigned char* output, const JobColumn& column, Value& value)
+{
+  value.intVal = 0;
+  value.doubleVal = 0;
+
+  if (column.width == datatypes::MAXDECIMALWIDTH)
+  {
+    memcpy(&value.intVal, output, sizeof(value.intVal));
+    value.isNull = (value.intVal == datatypes::Decimal128Null);
+    return;
+  }
+
+  uint64_t raw = 0;
+  memcpy(&raw, output, column.width);
+  value.isNull = (raw == utils::getNullValue(column.dataType, column.width));
+
+  if (value.isNull)
+    return;
+
+  switch (column.dataType)
+  {
+    case CalpontSystemCatalog::FLOAT:
+    case CalpontSystemCatalog::UFLOAT:
+    {
+      float f;
+      memcpy(&f, output, sizeof(f));
+      value.doubleVal = f;
+      break;
+    }
+
+    case CalpontSystemCatalog::DOUBLE:
+    case CalpontSystemCatalog::UDOUBLE:
+    {
+      memcpy(&value.doubleVal, output, sizeof(value.doubleVal));
+      break;
+    }
+
+    case CalpontSystemCatalog::UTINYINT:
+    case CalpontSystemCatalog::USMALLINT:
+    case CalpontSystemCatalog::UMEDINT:
+    case CalpontSystemCatalog::UINT:
+    case CalpontSystemCatalog::UBIGINT:
+    case CalpontSystemCatalog::UDECIMAL:
+    {
+      value.intVal = raw;
+      break;
+    }
+
+    default:
+    {
+      switch (column.width)
+      {
+        case 1: value.intVal = static_cast<int8_t>(raw); break;
+
+        case 2: value.intVal = static_cast<int16_t>(raw); break;
+
+        case 4: value.intVal = static_cast<int32_t>(raw); break;
+
+        default: value.intVal = static_cast<int64_t>(raw); break;
+      }
+
+      break;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Add a row to its group
+//------------------------------------------------------------------------------
+void ProjectionAggregator::addRow(const std::string& key, const Value* values)
+{
+  auto it = fGroupIndex.find(key);
+
+  if (it == fGroupIndex.end())
+  {
+    if (fGroupIndex.size() >= MAX_GROUPS)
+      writeGroups();
+
+    it = fGroupIndex.insert(std::make_pair(key, fGroupKeys.size())).first;
+    fGroupKeys.push_back(&it->first);
+    fAccumulators.resize(fAccumulators.size() + fAccOutputs.size(), Accumulator{0, 0, false});
+  }
+
+  Accumulator* acc = &fAccumulators[it->second * fAccOutputs.size()];
+
+  for (unsigned i = 0; i < fAccOutputs.size(); i++, acc++)
+  {
+    const Output& output = fOutputs[fAccOutputs[i]];
+
+    if (output.function == AggregateProjection::COUNT_STAR)
+    {
+      acc->intVal++;
+      continue;
+    }
+
+    const Value& value = values[output.index];
+
+    if (value.isNull)
+      continue;
+
+    switch (output.function)
+    {
+      case AggregateProjection::COUNT: acc->intVal++; break;
+
+      case AggregateProjection::SUM:
+        acc->intVal += value.intVal;
+        acc->doubleVal += value.doubleVal;
+        break;
+
+      case AggregateProjection::MIN:
+        if (!acc->hasValue ||
+            (output.isDouble ? value.doubleVal < acc->doubleVal : value.intVal < acc->intVal))
+        {
+          acc->intVal = value.intVal;
+          acc->doubleVal = value.doubleVal;
+        }
+
+        break;
+
+      case AggregateProjection::MAX:
+        if (!acc->hasValue ||
+            (output.isDouble ? value.doubleVal > acc->doubleVal : value.intVal > acc->intVal))
+        {
+          acc->intVal = value.intVal;
+          acc->doubleVal = value.doubleVal;
+        }
+
+        break;
+
+      default: break;
+    }
+
+    acc->hasValue = true;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Write a row per group to the file and start over
+//------------------------------------------------------------------------------
+void ProjectionAggregator::writeGroups()
+{
+  std::string row;
+  std::vector<std::pair<const char*, int> > keys(fKeyColumns.size());
+  char buf[64];
+
+  for (size_t group = 0; group < fGroupKeys.size(); group++)
+  {
+    // split the key back into its fields
+    const char* p = fGroupKeys[group]->data();
+
+    for (auto& key : keys)
+    {
+      key.second = -1;
+
+      if (*p++ != '\0')
+      {
+        uint32_t len;
+        memcpy(&len, p, sizeof(len));
+        key.first = p + sizeof(len);
+        key.second = len;
+        p += sizeof(len) + len;
+      }
+    }
+
+    const Accumulator* acc = &fAccumulators[group * fAccOutputs.size()];
+    row.clear();
+
+    for (unsigned i = 0; i < fOutputs.size(); i++)
+    {
+      const Output& output = fOutputs[i];
+
+      if (i > 0)
+        row.push_back(FIELD_DELIM);
+
+      if (output.function == AggregateProjection::GROUP_KEY)
+      {
+        const std::pair<const char*, int>& key = keys[output.index];
+
+        if (key.second < 0)
+        {
+          row.append("\\N");
+          continue;
+        }
+
+        row.push_back(ENCLOSED_BY);
+
+        for (int k = 0; k < key.second; k++)
+        {
+          char c = key.first[k];
+
+          if (c == ENCLOSED_BY || c == ESCAPE)
+            row.push_back(ESCAPE);
+          else if (c == '\n' || c == '\r')
+          {
+            row.push_back(ESCAPE);
+            fHasLineBreak = true;
+          }
+
+          row.push_back(c);
+        }
+
+        row.push_back(ENCLOSED_BY);
+        continue;
+      }
+
+      int8_t scale = fProjection.columns[i].colType.scale;
+
+      if (output.function == AggregateProjection::COUNT_STAR || output.function == AggregateProjection::COUNT)
+      {
+        row.append(datatypes::TSInt128(acc->intVal).toString());
+      }
+      else if (!acc->hasValue)
+      {
+        row.append("\\N");
+      }
+      else if (output.isDouble)
+      {
+        snprintf(buf, sizeof(buf), "%.17g", acc->doubleVal);
+        row.append(buf);
+      }
+      else
+      {
+        row.append(datatypes::Decimal(datatypes::TSInt128(acc->intVal), scale, 38).toString(true));
+      }
+
+      acc++;
+    }
+
+    fFile << row << '\n';
+    fRowCount++;
+
+    if (row.size() > fMaxRowLength)
+      fMaxRowLength = row.size();
+  }
+
+  fGroupIndex.clear();
+  fGroupKeys.clear();
+  fAccumulators.clear();
+}
+
+//------------------------------------------------------------------------------
+// Write out what's left
+//------------------------------------------------------------------------------
+bool ProjectionAggregator::finish(std::string& error)
+{
+  writeGroups();
+  fFile.close();
+
+  if (fFile.fail())
+  {
+    error = "error writing " + fFileName;
+    return false;
+  }
+
+  fFinished = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Check whether the rows can be sent in a BRM report file
+//------------------------------------------------------------------------------
+bool ProjectionAggregator::fitsReport() const
+{
+  return !fHasLineBreak && fMaxRowLength <= MAX_REPORT_LINE_LENGTH && fRowCount <= MAX_REPORT_ROWS;
+}
+
+}  // namespace WriteEngine
@@ -0,0 +1,165 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file we_projectionaggregator.h
+ * Aggregates the rows of an import for an aggregate projection of the table.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "we_type.h"
+#include "aggregateprojection.h"
+
+namespace WriteEngine
+{
+//------------------------------------------------------------------------------
+/** @brief Aggregates the rows loaded into a table for one of its aggregate
+ *  projections (see execplan::AggregateProjection).
+ *
+ * The read thread of the table adds each buffer it reads, before the buffer
+ * is parsed (see BulkLoadBuffer::aggregate()).  Rows are grouped by the text
+ * of their key fields as read, so "1" and "01" make two groups that queries
+ * add up again.  The groups are written to a text file that is loaded into
+ * the projection once the import of the table is committed.  If there are
+ * too many groups to keep, the ones so far are written out and aggregating
+ * starts over; that costs projection rows, not correctness.
+ */
+//------------------------------------------------------------------------------
+class ProjectionAggregator
+{
+ public:
+  /** @brief A converted measure field */
+  struct Value
+  {
+    bool isNull;
+    int128_t intVal;  // integer and decimal types, decimals scaled
+    double doubleVal;  // FLOAT and DOUBLE
+  };
+
+  /** @brief Returns 0 and the reason if this import can't maintain projection.
+   *  @param columns Columns of the table in the order of the import
+   *  @param fileName Where to write the groups
+   */
+  static ProjectionAggregator* create(const execplan::AggregateProjection& projection,
+                                      const std::vector<JobColumn>& columns, const std::string& fileName,
+                                      std::string& error);
+
+  /** @brief Destructor, removes the file
+   */
+  ~ProjectionAggregator();
+
+  const execplan::AggregateProjection& projection() const
+  {
+    return fProjection;
+  }
+
+  /** @brief Indexes of the key columns in the columns of the import
+   */
+  const std::vector<unsigned>& keyColumns() const
+  {
+    return fKeyColumns;
+  }
+
+  /** @brief Indexes of the aggregated columns in the columns of the import
+   */
+  const std::vector<unsigned>& valueColumns() const
+  {
+    return fValueColumns;
+  }
+
+  /** @brief Appends a key field to key; length <= 0 is NULL
+   */
+  static void appendKey(std::string& key, const char* field, int length);
+
+  /** @brief Reads the value convert() stored for a field of column
+   */
+  static void decodeValue(const unsigned char* output, const JobColumn& column, Value& value);
+
+  /** @brief Adds a row.  Only the read thread of the table calls this.
+   *  @param key The key fields appended with appendKey()
+   *  @param values A value for each of valueColumns()
+   */
+  void addRow(const std::string& key, const Value* values);
+
+  /** @brief Writes out the groups left and closes the file.  Returns false
+   *  and the reason on an error.
+   */
+  bool finish(std::string& error);
+
+  bool isFinished() const
+  {
+    return fFinished;
+  }
+  const std::string& fileName() const
+  {
+    return fFileName;
+  }
+  uint64_t rowCount() const
+  {
+    return fRowCount;
+  }
+
+  /** @brief Returns true if the rows can go through a BRM report file:  they
+   *  are lines that aren't too long and there aren't too many of them.
+   */
+  bool fitsReport() const;
+
+ private:
+  ProjectionAggregator(const execplan::AggregateProjection& projection, const std::string& fileName);
+
+  // what a column of the projection comes from
+  struct Output
+  {
+    execplan::AggregateProjection::Function function;
+    unsigned index;  // into the key fields for GROUP_KEY, else into values
+    bool isDouble;
+  };
+
+  // the state of a column of a group, other than a key
+  struct Accumulator
+  {
+    int128_t intVal;
+    double doubleVal;
+    bool hasValue;
+  };
+
+  void writeGroups();
+
+  execplan::AggregateProjection fProjection;
+  std::vector<unsigned> fKeyColumns;
+  std::vector<unsigned> fValueColumns;
+  std::vector<Output> fOutputs;       // in the order of the projection
+  std::vector<unsigned> fAccOutputs;  // the fOutputs that have an Accumulator
+
+  std::unordered_map<std::string, size_t> fGroupIndex;
+  std::vector<const std::string*> fGroupKeys;
+  std::vector<Accumulator> fAccumulators;  // fAccOutputs.size() per group
+
+  std::string fFileName;
+  std::ofstream fFile;
+  uint64_t fRowCount;
+  size_t fMaxRowLength;
+  bool fHasLineBreak;
+  bool fFinished;
+};
+
+}  // namespace WriteEngine
@@ -58,12 +58,14 @@ using namespace querytele;
 #include <arrow/io/api.h>
 #include <parquet/arrow/reader.h>
 #include <parquet/exception.h>
+#include <parquet/statistics.h>
 namespace
 {
 const std::string BAD_FILE_SUFFIX = ".bad";  // Reject data file suffix
 const std::string ERR_FILE_SUFFIX = ".err";  // Job error file suffix
 const std::string BOLD_START = "\033[0;1m";
 const std::string BOLD_STOP = "\033[0;39m";
+const int64_t PARQUET_BATCH_SIZE = 65536;  // Rows per batch read into a BulkLoadBuffer
 }  // namespace
 
 namespace WriteEngine
@@ -543,6 +545,18 @@ int TableInfo::readTableData()
       return ERR_BULK_MAX_ERR_NUM;
     }
 
+    // Sort the rows on the sort key, then aggregate them for the projections,
+    // before the parse threads get them
+    if (!fSortKey.empty())
+    {
+      fBuffers[readBufNo].sortRows(fSortKey, fColumns);
+    }
+
+    for (unsigned k = 0; k < fProjections.size(); k++)
+    {
+      fBuffers[readBufNo].aggregate(fProjections[k], fColumns);
+    }
+
     // mark the buffer status as read complete.
     {
 #ifdef PROFILE
@@ -870,6 +884,26 @@ int TableInfo::setParseComplete(const int& columnId, const int& bufferId, double
           return rc;
         }
 
+        //..Save the rows loaded to the inverted indexes of the columns, and
+        //..have PrimProc drop its copies of them and of the bloom filters
+        for (unsigned i = 0; i < fColumns.size() && rc == NO_ERROR; ++i)
+        {
+          if (fColumns[i].isIndexed())
+            rc = fColumns[i].saveColumnIndexes();
+        }
+
+        if (rc != NO_ERROR)
+        {
+          WErrorCodes ec;
+          ostringstream oss;
+          oss << "setParseComplete: column index error; "
+                 "Failed to load table: "
+              << fTableName << "; " << ec.errorString(rc);
+          fLog->logMsg(oss.str(), rc, MSGLVL_ERROR);
+          fStatusTI = WriteEngine::ERR;
+          return rc;
+        }
+
         //..Confirm changes to DB files (necessary for HDFS)
         rc = confirmDBFileChanges();
 
@@ -1095,6 +1129,51 @@ int TableInfo::finishBRM()
     badFiles = &fBadFiles;
   }
 
+  // Write out the aggregate projections.  In modes 1 and 2 their rows go to the
+  // front end in the report file; in mode 3 BulkLoad loads them after the job.
+  // A projection left out is marked stale before the import is committed.
+  for (unsigned k = 0; k < fProjections.size(); k++)
+  {
+    ProjectionAggregator& aggregator = fProjections[k];
+    const execplan::CalpontSystemCatalog::TableName& projTable = aggregator.projection().table;
+    std::string errMsg;
+    ostringstream oss;
+
+    if (!aggregator.finish(errMsg))
+    {
+      oss << "Aggregate projection " << projTable << " is stale and must be rebuilt; " << errMsg;
+    }
+    else if (!fBRMRptFileName.empty())
+    {
+      if (aggregator.fitsReport())
+      {
+        fBRMReporter.addToProjectionInfo(projTable.toString(), aggregator.fileName());
+        continue;
+      }
+
+      oss << "Aggregate projection " << projTable << " is stale and must be rebuilt; its "
+          << aggregator.rowCount() << " rows are too many or too long for the report file";
+    }
+    else
+    {
+      continue;
+    }
+
+    fLog->logMsg(oss.str(), MSGLVL_WARNING);
+
+    try
+    {
+      execplan::AggregateProjection::markStale(aggregator.projection().tableOid);
+    }
+    catch (std::exception& ex)
+    {
+      ostringstream ossErr;
+      ossErr << "Error marking aggregate projection " << projTable << " stale due to:  " << ex.what();
+      fLog->logMsg(ossErr.str(), ERR_FILE_CREATE, MSGLVL_ERROR);
+      return ERR_FILE_CREATE;
+    }
+  }
+
   // Save the info just collected, to a report file or send to BRM
   int rc = fBRMReporter.sendBRMInfo(fBRMRptFileName, *errFiles, *badFiles);
 
@@ -1289,6 +1368,11 @@ void TableInfo::addColumn(ColumnInfo* info)
   fExtentStrAlloc.addColumn(info->column.mapOid, info->column.width, info->column.dataType);
 }
 
+void TableInfo::addProjection(ProjectionAggregator* aggregator)
+{
+  fProjections.push_back(aggregator);
+}
+
 int TableInfo::openTableFileParquet(int64_t& totalRowsParquet)
 {
   if (fParquetReader != NULL)
@@ -1297,9 +1381,25 @@ int TableInfo::openTableFileParquet(int64_t& totalRowsParquet)
   try
   {
     PARQUET_ASSIGN_OR_THROW(infile, arrow::io::ReadableFile::Open(fFileName, arrow::default_memory_pool()));
-    PARQUET_THROW_NOT_OK(parquet::arrow::OpenFile(infile, arrow::default_memory_pool(), &fReader));
-    fReader->set_batch_size(1000);
-    PARQUET_THROW_NOT_OK(fReader->ScanContents({0}, 1000, &totalRowsParquet));
+
+    // Let Arrow decode the columns of a row group on its own thread pool,
+    // and coalesce the reads of each row group's column chunks.
+    parquet::ArrowReaderProperties arrowProperties = parquet::default_arrow_reader_properties();
+    arrowProperties.set_use_threads(true);
+    arrowProperties.set_pre_buffer(true);
+    arrowProperties.set_batch_size(PARQUET_BATCH_SIZE);
+
+    parquet::arrow::FileReaderBuilder readerBuilder;
+    PARQUET_THROW_NOT_OK(readerBuilder.Open(infile));
+    readerBuilder.memory_pool(arrow::default_memory_pool());
+    readerBuilder.properties(arrowProperties);
+    PARQUET_THROW_NOT_OK(readerBuilder.Build(&fReader));
+
+    // The row count is in the footer; no need to scan a column for it
+    std::shared_ptr<parquet::FileMetaData> metadata = fReader->parquet_reader()->metadata();
+    totalRowsParquet = metadata->num_rows();
+    fParquetStats = getParquetFileStats(*metadata);
+
     PARQUET_THROW_NOT_OK(fReader->GetRecordBatchReader(&fParquetReader));
   }
   catch (std::exception& ex)
@@ -1321,11 +1421,69 @@ int TableInfo::openTableFileParquet(int64_t& totalRowsParquet)
   // initialize fBuffers batch source
   for (auto& buffer : fBuffers)
   {
-    buffer.setParquetReader(fParquetReader);
+    buffer.setParquetReader(fParquetReader, fParquetStats);
   }
   return NO_ERROR;
 }
 
+//------------------------------------------------------------------------------
+// Collect the integer min/max statistics of each column chunk in a Parquet
+// file, so that parsing can set CP from them instead of from the values.
+// Statistics are only collected for flat schemas, where leaf column i is
+// Arrow column i.
+//------------------------------------------------------------------------------
+std::shared_ptr<const ParquetFileStats> TableInfo::getParquetFileStats(const parquet::FileMetaData& metadata)
+{
+  std::shared_ptr<ParquetFileStats> stats(new ParquetFileStats());
+
+  if (metadata.schema()->group_node()->field_count() != metadata.num_columns())
+    return stats;
+
+  stats->resize(metadata.num_columns());
+  int64_t firstRow = 0;
+
+  for (int rg = 0; rg < metadata.num_row_groups(); rg++)
+  {
+    std::unique_ptr<parquet::RowGroupMetaData> rowGroup = metadata.RowGroup(rg);
+
+    for (int col = 0; col < metadata.num_columns(); col++)
+    {
+      ParquetChunkStats chunk;
+      chunk.firstRow = firstRow;
+      chunk.numRows = rowGroup->num_rows();
+      chunk.hasMinMax = false;
+      chunk.minVal = 0;
+      chunk.maxVal = 0;
+
+      std::shared_ptr<parquet::Statistics> colStats = rowGroup->ColumnChunk(col)->statistics();
+
+      if (colStats && colStats->HasMinMax())
+      {
+        if (colStats->physical_type() == parquet::Type::INT32)
+        {
+          auto typedStats = std::static_pointer_cast<parquet::Int32Statistics>(colStats);
+          chunk.minVal = typedStats->min();
+          chunk.maxVal = typedStats->max();
+          chunk.hasMinMax = true;
+        }
+        else if (colStats->physical_type() == parquet::Type::INT64)
+        {
+          auto typedStats = std::static_pointer_cast<parquet::Int64Statistics>(colStats);
+          chunk.minVal = typedStats->min();
+          chunk.maxVal = typedStats->max();
+          chunk.hasMinMax = true;
+        }
+      }
+
+      (*stats)[col].push_back(chunk);
+    }
+
+    firstRow += rowGroup->num_rows();
+  }
+
+  return stats;
+}
+
 //------------------------------------------------------------------------------
 // Open the file corresponding to fFileName so that we can import it's contents.
 // A buffer is also allocated and passed to setvbuf().
@@ -1431,6 +1589,7 @@ void TableInfo::closeTableFile()
   {
     fReader.reset();
     fParquetReader.reset();
+    fParquetStats.reset();
   }
 }
 
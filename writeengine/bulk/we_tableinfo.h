@@ -47,6 +47,7 @@
 #include "we_log.h"
 #include "we_brmreporter.h"
 #include "we_extentstripealloc.h"
+#include "we_projectionaggregator.h"
 #include "messagelog.h"
 #include "brmtypes.h"
 #include "querytele.h"
@@ -173,9 +174,12 @@ class TableInfo : public WeUIDGID
   oam::OamCache* fOamCachePtr;              // OamCache: ptr is copyable
   boost::uuids::uuid fJobUUID;              // Job UUID
   std::vector<BRM::LBID_t> fDictFlushBlks;  // dict blks to be flushed from cache
+  boost::ptr_vector<ProjectionAggregator> fProjections;  // Aggregate projections maintained
+  std::vector<unsigned> fSortKey;  // Columns the rows of a buffer are sorted on, if any
 
   std::shared_ptr<arrow::RecordBatchReader> fParquetReader;  // Batch reader to read batches of data
   std::unique_ptr<parquet::arrow::FileReader> fReader;       // Reader to read parquet file
+  std::shared_ptr<const ParquetFileStats> fParquetStats;     // Footer statistics of parquet file
   //--------------------------------------------------------------------------
   // Private Functions
   //--------------------------------------------------------------------------
@@ -190,6 +194,8 @@ class TableInfo : public WeUIDGID
   bool isBufferAvailable(bool report);  // Is tbl buffer available for reading
   int openTableFileParquet(
       int64_t& totalRowsParquet);        // Open parquet data file and set batch reader for each buffer
+  std::shared_ptr<const ParquetFileStats> getParquetFileStats(
+      const parquet::FileMetaData& metadata);  // Collect column chunk min/max from the footer
   int openTableFile();                   // Open data file and set the buffer
   void reportTotals(double elapsedSec);  // Report summary totals
   void sleepMS(long int ms);             // Sleep method
@@ -367,6 +373,19 @@ class TableInfo : public WeUIDGID
    */
   void addColumn(ColumnInfo* info);
 
+  /** @brief Add an aggregate projection to maintain with this import
+   */
+  void addProjection(ProjectionAggregator* aggregator);
+
+  /** @brief Aggregate projections maintained with this import
+   */
+  boost::ptr_vector<ProjectionAggregator>& getProjections();
+
+  /** @brief Set the columns, by index into the columns of the table, to sort
+   *  the rows of each read buffer on before they are parsed
+   */
+  void setSortKey(const std::vector<unsigned>& sortKey);
+
   /** @brief Initialize the buffer list
    *  @param noOfBuffers Number of buffers to create for this table
    *  @param jobFieldRefList List of fields in this import
@@ -527,6 +546,11 @@ inline std::string TableInfo::getTableName() const
   return fTableName;
 }
 
+inline boost::ptr_vector<ProjectionAggregator>& TableInfo::getProjections()
+{
+  return fProjections;
+}
+
 inline OID TableInfo::getTableOID()
 {
   return fTableOID;
@@ -563,6 +587,11 @@ inline void TableInfo::setBufferSize(const int bufSize)
   fBufferSize = bufSize;
 }
 
+inline void TableInfo::setSortKey(const std::vector<unsigned>& sortKey)
+{
+  fSortKey = sortKey;
+}
+
 inline void TableInfo::setColDelimiter(const char delim)
 {
   fColDelim = delim;
@@ -649,6 +649,14 @@ uint8_t WE_DDLCommandProc::writeCreateSyscolumn(ByteStream& bs, std::string& err
         {
           colTuple.data = colDefPtr->fType->fCharsetNum;
         }
+        else if (SORTKEY_COL == column.tableColName.column)
+        {
+          colTuple.data = (int)colDefPtr->fType->fSortKey;
+        }
+        else if (INDEXTYPE_COL == column.tableColName.column)
+        {
+          colTuple.data = (int)colDefPtr->fType->fIndexType;
+        }
         else
         {
           colTuple.data = column.colType.getNullValueForType();
@@ -1039,6 +1047,14 @@ uint8_t WE_DDLCommandProc::writeSyscolumn(ByteStream& bs, std::string& err)
       {
         colTuple.data = colDefPtr->fType->fCharsetNum;
       }
+      else if (SORTKEY_COL == column.tableColName.column)
+      {
+        colTuple.data = (int)colDefPtr->fType->fSortKey;
+      }
+      else if (INDEXTYPE_COL == column.tableColName.column)
+      {
+        colTuple.data = (int)colDefPtr->fType->fIndexType;
+      }
       else
       {
         colTuple.data = column.colType.getNullValueForType();
@@ -19,6 +19,8 @@
 // $Id: we_dmlcommandproc.cpp 3082 2011-09-26 22:00:38Z chao $
 
 #include <unistd.h>
+#include <algorithm>
+#include <typeinfo>
 #include "bytestream.h"
 using namespace messageqcpp;
 
@@ -56,6 +58,238 @@ using namespace BRM;
 using namespace std;
 using namespace utils;
 
+namespace
+{
+// Columns of a table in the order of its sort key (see
+// CalpontSystemCatalog::ColType::sortKeyPosition), empty if it has none
+std::vector<unsigned> sortKeyColumns(const std::vector<CalpontSystemCatalog::ColType>& colTypes)
+{
+  std::vector<std::pair<int32_t, unsigned> > keyPositions;
+
+  for (unsigned i = 0; i < colTypes.size(); i++)
+  {
+    if (colTypes[i].sortKeyPosition > 0 && !colTypes[i].autoincrement)
+      keyPositions.push_back(std::make_pair(colTypes[i].sortKeyPosition, i));
+  }
+
+  std::sort(keyPositions.begin(), keyPositions.end());
+  std::vector<unsigned> keyColumns;
+
+  for (unsigned k = 0; k < keyPositions.size(); k++)
+    keyColumns.push_back(keyPositions[k].second);
+
+  return keyColumns;
+}
+
+// Order of the rows of a batch sorted on keyColumns; compare(a, b, column)
+// compares the values of rows a and b in a column like strcmp()
+template <typename Compare>
+std::vector<uint32_t> sortedRowOrder(uint32_t rowCount, const std::vector<unsigned>& keyColumns,
+                                     Compare compare)
+{
+  std::vector<uint32_t> order(rowCount);
+
+  for (uint32_t i = 0; i < rowCount; i++)
+    order[i] = i;
+
+  std::stable_sort(order.begin(), order.end(),
+                   [&](uint32_t a, uint32_t b)
+                   {
+                     for (unsigned column : keyColumns)
+                     {
+                       int rc = compare(a, b, column);
+
+                       if (rc)
+                         return rc < 0;
+                     }
+
+                     return false;
+                   });
+
+  return order;
+}
+
+// Put values[first, first + order.size()) in order
+template <typename T>
+void permuteRows(std::vector<T>& values, size_t first, const std::vector<uint32_t>& order)
+{
+  if (values.size() < first + order.size())
+    return;
+
+  std::vector<T> rows(values.begin() + first, values.begin() + first + order.size());
+
+  for (size_t i = 0; i < order.size(); i++)
+    values[first + i] = rows[order[i]];
+}
+
+int compareStrings(const NullString& a, const NullString& b, const CalpontSystemCatalog::ColType& colType)
+{
+  if (a.isNull() || b.isNull())
+    return (!a.isNull()) - (!b.isNull());
+
+  return datatypes::Charset(colType.charsetNumber).strnncollsp(a.unsafeStringRef(), b.unsafeStringRef());
+}
+
+template <typename T>
+bool compareAnyAs(const boost::any& a, const boost::any& b, int& rc)
+{
+  if (a.type() != typeid(T) || b.type() != typeid(T))
+    return false;
+
+  const T x = boost::any_cast<T>(a);
+  const T y = boost::any_cast<T>(b);
+  rc = (x > y) - (x < y);
+  return true;
+}
+
+// Compare two values converted by ColType::convertColumnData().  NULLs are
+// their NULL markers, so they sort where those do.
+int compareAny(const boost::any& a, const boost::any& b, const CalpontSystemCatalog::ColType& colType)
+{
+  int rc = 0;
+
+  if (a.type() == typeid(std::string) && b.type() == typeid(std::string))
+    return datatypes::Charset(colType.charsetNumber)
+        .strnncollsp(boost::any_cast<std::string>(a), boost::any_cast<std::string>(b));
+
+  compareAnyAs<char>(a, b, rc) || compareAnyAs<signed char>(a, b, rc) || compareAnyAs<short>(a, b, rc) ||
+      compareAnyAs<int>(a, b, rc) || compareAnyAs<long>(a, b, rc) || compareAnyAs<long long>(a, b, rc) ||
+      compareAnyAs<unsigned char>(a, b, rc) || compareAnyAs<unsigned short>(a, b, rc) ||
+      compareAnyAs<unsigned int>(a, b, rc) || compareAnyAs<unsigned long>(a, b, rc) ||
+      compareAnyAs<unsigned long long>(a, b, rc) || compareAnyAs<float>(a, b, rc) ||
+      compareAnyAs<double>(a, b, rc) || compareAnyAs<int128_t>(a, b, rc);
+
+  return rc;
+}
+
+// Compare two values of processBatchInsertBinary(), the bytes of the value in
+// a uint64_t, unsigned ones zero-extended
+int compareBinary(uint64_t a, uint64_t b, const CalpontSystemCatalog::ColType& colType)
+{
+  switch (colType.colDataType)
+  {
+    case CalpontSystemCatalog::FLOAT:
+    case CalpontSystemCatalog::UFLOAT:
+    {
+      float x, y;
+      memcpy(&x, &a, sizeof(x));
+      memcpy(&y, &b, sizeof(y));
+      return (x > y) - (x < y);
+    }
+
+    case CalpontSystemCatalog::DOUBLE:
+    case CalpontSystemCatalog::UDOUBLE:
+    {
+      double x, y;
+      memcpy(&x, &a, sizeof(x));
+      memcpy(&y, &b, sizeof(y));
+      return (x > y) - (x < y);
+    }
+
+    case CalpontSystemCatalog::CHAR:
+    case CalpontSystemCatalog::VARCHAR:
+    {
+      const char* x = reinterpret_cast<const char*>(&a);
+      const char* y = reinterpret_cast<const char*>(&b);
+      return datatypes::Charset(colType.charsetNumber)
+          .strnncollsp(x, strnlen(x, sizeof(a)), y, strnlen(y, sizeof(b)));
+    }
+
+    case CalpontSystemCatalog::TINYINT:
+    case CalpontSystemCatalog::SMALLINT:
+    case CalpontSystemCatalog::MEDINT:
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::BIGINT:
+    case CalpontSystemCatalog::DECIMAL:
+    case CalpontSystemCatalog::TIME:
+    {
+      int64_t x, y;
+
+      switch (colType.colWidth)
+      {
+        case 1: x = static_cast<int8_t>(a), y = static_cast<int8_t>(b); break;
+
+        case 2: x = static_cast<int16_t>(a), y = static_cast<int16_t>(b); break;
+
+        case 4: x = static_cast<int32_t>(a), y = static_cast<int32_t>(b); break;
+
+        default: x = static_cast<int64_t>(a), y = static_cast<int64_t>(b); break;
+      }
+
+      return (x > y) - (x < y);
+    }
+
+    default: return (a > b) - (a < b);
+  }
+}
+
+// Put the rows of a batch in the order of the sort key of the table, if it
+// has one, so the extents they go to get narrow casual partitioning ranges
+// on it
+void sortBatchRows(const WriteEngine::CSCTypesList& colTypes, const WriteEngine::ColStructList& colStructs,
+                   WriteEngine::ColValueList& colValuesList, WriteEngine::DictStrList& dicStringList)
+{
+  std::vector<unsigned> keyColumns = sortKeyColumns(colTypes);
+
+  if (keyColumns.empty() || colValuesList.size() < colTypes.size() ||
+      dicStringList.size() < colTypes.size() || colValuesList[0].size() < 2)
+    return;
+
+  std::vector<uint32_t> order =
+      sortedRowOrder(colValuesList[0].size(), keyColumns,
+                     [&](uint32_t a, uint32_t b, unsigned column)
+                     {
+                       if (colStructs[column].tokenFlag)
+                         return compareStrings(dicStringList[column][a], dicStringList[column][b],
+                                               colTypes[column]);
+
+                       return compareAny(colValuesList[column][a].data, colValuesList[column][b].data,
+                                         colTypes[column]);
+                     });
+
+  for (unsigned column = 0; column < colValuesList.size(); column++)
+  {
+    permuteRows(colValuesList[column], 0, order);
+    permuteRows(dicStringList[column], 0, order);
+  }
+}
+
+// Same for processBatchInsertBinary(), where the values of the columns follow
+// one another in colValuesList
+void sortBatchRowsBinary(const WriteEngine::CSCTypesList& colTypes,
+                         const WriteEngine::ColStructList& colStructs, std::vector<uint64_t>& colValuesList,
+                         WriteEngine::DictStrList& dicStringList)
+{
+  std::vector<unsigned> keyColumns = sortKeyColumns(colTypes);
+
+  if (keyColumns.empty() || dicStringList.size() != colTypes.size())
+    return;
+
+  const uint32_t rowCount = colValuesList.size() / colTypes.size();
+
+  if (rowCount < 2)
+    return;
+
+  std::vector<uint32_t> order =
+      sortedRowOrder(rowCount, keyColumns,
+                     [&](uint32_t a, uint32_t b, unsigned column)
+                     {
+                       if (colStructs[column].tokenFlag)
+                         return compareStrings(dicStringList[column][a], dicStringList[column][b],
+                                               colTypes[column]);
+
+                       return compareBinary(colValuesList[(size_t)column * rowCount + a],
+                                            colValuesList[(size_t)column * rowCount + b], colTypes[column]);
+                     });
+
+  for (unsigned column = 0; column < colTypes.size(); column++)
+  {
+    permuteRows(colValuesList, (size_t)column * rowCount, order);
+    permuteRows(dicStringList[column], 0, order);
+  }
+}
+}  // namespace
+
 namespace WriteEngine
 {
 // StopWatch timer;
@@ -191,6 +425,8 @@ uint8_t WE_DMLCommandProc::processSingleInsert(messageqcpp::ByteStream& bs, std:
         colStruct.dataOid = roPair.objnum;
         colStruct.tokenFlag = false;
         colStruct.fCompressionType = colType.compressionType;
+        colStruct.fIndexType = colType.indexType;
+        colStruct.fCharsetNumber = colType.charsetNumber;
 
         // Token
         if (isDictCol(colType))
@@ -1108,6 +1344,8 @@ uint8_t WE_DMLCommandProc::processBatchInsert(messageqcpp::ByteStream& bs, std::
         colStruct.dataOid = roPair.objnum;
         colStruct.tokenFlag = false;
         colStruct.fCompressionType = colType.compressionType;
+        colStruct.fIndexType = colType.indexType;
+        colStruct.fCharsetNumber = colType.charsetNumber;
 
         // Token
         if (isDictCol(colType))
@@ -1402,6 +1640,8 @@ uint8_t WE_DMLCommandProc::processBatchInsert(messageqcpp::ByteStream& bs, std::
     }
   }
 
+  sortBatchRows(cscColTypeList, colStructs, colValuesList, dicStringList);
+
   // call the write engine to write the rows
   int error = NO_ERROR;
 
@@ -1721,6 +1961,8 @@ uint8_t WE_DMLCommandProc::processBatchInsertBinary(messageqcpp::ByteStream& bs,
         colStruct.dataOid = oid;
         colStruct.tokenFlag = false;
         colStruct.fCompressionType = colType.compressionType;
+        colStruct.fIndexType = colType.indexType;
+        colStruct.fCharsetNumber = colType.charsetNumber;
 
         // Token
         if (isDictCol(colType))
@@ -2151,6 +2393,25 @@ uint8_t WE_DMLCommandProc::processBatchInsertBinary(messageqcpp::ByteStream& bs,
     }
   }
 
+  if (colValuesList.size() > 0)
+  {
+    WriteEngine::CSCTypesList cscColTypeList;
+
+    try
+    {
+      for (unsigned j = 0; j < colStructs.size(); j++)
+        cscColTypeList.push_back(systemCatalogPtr->colType(colStructs[j].dataOid));
+
+      sortBatchRowsBinary(cscColTypeList, colStructs, colValuesList, dicStringList);
+    }
+    catch (std::exception& ex)
+    {
+      err = ex.what();
+      rc = 1;
+      return rc;
+    }
+  }
+
   // call the write engine to write the rows
   int error = NO_ERROR;
 
@@ -2901,6 +3162,8 @@ uint8_t WE_DMLCommandProc::processUpdate(messageqcpp::ByteStream& bs, std::strin
     colStruct.colDataType = colType.colDataType;
     colStruct.tokenFlag = false;
     colStruct.fCompressionType = colType.compressionType;
+    colStruct.fIndexType = colType.indexType;
+    colStruct.fCharsetNumber = colType.charsetNumber;
     tableColName.column = columnsUpdated[j]->get_Name();
 
     if (!ridsFetched)
@@ -4588,6 +4851,8 @@ uint8_t WE_DMLCommandProc::processFixRows(messageqcpp::ByteStream& bs, std::stri
       colStruct.dataOid = tableRidList[i].objnum;
       colStruct.tokenFlag = false;
       colStruct.fCompressionType = colType.compressionType;
+      colStruct.fIndexType = colType.indexType;
+      colStruct.fCharsetNumber = colType.charsetNumber;
       WriteEngine::DctnryStruct dctnryStruct;
       dctnryStruct.fColDbRoot = colStruct.fColDbRoot;
       dctnryStruct.fColPartition = colStruct.fColPartition;
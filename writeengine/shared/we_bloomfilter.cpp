@@ -0,0 +1,286 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file we_bloomfilter.cpp
+ * Bloom filters of the extents of a column segment file.
+ */
+
+#include "we_bloomfilter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+
+#include <boost/scoped_ptr.hpp>
+
+#include "we_define.h"
+#include "IDBDataFile.h"
+#include "hasher.h"
+
+using namespace idbdatafile;
+
+namespace
+{
+const uint32_t BLOOM_FILE_MAGIC = 0x46424d43;  // "CMBF"
+const uint32_t BLOOM_FILE_VERSION = 1;
+const uint32_t HASH_COUNT = 4;  // 16 bit positions out of one 64 bit hash
+const uint32_t HEADER_WORDS = 5;
+const uint64_t HEADER_SIZE = 64;
+
+// A block's slot is a marker then its filter; a block without a filter has no marker.
+const uint64_t SLOT_MARKER = 0x544f4c53464d4243ULL;
+const uint64_t SLOT_WORDS = 1 + WriteEngine::BloomFilter::WORDS;
+const uint64_t SLOT_SIZE = SLOT_WORDS * sizeof(uint64_t);
+
+inline uint64_t bloomHash(uint64_t key)
+{
+  // fmix() maps 0 to 0
+  return utils::fmix((uint64_t)(key + 0x9e3779b97f4a7c15ULL));
+}
+
+void makeHeader(uint32_t* header)
+{
+  header[0] = BLOOM_FILE_MAGIC;
+  header[1] = BLOOM_FILE_VERSION;
+  header[2] = WriteEngine::BlockBloomFilters::ROWS_PER_FILTER;
+  header[3] = WriteEngine::BloomFilter::BITS;
+  header[4] = HASH_COUNT;
+}
+
+bool checkHeader(IDBDataFile* file)
+{
+  uint32_t header[HEADER_WORDS], expected[HEADER_WORDS];
+  makeHeader(expected);
+
+  return file->pread(header, 0, sizeof(header)) == (ssize_t)sizeof(header) &&
+         std::equal(header, header + HEADER_WORDS, expected);
+}
+}  // namespace
+
+namespace WriteEngine
+{
+static_assert(BloomFilter::BITS == 65536, "bloom filter bit positions are 16 bits");
+
+void BloomFilter::add(uint64_t key)
+{
+  uint64_t h = bloomHash(key);
+
+  for (uint32_t i = 0; i < HASH_COUNT; i++, h >>= 16)
+    fWords[(h & 0xffff) >> 6] |= 1ULL << (h & 63);
+}
+
+bool BloomFilter::mayContain(uint64_t key) const
+{
+  uint64_t h = bloomHash(key);
+
+  for (uint32_t i = 0; i < HASH_COUNT; i++, h >>= 16)
+  {
+    if (!(fWords[(h & 0xffff) >> 6] & (1ULL << (h & 63))))
+      return false;
+  }
+
+  return true;
+}
+
+void BloomFilter::merge(const BloomFilter& other)
+{
+  for (uint32_t i = 0; i < WORDS; i++)
+    fWords[i] |= other.fWords[i];
+}
+
+void BloomFilter::fill()
+{
+  std::fill(fWords.begin(), fWords.end(), ~0ULL);
+}
+
+void BlockBloomFilters::merge(const BlockBloomFilters& other)
+{
+  for (const auto& filter : other.fFilters)
+    fFilters[filter.first].merge(filter.second);
+}
+
+const BloomFilter* BlockBloomFilters::find(uint64_t block) const
+{
+  std::map<uint64_t, BloomFilter>::const_iterator it = fFilters.find(block);
+  return (it == fFilters.end()) ? 0 : &it->second;
+}
+
+size_t BlockBloomFilters::memorySize() const
+{
+  return sizeof(*this) + fFilters.size() * (sizeof(uint64_t) + sizeof(BloomFilter) + BloomFilter::BITS / 8);
+}
+
+/* static */
+std::string BlockBloomFilters::getFileName(const std::string& segFileName)
+{
+  return segFileName + ".bloom";
+}
+
+//------------------------------------------------------------------------------
+// The file is a header of magic, version, rows per filter, bits and hashes,
+// then a slot for each block of the segment file, in order.
+//------------------------------------------------------------------------------
+int BlockBloomFilters::read(const std::string& segFileName, uint64_t first, uint64_t count,
+                            IDBPolicy::Contexts ctxt)
+{
+  std::string fileName = getFileName(segFileName);
+  fFilters.clear();
+
+  if (!IDBPolicy::exists(fileName.c_str()))
+    return ERR_FILE_NOT_EXIST;
+
+  try
+  {
+    boost::scoped_ptr<IDBDataFile> file(
+        IDBDataFile::open(IDBPolicy::getType(fileName.c_str(), ctxt), fileName.c_str(), "r", 0));
+
+    if (!file || !checkHeader(file.get()))
+      return ERR_FILE_READ;
+
+    off64_t fileSize = file->size();
+    off64_t offset = HEADER_SIZE + first * SLOT_SIZE;
+
+    if (fileSize < offset + (off64_t)SLOT_SIZE)
+      return NO_ERROR;
+
+    count = std::min(count, (uint64_t)(fileSize - offset) / SLOT_SIZE);
+    std::vector<uint64_t> slots(count * SLOT_WORDS);
+    ssize_t size = count * SLOT_SIZE;
+
+    if (file->pread(&slots[0], offset, size) != size)
+      return ERR_FILE_READ;
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+      std::vector<uint64_t>::const_iterator slot = slots.begin() + i * SLOT_WORDS;
+
+      if (*slot == SLOT_MARKER)
+        fFilters[first + i].fWords.assign(slot + 1, slot + SLOT_WORDS);
+    }
+  }
+  catch (std::exception&)
+  {
+    fFilters.clear();
+    return ERR_FILE_READ;
+  }
+
+  return NO_ERROR;
+}
+
+//------------------------------------------------------------------------------
+// OR the filters into their slots in place.  A reader can see a slot half
+// written, which is still a superset of the rows it can see: a new slot of an
+// appended block only has rows that aren't committed yet.  A file that can't
+// be read is started over, and then the first appended block, which can have
+// rows from before, gets a filter that rules out nothing.
+//------------------------------------------------------------------------------
+int BlockBloomFilters::save(const std::string& segFileName, bool appended) const
+{
+  if (fFilters.empty())
+    return NO_ERROR;
+
+  std::string fileName = getFileName(segFileName);
+  IDBDataFile::Types type = IDBPolicy::getType(fileName.c_str(), IDBPolicy::WRITEENG);
+  bool restarted = false;
+
+  try
+  {
+    boost::scoped_ptr<IDBDataFile> file;
+
+    if (IDBPolicy::exists(fileName.c_str()))
+    {
+      file.reset(IDBDataFile::open(type, fileName.c_str(), "r+b", 0));
+
+      if (!file)
+        return ERR_FILE_OPEN;
+
+      if (!checkHeader(file.get()))
+      {
+        file.reset();
+        restarted = true;
+      }
+    }
+
+    if (!file)
+    {
+      file.reset(IDBDataFile::open(type, fileName.c_str(), "w+b", 0));
+
+      if (!file)
+        return ERR_FILE_OPEN;
+
+      uint8_t header[HEADER_SIZE] = {0};
+      makeHeader(reinterpret_cast<uint32_t*>(header));
+
+      if (file->write(header, HEADER_SIZE) != (ssize_t)HEADER_SIZE)
+        return ERR_FILE_WRITE;
+    }
+
+    off64_t fileSize = file->size();
+    std::vector<uint64_t> slot(SLOT_WORDS);
+
+    for (std::map<uint64_t, BloomFilter>::const_iterator it = fFilters.begin(); it != fFilters.end(); ++it)
+    {
+      off64_t offset = HEADER_SIZE + it->first * SLOT_SIZE;
+      const std::vector<uint64_t>& words = it->second.fWords;
+
+      if (offset + (off64_t)SLOT_SIZE <= fileSize &&
+          file->pread(&slot[0], offset, SLOT_SIZE) == (ssize_t)SLOT_SIZE && slot[0] == SLOT_MARKER)
+      {
+        for (uint32_t i = 0; i < BloomFilter::WORDS; i++)
+          slot[i + 1] |= words[i];
+      }
+      else if (!appended || (restarted && it == fFilters.begin()))
+      {
+        std::fill(slot.begin() + 1, slot.end(), ~0ULL);
+      }
+      else
+      {
+        std::copy(words.begin(), words.end(), slot.begin() + 1);
+      }
+
+      slot[0] = SLOT_MARKER;
+
+      if (file->seek(offset, SEEK_SET) != 0)
+        return ERR_FILE_SEEK;
+
+      if (file->write(&slot[0], SLOT_SIZE) != (ssize_t)SLOT_SIZE)
+        return ERR_FILE_WRITE;
+    }
+
+    if (file->flush() != 0)
+      return ERR_FILE_WRITE;
+  }
+  catch (std::exception&)
+  {
+    return ERR_FILE_WRITE;
+  }
+
+  return NO_ERROR;
+}
+
+/* static */
+int BlockBloomFilters::remove(const std::string& segFileName)
+{
+  std::string fileName = getFileName(segFileName);
+
+  if (IDBPolicy::exists(fileName.c_str()) && IDBPolicy::remove(fileName.c_str()) != 0)
+    return ERR_FILE_DELETE;
+
+  return NO_ERROR;
+}
+
+}  // namespace WriteEngine
@@ -0,0 +1,126 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file we_bloomfilter.h
+ * Bloom filters of the extents of a column segment file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "IDBPolicy.h"
+
+#define EXPORT
+
+namespace WriteEngine
+{
+/** @brief Bloom filter of the values of a logical block of rows (64K bits, 4 hashes).
+ *
+ * Keys are the stored bytes of the values, see ColumnIndex::key().
+ */
+class BloomFilter
+{
+ public:
+  static const uint32_t BITS = 65536;
+  static const uint32_t WORDS = BITS / 64;
+
+  BloomFilter() : fWords(WORDS, 0)
+  {
+  }
+
+  EXPORT void add(uint64_t key);
+  EXPORT bool mayContain(uint64_t key) const;
+  EXPORT void merge(const BloomFilter& other);
+
+  /** @brief Set all the bits: the filter doesn't rule out any key */
+  EXPORT void fill();
+
+ private:
+  friend class BlockBloomFilters;
+  std::vector<uint64_t> fWords;
+};
+
+/** @brief The bloom filters of the logical blocks of a column segment file.
+ *
+ * cpimport and DML keep the filters of a column with a bloom filter (see
+ * CalpontSystemCatalog::BLOOM_FILTER) in a file next to each of its segment
+ * files, one for each logical block of ROWS_PER_FILTER rows, so an extent is
+ * the filters of its blocks.  PrimProc reads the filters of an extent to skip
+ * the blocks an equality or IN filter can't match without reading them.
+ *
+ * Keys are only ever added, so a filter can have the values of rows that were
+ * updated or deleted since.  A block that has no filter in the file can hold
+ * any value.
+ */
+class BlockBloomFilters
+{
+ public:
+  static const uint32_t ROWS_PER_FILTER = 8192;
+
+  void add(uint64_t key, uint64_t row)
+  {
+    fFilters[row / ROWS_PER_FILTER].add(key);
+  }
+
+  EXPORT void merge(const BlockBloomFilters& other);
+
+  /** @brief The filter of a block, or 0 if it has none */
+  EXPORT const BloomFilter* find(uint64_t block) const;
+
+  bool empty() const
+  {
+    return fFilters.empty();
+  }
+
+  void clear()
+  {
+    fFilters.clear();
+  }
+
+  EXPORT size_t memorySize() const;
+
+  /** @brief The name of the bloom filter file of a segment file */
+  EXPORT static std::string getFileName(const std::string& segFileName);
+
+  /** @brief Read the filters of the blocks [first, first + count) of a segment file.
+   * @return NO_ERROR, ERR_FILE_NOT_EXIST if it has none, or ERR_FILE_READ
+   */
+  EXPORT int read(const std::string& segFileName, uint64_t first, uint64_t count,
+                  idbdatafile::IDBPolicy::Contexts ctxt);
+
+  /** @brief Add these filters to the ones of a segment file.
+   *
+   * appended tells that the rows were appended to the file: the rows of a block
+   * without a filter in the file that weren't added are empty.  Otherwise a block
+   * without a filter gets one that rules out nothing.
+   */
+  EXPORT int save(const std::string& segFileName, bool appended) const;
+
+  /** @brief Delete the bloom filters of a segment file, if it has any */
+  EXPORT static int remove(const std::string& segFileName);
+
+ private:
+  std::map<uint64_t, BloomFilter> fFilters;
+};
+
+}  // namespace WriteEngine
+
+#undef EXPORT
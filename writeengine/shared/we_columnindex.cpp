@@ -0,0 +1,468 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file we_columnindex.cpp
+ * Inverted index of a column segment file.
+ */
+
+#include "we_columnindex.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include <boost/scoped_ptr.hpp>
+
+#include "we_define.h"
+#include "IDBDataFile.h"
+
+using namespace execplan;
+using namespace idbdatafile;
+using namespace messageqcpp;
+
+namespace
+{
+const uint32_t INDEX_FILE_MAGIC = 0x58494d43;  // "CMIX"
+const uint32_t INDEX_FILE_VERSION = 1;
+
+const uint8_t ARRAY_GROUP = 0;
+const uint8_t BITMAP_GROUP = 1;
+}  // namespace
+
+namespace WriteEngine
+{
+//------------------------------------------------------------------------------
+// Add the lower 16 bits of a row to its group
+//------------------------------------------------------------------------------
+void RowIdSet::Group::add(uint16_t low)
+{
+  if (!bitmap.empty())
+  {
+    bitmap[low >> 6] |= 1ULL << (low & 63);
+    return;
+  }
+
+  // rows mostly come in order
+  if (array.empty() || array.back() < low)
+  {
+    array.push_back(low);
+  }
+  else
+  {
+    std::vector<uint16_t>::iterator it = std::lower_bound(array.begin(), array.end(), low);
+
+    if (*it == low)
+      return;
+
+    array.insert(it, low);
+  }
+
+  if (array.size() > MAX_ARRAY_SIZE)
+    toBitmap();
+}
+
+void RowIdSet::Group::toBitmap()
+{
+  if (!bitmap.empty())
+    return;
+
+  bitmap.assign(BITMAP_WORDS, 0);
+
+  for (uint16_t low : array)
+    bitmap[low >> 6] |= 1ULL << (low & 63);
+
+  std::vector<uint16_t>().swap(array);
+}
+
+void RowIdSet::add(uint32_t row)
+{
+  fGroups[row >> 16].add(row & 0xffff);
+}
+
+void RowIdSet::merge(const RowIdSet& other)
+{
+  for (const auto& otherGroup : other.fGroups)
+  {
+    Group& group = fGroups[otherGroup.first];
+
+    if (otherGroup.second.bitmap.empty())
+    {
+      for (uint16_t low : otherGroup.second.array)
+        group.add(low);
+
+      continue;
+    }
+
+    group.toBitmap();
+
+    for (uint32_t i = 0; i < BITMAP_WORDS; i++)
+      group.bitmap[i] |= otherGroup.second.bitmap[i];
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the rows of a range within a group
+//------------------------------------------------------------------------------
+uint32_t RowIdSet::getRange(uint32_t first, uint32_t count, uint16_t* rows) const
+{
+  std::map<uint32_t, Group>::const_iterator it = fGroups.find(first >> 16);
+
+  if (it == fGroups.end())
+    return 0;
+
+  const Group& group = it->second;
+  uint32_t begin = first & 0xffff;
+  uint32_t end = begin + count;
+  uint32_t n = 0;
+
+  if (group.bitmap.empty())
+  {
+    std::vector<uint16_t>::const_iterator low =
+        std::lower_bound(group.array.begin(), group.array.end(), (uint16_t)begin);
+
+    for (; low != group.array.end() && *low < end; ++low)
+      rows[n++] = *low - begin;
+
+    return n;
+  }
+
+  for (uint32_t word = begin >> 6; word < (end >> 6); word++)
+  {
+    uint64_t bits = group.bitmap[word];
+
+    while (bits != 0)
+    {
+      rows[n++] = (word << 6) + __builtin_ctzll(bits) - begin;
+      bits &= bits - 1;
+    }
+  }
+
+  return n;
+}
+
+size_t RowIdSet::memorySize() const
+{
+  size_t size = sizeof(*this);
+
+  for (const auto& group : fGroups)
+    size += sizeof(group) + group.second.array.capacity() * sizeof(uint16_t) +
+            group.second.bitmap.capacity() * sizeof(uint64_t);
+
+  return size;
+}
+
+//------------------------------------------------------------------------------
+// A group is its upper 16 bits, its kind, and its array or bitmap
+//------------------------------------------------------------------------------
+void RowIdSet::serialize(ByteStream& bs) const
+{
+  bs << (uint32_t)fGroups.size();
+
+  for (const auto& group : fGroups)
+  {
+    bs << group.first;
+
+    if (group.second.bitmap.empty())
+    {
+      bs << ARRAY_GROUP;
+      bs << (uint32_t)group.second.array.size();
+      bs.append(reinterpret_cast<const uint8_t*>(group.second.array.data()),
+                group.second.array.size() * sizeof(uint16_t));
+    }
+    else
+    {
+      bs << BITMAP_GROUP;
+      bs.append(reinterpret_cast<const uint8_t*>(group.second.bitmap.data()),
+                BITMAP_WORDS * sizeof(uint64_t));
+    }
+  }
+}
+
+void RowIdSet::deserialize(ByteStream& bs)
+{
+  uint32_t groupCount;
+  fGroups.clear();
+  bs >> groupCount;
+
+  for (uint32_t i = 0; i < groupCount; i++)
+  {
+    uint32_t high;
+    uint8_t kind;
+    bs >> high;
+    bs >> kind;
+    Group& group = fGroups[high];
+
+    if (kind == ARRAY_GROUP)
+    {
+      uint32_t size;
+      bs >> size;
+
+      if (size > MAX_ARRAY_SIZE + 1 || bs.length() < size * sizeof(uint16_t))
+        throw std::runtime_error("RowIdSet::deserialize: bad array");
+
+      group.array.resize(size);
+      memcpy(group.array.data(), bs.buf(), size * sizeof(uint16_t));
+      bs.advance(size * sizeof(uint16_t));
+    }
+    else
+    {
+      if (bs.length() < BITMAP_WORDS * sizeof(uint64_t))
+        throw std::runtime_error("RowIdSet::deserialize: bad bitmap");
+
+      group.bitmap.resize(BITMAP_WORDS);
+      memcpy(group.bitmap.data(), bs.buf(), BITMAP_WORDS * sizeof(uint64_t));
+      bs.advance(BITMAP_WORDS * sizeof(uint64_t));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ColumnIndex::ColumnIndex() : fCoverBegin(0), fCoverEnd(0), fAppended(false)
+{
+}
+
+//------------------------------------------------------------------------------
+// Filters compare the values of these types as they're stored, so a filter
+// value is looked up by its bytes.  Floating point columns have two zeroes and
+// strings collations, they can't be, but for the strings stored in the column
+// with a binary collation that doesn't pad: PrimProc compares those by their
+// bytes too.
+//------------------------------------------------------------------------------
+/* static */
+bool ColumnIndex::isIndexable(CalpontSystemCatalog::ColDataType type, int width, uint32_t charsetNumber)
+{
+  if (width > 8)
+    return false;
+
+  switch (type)
+  {
+    case CalpontSystemCatalog::TINYINT:
+    case CalpontSystemCatalog::SMALLINT:
+    case CalpontSystemCatalog::MEDINT:
+    case CalpontSystemCatalog::INT:
+    case CalpontSystemCatalog::BIGINT:
+    case CalpontSystemCatalog::DECIMAL:
+    case CalpontSystemCatalog::UTINYINT:
+    case CalpontSystemCatalog::USMALLINT:
+    case CalpontSystemCatalog::UMEDINT:
+    case CalpontSystemCatalog::UINT:
+    case CalpontSystemCatalog::UBIGINT:
+    case CalpontSystemCatalog::UDECIMAL:
+    case CalpontSystemCatalog::DATE:
+    case CalpontSystemCatalog::DATETIME:
+    case CalpontSystemCatalog::TIME:
+    case CalpontSystemCatalog::TIMESTAMP: return true;
+
+    case CalpontSystemCatalog::CHAR:
+    case CalpontSystemCatalog::VARCHAR:
+    case CalpontSystemCatalog::VARBINARY:
+    {
+      const uint32_t binary = MY_CS_BINSORT | MY_CS_NOPAD;
+      return (datatypes::Charset(charsetNumber).getCharset().state & binary) == binary;
+    }
+
+    default: return false;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Extend the covered rows.  Of two ranges that don't touch the first is kept,
+// being the one that can grow into a prefix of the file.
+//------------------------------------------------------------------------------
+void ColumnIndex::cover(uint64_t first, uint64_t count)
+{
+  if (count == 0)
+    return;
+
+  if (fCoverBegin == fCoverEnd || first + count < fCoverBegin)
+  {
+    fCoverBegin = first;
+    fCoverEnd = first + count;
+  }
+  else if (first <= fCoverEnd)
+  {
+    fCoverBegin = std::min(fCoverBegin, first);
+    fCoverEnd = std::max(fCoverEnd, first + count);
+  }
+}
+
+void ColumnIndex::merge(const ColumnIndex& other)
+{
+  for (const auto& entry : other.fEntries)
+    fEntries[entry.first].merge(entry.second);
+
+  cover(other.fCoverBegin, other.fCoverEnd - other.fCoverBegin);
+}
+
+const RowIdSet* ColumnIndex::find(uint64_t key) const
+{
+  std::map<uint64_t, RowIdSet>::const_iterator it = fEntries.find(key);
+  return (it == fEntries.end()) ? 0 : &it->second;
+}
+
+size_t ColumnIndex::memorySize() const
+{
+  size_t size = sizeof(*this);
+
+  for (const auto& entry : fEntries)
+    size += sizeof(entry.first) + entry.second.memorySize();
+
+  return size;
+}
+
+/* static */
+std::string ColumnIndex::getFileName(const std::string& segFileName)
+{
+  return segFileName + ".idx";
+}
+
+//------------------------------------------------------------------------------
+// The file is a header of magic, version, and the covered rows, then the
+// count of keys and each key with its rows.
+//------------------------------------------------------------------------------
+int ColumnIndex::read(const std::string& segFileName, IDBPolicy::Contexts ctxt)
+{
+  std::string fileName = getFileName(segFileName);
+  fEntries.clear();
+  fCoverBegin = fCoverEnd = 0;
+
+  if (!IDBPolicy::exists(fileName.c_str()))
+    return ERR_FILE_NOT_EXIST;
+
+  try
+  {
+    boost::scoped_ptr<IDBDataFile> file(
+        IDBDataFile::open(IDBPolicy::getType(fileName.c_str(), ctxt), fileName.c_str(), "r", 0));
+
+    if (!file)
+      return ERR_FILE_READ;
+
+    ByteStream bs;
+    ssize_t size = file->size();
+    bs.needAtLeast(size);
+
+    if (size < 0 || file->read(bs.getInputPtr(), size) != size)
+      return ERR_FILE_READ;
+
+    bs.advanceInputPtr(size);
+
+    uint32_t magic, version;
+    uint64_t entryCount;
+    bs >> magic;
+    bs >> version;
+
+    if (magic != INDEX_FILE_MAGIC || version != INDEX_FILE_VERSION)
+      return ERR_FILE_READ;
+
+    bs >> fCoverBegin;
+    bs >> fCoverEnd;
+    bs >> entryCount;
+
+    for (uint64_t i = 0; i < entryCount; i++)
+    {
+      uint64_t key;
+      bs >> key;
+      fEntries[key].deserialize(bs);
+    }
+  }
+  catch (std::exception&)
+  {
+    fEntries.clear();
+    fCoverBegin = fCoverEnd = 0;
+    return ERR_FILE_READ;
+  }
+
+  return NO_ERROR;
+}
+
+//------------------------------------------------------------------------------
+// Merge into the index of the segment file and replace it.  An index that
+// can't be read is started over; it covers no rows until the file is rewritten
+// from its first row, so readers won't use what's lost.  Appended rows extend
+// the covered rows of an existing index over the empty rows before them; without
+// one, or if it covers no rows, the rows before them may never have been added
+// and stay uncovered.
+//------------------------------------------------------------------------------
+int ColumnIndex::save(const std::string& segFileName) const
+{
+  ColumnIndex index;
+  int rc = index.read(segFileName, IDBPolicy::WRITEENG);
+
+  if (rc != NO_ERROR && rc != ERR_FILE_NOT_EXIST)
+    index = ColumnIndex();
+  else if (rc == NO_ERROR && fAppended && index.fCoverBegin == 0 && index.fCoverEnd > 0 &&
+           index.fCoverEnd < fCoverBegin)
+    index.cover(index.fCoverEnd, fCoverBegin - index.fCoverEnd);
+
+  index.merge(*this);
+
+  ByteStream bs;
+  bs << INDEX_FILE_MAGIC;
+  bs << INDEX_FILE_VERSION;
+  bs << index.fCoverBegin;
+  bs << index.fCoverEnd;
+  bs << (uint64_t)index.fEntries.size();
+
+  for (const auto& entry : index.fEntries)
+  {
+    bs << entry.first;
+    entry.second.serialize(bs);
+  }
+
+  std::string fileName = getFileName(segFileName);
+  std::string tmpFileName = fileName + ".tmp";
+
+  try
+  {
+    boost::scoped_ptr<IDBDataFile> file(IDBDataFile::open(
+        IDBPolicy::getType(tmpFileName.c_str(), IDBPolicy::WRITEENG), tmpFileName.c_str(), "w+b", 0));
+
+    if (!file)
+      return ERR_FILE_OPEN;
+
+    if (file->write(bs.buf(), bs.length()) != (ssize_t)bs.length() || file->flush() != 0)
+      return ERR_FILE_WRITE;
+  }
+  catch (std::exception&)
+  {
+    return ERR_FILE_WRITE;
+  }
+
+  // readers see the old or the new index, never part of one
+  if (IDBPolicy::rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+  {
+    IDBPolicy::remove(tmpFileName.c_str());
+    return ERR_FILE_WRITE;
+  }
+
+  return NO_ERROR;
+}
+
+/* static */
+int ColumnIndex::remove(const std::string& segFileName)
+{
+  std::string fileName = getFileName(segFileName);
+
+  if (IDBPolicy::exists(fileName.c_str()) && IDBPolicy::remove(fileName.c_str()) != 0)
+    return ERR_FILE_DELETE;
+
+  return NO_ERROR;
+}
+
+}  // namespace WriteEngine
@@ -0,0 +1,172 @@
+/* Copyright (C) 2024 MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA. */
+
+/** @file we_columnindex.h
+ * Inverted index of a column segment file.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "bytestream.h"
+#include "calpontsystemcatalog.h"
+#include "IDBPolicy.h"
+
+#define EXPORT
+
+namespace WriteEngine
+{
+/** @brief A set of the file-relative row numbers of a column segment file.
+ *
+ * Rows are grouped by their upper 16 bits, like in a roaring bitmap.  A group
+ * keeps the lower 16 bits of its rows in a sorted array until it has more than
+ * MAX_ARRAY_SIZE of them, and in a 64K bit bitmap after that.
+ */
+class RowIdSet
+{
+ public:
+  EXPORT void add(uint32_t row);
+  EXPORT void merge(const RowIdSet& other);
+
+  /** @brief Get the rows of [first, first + count) relative to first, in order.
+   *
+   * count has to be a power of 2 from 64 to 64K, and first a multiple of it.
+   * @return the number of rows stored in rows
+   */
+  EXPORT uint32_t getRange(uint32_t first, uint32_t count, uint16_t* rows) const;
+
+  bool empty() const
+  {
+    return fGroups.empty();
+  }
+
+  EXPORT size_t memorySize() const;
+
+  EXPORT void serialize(messageqcpp::ByteStream& bs) const;
+  EXPORT void deserialize(messageqcpp::ByteStream& bs);
+
+ private:
+  static const uint32_t MAX_ARRAY_SIZE = 4096;
+  static const uint32_t BITMAP_WORDS = 65536 / 64;
+
+  struct Group
+  {
+    std::vector<uint16_t> array;  // used while bitmap is empty
+    std::vector<uint64_t> bitmap;
+
+    void add(uint16_t low);
+    void toBitmap();
+  };
+
+  std::map<uint32_t, Group> fGroups;
+};
+
+/** @brief Inverted index of a column segment file: the rows each value is in.
+ *
+ * cpimport and DML keep the index of a column with an inverted index (see
+ * CalpontSystemCatalog::INVERTED_INDEX) in a file next to each of its segment
+ * files, and PrimProc reads it to go straight to the rows an equality or IN
+ * filter can match.
+ *
+ * Rows are only ever added, so after an update or a delete a value can still
+ * list rows that don't hold it anymore; readers have to filter the rows they
+ * get.  The rows of [0, coveredRows()) were all added, the values of the rows
+ * after them can be missing from the index.
+ */
+class ColumnIndex
+{
+ public:
+  EXPORT ColumnIndex();
+
+  /** @brief Whether the values of a column of this type are indexed as they're stored
+   *
+   * charsetNumber is the collation of a string column, see CalpontSystemCatalog::ColType.
+   */
+  EXPORT static bool isIndexable(execplan::CalpontSystemCatalog::ColDataType type, int width,
+                                 uint32_t charsetNumber);
+
+  /** @brief The key of a stored column value: its bytes, zero extended */
+  static uint64_t key(const void* value, int width)
+  {
+    uint64_t k = 0;
+    memcpy(&k, value, width);
+    return k;
+  }
+
+  void add(uint64_t key, uint32_t row)
+  {
+    fEntries[key].add(row);
+  }
+
+  /** @brief Record that all the rows of [first, first + count) were added */
+  EXPORT void cover(uint64_t first, uint64_t count);
+
+  /** @brief Record that the rows of [first, first + count) were added, having
+   *  been appended to the file: the rows it had that weren't added are empty.
+   */
+  void coverAppended(uint64_t first, uint64_t count)
+  {
+    cover(first, count);
+    fAppended = true;
+  }
+
+  EXPORT void merge(const ColumnIndex& other);
+
+  /** @brief The rows of a key, or 0 if it isn't in the index */
+  EXPORT const RowIdSet* find(uint64_t key) const;
+
+  uint64_t coveredRows() const
+  {
+    return (fCoverBegin == 0) ? fCoverEnd : 0;
+  }
+
+  bool empty() const
+  {
+    return fEntries.empty() && fCoverBegin == fCoverEnd;
+  }
+
+  EXPORT size_t memorySize() const;
+
+  /** @brief The name of the index file of a segment file */
+  EXPORT static std::string getFileName(const std::string& segFileName);
+
+  /** @brief Read the index of a segment file.
+   * @return NO_ERROR, ERR_FILE_NOT_EXIST if it has none, or ERR_FILE_READ
+   */
+  EXPORT int read(const std::string& segFileName, idbdatafile::IDBPolicy::Contexts ctxt);
+
+  /** @brief Add this index to the one of a segment file */
+  EXPORT int save(const std::string& segFileName) const;
+
+  /** @brief Delete the index of a segment file, if it has one */
+  EXPORT static int remove(const std::string& segFileName);
+
+ private:
+  std::map<uint64_t, RowIdSet> fEntries;
+  uint64_t fCoverBegin;  // [fCoverBegin, fCoverEnd) are the rows known to be added
+  uint64_t fCoverEnd;
+  bool fAppended;  // the rows were appended, see coverAppended()
+};
+
+}  // namespace WriteEngine
+
+#undef EXPORT
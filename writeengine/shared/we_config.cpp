@@ -47,6 +47,7 @@ const unsigned DEFAULT_EXTENTS_PER_SEGMENT_FILE = 2;
 const int DEFAULT_BULK_PROCESS_PRIORITY = -1;
 const unsigned DEFAULT_MAX_FILESYSTEM_DISK_USAGE = 98;  // allow 98% full
 const unsigned DEFAULT_COMPRESSED_PADDING_BLKS = 1;
+const uint64_t DEFAULT_SORT_BUFFER_SIZE = 128 * 1024 * 1024;
 const int DEFAULT_LOCAL_MODULE_ID = 1;
 const bool DEFAULT_PARENT_OAM = true;
 const char* DEFAULT_LOCAL_MODULE_TYPE = "pm";
@@ -71,6 +72,7 @@ string Config::m_BulkRollbackDir;
 bool Config::m_FastDelete;
 unsigned Config::m_MaxFileSystemDiskUsage = DEFAULT_MAX_FILESYSTEM_DISK_USAGE;
 unsigned Config::m_NumCompressedPadBlks = DEFAULT_COMPRESSED_PADDING_BLKS;
+uint64_t Config::m_SortBufferSize = DEFAULT_SORT_BUFFER_SIZE;
 bool Config::m_ParentOAMModuleFlag = DEFAULT_PARENT_OAM;
 string Config::m_LocalModuleType;
 int Config::m_LocalModuleID = DEFAULT_LOCAL_MODULE_ID;
@@ -217,6 +219,15 @@ void Config::checkReload()
   if (ncpb.length() != 0)
     m_NumCompressedPadBlks = cf->uFromText(ncpb);
 
+  //--------------------------------------------------------------------------
+  // Memory to sort the rows of a table with a sort key in
+  //--------------------------------------------------------------------------
+  m_SortBufferSize = DEFAULT_SORT_BUFFER_SIZE;
+  string sbs = cf->getConfig("WriteEngine", "SortBufferSize");
+
+  if (sbs.length() != 0)
+    m_SortBufferSize = cf->uFromText(sbs);
+
   IDBPolicy::configIDBPolicy();
 
   //--------------------------------------------------------------------------
@@ -570,6 +581,21 @@ unsigned Config::getNumCompressedPadBlks()
   return m_NumCompressedPadBlks;
 }
 
+/*******************************************************************************
+ * DESCRIPTION:
+ *    Get the memory cpimport sorts the rows of a table with a sort key in;
+ *    it's shared by the read buffers of the table.
+ * PARAMETERS:
+ *    none
+ ******************************************************************************/
+uint64_t Config::getSortBufferSize()
+{
+  boost::mutex::scoped_lock lk(fCacheLock);
+  checkReload();
+
+  return m_SortBufferSize;
+}
+
 /*******************************************************************************
  * DESCRIPTION:
  *    Get Parent OAM Module flag; are we running on active parent OAM node.
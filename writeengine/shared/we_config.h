@@ -136,6 +136,11 @@ class Config
    */
   EXPORT static unsigned getNumCompressedPadBlks();
 
+  /**
+   * @brief Memory to sort the rows of a table with a sort key in (cpimport).
+   */
+  EXPORT static uint64_t getSortBufferSize();
+
   /**
    * @brief Parent OAM Module flag (is this the parent OAM node, ex: pm1)
    */
@@ -194,6 +199,7 @@ class Config
   static bool m_FastDelete;                   // fast delete option
   static unsigned m_MaxFileSystemDiskUsage;   // max file system % disk usage
   static unsigned m_NumCompressedPadBlks;     // num blks to pad comp chunks
+  static uint64_t m_SortBufferSize;           // memory to sort rows in
   static bool m_ParentOAMModuleFlag;          // are we running on parent PM
   static std::string m_LocalModuleType;       // local node type (ex: "pm")
   static int m_LocalModuleID;                 // local node id   (ex: 1   )
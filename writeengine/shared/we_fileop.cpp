@@ -42,6 +42,8 @@ using namespace std;
 #include "we_convertor.h"
 #include "we_log.h"
 #include "we_config.h"
+#include "we_columnindex.h"
+#include "we_bloomfilter.h"
 #include "we_stats.h"
 #include "we_simplesyslog.h"
 
@@ -398,7 +400,9 @@ int FileOp::deletePartitions(const std::vector<OID>& fids,
     rcd = snprintf(rootOidDirName, FILE_NAME_SIZE, "%s/%s", rt.c_str(), tempFileName);
     rcp = snprintf(partitionDirName, FILE_NAME_SIZE, "%s/%s", rt.c_str(), oidDirName);
 
-    if (rcd == FILE_NAME_SIZE || rcp == FILE_NAME_SIZE || IDBPolicy::remove(rootOidDirName) != 0)
+    if (rcd == FILE_NAME_SIZE || rcp == FILE_NAME_SIZE || IDBPolicy::remove(rootOidDirName) != 0 ||
+        ColumnIndex::remove(rootOidDirName) != NO_ERROR ||
+        BlockBloomFilters::remove(rootOidDirName) != NO_ERROR)
     {
       ostringstream oss;
       oss << "Unable to remove " << rootOidDirName;
@@ -442,6 +446,8 @@ int FileOp::deleteFile(FID fid, uint16_t dbRoot, uint32_t partition, uint16_t se
   char fileName[FILE_NAME_SIZE];
 
   RETURN_ON_ERROR(getFileName(fid, fileName, dbRoot, partition, segment));
+  RETURN_ON_ERROR(ColumnIndex::remove(fileName));
+  RETURN_ON_ERROR(BlockBloomFilters::remove(fileName));
 
   return (deleteFile(fileName));
 }
@@ -274,12 +274,16 @@ struct Column /** @brief Column structure */
   execplan::CalpontSystemCatalog::ColDataType colDataType; /** @brief column data type (from interface)*/
   File dataFile;                                           /** @brief column data file */
   int compressionType;                                     /** @brief column compression type*/
+  int indexType;                                           /** @brief column secondary indexes */
+  uint32_t charsetNumber;                                  /** @brief column charset (strings) */
   Column()
    : colNo(0)
    , colWidth(0)
    , colType(WR_INT)
    , colDataType(execplan::CalpontSystemCatalog::INT)
    , compressionType(idbdatafile::IDBPolicy::useHdfs() ? 2 : 0)
+   , indexType(0)
+   , charsetNumber(0)
   {
   }
 };
@@ -315,6 +319,8 @@ struct ColStruct /** @brief Column Interface Struct*/
   uint16_t fColSegment;   /** @brief Segment for column file*/
   uint16_t fColDbRoot;    /** @brief DBRoot for column file */
   int fCompressionType;   /** @brief Compression tpye for column file */
+  int fIndexType;         /** @brief Secondary indexes of the column */
+  uint32_t fCharsetNumber; /** @brief Charset of a string column */
   ColStruct()
    : dataOid(0)
    , colWidth(0)
@@ -326,6 +332,8 @@ struct ColStruct /** @brief Column Interface Struct*/
    , fColSegment(0)
    , fColDbRoot(0)
    , fCompressionType(idbdatafile::IDBPolicy::useHdfs() ? 2 : 0)
+   , fIndexType(0)
+   , fCharsetNumber(0)
   {
   }
 };
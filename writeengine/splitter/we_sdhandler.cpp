@@ -31,6 +31,8 @@
 #include <ctime>
 #include <fstream>
 #include <istream>
+#include <sys/wait.h>
+#include <unistd.h>
 using namespace std;
 
 #include "we_messages.h"
@@ -54,6 +56,7 @@ using namespace config;
 using namespace messageqcpp;
 
 #include "calpontsystemcatalog.h"
+#include "aggregateprojection.h"
 using namespace execplan;
 
 #include "batchloader.h"
@@ -1278,6 +1281,12 @@ void WESDHandler::onBrmReport(int PmId, messageqcpp::SBS& Sbs)
     if (getDebugLvl() > 2)
       cout << "BRM Report value : " << aStr << endl;
 
+    if (aStr.compare(0, 5, "AGG: ") == 0)
+    {
+      add2ProjectionRows(aStr);
+      continue;
+    }
+
     bool aRet = WEBrmUpdater::prepareRowsInsertedInfo(aStr, aTotRows, aInsRows);
 
     if (aRet)
@@ -1742,6 +1751,122 @@ void WESDHandler::onRollbackResult(int PmId, messageqcpp::SBS& Sbs)
   }
 }
 
+//------------------------------------------------------------------------------
+// Keep a row of an aggregate projection from a BRM report, which has the form
+// "AGG: <schema>.<table> <row>"
+//------------------------------------------------------------------------------
+void WESDHandler::add2ProjectionRows(const std::string& Entry)
+{
+  std::string::size_type aPos = Entry.find(' ', 5);
+
+  if (aPos == std::string::npos)
+    return;
+
+  fProjectionRows[Entry.substr(5, aPos - 5)].push_back(Entry.substr(aPos + 1));
+}
+
+//------------------------------------------------------------------------------
+// Load the rows the PMs aggregated into the aggregate projections of the table
+// by running cpimport on them in mode 1.  The import of the table is committed
+// by now; a projection that fails to load is marked stale.  A table that is
+// itself a projection is populated now, so it's current.
+//------------------------------------------------------------------------------
+void WESDHandler::loadProjections()
+{
+  try
+  {
+    execplan::AggregateProjection::loaded(
+        execplan::CalpontSystemCatalog::TableName(fRef.fCmdArgs.getSchemaName(),
+                                                  fRef.fCmdArgs.getTableName()),
+        this->getTableOID());
+  }
+  catch (std::exception& aEx)
+  {
+    std::ostringstream aOss;
+    aOss << "Aggregate projection " << fRef.fCmdArgs.getSchemaName() << "." << fRef.fCmdArgs.getTableName()
+         << " is still stale; " << aEx.what();
+    fLog.logMsg(aOss.str(), MSGLVL_WARNING);
+  }
+
+  std::map<std::string, StrVec>::const_iterator aIt;
+
+  for (aIt = fProjectionRows.begin(); aIt != fProjectionRows.end(); ++aIt)
+  {
+    std::string::size_type aPos = aIt->first.find('.');
+
+    if (aPos == std::string::npos)
+      continue;
+
+    std::ostringstream aFileName;
+    aFileName << startup::StartUp::tmpDir() << "/" << aIt->first << "_" << getpid() << ".agg";
+    std::ofstream aFile(aFileName.str().c_str(), std::ofstream::trunc);
+
+    for (unsigned int aIdx = 0; aIdx < aIt->second.size(); aIdx++)
+      aFile << aIt->second[aIdx] << "\n";
+
+    aFile.close();
+
+    std::ostringstream aOss;
+    aOss << "Loading " << aIt->second.size() << " rows into aggregate projection " << aIt->first;
+    fLog.logMsg(aOss.str(), MSGLVL_INFO2);
+
+    int aStatus = -1;
+
+    if (!aFile.fail())
+    {
+      std::vector<std::string> aArgs{"cpimport", "-m", "1", "-s", "|", "-E", "\"", "-C", "\\", "-e", "0",
+                                     aIt->first.substr(0, aPos), aIt->first.substr(aPos + 1),
+                                     aFileName.str()};
+
+      if (!fRef.fCmdArgs.getConsoleOutput())
+        aArgs.insert(aArgs.begin() + 1, "-N");
+
+      std::vector<char*> aArgv;
+
+      for (unsigned int aIdx = 0; aIdx < aArgs.size(); aIdx++)
+        aArgv.push_back(const_cast<char*>(aArgs[aIdx].c_str()));
+
+      aArgv.push_back(0);
+      pid_t aPid = fork();
+
+      if (aPid == 0)
+      {
+        execv("/proc/self/exe", &aArgv[0]);
+        _exit(127);
+      }
+
+      if (aPid > 0)
+        waitpid(aPid, &aStatus, 0);
+    }
+
+    unlink(aFileName.str().c_str());
+
+    if (!WIFEXITED(aStatus) || WEXITSTATUS(aStatus) != 0)
+    {
+      std::ostringstream aOssErr;
+      aOssErr << "Loading aggregate projection " << aIt->first << " failed; it is stale and must be rebuilt";
+      fLog.logMsg(aOssErr.str(), MSGLVL_WARNING);
+
+      try
+      {
+        execplan::CalpontSystemCatalog::TableName aProjTable(aIt->first.substr(0, aPos),
+                                                             aIt->first.substr(aPos + 1));
+        boost::shared_ptr<execplan::CalpontSystemCatalog> aCat =
+            execplan::CalpontSystemCatalog::makeCalpontSystemCatalog();
+        execplan::AggregateProjection::markStale(aCat->tableRID(aProjTable).objnum);
+      }
+      catch (std::exception& aEx)
+      {
+        std::ostringstream aOssMark;
+        aOssMark << "Error marking aggregate projection " << aIt->first << " stale due to:  " << aEx.what();
+        fLog.logMsg(aOssMark.str(), MSGLVL_ERROR);
+      }
+    }
+  }
+
+  fProjectionRows.clear();
+}
+
 //------------------------------------------------------------------------------
 
 void WESDHandler::onCleanupResult(int PmId, messageqcpp::SBS& Sbs)
@@ -1880,6 +2005,7 @@ void WESDHandler::onCleanupResult(int PmId, messageqcpp::SBS& Sbs)
       if (fRef.fCmdArgs.getConsoleOutput())
         fLog.logMsg(oss1.str(), MSGLVL_INFO1);
 
+      loadProjections();
       fRef.onSigInterrupt(0);  // 0 for entire success
     }
     else
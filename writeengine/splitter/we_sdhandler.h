@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <map>
+
 #include "liboamcpp.h"
 #include "resourcemanager.h"
 #include "threadsafequeue.h"
@@ -108,6 +110,8 @@ class WESDHandler
   bool check4PmArguments();
   void setInputFileList(std::string InFileName);
   bool check4CriticalErrMsgs(std::string& Entry);
+  void add2ProjectionRows(const std::string& Entry);
+  void loadProjections();
 
   void onStartCpiResponse(int PmId);
   void onDataRqstResponse(int PmId);
@@ -296,6 +300,10 @@ class WESDHandler
   typedef std::vector<std::string> StrVec;
   StrVec fBrmRptVec;
 
+  // rows the PMs aggregated for the aggregate projections of the table,
+  // loaded once the import is committed (see loadProjections())
+  std::map<std::string, StrVec> fProjectionRows;
+
   BRM::DBRM fDbrm;
 
   batchloader::BatchLoader* fpBatchLoader;
@@ -73,6 +73,8 @@ ColumnOp::ColumnOp(Log* logger)
  */
 ColumnOp::~ColumnOp()
 {
+  // the statement's flush saves them; this is for a write that wasn't flushed
+  saveColumnIndexes();
 }
 
 /***********************************************************
@@ -1522,6 +1524,13 @@ int ColumnOp::writeRow(Column& curCol, uint64_t totalRow, const RID* rowIdArray,
   char charTmpBuf[8];
   int rc = NO_ERROR;
   uint16_t rowsInBlock = BYTE_PER_BLOCK / curCol.colWidth;
+  bool bIndex = !bDelete && (curCol.indexType & CalpontSystemCatalog::INVERTED_INDEX) &&
+                ColumnIndex::isIndexable(curCol.colDataType, curCol.colWidth, curCol.charsetNumber);
+  bool bBloom = !bDelete && (curCol.indexType & CalpontSystemCatalog::BLOOM_FILTER) &&
+                ColumnIndex::isIndexable(curCol.colDataType, curCol.colWidth, curCol.charsetNumber);
+  ColumnIndex index;
+  BlockBloomFilters bloomFilters;
+  uint64_t coverEnd = rowIdArray[0];
 
   while (!bExit)
   {
@@ -1652,6 +1661,17 @@ int ColumnOp::writeRow(Column& curCol, uint64_t totalRow, const RID* rowIdArray,
 
     writeBufValue(dataBuf + dataBio, pVal, curCol.colWidth);
 
+    if (bIndex)
+    {
+      index.add(ColumnIndex::key(dataBuf + dataBio, curCol.colWidth), curRowId);
+
+      if (curRowId == coverEnd)
+        coverEnd++;
+    }
+
+    if (bBloom)
+      bloomFilters.add(ColumnIndex::key(dataBuf + dataBio, curCol.colWidth), curRowId);
+
     i++;
 
     if (i >= totalRow)
@@ -1666,6 +1686,14 @@ int ColumnOp::writeRow(Column& curCol, uint64_t totalRow, const RID* rowIdArray,
     if (rc != NO_ERROR)
       return rc;
   }
+
+  // inserted rows are appended to the file
+  if (bIndex)
+    index.coverAppended(rowIdArray[0], coverEnd - rowIdArray[0]);
+
+  if (bIndex || bBloom)
+    bufferColumnIndex(curCol, bIndex ? &index : NULL, bBloom ? &bloomFilters : NULL, true);
+
   return rc;
 }
 
@@ -1692,11 +1720,60 @@ int ColumnOp::writeRows(Column& curCol, uint64_t totalRow, const RIDList& ridLis
   // void*    pOldVal;
   char charTmpBuf[8];
   int rc = NO_ERROR;
-
+  bool bIndex = !bDelete && (curCol.indexType & CalpontSystemCatalog::INVERTED_INDEX) &&
+                ColumnIndex::isIndexable(curCol.colDataType, curCol.colWidth, curCol.charsetNumber);
+  bool bBloom = !bDelete && (curCol.indexType & CalpontSystemCatalog::BLOOM_FILTER) &&
+                ColumnIndex::isIndexable(curCol.colDataType, curCol.colWidth, curCol.charsetNumber);
+  ColumnIndex index;
+  BlockBloomFilters bloomFilters;
+  uint64_t coverEnd = ridList[0];
+
+  // Every row gets the same value, so look it up once rather than per row.
+  // TODO MCOL-641 add support here
   if (bDelete)
   {
     pVal = getEmptyRowValue(curCol.colDataType, curCol.colWidth);
   }
+  else
+  {
+    switch (curCol.colType)
+    {
+      case WriteEngine::WR_FLOAT: pVal = &((float*)valArray)[0]; break;
+
+      case WriteEngine::WR_DOUBLE: pVal = &((double*)valArray)[0]; break;
+
+      case WriteEngine::WR_VARBINARY:  // treat same as char for now
+      case WriteEngine::WR_BLOB:
+      case WriteEngine::WR_TEXT:
+      case WriteEngine::WR_CHAR:
+        memcpy(charTmpBuf, (char*)valArray, 8);
+        pVal = charTmpBuf;
+        break;
+
+      // case WriteEngine::WR_BIT :    pVal = &((bool *) valArray)[i]; break;
+      case WriteEngine::WR_SHORT: pVal = &((short*)valArray)[0]; break;
+
+      case WriteEngine::WR_BYTE: pVal = &((char*)valArray)[0]; break;
+
+      case WriteEngine::WR_LONGLONG: pVal = &((long long*)valArray)[0]; break;
+
+      case WriteEngine::WR_TOKEN: pVal = &((Token*)valArray)[0]; break;
+
+      case WriteEngine::WR_INT:
+      case WriteEngine::WR_MEDINT: pVal = &((int*)valArray)[0]; break;
+
+      case WriteEngine::WR_USHORT: pVal = &((uint16_t*)valArray)[0]; break;
+
+      case WriteEngine::WR_UBYTE: pVal = &((uint8_t*)valArray)[0]; break;
+
+      case WriteEngine::WR_ULONGLONG: pVal = &((uint64_t*)valArray)[0]; break;
+
+      case WriteEngine::WR_UINT:
+      case WriteEngine::WR_UMEDINT: pVal = &((uint32_t*)valArray)[0]; break;
+
+      default: pVal = &((int*)valArray)[0]; break;
+    }
+  }
 
   while (!bExit)
   {
@@ -1714,7 +1791,6 @@ int ColumnOp::writeRows(Column& curCol, uint64_t totalRow, const RIDList& ridLis
         if (rc != NO_ERROR)
           return rc;
 
-        curCol.dataFile.pFile->flush();
         bDataDirty = false;
       }
 
@@ -1728,51 +1804,6 @@ int ColumnOp::writeRows(Column& curCol, uint64_t totalRow, const RIDList& ridLis
       bDataDirty = true;
     }
 
-    // This is a awkward way to convert void* and get ith element, I just don't have a good solution for that
-    // How about pVal = valArray? You're always getting the 0'th element here anyways.
-    // TODO MCOL-641 add support here
-    // This branch does not seem to be called from anywhere
-    if (!bDelete)
-    {
-      switch (curCol.colType)
-      {
-        case WriteEngine::WR_FLOAT: pVal = &((float*)valArray)[0]; break;
-
-        case WriteEngine::WR_DOUBLE: pVal = &((double*)valArray)[0]; break;
-
-        case WriteEngine::WR_VARBINARY:  // treat same as char for now
-        case WriteEngine::WR_BLOB:
-        case WriteEngine::WR_TEXT:
-        case WriteEngine::WR_CHAR:
-          memcpy(charTmpBuf, (char*)valArray, 8);
-          pVal = charTmpBuf;
-          break;
-
-        // case WriteEngine::WR_BIT :    pVal = &((bool *) valArray)[i]; break;
-        case WriteEngine::WR_SHORT: pVal = &((short*)valArray)[0]; break;
-
-        case WriteEngine::WR_BYTE: pVal = &((char*)valArray)[0]; break;
-
-        case WriteEngine::WR_LONGLONG: pVal = &((long long*)valArray)[0]; break;
-
-        case WriteEngine::WR_TOKEN: pVal = &((Token*)valArray)[0]; break;
-
-        case WriteEngine::WR_INT:
-        case WriteEngine::WR_MEDINT: pVal = &((int*)valArray)[0]; break;
-
-        case WriteEngine::WR_USHORT: pVal = &((uint16_t*)valArray)[0]; break;
-
-        case WriteEngine::WR_UBYTE: pVal = &((uint8_t*)valArray)[0]; break;
-
-        case WriteEngine::WR_ULONGLONG: pVal = &((uint64_t*)valArray)[0]; break;
-
-        case WriteEngine::WR_UINT:
-        case WriteEngine::WR_UMEDINT: pVal = &((uint32_t*)valArray)[0]; break;
-
-        default: pVal = &((int*)valArray)[0]; break;
-      }
-    }
-
     // This is the write stuff
     if (oldValArray)
     {
@@ -1782,6 +1813,17 @@ int ColumnOp::writeRows(Column& curCol, uint64_t totalRow, const RIDList& ridLis
 
     writeBufValue(dataBuf + dataBio, pVal, curCol.colWidth);
 
+    if (bIndex)
+    {
+      index.add(ColumnIndex::key(dataBuf + dataBio, curCol.colWidth), curRowId);
+
+      if (curRowId == coverEnd)
+        coverEnd++;
+    }
+
+    if (bBloom)
+      bloomFilters.add(ColumnIndex::key(dataBuf + dataBio, curCol.colWidth), curRowId);
+
     i++;
 
     if (i >= totalRow)
@@ -1797,6 +1839,12 @@ int ColumnOp::writeRows(Column& curCol, uint64_t totalRow, const RIDList& ridLis
 
   curCol.dataFile.pFile->flush();
 
+  if (bIndex)
+    index.cover(ridList[0], coverEnd - ridList[0]);
+
+  if ((bIndex || bBloom) && rc == NO_ERROR)
+    bufferColumnIndex(curCol, bIndex ? &index : NULL, bBloom ? &bloomFilters : NULL, false);
+
   return rc;
 }
 
@@ -1872,6 +1920,13 @@ int ColumnOp::writeRowsValues(Column& curCol, uint64_t totalRow, const RIDList&
   // void*    pOldVal;
   char charTmpBuf[8];
   int rc = NO_ERROR;
+  bool bIndex = (curCol.indexType & CalpontSystemCatalog::INVERTED_INDEX) &&
+                ColumnIndex::isIndexable(curCol.colDataType, curCol.colWidth, curCol.charsetNumber);
+  bool bBloom = (curCol.indexType & CalpontSystemCatalog::BLOOM_FILTER) &&
+                ColumnIndex::isIndexable(curCol.colDataType, curCol.colWidth, curCol.charsetNumber);
+  ColumnIndex index;
+  BlockBloomFilters bloomFilters;
+  uint64_t coverEnd = ridList[0];
 
   while (!bExit)
   {
@@ -1952,6 +2007,17 @@ int ColumnOp::writeRowsValues(Column& curCol, uint64_t totalRow, const RIDList&
 
     writeBufValue(dataBuf + dataBio, pVal, curCol.colWidth);
 
+    if (bIndex)
+    {
+      index.add(ColumnIndex::key(dataBuf + dataBio, curCol.colWidth), curRowId);
+
+      if (curRowId == coverEnd)
+        coverEnd++;
+    }
+
+    if (bBloom)
+      bloomFilters.add(ColumnIndex::key(dataBuf + dataBio, curCol.colWidth), curRowId);
+
     i++;
 
     if (i >= totalRow)
@@ -1964,6 +2030,106 @@ int ColumnOp::writeRowsValues(Column& curCol, uint64_t totalRow, const RIDList&
     rc = saveBlock(curCol.dataFile.pFile, dataBuf, curDataFbo);
   }
 
+  if (bIndex)
+    index.cover(ridList[0], coverEnd - ridList[0]);
+
+  if ((bIndex || bBloom) && rc == NO_ERROR)
+    bufferColumnIndex(curCol, bIndex ? &index : NULL, bBloom ? &bloomFilters : NULL, false);
+
+  return rc;
+}
+
+/***********************************************************
+ * DESCRIPTION:
+ *    Add the rows written to a column to the ones saved to the
+ *    inverted index and the bloom filters of its segment file by
+ *    the next saveColumnIndexes(), at the end of the statement.
+ *    Saving rewrites the index file, doing it for each call made
+ *    the writes of a statement quadratic.
+ * PARAMETERS:
+ *    curCol - column information
+ *    index - the rows written, or NULL
+ *    bloomFilters - the rows written, or NULL
+ *    appended - the rows were appended to the file
+ ***********************************************************/
+void ColumnOp::bufferColumnIndex(const Column& curCol, const ColumnIndex* index,
+                                 const BlockBloomFilters* bloomFilters, bool appended)
+{
+  PendingColumnIndex& pending = fPendingIndexes[SegmentFileKey(
+      curCol.dataFile.fid, curCol.dataFile.fDbRoot, curCol.dataFile.fPartition, curCol.dataFile.fSegment)];
+  pending.compressionType = curCol.compressionType;
+
+  if (index)
+  {
+    ColumnIndex& pendingIndex = appended ? pending.appendedIndex : pending.index;
+
+    // the first one tells whether the rows were appended
+    if (pendingIndex.empty())
+      pendingIndex = *index;
+    else
+      pendingIndex.merge(*index);
+  }
+
+  if (bloomFilters)
+    (appended ? pending.appendedBloomFilters : pending.bloomFilters).merge(*bloomFilters);
+}
+
+/***********************************************************
+ * DESCRIPTION:
+ *    Add the rows buffered by bufferColumnIndex() to the inverted
+ *    indexes and the bloom filters of their segment files, and
+ *    have PrimProc drop the ones it has cached so an updated row
+ *    isn't missed.  They only grow: a row whose value changed is
+ *    filtered out by the reader, and a rolled back row keeps its
+ *    old value's entry.
+ * RETURN:
+ *    NO_ERROR if success, other number otherwise
+ ***********************************************************/
+int ColumnOp::saveColumnIndexes()
+{
+  std::vector<BRM::FileInfo> files;
+  int rc = NO_ERROR;
+
+  for (const auto& entry : fPendingIndexes)
+  {
+    const PendingColumnIndex& pending = entry.second;
+    char fileName[FILE_NAME_SIZE];
+    BRM::FileInfo aFile;
+    aFile.oid = std::get<0>(entry.first);
+    aFile.dbRoot = std::get<1>(entry.first);
+    aFile.partitionNum = std::get<2>(entry.first);
+    aFile.segmentNum = std::get<3>(entry.first);
+    aFile.compType = pending.compressionType;
+
+    int rc1 = getFileName(aFile.oid, fileName, aFile.dbRoot, aFile.partitionNum, aFile.segmentNum);
+
+    // the file was dropped since
+    if (rc1 != NO_ERROR || !IDBPolicy::exists(fileName))
+      continue;
+
+    if (!pending.index.empty())
+      rc1 = pending.index.save(fileName);
+
+    if (rc1 == NO_ERROR && !pending.appendedIndex.empty())
+      rc1 = pending.appendedIndex.save(fileName);
+
+    if (rc1 == NO_ERROR)
+      rc1 = pending.bloomFilters.save(fileName, false);
+
+    if (rc1 == NO_ERROR)
+      rc1 = pending.appendedBloomFilters.save(fileName, true);
+
+    if (rc1 == NO_ERROR)
+      files.push_back(aFile);
+    else if (rc == NO_ERROR)
+      rc = rc1;
+  }
+
+  fPendingIndexes.clear();
+
+  if (!files.empty())
+    cacheutils::purgePrimProcFdCache(files, Config::getLocalModuleID());
+
   return rc;
 }
 
@@ -22,6 +22,8 @@
 #pragma once
 
 #include <stdlib.h>
+#include <map>
+#include <tuple>
 
 #include "we_dbfileop.h"
 #include "brmtypes.h"
@@ -29,6 +31,8 @@
 #include "we_tablemetadata.h"
 #include "../dictionary/we_dctnry.h"
 #include "stopwatch.h"
+#include "we_columnindex.h"
+#include "we_bloomfilter.h"
 #define EXPORT
 
 /** Namespace WriteEngine */
@@ -279,6 +283,12 @@ class ColumnOp : public DbFileOp
    */
   EXPORT virtual void closeColumnFile(Column& column) const;
 
+  /**
+   * @brief save the rows written to indexed columns since the last call to the
+   *  inverted indexes and bloom filters of their segment files, see bufferColumnIndex()
+   */
+  EXPORT int saveColumnIndexes();
+
  protected:
   /**
    * @brief populate readBuf with data in block #lbid
@@ -291,6 +301,26 @@ class ColumnOp : public DbFileOp
   virtual int saveBlock(IDBDataFile* pFile, const unsigned char* writeBuf, const uint64_t fbo) = 0;
 
  private:
+  /**
+   * @brief add the rows written to curCol to the ones its segment file's index gets on saveColumnIndexes()
+   */
+  void bufferColumnIndex(const Column& curCol, const ColumnIndex* index,
+                         const BlockBloomFilters* bloomFilters, bool appended);
+
+  // The rows written to a segment file of an indexed column since the last saveColumnIndexes().
+  // Appended rows are kept apart, they're saved differently.
+  struct PendingColumnIndex
+  {
+    int compressionType;
+    ColumnIndex index;
+    ColumnIndex appendedIndex;
+    BlockBloomFilters bloomFilters;
+    BlockBloomFilters appendedBloomFilters;
+  };
+
+  // oid, dbroot, partition, segment
+  typedef std::tuple<FID, uint16_t, uint32_t, uint16_t> SegmentFileKey;
+  std::map<SegmentFileKey, PendingColumnIndex> fPendingIndexes;
 };
 
 }  // namespace WriteEngine
@@ -25,6 +25,7 @@
 // XXX: a definition to switch off computations for token columns.
 #define	XXX_WRITEENGINE_TOKENS_RANGES_XXX
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <unistd.h>
@@ -4277,39 +4278,12 @@ int WriteEngineWrapper::processVersionBuffer(IDBDataFile* pFile, const TxnID& tx
   if (idbdatafile::IDBPolicy::useHdfs())
     return 0;
 
-  RID curRowId;
   int rc = NO_ERROR;
-  int curFbo = 0, curBio, lastFbo = -1;
-  bool successFlag;
-  BRM::LBID_t lbid;
   BRM::VER_t verId = (BRM::VER_t)txnid;
   vector<uint32_t> fboList;
-  LBIDRange range;
   ColumnOp* colOp = m_colOp[op(colStruct.fCompressionType)];
 
-  for (int i = 0; i < totalRow; i++)
-  {
-    curRowId = rowIdArray[i];
-    // cout << "processVersionBuffer got rid " << curRowId << endl;
-    successFlag = colOp->calculateRowId(curRowId, BYTE_PER_BLOCK / width, width, curFbo, curBio);
-
-    if (successFlag)
-    {
-      if (curFbo != lastFbo)
-      {
-        // cout << "processVersionBuffer is processing lbid  " << lbid << endl;
-        RETURN_ON_ERROR(BRMWrapper::getInstance()->getBrmInfo(colStruct.dataOid, colStruct.fColPartition,
-                                                              colStruct.fColSegment, curFbo, lbid));
-        // cout << "processVersionBuffer is processing lbid  " << lbid << endl;
-        fboList.push_back((uint32_t)curFbo);
-        range.start = lbid;
-        range.size = 1;
-        rangeList.push_back(range);
-      }
-
-      lastFbo = curFbo;
-    }
-  }
+  RETURN_ON_ERROR(getBlocksToVersion(colStruct, width, rowIdArray, totalRow, fboList, rangeList));
 
   std::vector<VBRange> freeList;
   rc = BRMWrapper::getInstance()->writeVB(pFile, verId, colStruct.dataOid, fboList, rangeList, colOp,
@@ -4325,47 +4299,129 @@ int WriteEngineWrapper::processVersionBuffers(IDBDataFile* pFile, const TxnID& t
   if (idbdatafile::IDBPolicy::useHdfs())
     return 0;
 
-  RID curRowId;
   int rc = NO_ERROR;
-  int curFbo = 0, curBio, lastFbo = -1;
-  bool successFlag;
-  BRM::LBID_t lbid;
   BRM::VER_t verId = (BRM::VER_t)txnid;
-  LBIDRange range;
   vector<uint32_t> fboList;
-  // vector<LBIDRange>   rangeList;
   ColumnOp* colOp = m_colOp[op(colStruct.fCompressionType)];
 
-  for (int i = 0; i < totalRow; i++)
-  {
-    curRowId = ridList[i];
-    // cout << "processVersionBuffer got rid " << curRowId << endl;
-    successFlag = colOp->calculateRowId(curRowId, BYTE_PER_BLOCK / width, width, curFbo, curBio);
+  RETURN_ON_ERROR(getBlocksToVersion(colStruct, width, ridList.data(), totalRow, fboList, rangeList));
 
-    if (successFlag)
+  // cout << "calling writeVB with blocks " << rangeList.size() << endl;
+  std::vector<VBRange> freeList;
+  rc = BRMWrapper::getInstance()->writeVB(pFile, verId, colStruct.dataOid, fboList, rangeList, colOp,
+                                          freeList, colStruct.fColDbRoot);
+
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+// Find the distinct blocks of a column segment file that hold the given rows,
+// and the LBIDs to version for them.  Rows normally arrive in RID order, so
+// the blocks come out sorted; if not, they are sorted here so that every block
+// is versioned (and later rewritten) once.  LBIDs are contiguous within an
+// extent, so only the first block of each extent is looked up in the extent
+// map instead of every block.
+//------------------------------------------------------------------------------
+int WriteEngineWrapper::getBlocksToVersion(const ColStruct& colStruct, int width, const RID* rowIdArray,
+                                           size_t totalRow, vector<uint32_t>& fboList,
+                                           vector<LBIDRange>& rangeList)
+{
+  ColumnOp* colOp = m_colOp[op(colStruct.fCompressionType)];
+  int curFbo = 0, curBio, lastFbo = -1;
+  bool bSorted = true;
+
+  fboList.clear();
+
+  for (size_t i = 0; i < totalRow; i++)
+  {
+    if (colOp->calculateRowId(rowIdArray[i], BYTE_PER_BLOCK / width, width, curFbo, curBio))
     {
       if (curFbo != lastFbo)
       {
-        // cout << "processVersionBuffer is processing lbid  " << lbid << endl;
-        RETURN_ON_ERROR(BRMWrapper::getInstance()->getBrmInfo(colStruct.dataOid, colStruct.fColPartition,
-                                                              colStruct.fColSegment, curFbo, lbid));
-        // cout << "processVersionBuffer is processing lbid  " << lbid << endl;
+        if (curFbo < lastFbo)
+          bSorted = false;
+
         fboList.push_back((uint32_t)curFbo);
-        range.start = lbid;
-        range.size = 1;
-        rangeList.push_back(range);
       }
 
       lastFbo = curFbo;
     }
   }
 
-  // cout << "calling writeVB with blocks " << rangeList.size() << endl;
-  std::vector<VBRange> freeList;
-  rc = BRMWrapper::getInstance()->writeVB(pFile, verId, colStruct.dataOid, fboList, rangeList, colOp,
-                                          freeList, colStruct.fColDbRoot);
+  if (!bSorted)
+  {
+    std::sort(fboList.begin(), fboList.end());
+    fboList.erase(std::unique(fboList.begin(), fboList.end()), fboList.end());
+  }
 
-  return rc;
+  const uint32_t blocksPerExtent = BRMWrapper::getInstance()->getExtentRows() * width / BYTE_PER_BLOCK;
+  uint32_t extentFirstFbo = 0;
+  BRM::LBID_t extentFirstLbid = -1;
+  LBIDRange range;
+  range.size = 1;
+
+  for (uint32_t fbo : fboList)
+  {
+    uint32_t firstFbo = fbo - (fbo % blocksPerExtent);
+
+    if ((extentFirstLbid == -1) || (firstFbo != extentFirstFbo))
+    {
+      BRM::LBID_t lbid;
+      RETURN_ON_ERROR(BRMWrapper::getInstance()->getBrmInfo(colStruct.dataOid, colStruct.fColPartition,
+                                                            colStruct.fColSegment, fbo, lbid));
+      extentFirstFbo = firstFbo;
+      extentFirstLbid = lbid - (fbo - firstFbo);
+    }
+
+    range.start = extentFirstLbid + (fbo - extentFirstFbo);
+    rangeList.push_back(range);
+  }
+
+  return NO_ERROR;
+}
+
+//------------------------------------------------------------------------------
+// Take the part of the free list returned by beginVBCopy() that covers the
+// next numBlocks blocks, after the blocksProcessed blocks already copied for
+// the preceding columns.
+//------------------------------------------------------------------------------
+int WriteEngineWrapper::getVBFreeRanges(const std::vector<VBRange>& freeList, uint32_t numBlocks,
+                                        uint32_t& blocksProcessed, uint32_t& blocksProcessedThisOid,
+                                        std::vector<VBRange>& curFreeList)
+{
+  VBRange aRange;
+
+  if (freeList[0].size >= (blocksProcessed + numBlocks))
+  {
+    aRange.vbOID = freeList[0].vbOID;
+    aRange.vbFBO = freeList[0].vbFBO + blocksProcessed;
+    aRange.size = numBlocks;
+    curFreeList.push_back(aRange);
+  }
+  else
+  {
+    aRange.vbOID = freeList[0].vbOID;
+    aRange.vbFBO = freeList[0].vbFBO + blocksProcessed;
+    aRange.size = freeList[0].size - blocksProcessed;
+    uint32_t blockUsed = aRange.size;
+    curFreeList.push_back(aRange);
+
+    if (freeList.size() > 1)
+    {
+      aRange.vbOID = freeList[1].vbOID;
+      aRange.vbFBO = freeList[1].vbFBO + blocksProcessedThisOid;
+      aRange.size = numBlocks - blockUsed;
+      curFreeList.push_back(aRange);
+      blocksProcessedThisOid += aRange.size;
+    }
+    else
+    {
+      return 1;
+    }
+  }
+
+  blocksProcessed += numBlocks;
+  return NO_ERROR;
 }
 
 int WriteEngineWrapper::processBeginVBCopy(const TxnID& txnid, const vector<ColStruct>& colStructList,
@@ -4377,12 +4433,7 @@ int WriteEngineWrapper::processBeginVBCopy(const TxnID& txnid, const vector<ColS
   if (idbdatafile::IDBPolicy::useHdfs())
     return 0;
 
-  RID curRowId;
   int rc = NO_ERROR;
-  int curFbo = 0, curBio, lastFbo = -1;
-  bool successFlag;
-  BRM::LBID_t lbid;
-  LBIDRange range;
 
   // StopWatch timer;
   // timer.start("calculation");
@@ -4390,37 +4441,12 @@ int WriteEngineWrapper::processBeginVBCopy(const TxnID& txnid, const vector<ColS
   {
     vector<uint32_t> fboList;
     vector<LBIDRange> rangeList;
-    lastFbo = -1;
-    ColumnOp* colOp = m_colOp[op(colStructList[j].fCompressionType)];
 
     ColStruct curColStruct = colStructList[j];
     Convertor::convertColType(&curColStruct);
 
-    for (uint32_t i = 0; i < ridList.size(); i++)
-    {
-      curRowId = ridList[i];
-      // cout << "processVersionBuffer got rid " << curRowId << endl;
-      successFlag = colOp->calculateRowId(curRowId, BYTE_PER_BLOCK / curColStruct.colWidth,
-                                          curColStruct.colWidth, curFbo, curBio);
-
-      if (successFlag)
-      {
-        if (curFbo != lastFbo)
-        {
-          // cout << "processVersionBuffer is processing curFbo  " << curFbo << endl;
-          RETURN_ON_ERROR(BRMWrapper::getInstance()->getBrmInfo(colStructList[j].dataOid,
-                                                                colStructList[j].fColPartition,
-                                                                colStructList[j].fColSegment, curFbo, lbid));
-          // cout << "beginVBCopy is processing lbid:transaction  " << lbid <<":"<<txnid<< endl;
-          fboList.push_back((uint32_t)curFbo);
-          range.start = lbid;
-          range.size = 1;
-          rangeList.push_back(range);
-        }
-
-        lastFbo = curFbo;
-      }
-    }
+    RETURN_ON_ERROR(getBlocksToVersion(colStructList[j], curColStruct.colWidth, ridList.data(),
+                                       ridList.size(), fboList, rangeList));
 
     BRMWrapper::getInstance()->pruneLBIDList(txnid, &rangeList, &fboList);
     rangeLists.push_back(rangeList);
@@ -4595,8 +4621,21 @@ int WriteEngineWrapper::updateColumnRec(const TxnID& txnid, const vector<CSCType
     if (m_opType != DELETE)
       m_opType = UPDATE;
 
+    // With fast delete, the AUX column is the table's delete vector: it is
+    // the only column written, and the other columns keep their values, so
+    // their CP ranges stay valid (if loose) and their extents are left alone.
+    bool hasFastDelete = false;
+
+    if (m_opType == DELETE && hasAUXCol)
+    {
+      hasFastDelete = Config::getFastDelete();
+    }
+
     for (unsigned j = 0; j < colStructList.size(); j++)
     {
+      if (hasFastDelete && (j != colStructList.size() - 1))
+        continue;
+
       colOp = m_colOp[op(colStructList[j].fCompressionType)];
       ExtCPInfo* cpInfoP = &(currentExtentRanges[j]);
       cpInfoP = getCPInfoToUpdateForUpdatableType(colStructList[j], cpInfoP, m_opType);
@@ -4622,13 +4661,6 @@ int WriteEngineWrapper::updateColumnRec(const TxnID& txnid, const vector<CSCType
     // timer.start("markExtentsInvalid");
     //#endif
 
-    bool hasFastDelete = false;
-
-    if (m_opType == DELETE && hasAUXCol)
-    {
-      hasFastDelete = Config::getFastDelete();
-    }
-
     if (hasFastDelete)
     {
       ColStructList colStructListAUX(1, colStructList.back());
@@ -4640,12 +4672,9 @@ int WriteEngineWrapper::updateColumnRec(const TxnID& txnid, const vector<CSCType
                                 ridLists[extent], tableOid, true, ridLists[extent].size(),
                                 &currentExtentRangesPtrsAUX, hasAUXCol);
 
-      for (auto& cpInfoPtr : currentExtentRangesPtrs)
+      if (currentExtentRangesPtrs.back())
       {
-        if (cpInfoPtr)
-        {
-          cpInfoPtr->toInvalid();
-        }
+        currentExtentRangesPtrs.back()->toInvalid();
       }
     }
     else
@@ -4790,6 +4819,39 @@ int WriteEngineWrapper::writeColumnRecords(const TxnID& txnid, const CSCTypesLis
 
   TableMetaData* aTbaleMetaData = TableMetaData::makeTableMetaData(tableOid);
 
+  // Reserve version buffer space for the blocks of all the columns with a
+  // single beginVBCopy() instead of one per column.
+  vector<LBIDRange> rangeListTot;
+  std::vector<VBRange> freeList;
+  vector<vector<uint32_t> > fboLists;
+  vector<vector<LBIDRange> > rangeLists;
+  uint32_t blocksProcessedThisOid = 0;
+  uint32_t blocksProcessed = 0;
+
+  if (versioning)
+  {
+    rc = processBeginVBCopy(txnid, colStructList, ridLists, freeList, fboLists, rangeLists, rangeListTot);
+
+    if (rc != NO_ERROR)
+    {
+      if (rangeListTot.size() > 0)
+        BRMWrapper::getInstance()->writeVBEnd(txnid, rangeListTot);
+
+      switch (rc)
+      {
+        case BRM::ERR_DEADLOCK: return ERR_BRM_DEAD_LOCK;
+
+        case BRM::ERR_VBBM_OVERFLOW: return ERR_BRM_VB_OVERFLOW;
+
+        case BRM::ERR_NETWORK: return ERR_BRM_NETWORK;
+
+        case BRM::ERR_READONLY: return ERR_BRM_READONLY;
+
+        default: return ERR_BRM_BEGIN_COPY;
+      }
+    }
+  }
+
   for (i = 0; i < totalColumn; i++)
   {
     ExtCPInfo* cpInfo = NULL;
@@ -4813,6 +4875,9 @@ int WriteEngineWrapper::writeColumnRecords(const TxnID& txnid, const CSCTypesLis
     colOp->setColParam(curCol, 0, curColStruct.colWidth, curColStruct.colDataType, curColStruct.colType,
                        curColStruct.dataOid, curColStruct.fCompressionType, curColStruct.fColDbRoot,
                        curColStruct.fColPartition, curColStruct.fColSegment);
+
+    curCol.indexType = curColStruct.fIndexType;
+    curCol.charsetNumber = curColStruct.fCharsetNumber;
     colOp->findTypeHandler(curColStruct.colWidth, curColStruct.colDataType);
     ColExtsInfo aColExtsInfo = aTbaleMetaData->getColExtsInfo(curColStruct.dataOid);
     ColExtsInfo::iterator it = aColExtsInfo.begin();
@@ -4844,12 +4909,16 @@ int WriteEngineWrapper::writeColumnRecords(const TxnID& txnid, const CSCTypesLis
     if (rc != NO_ERROR)
       break;
 
-    vector<LBIDRange> rangeList;
-
-    if (versioning)
+    if (versioning && !idbdatafile::IDBPolicy::useHdfs() && (rangeLists[i].size() > 0))
     {
-      rc = processVersionBuffers(curCol.dataFile.pFile, txnid, curColStruct, curColStruct.colWidth, totalRow,
-                                 ridLists, rangeList);
+      std::vector<VBRange> curFreeList;
+      rc = getVBFreeRanges(freeList, rangeLists[i].size(), blocksProcessed, blocksProcessedThisOid,
+                           curFreeList);
+
+      if (rc == NO_ERROR)
+        rc = BRMWrapper::getInstance()->writeVB(curCol.dataFile.pFile, (BRM::VER_t)txnid,
+                                                curColStruct.dataOid, fboLists[i], rangeLists[i], colOp,
+                                                curFreeList, curColStruct.fColDbRoot, true);
     }
 
     if (rc != NO_ERROR)
@@ -4859,7 +4928,6 @@ int WriteEngineWrapper::writeColumnRecords(const TxnID& txnid, const CSCTypesLis
         curCol.dataFile.pFile->flush();
       }
 
-      BRMWrapper::getInstance()->writeVBEnd(txnid, rangeList);
       break;
     }
 
@@ -4884,7 +4952,9 @@ int WriteEngineWrapper::writeColumnRecords(const TxnID& txnid, const CSCTypesLis
 
     if (bExcp)
     {
-      BRMWrapper::getInstance()->writeVBEnd(txnid, rangeList);
+      if (rangeListTot.size() > 0)
+        BRMWrapper::getInstance()->writeVBEnd(txnid, rangeListTot);
+
       return ERR_PARSING;
     }
 
@@ -4915,8 +4985,6 @@ int WriteEngineWrapper::writeColumnRecords(const TxnID& txnid, const CSCTypesLis
         cacheutils::purgePrimProcFdCache(files, Config::getLocalModuleID());
     }
 
-    BRMWrapper::getInstance()->writeVBEnd(txnid, rangeList);
-
     if (valArray != NULL)
       free(valArray);
 
@@ -4930,6 +4998,9 @@ int WriteEngineWrapper::writeColumnRecords(const TxnID& txnid, const CSCTypesLis
       break;
   }
 
+  if (rangeListTot.size() > 0)
+    BRMWrapper::getInstance()->writeVBEnd(txnid, rangeListTot);
+
   return rc;
 }
 
@@ -5005,6 +5076,8 @@ int WriteEngineWrapper::writeColumnRec(const TxnID& txnid, const CSCTypesList& c
                            colStructList[i].colType, colStructList[i].dataOid,
                            colStructList[i].fCompressionType, colStructList[i].fColDbRoot,
                            colStructList[i].fColPartition, colStructList[i].fColSegment);
+        curCol.indexType = colStructList[i].fIndexType;
+        curCol.charsetNumber = colStructList[i].fCharsetNumber;
         colOp->findTypeHandler(colStructList[i].colWidth, colStructList[i].colDataType);
 
         ColExtsInfo aColExtsInfo = aTbaleMetaData->getColExtsInfo(colStructList[i].dataOid);
@@ -5150,6 +5223,8 @@ int WriteEngineWrapper::writeColumnRec(const TxnID& txnid, const CSCTypesList& c
                          newColStructList[i].colType, newColStructList[i].dataOid,
                          newColStructList[i].fCompressionType, newColStructList[i].fColDbRoot,
                          newColStructList[i].fColPartition, newColStructList[i].fColSegment);
+      curCol.indexType = newColStructList[i].fIndexType;
+      curCol.charsetNumber = newColStructList[i].fCharsetNumber;
       colOp->findTypeHandler(newColStructList[i].colWidth, newColStructList[i].colDataType);
 
       ColExtsInfo aColExtsInfo = aTbaleMetaData->getColExtsInfo(newColStructList[i].dataOid);
@@ -5294,6 +5369,8 @@ int WriteEngineWrapper::writeColumnRec(const TxnID& txnid, const CSCTypesList& c
                          colStructList[i].colType, colStructList[i].dataOid,
                          colStructList[i].fCompressionType, colStructList[i].fColDbRoot,
                          colStructList[i].fColPartition, colStructList[i].fColSegment);
+      curCol.indexType = colStructList[i].fIndexType;
+      curCol.charsetNumber = colStructList[i].fCharsetNumber;
       colOp->findTypeHandler(colStructList[i].colWidth, colStructList[i].colDataType);
 
       rc = colOp->openColumnFile(curCol, segFile, useTmpSuffix, IO_BUFF_SIZE);  // @bug 5572 HDFS tmp file
@@ -5481,6 +5558,8 @@ int WriteEngineWrapper::writeColumnRecBinary(const TxnID& txnid, const ColStruct
                          colStructList[i].colType, colStructList[i].dataOid,
                          colStructList[i].fCompressionType, colStructList[i].fColDbRoot,
                          colStructList[i].fColPartition, colStructList[i].fColSegment);
+      curCol.indexType = colStructList[i].fIndexType;
+      curCol.charsetNumber = colStructList[i].fCharsetNumber;
       colOp->findTypeHandler(colStructList[i].colWidth, colStructList[i].colDataType);
 
       ColExtsInfo aColExtsInfo = aTbaleMetaData->getColExtsInfo(colStructList[i].dataOid);
@@ -5623,6 +5702,8 @@ int WriteEngineWrapper::writeColumnRecBinary(const TxnID& txnid, const ColStruct
                          newColStructList[i].colType, newColStructList[i].dataOid,
                          newColStructList[i].fCompressionType, newColStructList[i].fColDbRoot,
                          newColStructList[i].fColPartition, newColStructList[i].fColSegment);
+      curCol.indexType = newColStructList[i].fIndexType;
+      curCol.charsetNumber = newColStructList[i].fCharsetNumber;
       colOp->findTypeHandler(newColStructList[i].colWidth, newColStructList[i].colDataType);
 
       ColExtsInfo aColExtsInfo = aTbaleMetaData->getColExtsInfo(newColStructList[i].dataOid);
@@ -5804,7 +5885,6 @@ int WriteEngineWrapper::writeColumnRecUpdate(const TxnID& txnid, const CSCTypesL
     }
   }
 
-  VBRange aRange;
   uint32_t blocksProcessedThisOid = 0;
   uint32_t blocksProcessed = 0;
   std::vector<BRM::FileInfo> files;
@@ -5827,6 +5907,8 @@ int WriteEngineWrapper::writeColumnRecUpdate(const TxnID& txnid, const CSCTypesL
     colOp->setColParam(curCol, 0, curColStruct.colWidth, curColStruct.colDataType, curColStruct.colType,
                        curColStruct.dataOid, curColStruct.fCompressionType, curColStruct.fColDbRoot,
                        curColStruct.fColPartition, curColStruct.fColSegment);
+    curCol.indexType = curColStruct.fIndexType;
+    curCol.charsetNumber = curColStruct.fCharsetNumber;
     colOp->findTypeHandler(curColStruct.colWidth, curColStruct.colDataType);
 
     ColExtsInfo aColExtsInfo = aTbaleMetaData->getColExtsInfo(curColStruct.dataOid);
@@ -5873,7 +5955,6 @@ int WriteEngineWrapper::writeColumnRecUpdate(const TxnID& txnid, const CSCTypesL
 
     // handling versioning
     std::vector<VBRange> curFreeList;
-    uint32_t blockUsed = 0;
 
     if (!idbdatafile::IDBPolicy::useHdfs())
     {
@@ -5885,37 +5966,11 @@ int WriteEngineWrapper::writeColumnRecUpdate(const TxnID& txnid, const CSCTypesL
         if (m_opType == DELETE && hasAUXCol && (i == colStructList.size() - 1))
           j = 0;
 
-        if (freeList[0].size >= (blocksProcessed + rangeLists[j].size()))
-        {
-          aRange.vbOID = freeList[0].vbOID;
-          aRange.vbFBO = freeList[0].vbFBO + blocksProcessed;
-          aRange.size = rangeLists[j].size();
-          curFreeList.push_back(aRange);
-        }
-        else
-        {
-          aRange.vbOID = freeList[0].vbOID;
-          aRange.vbFBO = freeList[0].vbFBO + blocksProcessed;
-          aRange.size = freeList[0].size - blocksProcessed;
-          blockUsed = aRange.size;
-          curFreeList.push_back(aRange);
+        rc = getVBFreeRanges(freeList, rangeLists[j].size(), blocksProcessed, blocksProcessedThisOid,
+                             curFreeList);
 
-          if (freeList.size() > 1)
-          {
-            aRange.vbOID = freeList[1].vbOID;
-            aRange.vbFBO = freeList[1].vbFBO + blocksProcessedThisOid;
-            aRange.size = rangeLists[j].size() - blockUsed;
-            curFreeList.push_back(aRange);
-            blocksProcessedThisOid += aRange.size;
-          }
-          else
-          {
-            rc = 1;
-            break;
-          }
-        }
-
-        blocksProcessed += rangeLists[j].size();
+        if (rc != NO_ERROR)
+          break;
 
         rc = BRMWrapper::getInstance()->writeVB(curCol.dataFile.pFile, (BRM::VER_t)txnid,
                                                 curColStruct.dataOid, fboLists[j], rangeLists[j], colOp,
@@ -6554,6 +6609,8 @@ int WriteEngineWrapper::flushDataFiles(int rc, const TxnID txnId, std::map<FID,
   RemoveTxnFromLBIDMap(txnId);
   RemoveTxnFromDictMap(txnId);
 
+  int rcIndex = saveColumnIndexes();
+
   for (int i = 0; i < TOTAL_COMPRESS_OP; i++)
   {
     int rc1 = m_colOp[i]->flushFile(rc, columnOids);
@@ -6565,7 +6622,7 @@ int WriteEngineWrapper::flushDataFiles(int rc, const TxnID txnId, std::map<FID,
     }
   }
 
-  return rc;
+  return (rc == NO_ERROR) ? rcIndex : rc;
 }
 
 void WriteEngineWrapper::AddDictToList(const TxnID txnid, std::vector<BRM::LBID_t>& lbids)
@@ -442,11 +442,34 @@ class WriteEngineWrapper : public WEObj
   {
     return m_dictLBIDMap;
   };
+  /**
+   * @brief Save the rows written to indexed columns to their indexes, see ColumnOp::saveColumnIndexes().
+   */
+  int saveColumnIndexes()
+  {
+    int rc = NO_ERROR;
+
+    for (int i = 0; i < TOTAL_COMPRESS_OP; i++)
+    {
+      int rc1 = m_colOp[i]->saveColumnIndexes();
+
+      if (rc == NO_ERROR)
+        rc = rc1;
+    }
+
+    return rc;
+  }
+
   /**
    * @brief Flush the ChunkManagers.
    */
   int flushChunks(int rc, const std::map<FID, FID>& columOids)
   {
+    int rtn = saveColumnIndexes();
+
+    if (rtn != NO_ERROR)
+      return rtn;
+
     std::vector<int32_t> compressedOpIds = {COMPRESSED_OP_1, COMPRESSED_OP_2};
 
     for (const auto compressedOpId : compressedOpIds)
@@ -690,6 +713,18 @@ class WriteEngineWrapper : public WEObj
   int processVersionBuffers(IDBDataFile* pFile, const TxnID& txnid, const ColStruct& colStruct, int width,
                             int totalRow, const RIDList& ridList, std::vector<BRM::LBIDRange>& rangeList);
 
+  /**
+   * @brief Find the distinct blocks holding the given rows and their LBIDs
+   */
+  int getBlocksToVersion(const ColStruct& colStruct, int width, const RID* rowIdArray, size_t totalRow,
+                         std::vector<uint32_t>& fboList, std::vector<BRM::LBIDRange>& rangeList);
+
+  /**
+   * @brief Carve the next numBlocks blocks out of a beginVBCopy() free list
+   */
+  int getVBFreeRanges(const std::vector<BRM::VBRange>& freeList, uint32_t numBlocks, uint32_t& blocksProcessed,
+                      uint32_t& blocksProcessedThisOid, std::vector<BRM::VBRange>& curFreeList);
+
   int processBeginVBCopy(const TxnID& txnid, const std::vector<ColStruct>& colStructList,
                          const RIDList& ridList, std::vector<BRM::VBRange>& freeList,
                          std::vector<std::vector<uint32_t> >& fboLists,